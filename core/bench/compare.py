@@ -0,0 +1,73 @@
+"""
+Compare the results of spirit_bench against a stored baseline.
+
+    python core/bench/compare.py baseline.json results.json [--tolerance 0.1]
+
+Benchmarks are matched by name, system size and number of threads and compared by the
+median time per operation. The script exits with 1 if any benchmark is slower than the
+baseline by more than the tolerance, so that it can be used in automated checks.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(filename):
+    with open(filename) as f:
+        data = json.load(f)
+    benchmarks = {}
+    for b in data["benchmarks"]:
+        benchmarks[(b["name"], b["size"], b["threads"])] = b
+    return data, benchmarks
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare spirit_bench results against a baseline.")
+    parser.add_argument("baseline", help="JSON results of the baseline")
+    parser.add_argument("results",  help="JSON results to compare")
+    parser.add_argument("--tolerance", type=float, default=0.1,
+                        help="relative slowdown which is reported as a regression (default: 0.1)")
+    args = parser.parse_args()
+
+    baseline_data, baseline = load(args.baseline)
+    results_data, results = load(args.results)
+
+    if baseline_data.get("build") != results_data.get("build"):
+        print("Warning: the builds differ\n    baseline: {}\n    results:  {}".format(
+            baseline_data.get("build"), results_data.get("build")))
+
+    print("{:<45} {:>6} {:>7} {:>12} {:>12} {:>8}".format(
+        "benchmark", "size", "threads", "baseline [s]", "results [s]", "ratio"))
+    regressions = []
+    for key in sorted(results):
+        if key not in baseline:
+            continue
+        t_baseline = baseline[key]["time_median"]
+        t_results = results[key]["time_median"]
+        ratio = t_results / t_baseline if t_baseline > 0 else float("inf")
+        marker = ""
+        if ratio > 1 + args.tolerance:
+            marker = "  slower"
+            regressions.append(key)
+        elif ratio < 1 / (1 + args.tolerance):
+            marker = "  faster"
+        print("{:<45} {:>6} {:>7} {:>12.4e} {:>12.4e} {:>8.3f}{}".format(
+            key[0], key[1], key[2], t_baseline, t_results, ratio, marker))
+
+    missing = sorted(set(baseline) - set(results))
+    added = sorted(set(results) - set(baseline))
+    if missing:
+        print("\nNot in the results: " + ", ".join("{} ({}, {})".format(*k) for k in missing))
+    if added:
+        print("\nNot in the baseline: " + ", ".join("{} ({}, {})".format(*k) for k in added))
+
+    if regressions:
+        print("\n{} benchmark(s) slower than the baseline by more than {:.0f}%".format(
+            len(regressions), 100 * args.tolerance))
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,495 @@
+/*
+    spirit_bench: micro- and macro-benchmarks of the core library.
+
+    Every benchmark is run for each combination of system size (square lattices of
+    L x L x 1 cells) and number of threads (OpenMP only). The results are written as JSON,
+    which can be compared against a stored baseline with core/bench/compare.py.
+
+    Run from the root directory of the repository, e.g.
+        ./spirit_bench --sizes 32,64,128 --threads 1,4 --output bench.json
+    See --help for the available options.
+*/
+
+#include <Spirit/State.h>
+#include <Spirit/Chain.h>
+#include <Spirit/Configurations.h>
+#include <Spirit/Geometry.h>
+#include <Spirit/Hamiltonian.h>
+#include <Spirit/IO.h>
+#include <Spirit/Quantities.h>
+#include <Spirit/Simulation.h>
+#include <Spirit/Transitions.h>
+#include <Spirit/Version.h>
+#include <data/State.hpp>
+#include <engine/Hamiltonian_Heisenberg.hpp>
+#include <engine/Manifoldmath.hpp>
+#include <io/IO.hpp>
+#include <utility/Timing.hpp>
+
+#ifdef SPIRIT_USE_OPENMP
+#include <omp.h>
+#endif
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+
+struct Bench_Options
+{
+    std::string input   = "core/bench/input/bench.cfg";
+    std::string output  = "";
+    std::string scratch = "spirit_bench.ovf";
+    std::string filter  = "";
+    std::vector<int> sizes{ 32, 64, 128 };
+    std::vector<int> threads{ 1 };
+    // Minimum total time [s] and number of repetitions of each benchmark
+    double min_time        = 0.5;
+    int    min_repetitions = 5;
+    int    max_repetitions = 10000;
+};
+
+struct Bench_Result
+{
+    std::string name;
+    int size, nos, threads;
+    // Number of operations (e.g. iterations) per repetition
+    int n_operations;
+    // Time [s] per operation of each repetition
+    std::vector<double> times;
+};
+
+class Bench_Runner
+{
+public:
+    Bench_Runner( const Bench_Options & options ) : options(options), size(0), nos(0), threads(1)
+    {}
+
+    void Set_Context( int size, int nos, int threads )
+    {
+        this->size    = size;
+        this->nos     = nos;
+        this->threads = threads;
+    }
+
+    bool Selected( const std::string & name ) const
+    {
+        return options.filter.empty() || name.find( options.filter ) != std::string::npos;
+    }
+
+    // Time an operation, which returns the number of operations it carried out (e.g. iterations).
+    //      It is run once as a warm-up and then repeated until both the minimum time and the
+    //      minimum number of repetitions are reached.
+    void Run( const std::string & name, std::function<int()> operation )
+    {
+        if( !Selected( name ) )
+            return;
+
+        Bench_Result result{ name, size, nos, threads, operation(), {} };
+        if( result.n_operations <= 0 )
+        {
+            std::cerr << fmt::format( "    {:<45} skipped: no operations were carried out\n", name );
+            return;
+        }
+
+        double total = 0;
+        while( ( total < options.min_time || (int)result.times.size() < options.min_repetitions )
+               && (int)result.times.size() < options.max_repetitions )
+        {
+            auto t_start = std::chrono::steady_clock::now();
+            int n = operation();
+            std::chrono::duration<double> dt = std::chrono::steady_clock::now() - t_start;
+            total += dt.count();
+            result.times.push_back( dt.count() / std::max( n, 1 ) );
+        }
+
+        std::cerr << fmt::format( "    {:<45} {:>12.4e} s  ({} repetitions)\n", name, Median( result.times ), result.times.size() );
+        results.push_back( result );
+    }
+
+    static double Median( std::vector<double> times )
+    {
+        std::sort( times.begin(), times.end() );
+        std::size_t n = times.size();
+        return n % 2 ? times[n / 2] : 0.5 * ( times[n / 2 - 1] + times[n / 2] );
+    }
+
+    std::string To_JSON() const
+    {
+        std::string json = "{\n";
+        json += fmt::format( "  \"spirit_version\": \"{}\",\n", Spirit_Version_Full() );
+        json += fmt::format( "  \"date\": \"{}\",\n", Utility::Timing::CurrentDateTime() );
+        json += "  \"build\": {";
+        json += fmt::format( "\"scalar\": \"{}\", ", sizeof( scalar ) == sizeof( float ) ? "float" : "double" );
+        json += fmt::format( "\"openmp\": {}, ", Defined_OpenMP() );
+        json += fmt::format( "\"cuda\": {}, ", Defined_CUDA() );
+        json += fmt::format( "\"threads\": {}, ", Defined_Threads() );
+        json += fmt::format( "\"simd\": {}", Defined_SIMD() );
+        json += "},\n";
+        json += fmt::format( "  \"min_time\": {},\n", options.min_time );
+        json += "  \"benchmarks\": [\n";
+        for( std::size_t i = 0; i < results.size(); ++i )
+        {
+            auto & r = results[i];
+            double mean = std::accumulate( r.times.begin(), r.times.end(), 0.0 ) / r.times.size();
+            double variance = 0;
+            for( double t : r.times )
+                variance += ( t - mean ) * ( t - mean );
+            double stddev = r.times.size() > 1 ? std::sqrt( variance / ( r.times.size() - 1 ) ) : 0;
+
+            json += fmt::format( "    {{\"name\": \"{}\", \"size\": {}, \"nos\": {}, \"threads\": {}, ", r.name, r.size, r.nos, r.threads );
+            json += fmt::format( "\"operations_per_repetition\": {}, \"repetitions\": {}, ", r.n_operations, r.times.size() );
+            json += fmt::format( "\"time_median\": {:.6e}, \"time_mean\": {:.6e}, \"time_min\": {:.6e}, \"time_stddev\": {:.6e}}}",
+                                 Median( r.times ), mean, *std::min_element( r.times.begin(), r.times.end() ), stddev );
+            json += i + 1 < results.size() ? ",\n" : "\n";
+        }
+        json += "  ]\n}\n";
+        return json;
+    }
+
+private:
+    static const char * Defined_OpenMP()
+    {
+        #ifdef SPIRIT_USE_OPENMP
+        return "true";
+        #else
+        return "false";
+        #endif
+    }
+    static const char * Defined_CUDA()
+    {
+        #ifdef SPIRIT_USE_CUDA
+        return "true";
+        #else
+        return "false";
+        #endif
+    }
+    static const char * Defined_Threads()
+    {
+        #ifdef SPIRIT_USE_THREADS
+        return "true";
+        #else
+        return "false";
+        #endif
+    }
+    static const char * Defined_SIMD()
+    {
+        #ifdef SPIRIT_USE_SIMD
+        return "true";
+        #else
+        return "false";
+        #endif
+    }
+
+    const Bench_Options & options;
+    int size, nos, threads;
+    std::vector<Bench_Result> results;
+};
+
+
+// Create a state with L x L x 1 cells from the input file
+std::shared_ptr<State> Setup_State( const Bench_Options & options, int size )
+{
+    auto state = std::shared_ptr<State>( State_Setup( options.input.c_str(), true ), State_Delete );
+    int n_cells[3]{ size, size, 1 };
+    Geometry_Set_N_Cells( state.get(), n_cells );
+    return state;
+}
+
+// Reduce the Hamiltonian of the active image to a single term
+void Set_Single_Term( State * state, const std::string & term )
+{
+    auto ham = dynamic_cast<Engine::Hamiltonian_Heisenberg *>( state->active_image->hamiltonian.get() );
+
+    float normal[3]{ 0, 0, 1 };
+    float jij[1]{ 10 };
+    float dij[1]{ 6 };
+    Hamiltonian_Set_Field( state, term == "zeeman" ? 5 : 0, normal );
+    Hamiltonian_Set_Anisotropy( state, 0.5, normal );
+    Hamiltonian_Set_Exchange( state, term == "exchange" ? 1 : 0, jij );
+    Hamiltonian_Set_DMI( state, term == "dmi" ? 1 : 0, dij );
+    ham->ddi_method = term == "ddi" ? Engine::DDI_Method::FFT : Engine::DDI_Method::None;
+    Hamiltonian_Set_DDI( state, 0 );
+
+    // A zero anisotropy would still be evaluated, so the axes are removed
+    if( term != "anisotropy" )
+    {
+        ham->anisotropy_indices    = intfield( 0 );
+        ham->anisotropy_magnitudes = scalarfield( 0 );
+        ham->anisotropy_normals    = vectorfield( 0 );
+    }
+    ham->Update_Energy_Contributions();
+}
+
+void Bench_Hamiltonian( Bench_Runner & runner, State * state )
+{
+    auto & hamiltonian = *state->active_image->hamiltonian;
+    auto & spins = *state->active_image->spins;
+    int nos = spins.size();
+    vectorfield gradient( nos ), vec( nos ), product( nos );
+    SpMatrixX hessian;
+
+    for( std::string term : { "zeeman", "anisotropy", "exchange", "dmi", "ddi" } )
+    {
+        Set_Single_Term( state, term );
+        Configuration_Random( state );
+        vec = spins;
+        Configuration_Random( state );
+
+        runner.Run( "hamiltonian/" + term + "/energy", [&] {
+            volatile scalar energy = hamiltonian.Energy( spins );
+            (void)energy;
+            return 1;
+        } );
+        runner.Run( "hamiltonian/" + term + "/gradient", [&] {
+            hamiltonian.Gradient( spins, gradient );
+            return 1;
+        } );
+        // The sparse Hessian does not contain the DDI, when it is calculated by FFT convolution
+        if( term != "ddi" )
+        {
+            runner.Run( "hamiltonian/" + term + "/hessian", [&] {
+                hamiltonian.Sparse_Hessian( spins, hessian );
+                return 1;
+            } );
+        }
+        runner.Run( "hamiltonian/" + term + "/hessian_vector_product", [&] {
+            hamiltonian.Hessian_Vector_Product( spins, vec, product );
+            return 1;
+        } );
+    }
+}
+
+// The method which is stored in the state after a simulation of the active image or chain
+std::shared_ptr<Engine::Method> Stored_Method( State * state, const std::string & method )
+{
+    if( method == "GNEB" )
+        return state->method_chain[state->idx_active_chain];
+    return state->method_image[state->idx_active_chain][state->idx_active_image];
+}
+
+// Run a number of iterations of a method and return how many were actually carried out
+int Iterate( State * state, const char * method, const char * solver, int n_iterations )
+{
+    auto method_before = Stored_Method( state, method );
+    int iteration_start = method_before ? method_before->getNIterations() : 0;
+    Simulation_PlayPause( state, method, solver, n_iterations );
+    auto method_after = Stored_Method( state, method );
+    if( !method_after )
+        return 0;
+    // A method which is not resumed starts counting at zero
+    if( method_after != method_before )
+        iteration_start = 0;
+    return method_after->getNIterations() - iteration_start;
+}
+
+void Bench_Solvers( Bench_Runner & runner, State * state )
+{
+    const int n_iterations = 10;
+    for( auto solver : { "SIB", "Heun", "Depondt", "NCG", "VP", "BFGS" } )
+    {
+        Configuration_Random( state );
+        runner.Run( fmt::format( "solver/llg/{}", solver ), [&] {
+            return Iterate( state, "LLG", solver, n_iterations );
+        } );
+    }
+
+    Configuration_Random( state );
+    runner.Run( "solver/mc", [&] {
+        return Iterate( state, "MC", "", n_iterations );
+    } );
+}
+
+// Create a chain of images between a skyrmion and the ferromagnet
+void Setup_Chain( State * state, int size, int noi )
+{
+    Configuration_PlusZ( state );
+    Configuration_Skyrmion( state, size / 4.0f, 1, -90, false, false, false );
+    Chain_Image_to_Clipboard( state );
+    for( int i = 1; i < noi; ++i )
+        Chain_Push_Back( state );
+    Chain_Jump_To_Image( state, noi - 1 );
+    Configuration_PlusZ( state );
+    Chain_Jump_To_Image( state, 0 );
+    Transition_Homogeneous( state, 0, noi - 1 );
+}
+
+void Bench_Chain( Bench_Runner & runner, State * state )
+{
+    runner.Run( "solver/gneb/VP", [&] {
+        return Iterate( state, "GNEB", "VP", 10 );
+    } );
+
+    auto & chain = *state->active_chain;
+    int noi = chain.noi;
+    std::vector<std::shared_ptr<vectorfield>> configurations( noi );
+    std::vector<scalar> energies( noi );
+    std::vector<vectorfield> tangents( noi, vectorfield( chain.images[0]->nos ) );
+    for( int i = 0; i < noi; ++i )
+    {
+        configurations[i] = chain.images[i]->spins;
+        energies[i] = chain.images[i]->hamiltonian->Energy( *configurations[i] );
+    }
+    runner.Run( "manifoldmath/tangents", [&] {
+        Engine::Manifoldmath::Tangents( configurations, energies, tangents );
+        return 1;
+    } );
+}
+
+void Bench_Quantities_IO( Bench_Runner & runner, State * state, const Bench_Options & options, int size )
+{
+    Configuration_PlusZ( state );
+    Configuration_Skyrmion( state, size / 4.0f, 1, -90, false, false, false );
+
+    runner.Run( "quantities/topological_charge", [&] {
+        volatile float charge = Quantity_Get_Topological_Charge( state );
+        (void)charge;
+        return 1;
+    } );
+
+    const char * file = options.scratch.c_str();
+    for( auto format : { std::make_pair( "bin8", IO_Fileformat_OVF_bin8 ),
+                         std::make_pair( "bin4", IO_Fileformat_OVF_bin4 ),
+                         std::make_pair( "text", IO_Fileformat_OVF_text ) } )
+    {
+        // Writes may be queued, so the time includes waiting for them to be carried out
+        runner.Run( fmt::format( "io/ovf_write/{}", format.first ), [&] {
+            IO_Image_Write( state, file, format.second );
+            IO::Flush_Output( file );
+            return 1;
+        } );
+        IO_Image_Write( state, file, format.second );
+        IO::Flush_Output( file );
+        runner.Run( fmt::format( "io/ovf_read/{}", format.first ), [&] {
+            IO_Image_Read( state, file );
+            return 1;
+        } );
+    }
+    std::remove( file );
+}
+
+
+std::vector<int> Parse_List( const std::string & str )
+{
+    std::vector<int> values;
+    std::size_t begin = 0;
+    while( begin < str.size() )
+    {
+        std::size_t end = str.find( ',', begin );
+        if( end == std::string::npos )
+            end = str.size();
+        values.push_back( std::stoi( str.substr( begin, end - begin ) ) );
+        begin = end + 1;
+    }
+    return values;
+}
+
+void Print_Usage()
+{
+    std::cerr <<
+        "Usage: spirit_bench [options]\n"
+        "  --input <file>        Input file with the Hamiltonian and method parameters\n"
+        "                        (default: core/bench/input/bench.cfg)\n"
+        "  --output <file>       Write the JSON results to a file instead of stdout\n"
+        "  --sizes <L,...>       System sizes, i.e. number of cells along a and b (default: 32,64,128)\n"
+        "  --threads <n,...>     Numbers of OpenMP threads (default: 1 and the maximum)\n"
+        "  --filter <string>     Only run benchmarks whose name contains the string\n"
+        "  --min-time <s>        Minimum total time of each benchmark (default: 0.5)\n"
+        "  --min-repetitions <n> Minimum number of repetitions of each benchmark (default: 5)\n"
+        "  --scratch <file>      Temporary file for the IO benchmarks (default: spirit_bench.ovf)\n";
+}
+
+int main( int argc, char ** argv )
+{
+    Bench_Options options;
+    #ifdef SPIRIT_USE_OPENMP
+    if( omp_get_max_threads() > 1 )
+        options.threads.push_back( omp_get_max_threads() );
+    #endif
+
+    for( int i = 1; i < argc; ++i )
+    {
+        std::string arg = argv[i];
+        if( arg == "--help" || arg == "-h" )
+        {
+            Print_Usage();
+            return 0;
+        }
+        if( i + 1 >= argc )
+        {
+            std::cerr << "Missing value of option " << arg << "\n";
+            Print_Usage();
+            return 1;
+        }
+        std::string value = argv[++i];
+        if( arg == "--input" )                  options.input = value;
+        else if( arg == "--output" )            options.output = value;
+        else if( arg == "--sizes" )             options.sizes = Parse_List( value );
+        else if( arg == "--threads" )           options.threads = Parse_List( value );
+        else if( arg == "--filter" )            options.filter = value;
+        else if( arg == "--min-time" )          options.min_time = std::stod( value );
+        else if( arg == "--min-repetitions" )   options.min_repetitions = std::stoi( value );
+        else if( arg == "--scratch" )           options.scratch = value;
+        else
+        {
+            std::cerr << "Unknown option " << arg << "\n";
+            Print_Usage();
+            return 1;
+        }
+    }
+
+    #ifndef SPIRIT_USE_OPENMP
+    if( options.threads != std::vector<int>{ 1 } )
+        std::cerr << "Spirit was built without OpenMP, the benchmarks are only run with one thread\n";
+    options.threads = { 1 };
+    #endif
+
+    Bench_Runner runner( options );
+    for( int size : options.sizes )
+    {
+        auto state_hamiltonian = Setup_State( options, size );
+        auto state_solvers     = Setup_State( options, size );
+        auto state_chain       = Setup_State( options, size );
+        int nos = Geometry_Get_NOS( state_solvers.get() );
+        Setup_Chain( state_chain.get(), size, 7 );
+
+        for( int n_threads : options.threads )
+        {
+            #ifdef SPIRIT_USE_OPENMP
+            omp_set_num_threads( n_threads );
+            #endif
+            std::cerr << fmt::format( "size {}x{} ({} spins), {} threads\n", size, size, nos, n_threads );
+            runner.Set_Context( size, nos, n_threads );
+
+            Bench_Hamiltonian( runner, state_hamiltonian.get() );
+            Bench_Solvers( runner, state_solvers.get() );
+            Bench_Chain( runner, state_chain.get() );
+            Bench_Quantities_IO( runner, state_solvers.get(), options, size );
+        }
+    }
+
+    std::string json = runner.To_JSON();
+    if( options.output.empty() )
+        std::cout << json;
+    else
+    {
+        std::ofstream file( options.output );
+        file << json;
+        if( !file )
+        {
+            std::cerr << "Could not write the results to " << options.output << "\n";
+            return 1;
+        }
+    }
+    return 0;
+}
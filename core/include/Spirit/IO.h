@@ -49,9 +49,11 @@ DLLEXPORT void IO_Image_Write_Neighbours_Exchange( State * state, const char * f
 DLLEXPORT void IO_Image_Write_Neighbours_DMI( State * state, const char * file, 
                                     int idx_image=-1, int idx_chain=-1 ) noexcept;
 
-// Save the spin-resolved energy contributions of a spin system
+// Save the spin-resolved energy contributions of a spin system.
+//    With an OVF format, the total energy and the contributions are the values of each spin,
+//    otherwise (IO_Fileformat_GEN_text) they are written as a text table.
 DLLEXPORT void IO_Image_Write_Energy_per_Spin( State *state, const char *file, int idx_image=-1, 
-                                               int idx_chain = -1 ) noexcept;
+                                               int idx_chain = -1, int format=IO_Fileformat_GEN_text ) noexcept;
 // Save the Energy contributions of a spin system
 DLLEXPORT void IO_Image_Write_Energy( State *state, const char *file, int idx_image=-1, 
                                       int idx_chain=-1 ) noexcept;
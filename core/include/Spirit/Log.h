@@ -60,6 +60,8 @@ DLLEXPORT void Log_Set_Output_To_Console(State *state, bool b) noexcept;
 DLLEXPORT void Log_Set_Output_Console_Level(State *state, int level) noexcept;
 DLLEXPORT void Log_Set_Output_To_File(State *state, bool b) noexcept;
 DLLEXPORT void Log_Set_Output_File_Level(State *state, int level) noexcept;
+// Whether the accumulated timings (see Simulation_Get_Timings) are appended to the log messages of the methods
+DLLEXPORT void Log_Set_Output_Timings(State *state, bool b) noexcept;
 
 //      Get Log parameters
 DLLEXPORT const char * Log_Get_Output_File_Tag(State *state) noexcept;
@@ -68,6 +70,7 @@ DLLEXPORT bool Log_Get_Output_To_Console(State *state) noexcept;
 DLLEXPORT int Log_Get_Output_Console_Level(State *state) noexcept;
 DLLEXPORT bool Log_Get_Output_To_File(State *state) noexcept;
 DLLEXPORT int Log_Get_Output_File_Level(State *state) noexcept;
+DLLEXPORT bool Log_Get_Output_Timings(State *state) noexcept;
 
 #include "DLL_Undefine_Export.h"
 #endif
\ No newline at end of file
@@ -6,6 +6,10 @@
 
 struct State;
 
+// Monte Carlo algorithms
+#define MC_Algorithm_Metropolis 0   // Trial moves within a cone, accepted according to the energy difference
+#define MC_Algorithm_Heat_Bath  1   // Direct sampling from the local Boltzmann distribution
+
 //      Set LLG
 // Output
 DLLEXPORT void Parameters_Set_LLG_Output_Tag(State *state, const char * tag, int idx_image=-1, int idx_chain=-1) noexcept;
@@ -14,6 +18,15 @@ DLLEXPORT void Parameters_Set_LLG_Output_General(State *state, bool any, bool in
 DLLEXPORT void Parameters_Set_LLG_Output_Energy(State *state, bool energy_step, bool energy_archive, bool energy_spin_resolved, bool energy_divide_by_nos, bool energy_add_readability_lines, int idx_image=-1, int idx_chain=-1) noexcept;
 DLLEXPORT void Parameters_Set_LLG_Output_Configuration(State *state, bool configuration_step, bool configuration_archive, int configuration_filetype=IO_Fileformat_OVF_text, int idx_image=-1, int idx_chain=-1) noexcept;
 DLLEXPORT void Parameters_Set_LLG_N_Iterations(State *state, int n_iterations, int n_iterations_log, int idx_image=-1, int idx_chain=-1) noexcept;
+// Compressed trajectory output, written with every log step.
+//    n_bits is the number of bits per coordinate of the quantized spin directions (0 = lossless).
+DLLEXPORT void Parameters_Set_LLG_Output_Trajectory(State *state, bool trajectory, int n_bits=16, int idx_image=-1, int idx_chain=-1) noexcept;
+// Number of iterations after which energy and magnetization are recorded in the history.
+//    With 0 they are only calculated when needed, i.e. when logging, writing output or through the API.
+DLLEXPORT void Parameters_Set_LLG_N_Iterations_Observables(State *state, int n_iterations_observables, int idx_image=-1, int idx_chain=-1) noexcept;
+// Maximum number of iterations between checks of the stop file and walltime.
+//    The actual number is adapted such that a block of iterations takes about 10 ms.
+DLLEXPORT void Parameters_Set_LLG_N_Iterations_Amortize(State *state, int n_iterations_amortize, int idx_image=-1, int idx_chain=-1) noexcept;
 // Simulation Parameters
 DLLEXPORT void Parameters_Set_LLG_Direct_Minimization(State *state, bool direct, int idx_image=-1, int idx_chain=-1) noexcept;
 DLLEXPORT void Parameters_Set_LLG_Convergence(State *state, float convergence, int idx_image=-1, int idx_chain=-1) noexcept;
@@ -31,9 +44,17 @@ DLLEXPORT void Parameters_Set_MC_Output_General(State *state, bool any, bool ini
 DLLEXPORT void Parameters_Set_MC_Output_Energy(State *state, bool energy_step, bool energy_archive, bool energy_spin_resolved, bool energy_divide_by_nos, bool energy_add_readability_lines, int idx_image=-1, int idx_chain=-1) noexcept;
 DLLEXPORT void Parameters_Set_MC_Output_Configuration(State *state, bool configuration_step, bool configuration_archive, int configuration_filetype=IO_Fileformat_OVF_text, int idx_image=-1, int idx_chain=-1) noexcept;
 DLLEXPORT void Parameters_Set_MC_N_Iterations(State *state, int n_iterations, int n_iterations_log, int idx_image=-1, int idx_chain=-1) noexcept;
+DLLEXPORT void Parameters_Set_MC_N_Iterations_Amortize(State *state, int n_iterations_amortize, int idx_image=-1, int idx_chain=-1) noexcept;
+// Compressed trajectory output, written with every log step.
+//    n_bits is the number of bits per coordinate of the quantized spin directions (0 = lossless).
+DLLEXPORT void Parameters_Set_MC_Output_Trajectory(State *state, bool trajectory, int n_bits=16, int idx_image=-1, int idx_chain=-1) noexcept;
 // Simulation Parameters
 DLLEXPORT void Parameters_Set_MC_Temperature(State *state, float T, int idx_image=-1, int idx_chain=-1) noexcept;
 DLLEXPORT void Parameters_Set_MC_Acceptance_Ratio(State *state, float ratio, int idx_image=-1, int idx_chain=-1) noexcept;
+// Random sampling of spins (otherwise the spins are swept in order, in parallel where possible)
+DLLEXPORT void Parameters_Set_MC_Random_Sample(State *state, bool random_sample, int idx_image=-1, int idx_chain=-1) noexcept;
+// Algorithm used to update the spins (MC_Algorithm_Metropolis or MC_Algorithm_Heat_Bath)
+DLLEXPORT void Parameters_Set_MC_Algorithm(State *state, int algorithm, int idx_image=-1, int idx_chain=-1) noexcept;
 
 //      Set GNEB
 // Output
@@ -43,6 +64,7 @@ DLLEXPORT void Parameters_Set_GNEB_Output_General(State *state, bool any, bool i
 DLLEXPORT void Parameters_Set_GNEB_Output_Energies(State *state, bool energies_step, bool energies_interpolated, bool energies_divide_by_nos, bool energies_add_readability_lines, int idx_chain=-1) noexcept;
 DLLEXPORT void Parameters_Set_GNEB_Output_Chain(State *state, bool chain_step, int chain_filetype=IO_Fileformat_OVF_text, int idx_chain=-1) noexcept;
 DLLEXPORT void Parameters_Set_GNEB_N_Iterations(State *state, int n_iterations, int n_iterations_log, int idx_chain=-1) noexcept;
+DLLEXPORT void Parameters_Set_GNEB_N_Iterations_Amortize(State *state, int n_iterations_amortize, int idx_chain=-1) noexcept;
 // Simulation Parameters
 DLLEXPORT void Parameters_Set_GNEB_Convergence(State *state, float convergence, int idx_image=-1, int idx_chain=-1) noexcept;
 DLLEXPORT void Parameters_Set_GNEB_Spring_Constant(State *state, float spring_constant, int idx_image=-1, int idx_chain=-1) noexcept;
@@ -51,6 +73,9 @@ DLLEXPORT void Parameters_Set_GNEB_Climbing_Falling(State *state, int image_type
 //    Maxima are set to climbing, minima to falling, others are not changed.
 DLLEXPORT void Parameters_Set_GNEB_Image_Type_Automatically(State *state, int idx_chain=-1) noexcept;
 DLLEXPORT void Parameters_Set_GNEB_N_Energy_Interpolations(State *state, int n, int idx_chain=-1) noexcept;
+// Number of threads used for each image, so that several images are evaluated concurrently.
+//    With 0 the images are evaluated one after the other. This requires a build with OpenMP.
+DLLEXPORT void Parameters_Set_GNEB_Threads_Per_Image(State *state, int n_threads, int idx_chain=-1) noexcept;
 
 
 //      Get LLG
@@ -61,6 +86,9 @@ DLLEXPORT void Parameters_Get_LLG_Output_General(State *state, bool * any, bool
 DLLEXPORT void Parameters_Get_LLG_Output_Energy(State *state, bool * energy_step, bool * energy_archive, bool * energy_spin_resolved, bool * energy_divide_by_nos, bool * energy_add_readability_lines, int idx_image=-1, int idx_chain=-1) noexcept;
 DLLEXPORT void Parameters_Get_LLG_Output_Configuration(State *state, bool * configuration_step, bool * configuration_archive, int * configuration_filetype, int idx_image=-1, int idx_chain=-1) noexcept;
 DLLEXPORT void Parameters_Get_LLG_N_Iterations(State *state, int * iterations, int * iterations_log, int idx_image=-1, int idx_chain=-1) noexcept;
+DLLEXPORT void Parameters_Get_LLG_Output_Trajectory(State *state, bool * trajectory, int * n_bits, int idx_image=-1, int idx_chain=-1) noexcept;
+DLLEXPORT int Parameters_Get_LLG_N_Iterations_Observables(State *state, int idx_image=-1, int idx_chain=-1) noexcept;
+DLLEXPORT int Parameters_Get_LLG_N_Iterations_Amortize(State *state, int idx_image=-1, int idx_chain=-1) noexcept;
 // Simulation Parameters
 DLLEXPORT bool Parameters_Get_LLG_Direct_Minimization(State *state, int idx_image=-1, int idx_chain=-1) noexcept;
 DLLEXPORT float Parameters_Get_LLG_Convergence(State *state, int idx_image=-1, int idx_chain=-1) noexcept;
@@ -79,9 +107,13 @@ DLLEXPORT void Parameters_Get_MC_Output_General(State *state, bool * any, bool *
 DLLEXPORT void Parameters_Get_MC_Output_Energy(State *state, bool * energy_step, bool * energy_archive, bool * energy_spin_resolved, bool * energy_divide_by_nos, bool * energy_add_readability_lines, int idx_image=-1, int idx_chain=-1) noexcept;
 DLLEXPORT void Parameters_Get_MC_Output_Configuration(State *state, bool * configuration_step, bool * configuration_archive, int * configuration_filetype, int idx_image=-1, int idx_chain=-1) noexcept;
 DLLEXPORT void Parameters_Get_MC_N_Iterations(State *state, int * iterations, int * iterations_log, int idx_image=-1, int idx_chain=-1) noexcept;
+DLLEXPORT int Parameters_Get_MC_N_Iterations_Amortize(State *state, int idx_image=-1, int idx_chain=-1) noexcept;
+DLLEXPORT void Parameters_Get_MC_Output_Trajectory(State *state, bool * trajectory, int * n_bits, int idx_image=-1, int idx_chain=-1) noexcept;
 // Simulation Parameters
 DLLEXPORT float Parameters_Get_MC_Temperature(State *state, int idx_image=-1, int idx_chain=-1) noexcept;
 DLLEXPORT float Parameters_Get_MC_Acceptance_Ratio(State *state, int idx_image=-1, int idx_chain=-1) noexcept;
+DLLEXPORT bool Parameters_Get_MC_Random_Sample(State *state, int idx_image=-1, int idx_chain=-1) noexcept;
+DLLEXPORT int  Parameters_Get_MC_Algorithm(State *state, int idx_image=-1, int idx_chain=-1) noexcept;
 
 //      Get GNEB
 // Output
@@ -91,11 +123,13 @@ DLLEXPORT void Parameters_Get_GNEB_Output_General(State *state, bool * any, bool
 DLLEXPORT void Parameters_Get_GNEB_Output_Energies(State *state, bool * energies_step, bool * energies_interpolated, bool * energies_divide_by_nos, bool * energies_add_readability_lines, int idx_chain=-1) noexcept;
 DLLEXPORT void Parameters_Get_GNEB_Output_Chain(State *state, bool * chain_step, int * chain_filetype, int idx_chain=-1) noexcept;
 DLLEXPORT void Parameters_Get_GNEB_N_Iterations(State *state, int * iterations, int * iterations_log, int idx_chain=-1) noexcept;
+DLLEXPORT int Parameters_Get_GNEB_N_Iterations_Amortize(State *state, int idx_chain=-1) noexcept;
 // Simulation Parameters
 DLLEXPORT float Parameters_Get_GNEB_Convergence(State *state, int idx_image=-1, int idx_chain=-1) noexcept;
 DLLEXPORT float Parameters_Get_GNEB_Spring_Constant(State *state, int idx_image=-1, int idx_chain=-1) noexcept;
 DLLEXPORT int Parameters_Get_GNEB_Climbing_Falling(State *state, int idx_image=-1, int idx_chain=-1) noexcept;
 DLLEXPORT int Parameters_Get_GNEB_N_Energy_Interpolations(State *state, int idx_chain=-1) noexcept;
+DLLEXPORT int Parameters_Get_GNEB_Threads_Per_Image(State *state, int idx_chain=-1) noexcept;
 
 #include "DLL_Undefine_Export.h"
 #endif
\ No newline at end of file
@@ -5,7 +5,7 @@
 
 struct State;
 
-// Total Magnetization
+// Total Magnetization. While a simulation is running, it is calculated from the last published snapshot.
 DLLEXPORT void Quantity_Get_Magnetization(State * state, float m[3], int idx_image=-1, int idx_chain=-1) noexcept;
 
 // Topological Charge
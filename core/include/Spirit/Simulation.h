@@ -63,5 +63,18 @@ DLLEXPORT bool Simulation_Running_Anywhere_Chain(State *state, int idx_chain=-1)
 // Check if a simulation is running on any or all images or chains of a collection
 DLLEXPORT bool Simulation_Running_Anywhere_Collection(State *state) noexcept;
 
+
+// Timings of the Hamiltonian terms, solver phases and output
+//		The wall time and number of calls are accumulated across all simulations since the
+//		last reset, e.g. "Hamiltonian/Gradient/DMI", "LLG/Force" or "IO/Write".
+//		Only sections which have been called are included. Names are sorted alphabetically.
+// Get the number of timings
+DLLEXPORT int Simulation_Get_N_Timings(State *state) noexcept;
+// Get up to n timings, returns the number of timings written to the arrays.
+//		The names are valid for the lifetime of the library.
+DLLEXPORT int Simulation_Get_Timings(State *state, const char ** names, float * seconds, int * calls, int n) noexcept;
+// Set all timings to zero
+DLLEXPORT void Simulation_Reset_Timings(State *state) noexcept;
+
 #include "DLL_Undefine_Export.h"
 #endif
\ No newline at end of file
@@ -12,7 +12,20 @@ DLLEXPORT int System_Get_Index(State * state) noexcept;
 DLLEXPORT int System_Get_NOS(State * state, int idx_image=-1, int idx_chain=-1) noexcept;
 
 // Data
+// The spins may be written through the returned pointer, so the cached observables are invalidated.
+//    If the pointer is kept and written to later, System_Spins_Changed has to be called after writing.
 DLLEXPORT scalar * System_Get_Spin_Directions(State * state, int idx_image=-1, int idx_chain=-1) noexcept;
+// Invalidate the cached observables (energy, magnetization, effective field) and the snapshot
+//    after the spins were modified through the pointer returned by System_Get_Spin_Directions
+DLLEXPORT void System_Spins_Changed(State * state, int idx_image=-1, int idx_chain=-1) noexcept;
+// Copy the last published snapshot of the spin directions (3*NOS scalars) into spins, without waiting
+//    for a running simulation. Returns the iteration at which the snapshot was published or -1 on failure.
+//    If no simulation is running, a snapshot of the current spins is published if necessary.
+DLLEXPORT int System_Get_Spin_Snapshot(State * state, scalar * spins, int idx_image=-1, int idx_chain=-1) noexcept;
+// Number of iterations after which a running simulation publishes a snapshot (0 = only at start, end and log steps)
+DLLEXPORT void System_Set_Snapshot_Interval(State * state, int n_iterations, int idx_image=-1, int idx_chain=-1) noexcept;
+// While a simulation is running, the getters of the effective field and the energy do not wait for it:
+//    the last calculated effective field and the energy of the last published snapshot are returned
 DLLEXPORT scalar * System_Get_Effective_Field(State * state, int idx_image=-1, int idx_chain=-1) noexcept;
 DLLEXPORT float System_Get_Rx(State * state, int idx_image=-1, int idx_chain=-1) noexcept;
 DLLEXPORT float System_Get_Energy(State * state, int idx_image=-1, int idx_chain=-1) noexcept;
@@ -7,6 +7,9 @@
 #include <Spirit/Geometry.h>
 
 #include <vector>
+#include <array>
+#include <map>
+#include <mutex>
 
 namespace Data
 {
@@ -44,9 +47,10 @@ namespace Data
 
 
         // ---------- Convenience functions
-        // Retrieve triangulation, if 2D
+        // Retrieve triangulation, if 2D. It is calculated once per n_cell_step and remains valid
+        //      as long as the geometry exists, so it can be retrieved from several threads.
         const std::vector<triangle_t>&    triangulation(int n_cell_step=1);
-        // Retrieve tetrahedra, if 3D
+        // Retrieve tetrahedra, if 3D (see triangulation)
         const std::vector<tetrahedron_t>& tetrahedra(int n_cell_step=1);
         // Introduce disorder into the atom types
         // void disorder(scalar mixing);
@@ -106,14 +110,27 @@ namespace Data
 		// Calculate and update the type lattice
 		void calculateGeometryType();
 
-        // 
-        std::vector<triangle_t>    _triangulation;
-        std::vector<tetrahedron_t> _tetrahedra;
-        
-        // Temporaries to tell wether the triangulation or tetrahedra
-        // need to be updated when the corresponding function is called
-        int last_update_n_cell_step;
-        intfield last_update_n_cells;
+        // Triangulations and tetrahedra which have been calculated, for each n_cell_step.
+        //      The geometry is shared between systems, so the cache is guarded by a mutex.
+        //      Its entries are never modified once calculated.
+        struct Delaunay_Cache
+        {
+            Delaunay_Cache() {}
+            // A copy of the geometry calculates its triangulations and tetrahedra again on demand
+            Delaunay_Cache(const Delaunay_Cache &) {}
+            Delaunay_Cache & operator=(const Delaunay_Cache &)
+            {
+                std::lock_guard<std::mutex> guard(this->mutex);
+                this->triangulations.clear();
+                this->tetrahedra.clear();
+                return *this;
+            }
+
+            std::mutex mutex;
+            std::map<int, std::vector<triangle_t>>    triangulations;
+            std::map<int, std::vector<tetrahedron_t>> tetrahedra;
+        };
+        Delaunay_Cache cache;
     };
 }
 #endif
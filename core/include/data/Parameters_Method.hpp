@@ -29,6 +29,10 @@ namespace Data
         // Maximum walltime for Iterate in seconds
         long int max_walltime_sec;
 
+        // Maximum number of iterations between the checks of the stop file and walltime, during
+        //      which the systems stay locked. Shorter blocks are used if iterations take long.
+        long int n_iterations_amortize;
+
         // ---------------- Pinning --------------
         // Info on pinned spins
         std::shared_ptr<Pinning> pinning;
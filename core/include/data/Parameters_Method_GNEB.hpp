@@ -27,6 +27,9 @@ namespace Data
         // Number of Energy interpolations between Images
         int n_E_interpolations;
 
+        // Number of threads used for each image, if the images are evaluated concurrently (0 = one image after the other)
+        int n_threads_per_image;
+
         // Temperature [K]
         scalar temperature;
         // Seed for RNG
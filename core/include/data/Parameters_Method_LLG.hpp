@@ -3,6 +3,7 @@
 #define DATA_PARAMETERS_METHOD_LLG_H
 
 #include <vector>
+#include <cstdint>
 
 #include "Spirit_Defines.h"
 #include <engine/Vectormath_Defines.hpp>
@@ -31,6 +32,9 @@ namespace Data
         int rng_seed;
         // Mersenne twister PRNG
         std::mt19937 prng;
+        // Counter of the counter-based PRNG used for the thermal noise,
+        // which is incremented every time a noise field is generated
+        std::uint64_t rng_counter;
 
         // Temperature [K]
         scalar temperature;
@@ -49,6 +53,9 @@ namespace Data
         // Do direct minimization instead of dynamics
         bool direct_minimization;
 
+        // Number of iterations after which energy and magnetization are recorded (0 = only when data is saved)
+        long int n_iterations_observables;
+
         // ----------------- Output --------------
         // Energy output settings
         bool output_energy_step;
@@ -56,10 +63,15 @@ namespace Data
         bool output_energy_spin_resolved;
         bool output_energy_divide_by_nspins;
         bool output_energy_add_readability_lines;
+        // File format of the spin-resolved energies (IO_Fileformat_OVF_* or IO_Fileformat_GEN_text)
+        int  output_energy_spin_resolved_filetype;
         // Spin configurations output settings
         bool output_configuration_step;
         bool output_configuration_archive;
         int  output_configuration_filetype;
+        // Compressed trajectory output (see IO::Trajectory_Writer), n_bits = 0 for lossless frames
+        bool output_trajectory;
+        int  output_trajectory_bits;
     };
 }
 #endif
\ No newline at end of file
@@ -10,6 +10,15 @@
 
 namespace Data
 {
+    // Algorithm used to update a single spin in a Monte Carlo sweep
+    enum class MC_Algorithm
+    {
+        // Trial move within a cone, accepted according to the energy difference
+        Metropolis = 0,
+        // Direct sampling from the local Boltzmann distribution around the effective field
+        Heat_Bath  = 1
+    };
+
     // LLG_Parameters contains all LLG information about the spin system
     class Parameters_Method_MC : public Parameters_Method
     {
@@ -28,6 +37,8 @@ namespace Data
         // Mersenne twister PRNG
         std::mt19937 prng;
 
+        // Metropolis or heat bath algorithm
+        MC_Algorithm algorithm;
         // Whether to sample spins randomly or in sequence in Metropolis algorithm
         bool metropolis_random_sample;
         // Whether to use the adaptive cone radius (otherwise just uses full sphere sampling)
@@ -51,6 +62,9 @@ namespace Data
         bool output_configuration_step;
         bool output_configuration_archive;
         int  output_configuration_filetype;
+        // Compressed trajectory output (see IO::Trajectory_Writer), n_bits = 0 for lossless frames
+        bool output_trajectory;
+        int  output_trajectory_bits;
     };
 }
 #endif
\ No newline at end of file
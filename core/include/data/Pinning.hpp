@@ -27,6 +27,9 @@ namespace Data
 		// Set pinned vectors in a vectorfield
 		void Apply(vectorfield & vf);
 
+		// Move the masks to a new geometry, which replaces the current one
+		void Update_Geometry(std::shared_ptr<Geometry> geometry);
+
 		//intfield mask_pinned;
 		intfield mask_unpinned;
 		vectorfield mask_pinned_cells;
@@ -5,6 +5,8 @@
 #include <random>
 #include <memory>
 #include <mutex>
+#include <atomic>
+#include <cstdint>
 
 #include "Spirit_Defines.h"
 #include <engine/Vectormath_Defines.hpp>
@@ -16,6 +18,19 @@
 
 namespace Data
 {
+	// Copy of a spin configuration, published by a running method for readers such as the API and UIs
+	struct Spin_Snapshot
+	{
+		// Orientations of the spins at the time of publishing
+		vectorfield spins;
+		// Iteration of the method run at which the snapshot was published
+		int iteration;
+		// Total energy as last calculated or set before publishing (it may belong to earlier spins)
+		scalar energy;
+		// Version of the spin configuration which was copied
+		std::uint64_t spins_version;
+	};
+
 	/*
 	Spin_System contains all setup information on one system (one set of spins, one image).
 	This includes: Spin positions and orientations, Neighbours, Interaction constants, System parameters
@@ -31,27 +46,61 @@ namespace Data
 		Spin_System& operator=(Spin_System const & other);
 
 		// Update
+		//		The calculation uses the spins and the work buffers of the Hamiltonian, so the caller
+		//		has to hold the lock of the system or be the running method, which writes the spins.
 		void UpdateEnergy();
 		void UpdateEffectiveField();
+		void UpdateMagnetization();
+
+		// Lazy update: only recalculate if the spins have changed since the last update
+		void UpdateEnergyIfOutdated();
+		void UpdateEffectiveFieldIfOutdated();
+		void UpdateMagnetizationIfOutdated();
+
+		// Set the energy, e.g. as calculated by a method together with the forces
+		void SetEnergy(scalar energy);
+
+		// Have to be called whenever the spins or the Hamiltonian were modified, so that the
+		//		observables (E, M and effective_field) are recalculated by the next lazy update
+		void SpinsChanged();
+		void HamiltonianChanged();
+
+		// Give this system its own copy of the geometry, e.g. before modifying the atom types.
+		//		The interactions of the Hamiltonian are rebuilt for the copy.
+		void Unshare_Geometry();
 
 		// For multithreading
 		void Lock() const;
 		void Unlock() const;
 
+		// Publish a copy of the current spins. Has to be called by the only writer of the spins,
+		//		i.e. by the running method or while the system is locked.
+		void PublishSnapshot(int iteration);
+		// Get the last published snapshot (nullptr if there is none), without locking the system.
+		//		The snapshot is not modified while the returned pointer is held.
+		std::shared_ptr<const Spin_Snapshot> GetSnapshot() const;
+		// Whether the spins changed since the last snapshot was published
+		bool SnapshotOutdated() const;
+
 		// Number of spins
 		int nos;
 		// Orientations of the Spins: spins[dim][nos]
 		std::shared_ptr<vectorfield> spins;
 		// Spin Hamiltonian
 		std::shared_ptr<Engine::Hamiltonian> hamiltonian;
-		// Geometric Information
+		// Geometric Information, shared between copies of the system (e.g. the images of a chain).
+		//		It must not be modified in place, but replaced or unshared (see Unshare_Geometry).
 		std::shared_ptr<Geometry> geometry;
 		// Parameters for LLG iterations
 		std::shared_ptr<Parameters_Method_LLG> llg_parameters;
 		// Parameters for MC iterations
 		std::shared_ptr<Parameters_Method_MC> mc_parameters;
 		// Is it allowed to iterate on this system?
-		bool iteration_allowed;
+		//		Running methods check this in every iteration, so it can be reset without locking
+		std::atomic<bool> iteration_allowed;
+		// Number of iterations after which a running method publishes a snapshot of the spins
+		//		(0 = only at the start and end of an iteration run and at each log step)
+		int n_iterations_snapshot;
 
 		// Total Energy of the spin system (to be updated from outside, i.e. SIB, GNEB, ...)
 		scalar E;
@@ -64,6 +113,19 @@ namespace Data
 	private:
 		// Mutex for thread-safety
 		mutable std::mutex mutex;
+
+		// Version of the spin configuration and the versions for which the observables were calculated
+		std::atomic<std::uint64_t> spins_version;
+		std::uint64_t energy_version, effective_field_version, magnetization_version;
+		// Mutex for the update of the observables, which a running method also performs outside of Lock
+		mutable std::mutex observables_mutex;
+
+		// Published snapshot and the buffer which is reused for the next snapshot
+		std::shared_ptr<Spin_Snapshot> snapshot, snapshot_spare;
+
+		void Calculate_Energy();
+		void Calculate_Effective_Field();
+		void Calculate_Magnetization();
 	};
 }
 #endif
\ No newline at end of file
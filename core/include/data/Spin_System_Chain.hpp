@@ -6,6 +6,8 @@
 #include <data/Spin_System.hpp>
 #include <data/Parameters_Method_GNEB.hpp>
 
+#include <atomic>
+
 namespace Data
 {
 	enum class GNEB_Image_Type
@@ -34,7 +36,8 @@ namespace Data
 		std::shared_ptr<Data::Parameters_Method_GNEB> gneb_parameters;
 
 		// Are we allowed to iterate on this chain?
-		bool iteration_allowed;
+		//		Running methods check this in every iteration, so it can be reset without locking
+		std::atomic<bool> iteration_allowed;
 
 		// Climbing and falling images
 		std::vector<GNEB_Image_Type> image_type;
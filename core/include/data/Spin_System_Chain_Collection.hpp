@@ -5,6 +5,8 @@
 #include <data/Spin_System_Chain.hpp>
 #include <data/Parameters_Method_MMF.hpp>
 
+#include <atomic>
+
 namespace Data
 {
 	class Spin_System_Chain_Collection
@@ -21,7 +23,8 @@ namespace Data
 		std::shared_ptr<Data::Parameters_Method_MMF> parameters;
 
 		// Are we allowed to iterate on this collection?
-		bool iteration_allowed;
+		//		Running methods check this in every iteration, so it can be reset without locking
+		std::atomic<bool> iteration_allowed;
     };
 
 }
@@ -0,0 +1,34 @@
+#pragma once
+#ifndef EIGENMODES_H
+#define EIGENMODES_H
+
+#include "Spirit_Defines.h"
+#include <engine/Vectormath_Defines.hpp>
+#include <engine/Hamiltonian.hpp>
+
+namespace Engine
+{
+    namespace Eigenmodes
+    {
+        /*
+            Apply the Hessian, projected into the tangent space of the spins, to a tangent vectorfield.
+            The projected Hessian is P*(H - diag(s_i*g_i))*P, where P projects each vector onto the
+            tangent plane of its spin and g is the (unprojected) gradient.
+        */
+        void Tangent_Hessian_Vector_Product(Hamiltonian & hamiltonian, const vectorfield & spins,
+            const vectorfield & gradient, const vectorfield & vec, vectorfield & out);
+
+        /*
+            Calculate the lowest eigenvalue and corresponding eigenvector of the Hessian in the
+            2N-dimensional tangent space, using an explicitly restarted Lanczos iteration which
+            only needs Hessian-vector products.
+            The input mode is used as starting vector (if it is non-zero), so that the previous
+            result can be used to warm-start the calculation. On return, mode is normalized in 3N dimensions.
+        */
+        scalar Lowest_Tangent_Eigenmode(Hamiltonian & hamiltonian, const vectorfield & spins,
+            const vectorfield & gradient, vectorfield & mode,
+            int n_lanczos_vectors=20, int n_restarts_max=100, scalar tolerance=1e-8);
+    }
+}
+
+#endif
@@ -0,0 +1,72 @@
+#pragma once
+#ifndef SPIRIT_FFT_H
+#define SPIRIT_FFT_H
+
+#include <vector>
+#include <array>
+#include <complex>
+#include <memory>
+
+#include "Spirit_Defines.h"
+
+namespace Engine
+{
+    namespace FFT
+    {
+        typedef std::complex<scalar> cpx;
+        typedef std::vector<cpx>     cpxfield;
+
+        /*
+            Plan for a one-dimensional complex FFT of arbitrary length.
+            Powers of two are transformed with an iterative radix-2 scheme,
+            other lengths are mapped onto a power-of-two convolution (Bluestein).
+        */
+        class FFT_Plan_1D
+        {
+        public:
+            FFT_Plan_1D(int n=1);
+
+            // In-place transform of n contiguous values. The inverse is not normalized.
+            void Transform(cpx * data, bool inverse=false) const;
+
+            int n;
+
+        private:
+            void Transform_Radix2(cpx * data, bool inverse) const;
+
+            bool is_power_of_two;
+            // Radix-2 bit reversal permutation and twiddle factors exp(-2 pi i k/n)
+            std::vector<int> bit_reversal;
+            cpxfield twiddles;
+
+            // Bluestein: chirp exp(-i pi k^2/n), transformed convolution kernel and sub-plan
+            cpxfield chirp;
+            cpxfield chirp_kernel_k;
+            std::shared_ptr<FFT_Plan_1D> sub_plan;
+        };
+
+        /*
+            Plan for a three-dimensional complex FFT on a grid with dimensions dims,
+            stored with the first index running fastest.
+        */
+        class FFT_Plan
+        {
+        public:
+            FFT_Plan(std::array<int,3> dims={1,1,1});
+
+            // In-place transform of dims[0]*dims[1]*dims[2] values. The inverse is not normalized.
+            void Transform(cpx * data, bool inverse=false) const;
+
+            std::array<int,3> dims;
+            int n_total;
+
+        private:
+            std::array<FFT_Plan_1D, 3> plans;
+        };
+
+        // Smallest power of two which is larger than or equal to n
+        int Next_Power_of_Two(int n);
+    }
+}
+
+#endif
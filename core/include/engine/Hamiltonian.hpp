@@ -39,6 +39,29 @@ namespace Engine
             This function uses finite differences and may thus be quite inefficient.
         */
         virtual void Hessian_FD(const vectorfield & spins, MatrixX & hessian) final;
+
+        /*
+            Calculate the Hessian matrix of a spin configuration as a sparse matrix.
+            This function converts the dense Hessian and thus has no memory advantage. You should
+            override it if you want to treat large systems.
+            This function is the fallback for derived classes where it has not been overridden.
+        */
+        virtual void Sparse_Hessian(const vectorfield & spins, SpMatrixX & hessian);
+
+        /*
+            Calculate the product of the Hessian matrix of a spin configuration with a vectorfield,
+            without assembling the Hessian.
+            This function uses finite differences of the gradient. You should override it if you
+            want to get proper performance and accuracy.
+            This function is the fallback for derived classes where it has not been overridden.
+        */
+        virtual void Hessian_Vector_Product(const vectorfield & spins, const vectorfield & vec, vectorfield & out);
+
+        /*
+            Calculate the product of the Hessian matrix of a spin configuration with a vectorfield.
+            This function uses central finite differences of the gradient along vec.
+        */
+        virtual void Hessian_Vector_Product_FD(const vectorfield & spins, const vectorfield & vec, vectorfield & out) final;
         
         /*
             Calculate the energy gradient of a spin configuration.
@@ -63,8 +86,43 @@ namespace Engine
         // Calculate the Energy of a spin configuration
         virtual scalar Energy(const vectorfield & spins);
 
+        /*
+            Calculate the energy gradient of a spin configuration and return its energy.
+            This function simply calls Gradient and Energy. You should override it if the energy
+            can be obtained from the gradient, so that the interactions are traversed only once.
+            This function is the fallback for derived classes where it has not been overridden.
+        */
+        virtual scalar Energy_and_Gradient(const vectorfield & spins, vectorfield & gradient);
+
         // Calculate the total energy for a single spin
         virtual scalar Energy_Single_Spin(int ispin, const vectorfield & spins);
+
+        /*
+            Calculate the change of the total energy if spin ispin is replaced by spin_new.
+            This function copies the configuration and compares the total energies, so it may be
+            quite inefficient. You should override it if you want to get proper performance.
+            This function is the fallback for derived classes where it has not been overridden.
+        */
+        virtual scalar Energy_Single_Spin_Diff(int ispin, const vectorfield & spins, const Vector3 & spin_new);
+
+        /*
+            Calculate the effective field h of a single spin, defined by the part of the energy which is
+            linear in the spin, i.e. E(s_i) = -h*s_i + (terms which are even in s_i). Therefore h does not
+            depend on the direction of the spin itself.
+            This function uses finite differences of Energy_Single_Spin_Diff. You should override it
+            if you want to get proper performance.
+            This function is the fallback for derived classes where it has not been overridden.
+        */
+        virtual Vector3 Effective_Field_Single_Spin(int ispin, const vectorfield & spins);
+
+        /*
+            Get the graph of interacting spins in compressed sparse row format, i.e. the spins which
+            interact with spin i are neighbours[offsets[i]] ... neighbours[offsets[i+1]-1].
+            Spins which are not connected in the graph can be updated independently, e.g. in parallel
+            Monte Carlo. Returns false if the interactions are not local (e.g. long-ranged).
+            This function is the fallback for derived classes where it has not been overridden.
+        */
+        virtual bool Interaction_Graph(intfield & offsets, intfield & neighbours);
         
         // Hamiltonian name as string
         virtual const std::string& Name();
@@ -34,6 +34,8 @@ namespace Engine
 
         // Calculate the total energy for a single spin
         scalar Energy_Single_Spin(int ispin, const vectorfield & spins) override;
+        // Calculate the change of the energy if spin ispin is replaced by spin_new
+        scalar Energy_Single_Spin_Diff(int ispin, const vectorfield & spins, const Vector3 & spin_new) override;
 
         // Hamiltonian name as string
         const std::string& Name() override;
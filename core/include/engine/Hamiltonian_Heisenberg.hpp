@@ -8,10 +8,21 @@
 #include "Spirit_Defines.h"
 #include <engine/Vectormath_Defines.hpp>
 #include <engine/Hamiltonian.hpp>
+#include <engine/FFT.hpp>
 #include <data/Geometry.hpp>
 
 namespace Engine
 {
+    // Method used to calculate the dipole-dipole interaction
+    enum class DDI_Method
+    {
+        // Convolution of the full lattice via FFT, zero-padded along open boundaries
+        FFT    = 0,
+        // Direct summation over the pairs within the cutoff radius
+        Cutoff = 1,
+        None   = 2
+    };
+
     /*
         The Heisenberg Hamiltonian using Pairs contains all information on the interactions between spins.
         The information is presented in pair lists and parameter lists in order to easily e.g. calculate the energy of the system via summation.
@@ -26,7 +37,7 @@ namespace Engine
             intfield anisotropy_indices, scalarfield anisotropy_magnitudes, vectorfield anisotropy_normals,
             pairfield exchange_pairs, scalarfield exchange_magnitudes,
             pairfield dmi_pairs, scalarfield dmi_magnitudes, vectorfield dmi_normals,
-            scalar ddi_radius,
+            DDI_Method ddi_method, scalar ddi_radius,
             quadrupletfield quadruplets, scalarfield quadruplet_magnitudes,
             std::shared_ptr<Data::Geometry> geometry,
             intfield boundary_conditions
@@ -38,22 +49,42 @@ namespace Engine
             intfield anisotropy_indices, scalarfield anisotropy_magnitudes, vectorfield anisotropy_normals,
             scalarfield exchange_magnitudes,
             scalarfield dmi_magnitudes, int dm_chirality,
-            scalar ddi_radius,
+            DDI_Method ddi_method, scalar ddi_radius,
             quadrupletfield quadruplets, scalarfield quadruplet_magnitudes,
             std::shared_ptr<Data::Geometry> geometry,
             intfield boundary_conditions
         );
 
-        void Update_DDI_Pairs();
+        // Generate the DDI pairs or the FFT convolution kernel, depending on ddi_method
+        void Update_DDI();
+        // Rebuild the neighbour tables and the DDI and update the energy contributions,
+        // e.g. after the pairs, geometry or boundary conditions have been changed
+        void Update_Interactions();
+        // Replace the geometry (which may be shared with other images) and rebuild the interactions
+        void Update_Geometry(std::shared_ptr<Data::Geometry> geometry);
 
         void Update_Energy_Contributions() override;
 
         void Hessian(const vectorfield & spins, MatrixX & hessian) override;
+        // Sparse Hessian, assembled from 3x3 blocks of the interactions.
+        // Note: with the FFT method the DDI couples all spins, so the Hessian is not sparse.
+        void Sparse_Hessian(const vectorfield & spins, SpMatrixX & hessian) override;
+        // Analytical Hessian-vector product, which also includes the DDI with the FFT method
+        void Hessian_Vector_Product(const vectorfield & spins, const vectorfield & vec, vectorfield & out) override;
         void Gradient(const vectorfield & spins, vectorfield & gradient) override;
+        // Calculate the gradient and obtain the energy from it, as all terms are homogeneous in the spins
+        scalar Energy_and_Gradient(const vectorfield & spins, vectorfield & gradient) override;
         void Energy_Contributions_per_Spin(const vectorfield & spins, std::vector<std::pair<std::string, scalarfield>> & contributions) override;
 
         // Calculate the total energy for a single spin
         scalar Energy_Single_Spin(int ispin, const vectorfield & spins) override;
+        // Calculate the change of the total energy if spin ispin is replaced by spin_new,
+        // using only the interactions in which the spin takes part
+        scalar Energy_Single_Spin_Diff(int ispin, const vectorfield & spins, const Vector3 & spin_new) override;
+        // Effective field of a single spin from the interactions in which the spin takes part
+        Vector3 Effective_Field_Single_Spin(int ispin, const vectorfield & spins) override;
+        // Graph of the exchange, DMI, cutoff DDI and quadruplet interactions
+        bool Interaction_Graph(intfield & offsets, intfield & neighbours) override;
 
         // Hamiltonian name as string
         const std::string& Name() override;
@@ -85,6 +116,8 @@ namespace Engine
         scalarfield dmi_magnitudes;
         vectorfield dmi_normals;
         // Dipole Dipole interaction
+        //      (with the FFT method, a cutoff radius <= 0 means the interaction is not truncated)
+        DDI_Method  ddi_method;
         scalar      ddi_cutoff_radius;
         pairfield   ddi_pairs;
         scalarfield ddi_magnitudes;
@@ -97,6 +130,40 @@ namespace Engine
     private:
         std::shared_ptr<Data::Geometry> geometry;
 
+        // ------------ Neighbour Tables ------------
+        // Neighbours of each spin in compressed sparse row format, i.e. the neighbours
+        // of spin i are neighbours[offsets[i]] ... neighbours[offsets[i+1]-1]
+        struct Neighbour_Table
+        {
+            intfield offsets;
+            intfield neighbours;
+        };
+        // Build the table of a pair list, taking into account boundary conditions and atom types.
+        // For each entry, the index of the pair and the direction (+1, or -1 if inverted) are returned.
+        void Build_Neighbour_Table(const pairfield & pairs, Neighbour_Table & table, intfield & pair_indices, intfield & directions);
+        // Quadruplets in which a basis atom takes part, together with the translation from
+        // the cell of the atom to the cell of the quadruplet (i.e. the cell of its atom i)
+        struct Quadruplet_Site
+        {
+            int iquad;
+            std::array<int, 3> translations;
+        };
+        void Build_Quadruplet_Sites(std::vector<std::vector<Quadruplet_Site>> & sites_per_basis);
+
+        // The tables derived from the geometry and the interaction parameters are immutable
+        // once built. Copies of the Hamiltonian (e.g. the images of a chain) therefore share
+        // them, until Update_Interactions or Update_DDI builds new ones for a single copy.
+        struct Interaction_Tables
+        {
+            // Exchange and DMI neighbours with the coupling of each entry
+            Neighbour_Table exchange_table;
+            scalarfield     exchange_table_magnitudes;
+            Neighbour_Table dmi_table;
+            vectorfield     dmi_table_vectors;
+            std::vector<std::vector<Quadruplet_Site>> quadruplet_sites_per_basis;
+        };
+        std::shared_ptr<const Interaction_Tables> interaction_tables;
+
         // ------------ Effective Field Functions ------------
         // Calculate the Zeeman effective field of a single Spin
         void Gradient_Zeeman(vectorfield & gradient);
@@ -108,8 +175,16 @@ namespace Engine
         void Gradient_DMI(const vectorfield & spins, vectorfield & gradient);
         // Calculates the Dipole-Dipole contribution to the effective field of spin ispin within system s
         void Gradient_DDI(const vectorfield& spins, vectorfield & gradient);
+        // Calculates the Dipole-Dipole field (including mu_s of the source spins) via FFT convolution
+        void Field_DDI_FFT(const vectorfield& spins, vectorfield & field);
+        // Calculates the Dipole-Dipole field at a single spin via direct summation with the real-space tensors
+        Vector3 Field_DDI_Single_Spin(int ispin, const vectorfield & spins);
+        // Dipole-Dipole field of a moment of basis atom ibasis at its own periodic images (FFT method)
+        Vector3 Field_DDI_Periodic_Images(int ibasis, const Vector3 & moment) const;
         // Quadruplet
         void Gradient_Quadruplet(const vectorfield & spins, vectorfield & gradient);
+        // Spin indices of quadruplet iquad in cell icell. Returns false if one of the sites is not occupied.
+        bool quadruplet_spins(int iquad, int icell, int & ispin, int & jspin, int & kspin, int & lspin) const;
 
         // ------------ Energy Functions ------------
         // Indices for Energy vector
@@ -127,6 +202,49 @@ namespace Engine
         // Quadruplet
         void E_Quadruplet(const vectorfield & spins, scalarfield & Energy);
 
+        // ------------ Dipole-Dipole ------------
+        // Tables of the DDI, shared between copies like the Interaction_Tables
+        struct DDI_Tables
+        {
+            // Indices of the DDI pairs (cutoff method) which start at each basis atom
+            std::vector<intfield> ddi_pairs_per_basis;
+            FFT::FFT_Plan ddi_fft_plan;
+            // Interaction tensors (xx, xy, xz, yy, yz, zz) per pair of basis atoms,
+            // in real space (for single spin energies) and transformed and normalized
+            scalarfield   ddi_tensors;
+            FFT::cpxfield ddi_tensors_k;
+        };
+        std::shared_ptr<const DDI_Tables> ddi_tables;
+        // Build the dipolar interaction tensors on the (padded) lattice grid and their transforms
+        void Prepare_DDI_FFT(DDI_Tables & tables);
+        // Grid index of a cell on a padded FFT grid
+        static int ddi_fft_idx(const std::array<int, 3> & dims, int da, int db, int dc)
+        {
+            return da + dims[0]*(db + dims[1]*dc);
+        }
+        int ddi_fft_idx(int da, int db, int dc) const
+        {
+            return ddi_fft_idx(ddi_tables->ddi_fft_plan.dims, da, db, dc);
+        }
+        // Work buffers for the transformed moments and field. They are not copied with the
+        // Hamiltonian, so that each copy can be evaluated concurrently, and allocated on first use.
+        struct DDI_Buffers
+        {
+            FFT::cpxfield moments_k;
+            FFT::cpxfield field_k;
+            vectorfield   field;
+            DDI_Buffers() = default;
+            DDI_Buffers(const DDI_Buffers &) {}
+            DDI_Buffers & operator=(const DDI_Buffers &)
+            {
+                moments_k = FFT::cpxfield(0);
+                field_k   = FFT::cpxfield(0);
+                field     = vectorfield(0);
+                return *this;
+            }
+        };
+        DDI_Buffers ddi_buffers;
+
     };
 }
 #endif
\ No newline at end of file
@@ -9,6 +9,7 @@
 #include <utility/Timing.hpp>
 #include <utility/Logging.hpp>
 
+#include <atomic>
 #include <deque>
 #include <fstream>
 #include <map>
@@ -31,6 +32,17 @@ namespace Engine
         // `Iterate` is supposed to iteratively solve a problem
         virtual void Iterate();
 
+        // Whether a further call to `Iterate` can continue from the current state of the method
+        //      (iteration count, solver temporaries, random numbers). This requires that the method
+        //      works on the given systems and that they were not modified since it last iterated them.
+        virtual bool Resumable(const std::vector<std::shared_ptr<Data::Spin_System>> & systems);
+        // Prepare a further call to `Iterate`, which then continues for the number of iterations
+        //      currently set in the parameters
+        virtual void Resume();
+        // Whether a call to `Iterate` has not yet returned. After the iterations were stopped, this
+        //      includes the final output and `Finalize`, which resets the iteration_allowed flags.
+        virtual bool Running() final;
+
         // Calculate a smooth but current IPS value
         virtual scalar getIterationsPerSecond() final;
 
@@ -97,7 +109,8 @@ namespace Engine
         // Check if iterations allowed
         virtual bool Iterations_Allowed();
 
-        // Check wether to continue iterating - stop file, convergence etc.
+        // Check wether to continue iterating - convergence etc. This is checked in every iteration,
+        //      while the stop file and walltime are only checked between blocks of iterations
         virtual bool ContinueIterating();
 
 
@@ -119,6 +132,8 @@ namespace Engine
 
         // Number of iterations that have been executed
         int iteration;
+        // Iteration at which the current (or last) call to `Iterate` started
+        int iteration_start;
         // Number of steps (set of iterations between logs) that have been executed
         int step;
 
@@ -134,9 +149,14 @@ namespace Engine
         std::string starttime;
         // Timings and Iterations per Second
         scalar ips;
-        std::deque<std::chrono::time_point<std::chrono::system_clock>> t_iterations;
+        //      (time points at the end of the last blocks of iterations and the iteration counts)
+        std::deque<std::pair<std::chrono::time_point<std::chrono::system_clock>, int>> t_iterations;
         
         std::chrono::time_point<std::chrono::system_clock> t_start, t_last;
+        // Snapshots of the systems published at the end of the last call to `Iterate`
+        std::vector<std::shared_ptr<const Data::Spin_Snapshot>> snapshots_final;
+        // Set for the duration of `Iterate`
+        std::atomic<bool> running;
 
 
         //////////// Parameters //////////////////////////////////////////////////////
@@ -31,6 +31,10 @@ namespace Engine
         // Calculate Forces onto Systems
         void Calculate_Force(const std::vector<std::shared_ptr<vectorfield>> & configurations, std::vector<vectorfield> & forces) override;
         void Calculate_Force_Virtual(const std::vector<std::shared_ptr<vectorfield>> & configurations, const std::vector<vectorfield> & forces, std::vector<vectorfield> & forces_virtual) override;
+        // Only the force on a falling image is the negative gradient of its energy
+        bool Energy_of_Force(int img, scalar & energy) override;
+        // The force on a climbing image is inverted along the tangent
+        bool Force_Inverted(int img) override;
         
         // Check if the Forces are converged
         bool Converged() override;
@@ -67,6 +71,8 @@ namespace Engine
         std::vector<vectorfield> F_spring;
         // Last calculated tangents
         std::vector<vectorfield> tangents;
+        // Image types of the last iteration
+        std::vector<Data::GNEB_Image_Type> image_types_previous;
     };
 }
 
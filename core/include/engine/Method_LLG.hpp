@@ -6,8 +6,13 @@
 #include <engine/Method_Solver.hpp>
 #include <data/Spin_System.hpp>
 #include <data/Parameters_Method_LLG.hpp>
+#include <data/Geometry.hpp>
+#include <io/Trajectory.hpp>
+#include <io/OVF_File.hpp>
 
+#include <cstdint>
 #include <vector>
+#include <memory>
 
 namespace Engine
 {
@@ -24,10 +29,15 @@ namespace Engine
         // Method name as string
         std::string Name() override;
 
+        // Prepare a further run, in which the convergence is checked again after the first iteration
+        void Resume() override;
+
     private:
         // Calculate Forces onto Systems
         void Calculate_Force(const std::vector<std::shared_ptr<vectorfield>> & configurations, std::vector<vectorfield> & forces) override;
         void Calculate_Force_Virtual(const std::vector<std::shared_ptr<vectorfield>> & configurations, const std::vector<vectorfield> & forces, std::vector<vectorfield> & forces_virtual) override;
+        // The force is the negative gradient of the energy of the system
+        bool Energy_of_Force(int img, scalar & energy) override;
 
         // Check if the Forces are converged
         bool Converged() override;
@@ -42,6 +52,9 @@ namespace Engine
         // Sets iteration_allowed to false for the corresponding method
         void Finalize() override;
 
+        // Append the max. torque, energy and magnetization to the history, if this was not yet done for the iteration
+        void Record_Observables(int iteration);
+
         // Last calculated forces
         std::vector<vectorfield> Gradient;
         // Convergence parameters
@@ -50,7 +63,36 @@ namespace Engine
         scalarfield temperature_distribution;
         // Field for stt gradient method
         vectorfield s_c_grad;
+        // Iteration for which the observables were last recorded in the history
+        int iteration_observables;
+        // Writer of the compressed trajectory output (created with the first frame)
+        std::unique_ptr<IO::Trajectory_Writer> trajectory;
+        // Writer of the archive of spin configurations (created with the first segment of a run)
+        std::unique_ptr<IO::File_OVF> archive_file;
     };
+
+    namespace LLG
+    {
+        /*
+            Calculate the virtual force of the LLG equation, i.e. the right-hand side scaled by the time step,
+            from the spins and the force (minus the gradient) of a single image.
+            This includes damping, precession, spin-transfer torques and the thermal noise, where the
+            random numbers are drawn from the Philox stream (parameters.rng_seed, rng_counter).
+            If direct_minimization is set, only the precession term without (1+damping^2) is used.
+        */
+        // Reference implementation, composed of one Vectormath pass over the spins per term.
+        //      xi, s_c_grad and temperature_distribution are used as temporary fields.
+        void Force_Virtual_Passes(const Data::Parameters_Method_LLG & parameters, const Data::Geometry & geometry,
+            const intfield & boundary_conditions, const vectorfield & spins, const vectorfield & force,
+            bool direct_minimization, std::uint64_t rng_counter,
+            vectorfield & xi, vectorfield & s_c_grad, scalarfield & temperature_distribution, vectorfield & force_virtual);
+        // Fused implementation, which calculates all terms in a single traversal of the spins.
+        //      Only the gradient for the STT needs a separate pass (into s_c_grad), as it is a stencil operation.
+        void Force_Virtual_Fused(const Data::Parameters_Method_LLG & parameters, const Data::Geometry & geometry,
+            const intfield & boundary_conditions, const vectorfield & spins, const vectorfield & force,
+            bool direct_minimization, std::uint64_t rng_counter,
+            vectorfield & s_c_grad, vectorfield & force_virtual);
+    }
 }
 
 #endif
\ No newline at end of file
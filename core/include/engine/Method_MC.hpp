@@ -5,9 +5,12 @@
 #include "Spirit_Defines.h"
 #include <engine/Method_Solver.hpp>
 #include <data/Spin_System.hpp>
+#include <io/Trajectory.hpp>
 // #include <data/Parameters_Method_MC.hpp>
 
 #include <vector>
+#include <random>
+#include <memory>
 
 namespace Engine
 {
@@ -27,8 +30,20 @@ namespace Engine
         // Solver_Iteration represents one iteration of a certain Solver
         void Iteration() override;
 
-        // Metropolis iteration with adaptive cone radius
-        void Metropolis(const vectorfield & spins_old, vectorfield & spins_new);
+        // Sweep of single spin updates, in random order or over the colour classes
+        void Sweep(vectorfield & spins);
+        // Update of a single spin with the selected algorithm. Returns false if the move was rejected.
+        bool Update_Spin(int ispin, vectorfield & spins, std::mt19937 & prng);
+        // Metropolis trial move of a single spin, using the adaptive cone radius
+        bool Metropolis_Spin(int ispin, vectorfield & spins, std::mt19937 & prng);
+        // Heat bath update of a single spin
+        bool Heat_Bath_Spin(int ispin, vectorfield & spins, std::mt19937 & prng);
+
+        // Add a random number stream for each thread of the parallel sweep which does not have one yet
+        void Seed_Thread_Streams();
+        // Colour the interaction graph of the Hamiltonian, so that spins of the same colour
+        // do not interact (empty if the interactions are not local)
+        void Build_Colour_Classes();
 
         // Save the current Step's Data: spins and energy
         void Save_Current(std::string starttime, int iteration, bool initial=false, bool final=false) override;
@@ -55,6 +70,13 @@ namespace Engine
         scalar cone_angle;
         int n_rejected;
         scalar acceptance_ratio_current;
+
+        // Spin indices of each colour class
+        std::vector<intfield> colour_classes;
+        // Random number streams of the threads in the parallel sweep
+        std::vector<std::mt19937> prng_threads;
+        // Writer of the compressed trajectory output (created with the first frame)
+        std::unique_ptr<IO::Trajectory_Writer> trajectory;
     };
 }
 
@@ -6,6 +6,9 @@
 #include <engine/Method_Solver.hpp>
 #include <data/Parameters_Method_MMF.hpp>
 #include <data/Spin_System_Chain_Collection.hpp>
+#include <io/OVF_File.hpp>
+
+#include <memory>
 
 namespace Engine
 {
@@ -25,9 +28,8 @@ namespace Engine
     private:
         // Calculate Forces onto Systems
         void Calculate_Force(const std::vector<std::shared_ptr<vectorfield>> & configurations, std::vector<vectorfield> & forces) override;
-        
-        // Functions for getting the minimum mode of a Hessian
-        void Calculate_Force_Spectra_Matrix(const std::vector<std::shared_ptr<vectorfield>> & configurations, std::vector<vectorfield> & forces);
+        // The force leads to a saddle point
+        bool Force_Inverted(int img) override;
         
         // Check if the Forces are converged
         bool Converged() override;
@@ -49,20 +51,18 @@ namespace Engine
         bool switched1, switched2;
         std::shared_ptr<Data::Spin_System_Chain_Collection> collection;
 
-        // Last calculated hessian
-        std::vector<MatrixX> hessian;
         // Last calculated gradient
         std::vector<vectorfield> gradient;
-        // Last calculated minimum mode
+        // Last calculated minimum mode of the Hessian in the tangent space and its eigenvalue
+        //      (the mode is used as starting point for the next calculation)
         std::vector<vectorfield> minimum_mode;
+        std::vector<scalar> minimum_eigenvalue;
 
         // Last iterations spins and reaction coordinate
         scalar Rx_last;
         std::vector<vectorfield> spins_last;
-
-        // Which minimum mode function to use
-        // ToDo: move into parameters
-        std::string mm_function;
+        // Writer of the archive of spin configurations (created with the first segment of a run)
+        std::unique_ptr<IO::File_OVF> archive_file;
     };
 }
 
@@ -15,6 +15,7 @@
 
 #include <deque>
 #include <fstream>
+#include <limits>
 #include <map>
 #include <sstream>
 #include <iomanip>
@@ -116,6 +117,26 @@ namespace Engine
         // Iteration represents one iteration of a certain Solver
         virtual void Iteration() override;
 
+        // Energy of an image for the force of the last call to Calculate_Force, if that force is
+        //      the negative gradient of the energy. Solvers may use it to check that a step has
+        //      decreased the energy. Default implementation: no energy is available
+        virtual bool Energy_of_Force(int img, scalar & energy)
+        {
+            return false;
+        }
+
+        // Whether the force on an image is inverted along some direction, so that it leads to a
+        //      saddle point instead of a minimum, e.g. for a GNEB climbing image.
+        //      Default implementation: the force leads to a minimum
+        virtual bool Force_Inverted(int img)
+        {
+            return false;
+        }
+
+        // Clear what the solver remembers of previous iterations, e.g. because the force on
+        //      an image has become a different function of the configuration
+        virtual void Reset_Memory();
+
         // Initialise contains the initialisations of arrays etc. for a certain solver
         virtual void Initialize() override;
         virtual void Finalize() override;
@@ -158,6 +179,33 @@ namespace Engine
         // buffer variables for checking convergence for solver and Newton-Raphson
         std::vector<scalarfield> r_dot_d, dda2;
 
+        //////////// BFGS /////////////////////////////////////////////////////////////
+        // Number of stored pairs of steps and gradient changes
+        int n_bfgs_memory;
+        // Maximum rotation angle of a spin in a step, and the angle of a first steepest descent step
+        scalar bfgs_max_rotation, bfgs_restart_rotation;
+        // Constants of the sufficient decrease (Armijo) and curvature conditions of the step check,
+        //      and the number of times a step is halved before the memory is cleared instead
+        scalar bfgs_c1, bfgs_c2;
+        int bfgs_max_backtracks;
+        // Steps and changes of the gradient of the last iterations, transported into the
+        //      tangent spaces of the current configurations [n_bfgs_memory][noi][nos]
+        std::vector<std::vector<vectorfield>> bfgs_steps, bfgs_gradient_differences;
+        // Inverse products of the stored steps and gradient changes, and the coefficients of the recursion [n_bfgs_memory]
+        scalarfield bfgs_rho, bfgs_alpha;
+        // Scaling of the initial inverse Hessian
+        scalar bfgs_gamma;
+        // Number of valid stored pairs and index of the newest one
+        int bfgs_n_stored, bfgs_idx_newest;
+        // Directional derivative of the gradient along the last step at the configurations, from which
+        //      it was taken, and the part of it and the energy of the images with an energy (see Energy_of_Force).
+        //      A derivative of zero means that no step is pending
+        scalar bfgs_slope, bfgs_energy_slope, bfgs_energy_previous;
+        // Number of times the last step has been halved
+        int bfgs_n_backtracks;
+        // Tangent gradient, the transported gradient of the previous iteration and the search direction [noi][nos]
+        std::vector<vectorfield> bfgs_gradient, bfgs_gradient_previous, bfgs_direction;
+
         //////////// VP ///////////////////////////////////////////////////////////////
         // "Mass of our particle" which we accelerate
         scalar m = 1.0;
@@ -194,6 +242,12 @@ namespace Engine
         return converged;
     }
 
+    // Default implementation: do nothing
+    template<Solver solver>
+    void Method_Solver<solver>::Reset_Memory()
+    {
+    };
+
     // Default implementation: do nothing
     template<Solver solver>
     void Method_Solver<solver>::Initialize()
@@ -281,7 +335,7 @@ namespace Engine
         block.push_back(fmt::format("----- Duration:       {}", Timing::DateTimePassed(t_end - this->t_start)));
         block.push_back(fmt::format("    Step              {} / {}", step, n_log));
         block.push_back(fmt::format("    Iteration         {} / {}", this->iteration, n_iterations));
-        block.push_back(fmt::format("    Iterations / sec: {}", this->iteration / Timing::SecondsPassed(t_end - this->t_start)));
+        block.push_back(fmt::format("    Iterations / sec: {}", (this->iteration - this->iteration_start) / Timing::SecondsPassed(t_end - this->t_start)));
         block.push_back(fmt::format("    Force convergence parameter: {:."+fmt::format("{}",this->print_precision)+"f}", this->parameters->force_convergence));
         block.push_back(fmt::format("    Maximum force component:     {:."+fmt::format("{}",this->print_precision)+"f}", this->force_max_abs_component));
         block.push_back(fmt::format("    Solver: " + this->SolverFullName()));
@@ -308,6 +362,7 @@ namespace Engine
     #include <engine/Solver_Heun.hpp>
     #include <engine/Solver_Depondt.hpp>
     #include <engine/Solver_NCG.hpp>
+    #include <engine/Solver_BFGS.hpp>
 }
 
 #endif
\ No newline at end of file
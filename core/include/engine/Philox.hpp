@@ -0,0 +1,62 @@
+#pragma once
+#ifndef PHILOX_H
+#define PHILOX_H
+
+#include "Spirit_Defines.h"
+
+#include <cstdint>
+
+#ifdef SPIRIT_USE_CUDA
+    #define PHILOX_FUNCTION __host__ __device__ inline
+#else
+    #define PHILOX_FUNCTION inline
+#endif
+
+namespace Engine
+{
+    /*
+        Philox4x32-10 counter-based random number generator, see J. K. Salmon et al,
+        "Parallel random numbers: as easy as 1, 2, 3", SC11 (2011).
+        Each call maps a counter and a key to four independent 32-bit random numbers,
+        so that random numbers can be generated in any order and in parallel, e.g. with
+        the counter made up of the index of a spin and the number of the iteration.
+    */
+    namespace Philox
+    {
+        PHILOX_FUNCTION void mulhilo(std::uint32_t a, std::uint32_t b, std::uint32_t & hi, std::uint32_t & lo)
+        {
+            std::uint64_t product = std::uint64_t(a) * std::uint64_t(b);
+            hi = std::uint32_t(product >> 32);
+            lo = std::uint32_t(product);
+        }
+
+        // Apply ten rounds to the counter ctr with the given key. The result is written into ctr.
+        PHILOX_FUNCTION void philox4x32_10(std::uint32_t ctr[4], const std::uint32_t key_in[2])
+        {
+            const std::uint32_t M0 = 0xD2511F53, M1 = 0xCD9E8D57;
+            const std::uint32_t W0 = 0x9E3779B9, W1 = 0xBB67AE85;
+            std::uint32_t key[2] = { key_in[0], key_in[1] };
+            for (int round = 0; round < 10; ++round)
+            {
+                std::uint32_t hi0, lo0, hi1, lo1;
+                mulhilo(M0, ctr[0], hi0, lo0);
+                mulhilo(M1, ctr[2], hi1, lo1);
+                ctr[0] = hi1 ^ ctr[1] ^ key[0];
+                ctr[1] = lo1;
+                ctr[2] = hi0 ^ ctr[3] ^ key[1];
+                ctr[3] = lo0;
+                key[0] += W0;
+                key[1] += W1;
+            }
+        }
+
+        // Uniform random number in (0,1) from two 32-bit random numbers, using 53 bits
+        PHILOX_FUNCTION double uniform_open(std::uint32_t hi, std::uint32_t lo)
+        {
+            std::uint64_t bits = ((std::uint64_t(hi) << 32) | lo) >> 11;
+            return (bits + 0.5) * (1.0 / 9007199254740992.0);
+        }
+    }
+}
+
+#endif
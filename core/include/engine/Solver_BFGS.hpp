@@ -0,0 +1,319 @@
+// Forget the stored pairs, the curvature estimate and the pending step
+template <> inline
+void Method_Solver<Solver::BFGS>::Reset_Memory ()
+{
+    this->bfgs_n_stored        = 0;
+    this->bfgs_gamma           = 0;
+    this->bfgs_slope           = 0;
+    this->bfgs_energy_slope    = 0;
+    this->bfgs_energy_previous = 0;
+    this->bfgs_n_backtracks    = 0;
+};
+
+template <> inline
+void Method_Solver<Solver::BFGS>::Initialize ()
+{
+    this->n_bfgs_memory         = 10;                           // number of stored pairs of steps and gradient changes
+    this->bfgs_max_rotation     = Utility::Constants::Pi / 20;  // maximum rotation angle of a spin in one step
+    this->bfgs_restart_rotation = Utility::Constants::Pi / 200; // rotation angle of a first steepest descent step
+    this->bfgs_c1               = 1e-4;                         // sufficient decrease of the energy
+    this->bfgs_c2               = 0.9;                          // maximum reversal of the directional derivative
+    this->bfgs_max_backtracks   = 4;                            // number of times a step is halved
+
+    this->forces         = std::vector<vectorfield>( this->noi, vectorfield( this->nos, {0, 0, 0} ) );
+    this->forces_virtual = std::vector<vectorfield>( this->noi, vectorfield( this->nos, {0, 0, 0} ) );
+
+    this->bfgs_steps                = std::vector<std::vector<vectorfield>>( this->n_bfgs_memory,
+                                        std::vector<vectorfield>( this->noi, vectorfield( this->nos, {0, 0, 0} ) ) );
+    this->bfgs_gradient_differences = this->bfgs_steps;
+    this->bfgs_rho        = scalarfield( this->n_bfgs_memory, 0 );
+    this->bfgs_alpha      = this->bfgs_rho;
+    this->bfgs_idx_newest = 0;
+    this->Reset_Memory();
+
+    this->bfgs_gradient          = std::vector<vectorfield>( this->noi, vectorfield( this->nos, {0, 0, 0} ) );
+    this->bfgs_gradient_previous = this->bfgs_gradient;
+    this->bfgs_direction         = this->bfgs_gradient;
+
+    // Rotation axes and angles of the spins in a step
+    this->rotationaxis = std::vector<vectorfield>( this->noi, vectorfield( this->nos, {0, 0, 0} ) );
+    this->angle = scalarfield( this->nos, 0 );
+};
+
+/*
+    Template instantiation of the Simulation class for use with the L-BFGS Solver.
+        The limited-memory BFGS method approximates the inverse Hessian from the steps and
+        changes of the gradient of the last n_bfgs_memory iterations. It is meant for direct
+        minimization and needs only a single force calculation per iteration.
+        All vectors live in the tangent spaces of the spins. A step rotates each spin along the
+        great circle given by its component of the search direction, and the stored steps and
+        gradient changes are rotated along with the spins (parallel transport), so that they
+        remain in the tangent spaces of the new configuration and keep their inner products.
+        The images share one memory, as the GNEB force on an image depends on its neighbours,
+        and the inner products are summed over the images. Images with an inverted force, such as
+        climbing images, are not described well by the approximated Hessian. They are excluded
+        from it and take steepest descent steps, scaled with the curvature of the last stored pair.
+        A step is scaled down if any spin would rotate by more than bfgs_max_rotation.
+        It is checked with the forces of the next iteration, so that the check costs no additional
+        force calculation. If the energy did not decrease sufficiently (Armijo condition), or the
+        derivative along the step reversed by more than bfgs_c2 (the step overshot), the spins go
+        back halfway along the step. After bfgs_max_backtracks halvings the step is accepted.
+        Only the energies provided by the method are checked (see Energy_of_Force), as e.g. the
+        GNEB forces on climbing images or with springs are not the gradient of the energy.
+        The memory is cleared, and a steepest descent step is taken, whenever a step violates
+        the curvature condition, was only accepted after halving it bfgs_max_backtracks times,
+        or the direction is not a descent direction.
+    Paper: J. Nocedal, Updating quasi-Newton matrices with limited storage,
+           Math. Comp. 35, 773 (1980);
+           W. Ring and B. Wirth, Optimization methods on Riemannian manifolds and their
+           application to shape space, SIAM J. Optim. 22, 596 (2012);
+           D. Sheppard, R. Terrell and G. Henkelman, Optimization methods for finding minimum
+           energy paths, J. Chem. Phys. 128, 134106 (2008).
+*/
+template <> inline
+void Method_Solver<Solver::BFGS>::Iteration ()
+{
+    // Wall time of the calculation of the search directions and of the steps, excluding the force calculations
+    static Utility::Timing::Counter timing_direction("Solver/BFGS/Direction");
+    static Utility::Timing::Counter timing_step("Solver/BFGS/Step");
+
+    // Get the forces on the configurations
+    this->Calculate_Force(this->configurations, this->forces);
+    this->Calculate_Force_Virtual(this->configurations, this->forces, this->forces_virtual);
+
+    // Images described by the approximated Hessian. If there are none, the curvature
+    //      of the last step is taken from all images
+    std::vector<bool> in_model( this->noi, false );
+    bool model_empty = true;
+    for (int img = 0; img < this->noi; ++img)
+    {
+        in_model[img] = !this->Force_Inverted(img);
+        if (in_model[img]) model_empty = false;
+    }
+
+    // Inner product of tangent vectors of all images, and of the images in the model
+    auto dot = [this](const std::vector<vectorfield> & a, const std::vector<vectorfield> & b)
+    {
+        scalar result = 0;
+        for (int img = 0; img < this->noi; ++img)
+            result += Vectormath::dot( a[img], b[img] );
+        return result;
+    };
+    auto dot_model = [&](const std::vector<vectorfield> & a, const std::vector<vectorfield> & b)
+    {
+        scalar result = 0;
+        for (int img = 0; img < this->noi; ++img)
+        {
+            if (in_model[img] || model_empty)
+                result += Vectormath::dot( a[img], b[img] );
+        }
+        return result;
+    };
+
+    int m = this->n_bfgs_memory;
+    auto& gradient   = this->bfgs_gradient;
+    auto& direction  = this->bfgs_direction;
+    auto& steps      = this->bfgs_steps;
+    auto& gradient_differences = this->bfgs_gradient_differences;
+    auto& rho        = this->bfgs_rho;
+    auto& alpha      = this->bfgs_alpha;
+    auto& n_stored   = this->bfgs_n_stored;
+    auto& idx_newest = this->bfgs_idx_newest;
+    auto& slope      = this->bfgs_slope;
+    bool fixed_step = false;
+    bool accepted   = true;
+    bool backtrack  = false;
+
+    // Summed energy of the images, for which the method provides it
+    std::vector<bool> has_energy( this->noi, false );
+    scalar energy = 0;
+    {
+        Utility::Timing::Scope timing(timing_direction);
+
+        // The last step, transported into the tangent spaces of the current configurations
+        auto& step = steps[(idx_newest + 1) % m];
+
+        for (int img = 0; img < this->noi; ++img)
+        {
+            // Gradient in the tangent spaces of the spins
+            Vectormath::set_c_a( -1, this->forces[img], gradient[img] );
+            Manifoldmath::project_tangential( gradient[img], *this->configurations[img] );
+
+            scalar energy_img = 0;
+            has_energy[img] = this->Energy_of_Force( img, energy_img );
+            energy += energy_img;
+        }
+
+        if (slope < 0)
+        {
+            // Check the last step, which is halved if it did not decrease the energy sufficiently
+            //      or overshot. The tolerance accounts for the rounding errors of the energy.
+            scalar tolerance = 10 * std::numeric_limits<scalar>::epsilon() * std::abs(this->bfgs_energy_previous);
+            bool decreased   = energy <= this->bfgs_energy_previous + this->bfgs_c1 * this->bfgs_energy_slope + tolerance;
+            bool overshot    = dot( gradient, step ) > -this->bfgs_c2 * slope;
+            accepted  = decreased && !overshot;
+            backtrack = !accepted && this->bfgs_n_backtracks < this->bfgs_max_backtracks;
+            if (backtrack)
+                ++this->bfgs_n_backtracks;
+        }
+
+        // Store the last step together with the change of the gradient along it,
+        //      if it fulfills the curvature condition. Otherwise the memory is cleared,
+        //      as well as when the step had to be accepted after halving it repeatedly.
+        if (slope < 0 && accepted)
+        {
+            int k = (idx_newest + 1) % m;
+            for (int img = 0; img < this->noi; ++img)
+            {
+                Vectormath::set_c_a( 1, gradient[img], gradient_differences[k][img] );
+                Vectormath::add_c_a( -1, this->bfgs_gradient_previous[img], gradient_differences[k][img] );
+            }
+            scalar sy = dot_model( steps[k], gradient_differences[k] );
+            scalar yy = dot_model( gradient_differences[k], gradient_differences[k] );
+            if (sy > 0 && yy > 0)
+            {
+                rho[k] = 1 / sy;
+                this->bfgs_gamma = sy / yy;
+                idx_newest = k;
+                n_stored = std::min( n_stored + 1, m );
+            }
+            else
+                n_stored = 0;
+        }
+        else if (!accepted && !backtrack)
+            n_stored = 0;
+
+        if (backtrack)
+        {
+            // Go back halfway along the last step
+            for (int img = 0; img < this->noi; ++img)
+                Vectormath::set_c_a( -0.5, step[img], direction[img] );
+        }
+        else
+        {
+            // Two-loop recursion for the search direction d = - H * gradient
+            for (int img = 0; img < this->noi; ++img)
+                Vectormath::set_c_a( -1, gradient[img], direction[img] );
+            for (int j = 0; j < n_stored; ++j)
+            {
+                int k = (idx_newest - j + m) % m;
+                alpha[k] = rho[k] * dot_model( steps[k], direction );
+                for (int img = 0; img < this->noi; ++img)
+                    Vectormath::add_c_a( -alpha[k], gradient_differences[k][img], direction[img] );
+            }
+            if (n_stored > 0)
+            {
+                for (int img = 0; img < this->noi; ++img)
+                    Vectormath::scale( direction[img], this->bfgs_gamma );
+            }
+            for (int j = n_stored - 1; j >= 0; --j)
+            {
+                int k = (idx_newest - j + m) % m;
+                scalar beta = rho[k] * dot_model( gradient_differences[k], direction );
+                for (int img = 0; img < this->noi; ++img)
+                    Vectormath::add_c_a( alpha[k] - beta, steps[k][img], direction[img] );
+            }
+
+            // Restart with the steepest descent direction if this is not a descent direction.
+            //      It is scaled with the curvature of the last stored pair, if there was one.
+            if (n_stored == 0 || dot_model( direction, gradient ) >= 0)
+            {
+                n_stored = 0;
+                fixed_step = this->bfgs_gamma == 0;
+            }
+            scalar scaling = fixed_step ? 1 : this->bfgs_gamma;
+            for (int img = 0; img < this->noi; ++img)
+            {
+                if (n_stored == 0 || !in_model[img])
+                    Vectormath::set_c_a( -scaling, gradient[img], direction[img] );
+            }
+        }
+    }
+
+    {
+        Utility::Timing::Scope timing(timing_step);
+
+        // Limit the largest rotation angle of a spin, which is the norm of its component of the direction.
+        //      Without any curvature information, the step length is fixed.
+        scalar angle_max = 0;
+        for (int img = 0; img < this->noi; ++img)
+        {
+            Vectormath::norm( direction[img], this->angle );
+            for (auto& a : this->angle) angle_max = std::max(angle_max, a);
+        }
+        scalar max_rotation = fixed_step ? this->bfgs_restart_rotation : this->bfgs_max_rotation;
+        if (angle_max > 0 && (fixed_step || angle_max > max_rotation))
+        {
+            for (int img = 0; img < this->noi; ++img)
+                Vectormath::scale( direction[img], max_rotation / angle_max );
+        }
+
+        if (!backtrack)
+        {
+            // Directional derivatives along the new step
+            slope = dot( gradient, direction );
+            this->bfgs_energy_slope    = 0;
+            this->bfgs_energy_previous = energy;
+            this->bfgs_n_backtracks    = 0;
+            for (int img = 0; img < this->noi; ++img)
+            {
+                if (has_energy[img])
+                    this->bfgs_energy_slope += Vectormath::dot( gradient[img], direction[img] );
+            }
+        }
+        else
+        {
+            slope *= 0.5;
+            this->bfgs_energy_slope *= 0.5;
+        }
+
+        int k_step = (idx_newest + 1) % m;
+        for (int img = 0; img < this->noi; ++img)
+        {
+            auto& conf = *this->configurations[img];
+            auto& angle = this->angle;
+
+            // The spin n rotates about n x d by the angle |d| towards d
+            Vectormath::norm( direction[img], angle );
+            auto& axis = this->rotationaxis[img];
+            Vectormath::set_c_cross( 1, conf, direction[img], axis );
+            Vectormath::normalize_vectors( axis );
+
+            // Transport the stored vectors into the tangent spaces of the new configuration
+            for (int j = 0; j < n_stored; ++j)
+            {
+                int k = (idx_newest - j + m) % m;
+                Vectormath::rotate( steps[k][img], axis, angle, steps[k][img] );
+                Vectormath::rotate( gradient_differences[k][img], axis, angle, gradient_differences[k][img] );
+            }
+            if (backtrack)
+            {
+                // The remaining half of the step still starts at the same configuration
+                Vectormath::rotate( direction[img], axis, angle, steps[k_step][img] );
+                Vectormath::scale( steps[k_step][img], -1 );
+                Vectormath::rotate( this->bfgs_gradient_previous[img], axis, angle, this->bfgs_gradient_previous[img] );
+            }
+            else
+            {
+                Vectormath::rotate( direction[img], axis, angle, steps[k_step][img] );
+                Vectormath::rotate( gradient[img], axis, angle, this->bfgs_gradient_previous[img] );
+            }
+
+            // Rotate the spins
+            Vectormath::rotate( conf, axis, angle, conf );
+            Vectormath::normalize_vectors( conf );
+        }
+    }
+};
+
+template <> inline
+std::string Method_Solver<Solver::BFGS>::SolverName()
+{
+    return "BFGS";
+};
+
+template <> inline
+std::string Method_Solver<Solver::BFGS>::SolverFullName()
+{
+    return "Limited-memory BFGS";
+};
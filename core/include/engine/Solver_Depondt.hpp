@@ -29,6 +29,10 @@ void Method_Solver<Solver::Depondt>::Initialize ()
 template <> inline
 void Method_Solver<Solver::Depondt>::Iteration ()
 {
+    // Wall time of the updates of the spins, excluding the force calculations
+    static Utility::Timing::Counter timing_predictor("Solver/Depondt/Predictor");
+    static Utility::Timing::Counter timing_corrector("Solver/Depondt/Corrector");
+
     // Get the actual forces on the configurations
     this->Calculate_Force(this->configurations, this->forces);
     this->Calculate_Force_Virtual(this->configurations, this->forces, this->forces_virtual);
@@ -36,6 +40,7 @@ void Method_Solver<Solver::Depondt>::Iteration ()
     // Predictor for each image
     for (int i = 0; i < this->noi; ++i)
     {
+        Utility::Timing::Scope timing(timing_predictor);
         auto& conf           = *this->configurations[i];
         auto& conf_predictor = *this->configurations_predictor[i];
 
@@ -56,6 +61,7 @@ void Method_Solver<Solver::Depondt>::Iteration ()
     // Corrector step for each image
     for (int i=0; i < this->noi; i++)
     {
+        Utility::Timing::Scope timing(timing_corrector);
         auto& conf   = *this->configurations[i];
 
         // Calculate the linear combination of the two forces_virtuals
@@ -30,6 +30,10 @@ void Method_Solver<Solver::Heun>::Initialize ()
 template <> inline
 void Method_Solver<Solver::Heun>::Iteration ()
 {
+    // Wall time of the updates of the spins, excluding the force calculations
+    static Utility::Timing::Counter timing_predictor("Solver/Heun/Predictor");
+    static Utility::Timing::Counter timing_corrector("Solver/Heun/Corrector");
+
     // Get the actual forces on the configurations
     this->Calculate_Force(this->configurations, this->forces);
     this->Calculate_Force_Virtual(this->configurations, this->forces, this->forces_virtual);
@@ -37,6 +41,7 @@ void Method_Solver<Solver::Heun>::Iteration ()
     // Predictor for each image
     for (int i = 0; i < this->noi; ++i)
     {
+        Utility::Timing::Scope timing(timing_predictor);
         auto& conf           = *this->configurations[i];
         auto& conf_temp      = *this->configurations_temp[i];
         auto& conf_predictor = *this->configurations_predictor[i];
@@ -57,6 +62,7 @@ void Method_Solver<Solver::Heun>::Iteration ()
     // Corrector step for each image
     for (int i=0; i < this->noi; i++)
     {
+        Utility::Timing::Scope timing(timing_corrector);
         auto& conf           = *this->configurations[i];
         auto& conf_temp      = *this->configurations_temp[i];
         auto& conf_predictor = *this->configurations_predictor[i];
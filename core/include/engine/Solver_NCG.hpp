@@ -55,6 +55,10 @@ void Method_Solver<Solver::NCG>::Initialize ()
 template <> inline
 void Method_Solver<Solver::NCG>::Iteration ()
 {
+    // Wall time of the line search steps and direction updates, excluding the force calculations
+    static Utility::Timing::Counter timing_line_search("Solver/NCG/Line_Search");
+    static Utility::Timing::Counter timing_direction("Solver/NCG/Direction");
+
 	// By default continue Newton-Raphson
     this->continue_NR = true;
 	// By default do not restart( XXX:reset?? ) the whole method
@@ -73,6 +77,7 @@ void Method_Solver<Solver::NCG>::Iteration ()
 		// Do line search per image
         for (int img = 0; img < this->noi; img++)
         {
+            Utility::Timing::Scope timing(timing_line_search);
             // Project force into the tangent space of the spin configuration
             Manifoldmath::project_tangential(this->forces[img], *this->configurations[img]);
 
@@ -118,6 +123,7 @@ void Method_Solver<Solver::NCG>::Iteration ()
     // Update the direction
     for (int img=0; img<this->noi; img++)
     {
+        Utility::Timing::Scope timing(timing_direction);
         // Project force into the tangent space of the spin configuration
         Manifoldmath::project_tangential(this->forces[img], *this->configurations[img]);
 
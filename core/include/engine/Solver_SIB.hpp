@@ -22,11 +22,16 @@ void Method_Solver<Solver::SIB>::Initialize ()
 template <> inline
 void Method_Solver<Solver::SIB>::Iteration ()
 {
+    // Wall time of the updates of the spins, excluding the force calculations
+    static Utility::Timing::Counter timing_predictor("Solver/SIB/Predictor");
+    static Utility::Timing::Counter timing_corrector("Solver/SIB/Corrector");
+
     // First part of the step
     this->Calculate_Force(this->configurations, this->forces);
     this->Calculate_Force_Virtual(this->configurations, this->forces, this->forces_virtual);
     for (int i = 0; i < this->noi; ++i)
     {
+        Utility::Timing::Scope timing(timing_predictor);
         auto& image      = *this->systems[i]->spins;
         auto& image_temp = *this->configurations_predictor[i];
 
@@ -40,6 +45,7 @@ void Method_Solver<Solver::SIB>::Iteration ()
     this->Calculate_Force_Virtual(this->configurations_predictor, this->forces_predictor, this->forces_virtual_predictor);
     for (int i = 0; i < this->noi; ++i)
     {
+        Utility::Timing::Scope timing(timing_corrector);
         auto& image      = *this->systems[i]->spins;
         
         Vectormath::transform(image, forces_virtual_predictor[i], image);
@@ -27,6 +27,10 @@ void Method_Solver<Solver::VP>::Initialize ()
 template <> inline
 void Method_Solver<Solver::VP>::Iteration ()
 {
+    // Wall time of the updates of the velocities and spins, excluding the force calculations
+    static Utility::Timing::Counter timing_velocities("Solver/VP/Velocities");
+    static Utility::Timing::Counter timing_update("Solver/VP/Update");
+
     scalar projection_full  = 0;
     scalar force_norm2_full = 0;
 
@@ -43,6 +47,7 @@ void Method_Solver<Solver::VP>::Iteration ()
     
     for (int i = 0; i < noi; ++i)
     {
+        Utility::Timing::Scope timing(timing_velocities);
         auto& velocity      = velocities[i];
         auto& force         = forces[i];
         auto& force_prev    = forces_previous[i];
@@ -62,6 +67,7 @@ void Method_Solver<Solver::VP>::Iteration ()
     }
     for (int i = 0; i < noi; ++i)
     {
+        Utility::Timing::Scope timing(timing_update);
         auto& velocity           = velocities[i];
         auto& force              = forces[i];
         auto& configuration      = *(configurations[i]);
@@ -4,6 +4,7 @@
 
 #include <vector>
 #include <memory>
+#include <cstdint>
 
 #include <Eigen/Core>
 
@@ -391,6 +392,11 @@ namespace Engine
         void get_random_vectorfield(std::mt19937 & prng, vectorfield & xi);
         void get_random_vector_unitsphere(std::uniform_real_distribution<scalar> & distribution, std::mt19937 & prng, Vector3 & vec);
         void get_random_vectorfield_unitsphere(std::mt19937 & prng, vectorfield & xi);
+        // Random vectors on the unit sphere from the counter-based Philox generator. The vector of index i
+        // only depends on (seed, counter, i), so it is generated in parallel and independent of the number of threads.
+        void get_random_vectorfield_unitsphere(std::uint64_t seed, std::uint64_t counter, vectorfield & xi);
+        // The single random vector of index i of get_random_vectorfield_unitsphere(seed, counter, xi)
+        Vector3 get_random_vector_unitsphere(std::uint64_t seed, std::uint64_t counter, std::uint32_t index);
 
         // Calculate a gradient scalar distribution according to a starting value, direction and inclination
         void get_gradient_distribution(const Data::Geometry & geometry, Vector3 gradient_direction, scalar gradient_start, scalar gradient_inclination, scalarfield & distribution, scalar range_min, scalar range_max);
@@ -19,6 +19,11 @@ namespace IO
                                            const std::string file, int start_image_infile, 
                                            int end_image_infile, const int insert_idx, 
                                            int& noi_to_add, int& noi_to_read, const int idx_chain );
+    // Read the spin-resolved energies of image idx_image_infile of an OVF file written by
+    // Write_Image_Energy_per_Spin, i.e. the total energy "E_tot" followed by the contributions
+    void Read_Image_Energy_per_Spin( const std::string file, const Data::Geometry& geometry,
+                                     std::vector<std::pair<std::string, scalarfield>>& energies,
+                                     const int idx_image_infile = 0 );
     void Anisotropy_from_File( const std::string anisotropyFile, 
                                const std::shared_ptr<Data::Geometry> geometry, int& n_indices,
                                intfield& anisotropy_index, scalarfield& anisotropy_magnitude, 
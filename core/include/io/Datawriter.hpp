@@ -5,6 +5,7 @@
 #include <data/Geometry.hpp>
 #include <data/Spin_System.hpp>
 #include <data/Spin_System_Chain.hpp>
+#include <io/Fileformat.hpp>
 
 namespace IO
 {
@@ -23,9 +24,11 @@ namespace IO
     // Save energy contributions of a spin system
     void Write_Image_Energy( const Data::Spin_System& system, const std::string filename, 
                              bool normalize_by_nos=true, bool readability_toggle = true );
-    // Save energy contributions of a spin system per spin
+    // Save energy contributions of a spin system per spin, either as a text table (GENERAL_TXT)
+    // or as an OVF file with the total energy and the contributions as values of each spin
     void Write_Image_Energy_per_Spin( const Data::Spin_System & s, const std::string filename, 
-                                      bool normalize_nos=true, bool readability_toggle = true );
+                                      bool normalize_nos=true, bool readability_toggle = true,
+                                      VF_FileFormat format = VF_FileFormat::GENERAL_TXT );
 
     // Saves Energies of all images with header and contributions
     void Write_Chain_Energies( const Data::Spin_System_Chain& c, const int iteration, 
@@ -4,17 +4,37 @@
 
 #include <string>
 #include <vector>
+#include <functional>
+#include <cstddef>
 
 #include <io/Fileformat.hpp>
 #include "Spirit_Defines.h"
 
 namespace IO
 {
+    // ------ Asynchronous output ---------------------------------------
+	/*
+		With SPIRIT_USE_THREADS, output is handed to a single background writer thread, which
+		carries out the writes in the order in which they were queued, so that e.g. appends to
+		a file stay ordered. The queue is bounded: if it is full, the caller blocks until
+		enough has been written. Without SPIRIT_USE_THREADS, the output is written immediately.
+	*/
+	// Queue a write to the file "name", where size is the number of bytes it holds in memory
+	void Queue_Output(const std::string & name, std::size_t size, std::function<void()> write);
+	// Block until all queued writes to the file "name" have been carried out (all files if "name" is empty)
+	void Flush_Output(const std::string & name="");
+	// Whether the file exists or writes to it are queued
+	bool Output_File_Exists(const std::string & name);
+	// Total time [s] the calling thread has been blocked by a full queue or by flushing
+	double Get_Output_Blocked_Time();
+
     // ------ Saving Helpers --------------------------------------------
-	// Creates a new thread with String_to_File, which is immediately detached
-	void Dump_to_File(const std::string text, const std::string name);
+	// Writes the string to a file asynchronously, see Queue_Output
+	void Dump_to_File(std::string text, const std::string name);
 	// Takes a vector of strings of size "no" and dumps those into a file asynchronously
-	void Dump_to_File(const std::vector<std::string> text, const std::string name, const int no);
+	void Dump_to_File(std::vector<std::string> text, const std::string name, const int no);
+	// Appends the string to a file asynchronously, see Queue_Output
+	void Dump_Append_to_File(std::string text, const std::string name);
 
 	// Dumps the contents of the strings in text vector into file "name"
 	void Strings_to_File(const std::vector<std::string> text, const std::string name, const int no);
@@ -0,0 +1,40 @@
+#pragma once
+#ifndef IO_MAPPEDFILE_H
+#define IO_MAPPEDFILE_H
+
+#include <string>
+#include <cstddef>
+
+namespace IO
+{
+    /*
+        Read-only memory mapping of a whole file, so that arbitrary parts of it can be
+        accessed without reading the file up to there. The mapping is released on destruction.
+    */
+    class Mapped_File
+    {
+    public:
+        // Map the file with the given name. Throws if it cannot be opened
+        Mapped_File( const std::string& filename );
+        ~Mapped_File();
+
+        Mapped_File( const Mapped_File& ) = delete;
+        Mapped_File& operator=( const Mapped_File& ) = delete;
+
+        // Pointer to the beginning of the file contents (nullptr for an empty file)
+        const char * data() const;
+        // Size of the file in bytes
+        std::size_t size() const;
+
+    private:
+        std::string filename;
+        const char * begin;
+        std::size_t length;
+        #ifdef _WIN32
+        void * file_handle;
+        void * mapping_handle;
+        #endif
+    };
+}
+
+#endif
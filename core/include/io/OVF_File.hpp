@@ -10,9 +10,15 @@
 #include <utility/Exception.hpp>
 #include <utility/Version.hpp>
 #include <io/Filter_File_Handle.hpp>
+#include <io/Mapped_File.hpp>
 
 #include <string>
 #include <fstream>
+#include <memory>
+#include <functional>
+#include <vector>
+#include <utility>
+#include <cstddef>
 #include <cctype>
     
 #include <fmt/format.h>
@@ -26,8 +32,10 @@ namespace IO
         bool isOVF;
         VF_FileFormat format;
         std::string filename;
-        const uint32_t test_hex_4b = 0x4996B438;
-        const uint64_t test_hex_8b = 0x42DC12218377DE40;
+        static const uint32_t test_hex_4b = 0x4996B438;
+        static const uint64_t test_hex_8b = 0x42DC12218377DE40;
+        // Number of spins which are converted into a buffer at a time when writing
+        static const std::size_t n_spins_chunk = 4096;
         const std::string comment_tag = "##";
         Utility::Log_Sender sender;
         
@@ -36,13 +44,21 @@ namespace IO
         std::ios::pos_type n_segments_pos; 
         const int n_segments_str_digits = 6;  // can store 1M modes
         bool file_exists; 
+        // Whether the existence, the version and the segments of the file were checked
+        bool file_inspected;
         // Positions of the beggining of each segment in the input file 
         std::vector<std::ios::pos_type> segment_fpos;
+        // Positions of the "# Begin: Data" line of each segment in the input file
+        std::vector<std::ios::pos_type> segment_data_fpos;
+        // Memory mapping of the input file, used to index the segments and to read binary data
+        std::unique_ptr<Mapped_File> mapped;
 
         // Output attributes
         const std::string empty_line = "#\n";
         std::string output_to_file;
         std::string datatype_out;
+        // File handle shared by the segments written to the file, kept open across appended segments
+        std::shared_ptr<std::fstream> ofile;
 
         // Input attributes 
         std::unique_ptr<Filter_File_Handle> ifile;
@@ -51,6 +67,7 @@ namespace IO
         std::string meshunit;
         std::string meshtype;
         std::string valueunits;
+        std::string valuelabels;
         std::string datatype_in;
         int binary_length;
         Vector3 max;
@@ -63,6 +80,10 @@ namespace IO
         Vector3 stepsize;
         std::array<int,3> nodes;
 
+        // Check if the file exists, its OVF version and locate its segments, unless this was
+        // already done. Queued writes to the file are carried out first, so this is only done
+        // when the file is read or appended to
+        void inspect_file();
         // Check OVF version
         void check_version();
         // Read segment's header
@@ -70,25 +91,59 @@ namespace IO
         // Check segment's geometry
         void check_geometry( const Data::Geometry& geometry );
         // Read segment's data
-        void read_data( vectorfield& vf, Data::Geometry& geometry );
+        void read_data( vectorfield& vf, Data::Geometry& geometry, const int idx_seg );
         // In case of binary data check the binary check values
-        bool check_binary_values();
-        // Read binary OVF data
-        void read_data_bin( vectorfield& vf, Data::Geometry& geometry );
+        bool check_binary_values( const char * data );
+        // Read the data representation of a segment from the "# Begin: Data" line
+        void read_data_representation();
+        // Locate the binary data block of a segment with n_values values in the memory mapped
+        // file and check its initial check value. Returns a pointer to the first value
+        const char * locate_data_bin( const int idx_seg, const std::size_t n_values );
+        // Read binary OVF data of a segment from the memory mapped file
+        void read_data_bin( vectorfield& vf, Data::Geometry& geometry, const int idx_seg );
+        // Read nos binary vectors with precision T from data, with a single copy if T is scalar
+        template <typename T> static void read_data_bin_as( const char * data, vectorfield& vf,
+                                                            const int nos );
         // Read text OVF data. The delimiter, if any, will be discarded in the reading
         void read_data_txt( vectorfield& vf, Data::Geometry& geometry, 
                             const std::string& delimiter = "" );
+        // Read the scalar fields of a segment, stored as valuedim values per node
+        void read_data( std::vector<std::pair<std::string, scalarfield>>& fields, const int idx_seg );
+        // Read n_nodes binary values with precision T per field from data, interleaved node by node
+        template <typename T> static void read_fields_bin_as( const char * data,
+                    std::vector<std::pair<std::string, scalarfield>>& fields, const std::size_t n_nodes );
         // Write OVF file header
         void write_top_header();
-        // Write segment data binary
-        void write_data_bin( const vectorfield& vf );
-        // Write segment data text
-        void write_data_txt( const vectorfield& vf, const std::string& delimiter = "" ); 
-        // Increment segment count
+        // Build the header of a segment with valuedim values per node and queue the segment to be
+        // written. write_data writes the data block (data_size bytes) into the file
+        void write_segment_queued( const Data::Geometry& geometry, const std::string& comment,
+                                   const bool append, const int valuedim,
+                                   const std::string& valueunits, const std::string& valuelabels,
+                                   const std::size_t data_size,
+                                   std::function<void(std::ostream&)> write_data );
+        // Write segment data binary into a stream
+        static void write_data_bin( std::ostream& stream, const vectorfield& vf,
+                                    const VF_FileFormat format );
+        // Write binary data with precision T, directly from vf if T is scalar
+        template <typename T> static void write_data_bin_as( std::ostream& stream,
+                                                             const vectorfield& vf );
+        // Write segment data text into a stream
+        static void write_data_txt( std::ostream& stream, const vectorfield& vf,
+                                    const std::string& delimiter = "" ); 
+        // Write scalar fields binary into a stream, interleaved node by node
+        template <typename T> static void write_fields_bin_as( std::ostream& stream,
+                    const std::vector<std::pair<std::string, scalarfield>>& fields );
+        // Write scalar fields as text into a stream, one line per node
+        static void write_fields_txt( std::ostream& stream,
+                    const std::vector<std::pair<std::string, scalarfield>>& fields,
+                    const std::string& delimiter = "" );
+        // Increment segment count and update its padded string
         void increment_n_segments();
         // Read the number of segments in the file by reading the top header
         void read_n_segments_from_top_header();
-        // Count the number of segments in the file. It also saves their file positions
+        // Count the number of segments in the file. It also saves their file positions and the
+        // positions of their data blocks. Binary data blocks are skipped, so that only the
+        // segment headers are scanned
         int count_and_locate_segments();
     public:
         // constructor
@@ -99,12 +154,23 @@ namespace IO
         bool is_OVF();
         // Get the number of segments in the file
         int get_n_segments();
-        // Read header and data from a given segment. Also check geometry
+        // Read header and data from a given segment. Also check geometry. Any segment can be
+        // read without reading the segments before it
         void read_segment( vectorfield& vf, Data::Geometry& geometry, 
                            const int idx_seg = 0 );
-        // Write segment to file (if the file exists overwrite it)
+        // Write segment to file (if the file exists overwrite it). The segment is written
+        // through the output queue, see IO::Queue_Output
         void write_segment( const vectorfield& vf, const Data::Geometry& geometry,
                             const std::string comment = "", const bool append = false ); 
+        // Read the scalar fields of a segment, e.g. spin-resolved energy contributions, labelled
+        // by the valuelabels of the segment
+        void read_segment( std::vector<std::pair<std::string, scalarfield>>& fields,
+                           const Data::Geometry& geometry, const int idx_seg = 0 );
+        // Write scalar fields to a segment with valuedim = fields.size(), labelled by their names
+        // (which must not contain whitespace). The segment is written through the output queue
+        void write_segment( const std::vector<std::pair<std::string, scalarfield>>& fields,
+                            const Data::Geometry& geometry, const std::string comment = "",
+                            const bool append = false );
     private: 
         // Read a variable from the comment section from the header of segment idx_seg
         template <typename T> void Read_Variable_from_Comment( T& var, const std::string name,
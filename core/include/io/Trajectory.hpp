@@ -0,0 +1,125 @@
+#pragma once
+#ifndef IO_TRAJECTORY_H
+#define IO_TRAJECTORY_H
+
+#include "Spirit_Defines.h"
+#include <engine/Vectormath_Defines.hpp>
+#include <io/Mapped_File.hpp>
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+namespace IO
+{
+    /*
+        Trajectory files store a sequence of spin configurations (frames) of a system together
+        with the iteration and total energy of each frame.
+
+        The spins are stored either lossless or, with n_bits > 0, as bounded-error quantized
+        directions: each unit vector is mapped onto the octahedron, the two resulting coordinates
+        are quantized with n_bits each and reconstructed with an angular error of at most
+        about 2^(3-n_bits) rad. Each frame is stored as a chunk of variable length integers,
+        which are the errors of a linear prediction: in every keyframe_interval-th frame
+        (keyframe) from the two preceding spins, in all other frames from the two preceding
+        frames. For smooth textures and steady dynamics, a spin typically takes 2-3 bytes with
+        16 bits, compared to 24 bytes in binary OVF. Lossless frames hold the bitwise differences
+        of the raw values to the previous frame and are therefore hardly compressed.
+
+        File layout (host byte order):
+            header: "SPIRITTJ", uint32 version, uint32 n_bits, uint32 keyframe_interval, uint64 nos
+            frames: "FRAM", uint8 keyframe, int64 iteration, float64 energy, uint64 n_bytes, data
+        Frames can be appended to an existing file with the same nos and n_bits. The reader
+        indexes the frames by jumping from one frame to the next, so a partially written last
+        frame (e.g. after a crash) is simply ignored.
+    */
+
+    // Metadata of a frame of a trajectory
+    struct Trajectory_Frame
+    {
+        long int iteration;
+        scalar energy;
+    };
+
+    /*
+        Writes frames to a trajectory file. Encoding and writing are carried out through the
+        output queue (see IO::Queue_Output), i.e. by the background writer with SPIRIT_USE_THREADS,
+        so that the caller only pays for a copy of the spins.
+    */
+    class Trajectory_Writer
+    {
+    public:
+        // Create the trajectory file, or append to it if append is set and it is compatible
+        Trajectory_Writer( const std::string & filename, std::size_t nos, int n_bits = 16,
+                           int keyframe_interval = 32, bool append = false );
+
+        // Queue a frame for writing
+        void Write_Frame( const vectorfield & spins, long int iteration, scalar energy );
+
+        // Number of frames written so far by this writer (excluding frames which are still queued)
+        int Get_N_Frames_Written() const;
+
+    private:
+        struct Encoder;
+        std::string filename;
+        std::size_t nos;
+        // State of the encoding, shared with the queued output jobs
+        std::shared_ptr<Encoder> encoder;
+    };
+
+    /*
+        Random access to the frames of a trajectory file. Reading a frame decodes at most
+        keyframe_interval frames, starting from the last keyframe before it. Reading frames in
+        ascending order decodes each frame only once.
+    */
+    class Trajectory_Reader
+    {
+    public:
+        // Open and index a trajectory file. Throws if it is not a trajectory file
+        Trajectory_Reader( const std::string & filename );
+
+        // Number of complete frames in the file
+        int Get_N_Frames() const;
+        // Number of spins per frame
+        std::size_t Get_NOS() const;
+        // Number of bits per coordinate (0 for lossless frames)
+        int Get_N_Bits() const;
+        // Metadata of a frame
+        Trajectory_Frame Get_Frame_Info( int idx_frame ) const;
+        // Read the spins of a frame into spins, which has to hold at least nos vectors
+        Trajectory_Frame Read_Frame( int idx_frame, vectorfield & spins );
+
+        // Position and metadata of a frame in the file
+        struct Frame_Record
+        {
+            std::size_t offset;
+            std::size_t n_bytes;
+            bool keyframe;
+            Trajectory_Frame info;
+        };
+        // Index the complete frames of a mapped file. Returns false if it is not a trajectory file
+        static bool Index_Frames( const Mapped_File & file, std::size_t & nos, int & n_bits,
+                                  std::vector<Frame_Record> & frames );
+
+    private:
+        // Decode the data of a frame, which is n_since_keyframe frames after the last keyframe,
+        // on top of the currently decoded state
+        void Decode_Frame( const Frame_Record & record, int n_since_keyframe );
+
+        std::string filename;
+        std::unique_ptr<Mapped_File> mapped;
+        std::size_t nos;
+        int n_bits;
+        std::vector<Frame_Record> frames;
+        // Currently decoded frame (-1 if none) and its distance to the last keyframe
+        int idx_decoded;
+        int n_since_keyframe_decoded;
+        // Quantized values of the decoded frame (last) and the one before, or its raw values
+        std::vector<std::int32_t> quantized, quantized_last, quantized_before_last;
+        std::vector<std::uint64_t> raw;
+    };
+}
+
+#endif
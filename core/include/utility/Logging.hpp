@@ -112,6 +112,8 @@ namespace Utility
 		bool save_positions_final;
 		bool save_neighbours_initial;
 		bool save_neighbours_final;
+		// Append the accumulated timings (see Utility::Timing::Counter) to the step and end messages of the methods
+		bool messages_timings;
 		// Name of the Log file
 		std::string fileName;
 		// Number of Log entries
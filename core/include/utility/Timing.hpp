@@ -4,6 +4,9 @@
 
 #include <string>
 #include <chrono>
+#include <atomic>
+#include <vector>
+#include <cstdint>
 
 #include "Spirit_Defines.h"
 
@@ -36,6 +39,64 @@ namespace Utility
         
         // Returns the duration when passed a string "hh:mm:ss"
 		duration<scalar> DurationFromString(std::string dt);
+
+
+        // ------ Instrumentation -------------------------------------------
+        /*
+            A Counter accumulates the wall time and the number of calls of a section of code,
+            such as a Hamiltonian term, a solver phase or an output call. Counters are global,
+            like the Log, and register themselves on construction, so they should be static:
+                static Timing::Counter counter("Hamiltonian/Gradient/DMI");
+                Timing::Scope scope(counter);
+            The times of concurrent calls (e.g. of GNEB images which are calculated in parallel)
+            add up, so the total can exceed the wall time. A call costs two reads of the steady
+            clock and two atomic additions.
+        */
+        class Counter
+        {
+        public:
+            explicit Counter(const char * name);
+
+            void Add(std::chrono::steady_clock::duration dt)
+            {
+                nanoseconds.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(dt).count(), std::memory_order_relaxed);
+                calls.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            const char * name;
+            std::atomic<std::int64_t> nanoseconds;
+            std::atomic<std::int64_t> calls;
+        };
+
+        // Adds the wall time from its construction to its destruction to a Counter
+        class Scope
+        {
+        public:
+            explicit Scope(Counter & counter) : counter(counter), t_start(std::chrono::steady_clock::now())
+            {}
+            ~Scope()
+            {
+                counter.Add(std::chrono::steady_clock::now() - t_start);
+            }
+
+        private:
+            Counter & counter;
+            std::chrono::steady_clock::time_point t_start;
+        };
+
+        struct Counter_Value
+        {
+            const char * name;
+            double seconds;
+            std::int64_t calls;
+        };
+
+        // Values of the counters which have been called since the last reset, sorted by name
+        std::vector<Counter_Value> Get_Counters();
+        // Set all counters to zero
+        void Reset_Counters();
+        // The counters formatted as a table, e.g. for a log block
+        std::vector<std::string> Counters_Table();
     }
 }
 #endif
\ No newline at end of file
@@ -65,3 +65,13 @@ def Chain_Append(p_state, filename, fileformat=6, comment=" ", idx_chain=-1):
                  ctypes.c_int(fileformat), ctypes.c_char_p(comment.encode('utf-8')), 
                  ctypes.c_int(idx_chain))
 
+
+### Write the spin-resolved energy contributions of an image to disk
+_Image_Write_Energy_per_Spin             = _spirit.IO_Image_Write_Energy_per_Spin
+_Image_Write_Energy_per_Spin.argtypes    = [ctypes.c_void_p, ctypes.c_char_p, ctypes.c_int, 
+                                            ctypes.c_int, ctypes.c_int]
+_Image_Write_Energy_per_Spin.restype     = None
+def Image_Write_Energy_per_Spin(p_state, filename, idx_image=-1, idx_chain=-1, fileformat=8):
+    _Image_Write_Energy_per_Spin(ctypes.c_void_p(p_state), ctypes.c_char_p(filename.encode('utf-8')),
+                                 ctypes.c_int(idx_image), ctypes.c_int(idx_chain), 
+                                 ctypes.c_int(fileformat))
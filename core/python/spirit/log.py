@@ -84,6 +84,13 @@ _Set_Output_File_Level.restype  = None
 def SetOutputFileLevel(p_state, level):
     _Set_Output_File_Level(ctypes.c_void_p(p_state), ctypes.c_int(level))
 
+### Set whether the accumulated timings are appended to the log messages of the methods
+_Set_Output_Timings          = _spirit.Log_Set_Output_Timings
+_Set_Output_Timings.argtypes = [ctypes.c_void_p, ctypes.c_bool]
+_Set_Output_Timings.restype  = None
+def SetOutputTimings(p_state, b):
+    _Set_Output_Timings(ctypes.c_void_p(p_state), ctypes.c_bool(b))
+
 ### Returns whether the Log is output to the console
 _Get_Output_To_Console          = _spirit.Log_Get_Output_To_Console
 _Get_Output_To_Console.argtypes = [ctypes.c_void_p]
@@ -110,4 +117,11 @@ _Get_Output_File_Level          = _spirit.Log_Get_Output_File_Level
 _Get_Output_File_Level.argtypes = [ctypes.c_void_p]
 _Get_Output_File_Level.restype  = ctypes.c_int
 def GetOutputFileLevel(p_state):
-    return int(_Get_Output_File_Level(ctypes.c_void_p(p_state)))
\ No newline at end of file
+    return int(_Get_Output_File_Level(ctypes.c_void_p(p_state)))
+
+### Returns whether the accumulated timings are appended to the log messages of the methods
+_Get_Output_Timings          = _spirit.Log_Get_Output_Timings
+_Get_Output_Timings.argtypes = [ctypes.c_void_p]
+_Get_Output_Timings.restype  = ctypes.c_bool
+def GetOutputTimings(p_state):
+    return bool(_Get_Output_Timings(ctypes.c_void_p(p_state)))
\ No newline at end of file
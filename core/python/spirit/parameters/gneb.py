@@ -61,6 +61,14 @@ def setIterations(p_state, n_iterations, n_iterations_log, idx_image=-1, idx_cha
                            ctypes.c_int(n_iterations_log), ctypes.c_int(idx_image),
                            ctypes.c_int(idx_chain))
 
+### Set GNEB maximum number of iterations between checks of the stop file and walltime
+_Set_GNEB_N_Iterations_Amortize             = _spirit.Parameters_Set_GNEB_N_Iterations_Amortize
+_Set_GNEB_N_Iterations_Amortize.argtypes    = [ctypes.c_void_p, ctypes.c_int, ctypes.c_int]
+_Set_GNEB_N_Iterations_Amortize.restype     = None
+def setIterationsAmortize(p_state, n_iterations_amortize, idx_chain=-1):
+    _Set_GNEB_N_Iterations_Amortize(ctypes.c_void_p(p_state), ctypes.c_int(n_iterations_amortize),
+                                    ctypes.c_int(idx_chain))
+
 ### Set GNEB convergence
 _Set_GNEB_Convergence           = _spirit.Parameters_Set_GNEB_Convergence
 _Set_GNEB_Convergence.argtypes  = [ctypes.c_void_p, ctypes.c_float, ctypes.c_int, ctypes.c_int]
@@ -92,6 +100,13 @@ _Set_GNEB_Image_Type_Automatically.restype     = None
 def setImageTypeAutomatically(p_state, idx_chain=-1):
     _Set_GNEB_Image_Type_Automatically(ctypes.c_void_p(p_state), ctypes.c_int(idx_chain))
 
+### Set the number of threads per image, to evaluate several images concurrently (0 = one after the other)
+_Set_GNEB_Threads_Per_Image             = _spirit.Parameters_Set_GNEB_Threads_Per_Image
+_Set_GNEB_Threads_Per_Image.argtypes    = [ctypes.c_void_p, ctypes.c_int, ctypes.c_int]
+_Set_GNEB_Threads_Per_Image.restype     = None
+def setThreadsPerImage(p_state, n_threads, idx_chain=-1):
+    _Set_GNEB_Threads_Per_Image(ctypes.c_void_p(p_state), ctypes.c_int(n_threads), ctypes.c_int(idx_chain))
+
 ### ---------------------------------- Get ----------------------------------
 
 ### Get GNEB N Iterations
@@ -107,6 +122,13 @@ def getIterations(p_state, idx_image=-1, idx_chain=-1):
                            ctypes.c_int(idx_chain) )
     return int(n_iterations.value), int(n_iterations_log.value)
 
+### Get GNEB maximum number of iterations between checks of the stop file and walltime
+_Get_GNEB_N_Iterations_Amortize             = _spirit.Parameters_Get_GNEB_N_Iterations_Amortize
+_Get_GNEB_N_Iterations_Amortize.argtypes    = [ctypes.c_void_p, ctypes.c_int]
+_Get_GNEB_N_Iterations_Amortize.restype     = ctypes.c_int
+def getIterationsAmortize(p_state, idx_chain=-1):
+    return int(_Get_GNEB_N_Iterations_Amortize(ctypes.c_void_p(p_state), ctypes.c_int(idx_chain)))
+
 ### Get GNEB convergence
 _Get_GNEB_Convergence           = _spirit.Parameters_Get_GNEB_Convergence
 _Get_GNEB_Convergence.argtypes  = [ctypes.c_void_p, ctypes.c_int, ctypes.c_int]
@@ -136,4 +158,11 @@ _Get_GNEB_N_Energy_Interpolations             = _spirit.Parameters_Get_GNEB_N_En
 _Get_GNEB_N_Energy_Interpolations.argtypes    = [ctypes.c_void_p, ctypes.c_int]
 _Get_GNEB_N_Energy_Interpolations.restype     = ctypes.c_int
 def getEnergyInterpolations(p_state, idx_chain=-1):
-    return int(_Get_GNEB_N_Energy_Interpolations(ctypes.c_void_p(p_state), ctypes.c_int(idx_chain)))
\ No newline at end of file
+    return int(_Get_GNEB_N_Energy_Interpolations(ctypes.c_void_p(p_state), ctypes.c_int(idx_chain)))
+
+### Get GNEB number of threads per image
+_Get_GNEB_Threads_Per_Image             = _spirit.Parameters_Get_GNEB_Threads_Per_Image
+_Get_GNEB_Threads_Per_Image.argtypes    = [ctypes.c_void_p, ctypes.c_int]
+_Get_GNEB_Threads_Per_Image.restype     = ctypes.c_int
+def getThreadsPerImage(p_state, idx_chain=-1):
+    return int(_Get_GNEB_Threads_Per_Image(ctypes.c_void_p(p_state), ctypes.c_int(idx_chain)))
\ No newline at end of file
@@ -53,6 +53,14 @@ def setOutputConfiguration(p_state, step=False, archive=True, filetype=6, idx_im
     _Set_LLG_Output_Configuration(ctypes.c_void_p(p_state), ctypes.c_bool(step), ctypes.c_bool(archive),
                         ctypes.c_int(filetype), ctypes.c_int(idx_image), ctypes.c_int(idx_chain))
 
+### Set compressed trajectory output and number of bits per coordinate (0 = lossless)
+_Set_LLG_Output_Trajectory             = _spirit.Parameters_Set_LLG_Output_Trajectory
+_Set_LLG_Output_Trajectory.argtypes    = [ctypes.c_void_p, ctypes.c_bool, ctypes.c_int, ctypes.c_int, ctypes.c_int]
+_Set_LLG_Output_Trajectory.restype     = None
+def setOutputTrajectory(p_state, trajectory, n_bits=16, idx_image=-1, idx_chain=-1):
+    _Set_LLG_Output_Trajectory(ctypes.c_void_p(p_state), ctypes.c_bool(trajectory), ctypes.c_int(n_bits),
+                              ctypes.c_int(idx_image), ctypes.c_int(idx_chain))
+
 ### Set LLG N Iterations
 _Set_LLG_N_Iterations             = _spirit.Parameters_Set_LLG_N_Iterations
 _Set_LLG_N_Iterations.argtypes    = [ctypes.c_void_p, ctypes.c_int, ctypes.c_int,
@@ -63,6 +71,22 @@ def setIterations(p_state, n_iterations, n_iterations_log, idx_image=-1, idx_cha
                           ctypes.c_int(n_iterations_log), ctypes.c_int(idx_image), 
                           ctypes.c_int(idx_chain))
 
+### Set LLG number of iterations after which energy and magnetization are recorded (0 = only when needed)
+_Set_LLG_N_Iterations_Observables             = _spirit.Parameters_Set_LLG_N_Iterations_Observables
+_Set_LLG_N_Iterations_Observables.argtypes    = [ctypes.c_void_p, ctypes.c_int, ctypes.c_int, ctypes.c_int]
+_Set_LLG_N_Iterations_Observables.restype     = None
+def setIterationsObservables(p_state, n_iterations_observables, idx_image=-1, idx_chain=-1):
+    _Set_LLG_N_Iterations_Observables(ctypes.c_void_p(p_state), ctypes.c_int(n_iterations_observables),
+                                      ctypes.c_int(idx_image), ctypes.c_int(idx_chain))
+
+### Set LLG maximum number of iterations between checks of the stop file and walltime
+_Set_LLG_N_Iterations_Amortize             = _spirit.Parameters_Set_LLG_N_Iterations_Amortize
+_Set_LLG_N_Iterations_Amortize.argtypes    = [ctypes.c_void_p, ctypes.c_int, ctypes.c_int, ctypes.c_int]
+_Set_LLG_N_Iterations_Amortize.restype     = None
+def setIterationsAmortize(p_state, n_iterations_amortize, idx_image=-1, idx_chain=-1):
+    _Set_LLG_N_Iterations_Amortize(ctypes.c_void_p(p_state), ctypes.c_int(n_iterations_amortize),
+                                   ctypes.c_int(idx_image), ctypes.c_int(idx_chain))
+
 ### Set LLG Direct Minimization
 _Set_LLG_Direct_Minimization            = _spirit.Parameters_Set_LLG_Direct_Minimization
 _Set_LLG_Direct_Minimization.argtypes   = [ctypes.c_void_p, ctypes.c_bool,
@@ -127,6 +151,18 @@ def setTemperature(p_state, temperature, gradient_inclination=0, gradient_direct
 
 ### ---------------------------------- Get ----------------------------------
 
+### Get compressed trajectory output and number of bits per coordinate
+_Get_LLG_Output_Trajectory             = _spirit.Parameters_Get_LLG_Output_Trajectory
+_Get_LLG_Output_Trajectory.argtypes    = [ctypes.c_void_p, ctypes.POINTER( ctypes.c_bool ),
+                                          ctypes.POINTER( ctypes.c_int ), ctypes.c_int, ctypes.c_int]
+_Get_LLG_Output_Trajectory.restype     = None
+def getOutputTrajectory(p_state, idx_image=-1, idx_chain=-1):
+    trajectory = ctypes.c_bool()
+    n_bits = ctypes.c_int()
+    _Get_LLG_Output_Trajectory(ctypes.c_void_p(p_state), ctypes.pointer(trajectory), ctypes.pointer(n_bits),
+                              ctypes.c_int(idx_image), ctypes.c_int(idx_chain))
+    return bool(trajectory.value), int(n_bits.value)
+
 ### Get LLG N Iterations
 _Get_LLG_N_Iterations             = _spirit.Parameters_Get_LLG_N_Iterations
 _Get_LLG_N_Iterations.argtypes    = [ctypes.c_void_p, ctypes.POINTER( ctypes.c_int ),
@@ -139,6 +175,22 @@ def getIterations(p_state, idx_image=-1, idx_chain=-1):
                           ctypes.c_int(idx_image), ctypes.c_int(idx_chain))
     return int(n_iterations.value), int(n_iterations_log.value)
 
+### Get LLG number of iterations after which energy and magnetization are recorded
+_Get_LLG_N_Iterations_Observables             = _spirit.Parameters_Get_LLG_N_Iterations_Observables
+_Get_LLG_N_Iterations_Observables.argtypes    = [ctypes.c_void_p, ctypes.c_int, ctypes.c_int]
+_Get_LLG_N_Iterations_Observables.restype     = ctypes.c_int
+def getIterationsObservables(p_state, idx_image=-1, idx_chain=-1):
+    return int(_Get_LLG_N_Iterations_Observables(ctypes.c_void_p(p_state), ctypes.c_int(idx_image),
+                                                 ctypes.c_int(idx_chain)))
+
+### Get LLG maximum number of iterations between checks of the stop file and walltime
+_Get_LLG_N_Iterations_Amortize             = _spirit.Parameters_Get_LLG_N_Iterations_Amortize
+_Get_LLG_N_Iterations_Amortize.argtypes    = [ctypes.c_void_p, ctypes.c_int, ctypes.c_int]
+_Get_LLG_N_Iterations_Amortize.restype     = ctypes.c_int
+def getIterationsAmortize(p_state, idx_image=-1, idx_chain=-1):
+    return int(_Get_LLG_N_Iterations_Amortize(ctypes.c_void_p(p_state), ctypes.c_int(idx_image),
+                                              ctypes.c_int(idx_chain)))
+
 ### Get LLG Direct Minimization
 _Get_LLG_Direct_Minimization            = _spirit.Parameters_Get_LLG_Direct_Minimization
 _Get_LLG_Direct_Minimization.argtypes   = [ctypes.c_void_p, ctypes.c_int, ctypes.c_int ]
@@ -4,6 +4,10 @@ import ctypes
 ### Load Library
 _spirit = spiritlib.LoadSpiritLibrary()
 
+### MC algorithms
+ALGORITHM_METROPOLIS = 0
+ALGORITHM_HEAT_BATH  = 1
+
 ## ---------------------------------- Set ----------------------------------
 
 ### Set the output file tag, which is placed in front of all output files of MC simulations
@@ -53,6 +57,14 @@ def setOutputConfiguration(p_state, step=False, archive=True, filetype=6, idx_im
     _Set_MC_Output_Configuration(ctypes.c_void_p(p_state), ctypes.c_bool(step), ctypes.c_bool(archive),
                         ctypes.c_int(filetype), ctypes.c_int(idx_image), ctypes.c_int(idx_chain))
 
+### Set compressed trajectory output and number of bits per coordinate (0 = lossless)
+_Set_MC_Output_Trajectory             = _spirit.Parameters_Set_MC_Output_Trajectory
+_Set_MC_Output_Trajectory.argtypes    = [ctypes.c_void_p, ctypes.c_bool, ctypes.c_int, ctypes.c_int, ctypes.c_int]
+_Set_MC_Output_Trajectory.restype     = None
+def setOutputTrajectory(p_state, trajectory, n_bits=16, idx_image=-1, idx_chain=-1):
+    _Set_MC_Output_Trajectory(ctypes.c_void_p(p_state), ctypes.c_bool(trajectory), ctypes.c_int(n_bits),
+                              ctypes.c_int(idx_image), ctypes.c_int(idx_chain))
+
 ### Set number of iterations and step size
 _Set_MC_N_Iterations             = _spirit.Parameters_Set_MC_N_Iterations
 _Set_MC_N_Iterations.argtypes    = [ctypes.c_void_p, ctypes.c_int, ctypes.c_int,
@@ -63,6 +75,14 @@ def setIterations(p_state, n_iterations, n_iterations_log, idx_image=-1, idx_cha
                           ctypes.c_int(n_iterations_log), ctypes.c_int(idx_image),
                           ctypes.c_int(idx_chain))
 
+### Set maximum number of iterations between checks of the stop file and walltime
+_Set_MC_N_Iterations_Amortize             = _spirit.Parameters_Set_MC_N_Iterations_Amortize
+_Set_MC_N_Iterations_Amortize.argtypes    = [ctypes.c_void_p, ctypes.c_int, ctypes.c_int, ctypes.c_int]
+_Set_MC_N_Iterations_Amortize.restype     = None
+def setIterationsAmortize(p_state, n_iterations_amortize, idx_image=-1, idx_chain=-1):
+    _Set_MC_N_Iterations_Amortize(ctypes.c_void_p(p_state), ctypes.c_int(n_iterations_amortize),
+                                  ctypes.c_int(idx_image), ctypes.c_int(idx_chain))
+
 ### Set temperature
 _Set_MC_Temperature             = _spirit.Parameters_Set_MC_Temperature
 _Set_MC_Temperature.argtypes    = [ctypes.c_void_p, ctypes.c_float, ctypes.c_int, ctypes.c_int]
@@ -78,8 +98,36 @@ _Set_MC_Acceptance_Ratio.restype     = None
 def setAcceptanceRatio(p_state, ratio, idx_image=-1, idx_chain=-1):
     _Set_MC_Acceptance_Ratio(p_state, ctypes.c_float(ratio), idx_image, idx_chain)
 
+### Set whether spins are sampled randomly (otherwise they are swept in order, in parallel where possible)
+_Set_MC_Random_Sample             = _spirit.Parameters_Set_MC_Random_Sample
+_Set_MC_Random_Sample.argtypes    = [ctypes.c_void_p, ctypes.c_bool, ctypes.c_int, ctypes.c_int]
+_Set_MC_Random_Sample.restype     = None
+def setRandomSample(p_state, random_sample, idx_image=-1, idx_chain=-1):
+    _Set_MC_Random_Sample(ctypes.c_void_p(p_state), ctypes.c_bool(random_sample),
+                          ctypes.c_int(idx_image), ctypes.c_int(idx_chain))
+
+### Set the algorithm (ALGORITHM_METROPOLIS or ALGORITHM_HEAT_BATH)
+_Set_MC_Algorithm             = _spirit.Parameters_Set_MC_Algorithm
+_Set_MC_Algorithm.argtypes    = [ctypes.c_void_p, ctypes.c_int, ctypes.c_int, ctypes.c_int]
+_Set_MC_Algorithm.restype     = None
+def setAlgorithm(p_state, algorithm, idx_image=-1, idx_chain=-1):
+    _Set_MC_Algorithm(ctypes.c_void_p(p_state), ctypes.c_int(algorithm),
+                      ctypes.c_int(idx_image), ctypes.c_int(idx_chain))
+
 ## ---------------------------------- Get ----------------------------------
 
+### Get compressed trajectory output and number of bits per coordinate
+_Get_MC_Output_Trajectory             = _spirit.Parameters_Get_MC_Output_Trajectory
+_Get_MC_Output_Trajectory.argtypes    = [ctypes.c_void_p, ctypes.POINTER( ctypes.c_bool ),
+                                          ctypes.POINTER( ctypes.c_int ), ctypes.c_int, ctypes.c_int]
+_Get_MC_Output_Trajectory.restype     = None
+def getOutputTrajectory(p_state, idx_image=-1, idx_chain=-1):
+    trajectory = ctypes.c_bool()
+    n_bits = ctypes.c_int()
+    _Get_MC_Output_Trajectory(ctypes.c_void_p(p_state), ctypes.pointer(trajectory), ctypes.pointer(n_bits),
+                              ctypes.c_int(idx_image), ctypes.c_int(idx_chain))
+    return bool(trajectory.value), int(n_bits.value)
+
 ### Get number of iterations and step size
 _Get_MC_N_Iterations             = _spirit.Parameters_Get_MC_N_Iterations
 _Get_MC_N_Iterations.argtypes    = [ctypes.c_void_p, ctypes.POINTER( ctypes.c_int ),
@@ -92,6 +140,14 @@ def getIterations(p_state, idx_image=-1, idx_chain=-1):
                           ctypes.c_int(idx_image), ctypes.c_int(idx_chain))
     return int(n_iterations.value), int(n_iterations_log.value)
 
+### Get maximum number of iterations between checks of the stop file and walltime
+_Get_MC_N_Iterations_Amortize             = _spirit.Parameters_Get_MC_N_Iterations_Amortize
+_Get_MC_N_Iterations_Amortize.argtypes    = [ctypes.c_void_p, ctypes.c_int, ctypes.c_int]
+_Get_MC_N_Iterations_Amortize.restype     = ctypes.c_int
+def getIterationsAmortize(p_state, idx_image=-1, idx_chain=-1):
+    return int(_Get_MC_N_Iterations_Amortize(ctypes.c_void_p(p_state), ctypes.c_int(idx_image),
+                                             ctypes.c_int(idx_chain)))
+
 ### Get temperature
 _Get_MC_Temperature             = _spirit.Parameters_Get_MC_Temperature
 _Get_MC_Temperature.argtypes    = [ctypes.c_void_p, ctypes.c_int, ctypes.c_int]
@@ -106,4 +162,20 @@ _Get_MC_Acceptance_Ratio.argtypes    = [ctypes.c_void_p, ctypes.c_int, ctypes.c_
 _Get_MC_Acceptance_Ratio.restype     = ctypes.c_float
 def getAcceptanceRatio(p_state, idx_image=-1, idx_chain=-1):
     return float(_Get_MC_Acceptance_Ratio(ctypes.c_void_p(p_state), ctypes.c_int(idx_image),
-                                    ctypes.c_int(idx_chain)))
\ No newline at end of file
+                                    ctypes.c_int(idx_chain)))
+
+### Get whether spins are sampled randomly
+_Get_MC_Random_Sample             = _spirit.Parameters_Get_MC_Random_Sample
+_Get_MC_Random_Sample.argtypes    = [ctypes.c_void_p, ctypes.c_int, ctypes.c_int]
+_Get_MC_Random_Sample.restype     = ctypes.c_bool
+def getRandomSample(p_state, idx_image=-1, idx_chain=-1):
+    return bool(_Get_MC_Random_Sample(ctypes.c_void_p(p_state), ctypes.c_int(idx_image),
+                                      ctypes.c_int(idx_chain)))
+
+### Get the algorithm
+_Get_MC_Algorithm             = _spirit.Parameters_Get_MC_Algorithm
+_Get_MC_Algorithm.argtypes    = [ctypes.c_void_p, ctypes.c_int, ctypes.c_int]
+_Get_MC_Algorithm.restype     = ctypes.c_int
+def getAlgorithm(p_state, idx_image=-1, idx_chain=-1):
+    return int(_Get_MC_Algorithm(ctypes.c_void_p(p_state), ctypes.c_int(idx_image),
+                                 ctypes.c_int(idx_chain)))
\ No newline at end of file
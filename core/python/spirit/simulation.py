@@ -84,4 +84,32 @@ _Running_Anywhere_Collection            = _spirit.Simulation_Running_Anywhere_Co
 _Running_Anywhere_Collection.argtypes   = [ctypes.c_void_p]
 _Running_Anywhere_Collection.restype    = ctypes.c_bool
 def Running_Anywhere_Collection(p_state):
-    return bool(_Running_Anywhere_Collection(ctypes.c_void_p(p_state)))
\ No newline at end of file
+    return bool(_Running_Anywhere_Collection(ctypes.c_void_p(p_state)))
+
+
+### Get the number of timings of the Hamiltonian terms, solver phases and output
+_Get_N_Timings            = _spirit.Simulation_Get_N_Timings
+_Get_N_Timings.argtypes   = [ctypes.c_void_p]
+_Get_N_Timings.restype    = ctypes.c_int
+def Get_N_Timings(p_state):
+    return int(_Get_N_Timings(ctypes.c_void_p(p_state)))
+
+### Get the timings as a list of (name, seconds, calls), accumulated since the last reset
+_Get_Timings            = _spirit.Simulation_Get_Timings
+_Get_Timings.argtypes   = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_char_p), ctypes.POINTER(ctypes.c_float),
+                           ctypes.POINTER(ctypes.c_int), ctypes.c_int]
+_Get_Timings.restype    = ctypes.c_int
+def Get_Timings(p_state):
+    n = Get_N_Timings(p_state)
+    names   = (n*ctypes.c_char_p)()
+    seconds = (n*ctypes.c_float)()
+    calls   = (n*ctypes.c_int)()
+    n = _Get_Timings(ctypes.c_void_p(p_state), names, seconds, calls, ctypes.c_int(n))
+    return [ (names[i].decode('utf-8'), seconds[i], calls[i]) for i in range(n) ]
+
+### Set all timings to zero
+_Reset_Timings            = _spirit.Simulation_Reset_Timings
+_Reset_Timings.argtypes   = [ctypes.c_void_p]
+_Reset_Timings.restype    = None
+def Reset_Timings(p_state):
+    _Reset_Timings(ctypes.c_void_p(p_state))
\ No newline at end of file
@@ -22,7 +22,8 @@ def Get_NOS(p_state, idx_image=-1, idx_chain=-1):
     return int(_Get_NOS(ctypes.c_void_p(p_state), ctypes.c_int(idx_image), ctypes.c_int(idx_chain)))
 
 ### Get Pointer to Spin Directions
-# NOTE: Changing the values of the array_view one can alter the value of the data of the state
+# NOTE: Changing the values of the array_view one can alter the value of the data of the state.
+#       If the array_view is kept and written to after other calls, call Spins_Changed afterwards.
 _Get_Spin_Directions            = _spirit.System_Get_Spin_Directions
 _Get_Spin_Directions.argtypes   = [ctypes.c_void_p, ctypes.c_int, ctypes.c_int]
 _Get_Spin_Directions.restype    = ctypes.POINTER(scalar)
@@ -37,6 +38,36 @@ def Get_Spin_Directions(p_state, idx_image=-1, idx_chain=-1):
     array_view.shape = (nos, 3)
     return array_view
 
+### Mark the spins as changed after writing to an array_view returned by Get_Spin_Directions,
+### so that the energy, magnetization and effective field are recalculated
+_Spins_Changed            = _spirit.System_Spins_Changed
+_Spins_Changed.argtypes   = [ctypes.c_void_p, ctypes.c_int, ctypes.c_int]
+_Spins_Changed.restype    = None
+def Spins_Changed(p_state, idx_image=-1, idx_chain=-1):
+    _Spins_Changed(ctypes.c_void_p(p_state), ctypes.c_int(idx_image), ctypes.c_int(idx_chain))
+
+### Get a copy of the last published snapshot of the spin directions and the iteration at which
+### it was published. This does not wait for a running simulation.
+_Get_Spin_Snapshot              = _spirit.System_Get_Spin_Snapshot
+_Get_Spin_Snapshot.argtypes     = [ctypes.c_void_p, ctypes.POINTER(scalar), ctypes.c_int, ctypes.c_int]
+_Get_Spin_Snapshot.restype      = ctypes.c_int
+def Get_Spin_Snapshot(p_state, idx_image=-1, idx_chain=-1):
+    nos = Get_NOS(p_state, idx_image, idx_chain)
+    spins = (scalar*(3*nos))()
+    iteration = _Get_Spin_Snapshot(ctypes.c_void_p(p_state), spins, ctypes.c_int(idx_image),
+                                   ctypes.c_int(idx_chain))
+    array = frombuffer(spins, dtype=scalar).copy()
+    array.shape = (nos, 3)
+    return array, int(iteration)
+
+### Set the number of iterations after which a running simulation publishes a snapshot (0 = only at start, end and log steps)
+_Set_Snapshot_Interval          = _spirit.System_Set_Snapshot_Interval
+_Set_Snapshot_Interval.argtypes = [ctypes.c_void_p, ctypes.c_int, ctypes.c_int, ctypes.c_int]
+_Set_Snapshot_Interval.restype  = None
+def Set_Snapshot_Interval(p_state, n_iterations, idx_image=-1, idx_chain=-1):
+    _Set_Snapshot_Interval(ctypes.c_void_p(p_state), ctypes.c_int(n_iterations), ctypes.c_int(idx_image),
+                           ctypes.c_int(idx_chain))
+
 ### Get total Energy
 _Get_Energy          = _spirit.System_Get_Energy
 _Get_Energy.argtypes = [ctypes.c_void_p, ctypes.c_int, ctypes.c_int]
@@ -14,6 +14,7 @@ import unittest
 cfgfile       = spirit_py_dir + "/../test/input/fd_neighbours.cfg"   # Input File
 io_image_test = spirit_py_dir + "/test/io_test_files/io_image_test"
 io_chain_test = spirit_py_dir + "/test/io_test_files/io_chain_test"
+io_energy_per_spin_test = spirit_py_dir + "/test/io_test_files/io_energy_per_spin_test"
 
 p_state = state.setup(cfgfile)                  # State setup
 
@@ -57,6 +58,11 @@ class Image_IO(TestParameters):
         io.Image_Append(self.p_state, io_image_test, 6, "python io test")
         io.Image_Append(self.p_state, io_image_test, 6, "python io test")
     
+    def test_write_energy_per_spin(self):
+        configuration.PlusZ(self.p_state)
+        io.Image_Write_Energy_per_Spin(self.p_state, io_energy_per_spin_test, fileformat=6)
+        self.assertTrue( os.path.isfile(io_energy_per_spin_test) )
+    
 class Chain_IO(TestParameters):
     
     def test_chain_write(self):
@@ -33,7 +33,26 @@ class LLG_set_get(TestParameters):
         N_get, Nlog_get = parameters.llg.getIterations(self.p_state, 0, 0)   # try get
         self.assertEqual( N_set, N_get )
         self.assertEqual( Nlog_set, Nlog_get )
+
+    def test_LLG_N_iterations_observables(self):
+        Nobs_set = 10
+        parameters.llg.setIterationsObservables(self.p_state, Nobs_set)     # try set
+        Nobs_get = parameters.llg.getIterationsObservables(self.p_state)    # try get
+        self.assertEqual( Nobs_set, Nobs_get )
+
+    def test_LLG_N_iterations_amortize(self):
+        Namortize_set = 16
+        parameters.llg.setIterationsAmortize(self.p_state, Namortize_set)    # try set
+        Namortize_get = parameters.llg.getIterationsAmortize(self.p_state)   # try get
+        self.assertEqual( Namortize_set, Namortize_get )
         
+    def test_LLG_output_trajectory(self):
+        parameters.llg.setOutputTrajectory(self.p_state, True, 12)                  # try set
+        trajectory_get, n_bits_get = parameters.llg.getOutputTrajectory(self.p_state) # try get
+        self.assertTrue( trajectory_get )
+        self.assertEqual( n_bits_get, 12 )
+        parameters.llg.setOutputTrajectory(self.p_state, False)
+
     def test_LLG_direct_minimization(self):
         parameters.llg.setDirectMinimization(self.p_state, True)      # try set
         ret = parameters.llg.getDirectMinimization(self.p_state)      # try get
@@ -112,6 +131,12 @@ class GNEB_set_get(TestParameters):
         # NOTE: this tests only the wrapping of the function since we cannot know the right value
         E_inter = parameters.gneb.getEnergyInterpolations(self.p_state)
         self.assertTrue(E_inter > 0)
+
+    def test_GNEB_Threads_Per_Image(self):
+        n_set = 2
+        parameters.gneb.setThreadsPerImage(self.p_state, n_set)     # try set
+        n_get = parameters.gneb.getThreadsPerImage(self.p_state)    # try get
+        self.assertEqual(n_set, n_get)
     
 #########
 
@@ -5,7 +5,7 @@ import sys
 spirit_py_dir = os.path.abspath(os.path.join(os.path.dirname( __file__ ), ".."))
 sys.path.insert(0, spirit_py_dir)
 
-from spirit import state, system, configuration
+from spirit import state, system, configuration, quantities
 
 import unittest
 
@@ -39,6 +39,35 @@ class SystemGetters(TestSystem):
             self.assertAlmostEqual( arr[i][1], 0. )
             self.assertAlmostEqual( arr[i][2], 1. )
     
+    def test_write_spin_directions(self):
+        configuration.PlusZ(self.p_state)
+        M = quantities.Get_Magnetization(self.p_state)
+        self.assertAlmostEqual( M[2], 1. )
+        arr = system.Get_Spin_Directions(self.p_state)
+        arr[:,2] = -1.
+        M = quantities.Get_Magnetization(self.p_state)
+        self.assertAlmostEqual( M[2], -1. )
+        # A kept array_view needs Spins_Changed after writing
+        arr[:,2] = 1.
+        system.Spins_Changed(self.p_state)
+        M = quantities.Get_Magnetization(self.p_state)
+        self.assertAlmostEqual( M[2], 1. )
+    
+    def test_get_spin_snapshot(self):
+        configuration.PlusZ(self.p_state)
+        nos = system.Get_NOS(self.p_state)
+        arr, iteration = system.Get_Spin_Snapshot(self.p_state)
+        self.assertEqual(iteration, 0)
+        for i in range(nos):
+            self.assertAlmostEqual( arr[i][0], 0. )
+            self.assertAlmostEqual( arr[i][1], 0. )
+            self.assertAlmostEqual( arr[i][2], 1. )
+        # The snapshot is updated after the configuration changed
+        configuration.MinusZ(self.p_state)
+        arr, iteration = system.Get_Spin_Snapshot(self.p_state)
+        for i in range(nos):
+            self.assertAlmostEqual( arr[i][2], -1. )
+    
     def test_get_energy(self):
         # NOTE: that test is trivial
         E = system.Get_Energy(self.p_state)
@@ -9,10 +9,12 @@
 #include <fmt/ostream.h>
 
 
-void Helper_System_Set_Geometry(std::shared_ptr<Data::Spin_System> system, const Data::Geometry & new_geometry)
+void Helper_System_Set_Geometry(std::shared_ptr<Data::Spin_System> system, std::shared_ptr<Data::Geometry> new_geometry_ptr)
 {
-    // *system->geometry = new_geometry;
-    auto old_geometry = *system->geometry;
+    // The geometry may be shared with other systems, so it is replaced instead of modified
+    auto old_geometry_ptr = system->geometry;
+    auto& old_geometry = *old_geometry_ptr;
+    auto& new_geometry = *new_geometry_ptr;
 
     // Spins
     int nos_old = system->nos;
@@ -22,21 +24,28 @@ void Helper_System_Set_Geometry(std::shared_ptr<Data::Spin_System> system, const
     // Move the vector-fields to the new geometry
     *system->spins = Engine::Vectormath::change_dimensions(*system->spins, old_geometry, new_geometry, {0,0,1});
     system->effective_field = Engine::Vectormath::change_dimensions(system->effective_field, old_geometry, new_geometry, {0,0,0});
+    system->SpinsChanged();
+    system->HamiltonianChanged();
 
     // Update the system geometry
-    *system->geometry = new_geometry;
+    system->geometry = new_geometry_ptr;
 
     // Parameters
-    system->llg_parameters->pinning->mask_unpinned =
-        Engine::Vectormath::change_dimensions(system->llg_parameters->pinning->mask_unpinned, old_geometry, new_geometry, 1);
+    system->llg_parameters->pinning->Update_Geometry(new_geometry_ptr);
+    system->mc_parameters->pinning->Update_Geometry(new_geometry_ptr);
 
     // Heisenberg Hamiltonian
     if (system->hamiltonian->Name() == "Heisenberg")
-        std::static_pointer_cast<Engine::Hamiltonian_Heisenberg>(system->hamiltonian)->Update_DDI_Pairs();
+        std::static_pointer_cast<Engine::Hamiltonian_Heisenberg>(system->hamiltonian)->Update_Geometry(new_geometry_ptr);
 }
 
 void Helper_State_Set_Geometry(State * state, const Data::Geometry & old_geometry, const Data::Geometry & new_geometry)
 {
+    // All systems share the new geometry. The old one is kept alive until the clipboard
+    // configuration has been moved to the new geometry.
+    auto new_geometry_ptr = std::make_shared<Data::Geometry>(new_geometry);
+    auto old_geometry_ptr = state->active_image->geometry;
+
     // Deal with all systems in all chains
     for (auto& chain : state->collection->chains)
     {
@@ -47,8 +56,9 @@ void Helper_State_Set_Geometry(State * state, const Data::Geometry & old_geometr
             // Modify all systems in the chain
             for (auto& system : chain->images)
             {
-                Helper_System_Set_Geometry(system, new_geometry);
+                Helper_System_Set_Geometry(system, new_geometry_ptr);
             }
+            chain->gneb_parameters->pinning->Update_Geometry(new_geometry_ptr);
         }
         catch( ... )
         {
@@ -73,7 +83,7 @@ void Helper_State_Set_Geometry(State * state, const Data::Geometry & old_geometr
         try
         {
             // Modify
-            Helper_System_Set_Geometry(system, new_geometry);
+            Helper_System_Set_Geometry(system, new_geometry_ptr);
         }
         catch( ... )
         {
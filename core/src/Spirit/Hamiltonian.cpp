@@ -35,11 +35,16 @@ void Hamiltonian_Set_Boundary_Conditions(State *state, const bool * periodical,
             image->hamiltonian->boundary_conditions[0] = periodical[0];
             image->hamiltonian->boundary_conditions[1] = periodical[1];
             image->hamiltonian->boundary_conditions[2] = periodical[2];
+
+            // The neighbour tables and DDI depend on the boundary conditions
+            if (image->hamiltonian->Name() == "Heisenberg")
+                std::static_pointer_cast<Engine::Hamiltonian_Heisenberg>(image->hamiltonian)->Update_Interactions();
         }
         catch( ... )
         {
             spirit_handle_exception_api(idx_image, idx_chain);
         }
+        image->HamiltonianChanged();
         image->Unlock();
 
         Log( Utility::Log_Level::Info, Utility::Log_Sender::API,
@@ -82,6 +87,7 @@ void Hamiltonian_Set_mu_s(State *state, float mu_s, int idx_image, int idx_chain
             spirit_handle_exception_api(idx_image, idx_chain);
         }
         
+        image->HamiltonianChanged();
         image->Unlock();
     }
     catch( ... )
@@ -135,6 +141,7 @@ void Hamiltonian_Set_Field(State *state, float magnitude, const float * normal,
         }
         
         // Unlock mutex
+        image->HamiltonianChanged();
         image->Unlock();
     }
     catch( ... )
@@ -198,6 +205,7 @@ void Hamiltonian_Set_Anisotropy( State *state, float magnitude, const float * no
             spirit_handle_exception_api(idx_image, idx_chain);
         }
 
+        image->HamiltonianChanged();
         image->Unlock();
     }
     catch( ... )
@@ -235,9 +243,9 @@ void Hamiltonian_Set_Exchange(State *state, int n_shells, const float* jij, int
                 intfield  shells(0);
                 Engine::Neighbours::Get_Neighbours_in_Shells(*image->geometry, n_shells, neighbours, shells, remove_redundant);
                 scalarfield magnitudes(0);
-                for (int i=0; i<n_shells; ++i)
+                for (unsigned int i=0; i<neighbours.size(); ++i)
                 {
-                    magnitudes.push_back( { (scalar)jij[i] } );
+                    magnitudes.push_back( { (scalar)jij[shells[i]] } );
                 }
                 
                 // Set Hamiltonian's arrays
@@ -246,8 +254,8 @@ void Hamiltonian_Set_Exchange(State *state, int n_shells, const float* jij, int
                 ham->exchange_pairs      = neighbours;
                 ham->exchange_magnitudes = magnitudes;
                 
-                // Update the list of different contributions
-                ham->Update_Energy_Contributions();
+                // Update the neighbour tables and the list of different contributions
+                ham->Update_Interactions();
                 
                 std::string message = fmt::format("Set exchange to {} shells", n_shells);
                 if (n_shells > 0) message += fmt::format(" Jij[0] = {}", jij[0]);
@@ -262,6 +270,7 @@ void Hamiltonian_Set_Exchange(State *state, int n_shells, const float* jij, int
             spirit_handle_exception_api(idx_image, idx_chain);
         }
                 
+        image->HamiltonianChanged();
         image->Unlock();
     }
     catch( ... )
@@ -302,9 +311,9 @@ void Hamiltonian_Set_DMI(State *state, int n_shells, const float * dij, int idx_
                 Engine::Neighbours::Get_Neighbours_in_Shells(*image->geometry, n_shells, neighbours, shells, remove_redundant);
                 scalarfield magnitudes(0);
                 vectorfield normals(0);
-                for (int i=0; i<n_shells; ++i)
+                for (unsigned int i=0; i<neighbours.size(); ++i)
                 {
-                    magnitudes.push_back({ (scalar)dij[i] });
+                    magnitudes.push_back({ (scalar)dij[shells[i]] });
                     normals.push_back({ Engine::Neighbours::DMI_Normal_from_Pair( *image->geometry, neighbours[i], dmi_chirality) } );
                 }
 
@@ -315,8 +324,8 @@ void Hamiltonian_Set_DMI(State *state, int n_shells, const float * dij, int idx_
                 ham->dmi_magnitudes = magnitudes;
                 ham->dmi_normals    = normals;
 
-                // Update the list of different contributions
-                ham->Update_Energy_Contributions();
+                // Update the neighbour tables and the list of different contributions
+                ham->Update_Interactions();
 
                 std::string message = fmt::format("Set dmi to {} shells", n_shells);
                 if (n_shells > 0) message += fmt::format(" Dij[0] = {}", dij[0]);
@@ -331,6 +340,7 @@ void Hamiltonian_Set_DMI(State *state, int n_shells, const float * dij, int idx_
             spirit_handle_exception_api(idx_image, idx_chain);
         }
 
+        image->HamiltonianChanged();
         image->Unlock();
     }
     catch( ... )
@@ -356,20 +366,9 @@ void Hamiltonian_Set_DDI(State *state, float radius, int idx_image, int idx_chai
             {
                 auto ham = (Engine::Hamiltonian_Heisenberg*)image->hamiltonian.get();
 
-                auto pairs = Engine::Neighbours::Get_Pairs_in_Radius(*image->geometry, radius);
-                scalarfield magnitudes(0);
-                vectorfield normals(0);
-                scalar magnitude;
-                Vector3 normal;
-                for (auto& pair : pairs)
-                {
-                    Engine::Neighbours::DDI_from_Pair(*image->geometry, pair, magnitude, normal);
-                    magnitudes.push_back(magnitude);
-                    normals.push_back(normal);
-                }
-                ham->ddi_pairs = pairs;
-                ham->ddi_magnitudes = magnitudes;
-                ham->ddi_normals = normals;
+                // Regenerate the DDI pairs or kernel with the new radius
+                ham->ddi_cutoff_radius = radius;
+                ham->Update_DDI();
 
                 // Update the list of different contributions
                 ham->Update_Energy_Contributions();
@@ -385,6 +384,7 @@ void Hamiltonian_Set_DDI(State *state, float radius, int idx_image, int idx_chai
             spirit_handle_exception_api(idx_image, idx_chain);
         }
 
+        image->HamiltonianChanged();
         image->Unlock();
     }
     catch( ... )
@@ -149,6 +149,9 @@ void IO_Positions_Write( State * state, const char *file, int format,
         
         Log( Utility::Log_Level::Info, Utility::Log_Sender::API, fmt::format( "Wrote positions to file "
                 "{} with format {}", file, format ), idx_image, idx_chain );
+
+        // The file is complete when the function returns
+        IO::Flush_Output( std::string(file) );
     }
     catch( ... )
     {
@@ -206,6 +209,11 @@ void IO_Image_Read( State *state, const char *file, int idx_image_infile,
         {
             const std::string extension = Get_Extension( file );
             
+            // Vacancies in the file change the atom types of this image only
+            #ifdef SPIRIT_ENABLE_DEFECTS
+            image->Unshare_Geometry();
+            #endif
+
             // helper variables
             auto& spins = *image->spins;
             auto& geometry = *image->geometry;
@@ -253,6 +261,7 @@ void IO_Image_Read( State *state, const char *file, int idx_image_infile,
             spirit_handle_exception_api(idx_image_inchain, idx_chain);
         }
         
+        image->SpinsChanged();
         image->Unlock();
 
     }
@@ -330,6 +339,9 @@ void IO_Image_Write( State *state, const char *file, int format, const char* com
 
         image->Unlock();
         
+
+        // The file is complete when the function returns
+        IO::Flush_Output( std::string(file) );
     }
     catch( ... )
     {
@@ -405,6 +417,9 @@ void IO_Image_Append( State *state, const char *file, int format, const char * c
 
         image->Unlock();
 
+
+        // The file is complete when the function returns
+        IO::Flush_Output( std::string(file) );
     }
     catch( ... )
     {
@@ -506,8 +521,12 @@ void IO_Chain_Read( State *state, const char *file, int start_image_infile,
                         // Read the images
                         for (int i=insert_idx; i<noi_to_read; i++)
                         {
+                            #ifdef SPIRIT_ENABLE_DEFECTS
+                            images[i]->Unshare_Geometry();
+                            #endif
                             file_ovf.read_segment( *images[i]->spins, *images[i]->geometry, 
                                                    start_image_infile );
+                            images[i]->SpinsChanged();
                             start_image_infile++;
                         }
                         
@@ -547,10 +566,14 @@ void IO_Chain_Read( State *state, const char *file, int start_image_infile,
                     { 
                         for (int i=insert_idx; i<noi_to_read; i++)
                         {
+                            #ifdef SPIRIT_ENABLE_DEFECTS
+                            chain->images[i]->Unshare_Geometry();
+                            #endif
                             IO::Read_NonOVF_Spin_Configuration( *chain->images[i]->spins,
                                                                 *chain->images[i]->geometry,
                                                                 chain->images[i]->nos,
                                                                 start_image_infile, file );
+                            chain->images[i]->SpinsChanged();
                             start_image_infile++;
                         }
                         success = true;
@@ -667,6 +690,9 @@ void IO_Chain_Write( State *state, const char *file, int format, const char* com
         Log( Utility::Log_Level::Info, Utility::Log_Sender::API,
                 fmt::format("Wrote chain to file {} with format {}", file, format), 
                 idx_image, idx_chain );
+
+        // The file is complete when the function returns
+        IO::Flush_Output( std::string(file) );
     }
     catch( ... )
     {
@@ -746,6 +772,9 @@ void IO_Chain_Append( State *state, const char *file, int format, const char* co
         Log( Utility::Log_Level::Info, Utility::Log_Sender::API,
                 fmt::format("Wrote chain to file {} with format {}", file, format), 
                 idx_image, idx_chain );
+
+        // The file is complete when the function returns
+        IO::Flush_Output( std::string(file) );
     }
     catch( ... )
     {
@@ -771,6 +800,9 @@ void IO_Image_Write_Neighbours_Exchange( State * state, const char * file,
         
         // Write the data
         IO::Write_Neighbours_Exchange( *image, std::string(file) );
+
+        // The file is complete when the function returns
+        IO::Flush_Output( std::string(file) );
     }
     catch( ... )
     {
@@ -791,6 +823,9 @@ void IO_Image_Write_Neighbours_DMI( State * state, const char * file,
         
         // Write the data
         IO::Write_Neighbours_DMI( *image, std::string(file) );
+
+        // The file is complete when the function returns
+        IO::Flush_Output( std::string(file) );
     }
     catch( ... )
     {
@@ -799,7 +834,7 @@ void IO_Image_Write_Neighbours_DMI( State * state, const char * file,
 }
 
 //IO_Energies_Spins_Save
-void IO_Image_Write_Energy_per_Spin(State * state, const char * file, int idx_image, int idx_chain) noexcept
+void IO_Image_Write_Energy_per_Spin(State * state, const char * file, int idx_image, int idx_chain, int format) noexcept
 {
     try
     {
@@ -810,7 +845,10 @@ void IO_Image_Write_Energy_per_Spin(State * state, const char * file, int idx_im
         from_indices( state, idx_image, idx_chain, image, chain );
         
         // Write the data
-        IO::Write_Image_Energy_per_Spin(*image, std::string(file));
+        IO::Write_Image_Energy_per_Spin(*image, std::string(file), true, true, IO::VF_FileFormat(format));
+
+        // The file is complete when the function returns
+        IO::Flush_Output( std::string(file) );
     }
     catch( ... )
     {
@@ -831,6 +869,9 @@ void IO_Image_Write_Energy(State * state, const char * file, int idx_image, int
         
         // Write the data
         IO::Write_Image_Energy(*image, std::string(file));
+
+        // The file is complete when the function returns
+        IO::Flush_Output( std::string(file) );
     }
     catch( ... )
     {
@@ -853,6 +894,9 @@ void IO_Chain_Write_Energies(State * state, const char * file, int idx_chain) no
         
         // Write the data
         IO::Write_Chain_Energies(*chain, idx_chain, std::string(file));
+
+        // The file is complete when the function returns
+        IO::Flush_Output( std::string(file) );
     }
     catch( ... )
     {
@@ -875,6 +919,9 @@ void IO_Chain_Write_Energies_Interpolated(State * state, const char * file, int
         
         // Write the data
         IO::Write_Chain_Energies_Interpolated(*chain, std::string(file));
+
+        // The file is complete when the function returns
+        IO::Flush_Output( std::string(file) );
     }
     catch( ... )
     {
@@ -149,6 +149,18 @@ void Log_Set_Output_File_Level(State *state, int level) noexcept
     }
 }
 
+void Log_Set_Output_Timings(State *state, bool b) noexcept
+{
+    try
+    {
+        Log.messages_timings = b;
+    }
+    catch( ... )
+    {
+        spirit_handle_exception_api(-1, -1);
+    }
+}
+
 //      Get Log parameters
 const char * Log_Get_Output_File_Tag(State *state) noexcept
 {
@@ -226,4 +238,17 @@ int Log_Get_Output_File_Level(State *state) noexcept
         spirit_handle_exception_api(-1, -1);
         return 0;
     }
+}
+
+bool Log_Get_Output_Timings(State *state) noexcept
+{
+    try
+    {
+        return Log.messages_timings;
+    }
+    catch( ... )
+    {
+        spirit_handle_exception_api(-1, -1);
+        return false;
+    }
 }
\ No newline at end of file
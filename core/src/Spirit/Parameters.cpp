@@ -133,6 +133,28 @@ void Parameters_Set_LLG_Output_Configuration( State *state, bool configuration_s
     }
 }
 
+void Parameters_Set_LLG_Output_Trajectory( State *state, bool trajectory, int n_bits,
+                                           int idx_image, int idx_chain ) noexcept
+{
+    try
+    {
+        std::shared_ptr<Data::Spin_System> image;
+        std::shared_ptr<Data::Spin_System_Chain> chain;
+
+        // Fetch correct indices and pointers
+        from_indices( state, idx_image, idx_chain, image, chain );
+
+        image->Lock();
+        image->llg_parameters->output_trajectory = trajectory;
+        image->llg_parameters->output_trajectory_bits = n_bits;
+        image->Unlock();
+    }
+    catch( ... )
+    {
+        spirit_handle_exception_api(idx_image, idx_chain);
+    }
+}
+
 void Parameters_Set_LLG_N_Iterations( State *state, int n_iterations, int n_iterations_log, 
                                       int idx_image, int idx_chain ) noexcept
 {
@@ -156,6 +178,48 @@ void Parameters_Set_LLG_N_Iterations( State *state, int n_iterations, int n_iter
 }
 
 
+void Parameters_Set_LLG_N_Iterations_Observables( State *state, int n_iterations_observables,
+                                                  int idx_image, int idx_chain ) noexcept
+{
+    try
+    {
+        std::shared_ptr<Data::Spin_System> image;
+        std::shared_ptr<Data::Spin_System_Chain> chain;
+
+        // Fetch correct indices and pointers
+        from_indices( state, idx_image, idx_chain, image, chain );
+
+        image->Lock();
+        image->llg_parameters->n_iterations_observables = n_iterations_observables;
+        image->Unlock();
+    }
+    catch( ... )
+    {
+        spirit_handle_exception_api(idx_image, idx_chain);
+    }
+}
+
+void Parameters_Set_LLG_N_Iterations_Amortize( State *state, int n_iterations_amortize,
+                                                int idx_image, int idx_chain ) noexcept
+{
+    try
+    {
+        std::shared_ptr<Data::Spin_System> image;
+        std::shared_ptr<Data::Spin_System_Chain> chain;
+
+        // Fetch correct indices and pointers
+        from_indices( state, idx_image, idx_chain, image, chain );
+
+        image->Lock();
+        image->llg_parameters->n_iterations_amortize = n_iterations_amortize;
+        image->Unlock();
+    }
+    catch( ... )
+    {
+        spirit_handle_exception_api(idx_image, idx_chain);
+    }
+}
+
 // Set LLG Simulation Parameters
 void Parameters_Set_LLG_Direct_Minimization( State *state, bool direct, int idx_image, int idx_chain ) noexcept
 {
@@ -476,6 +540,28 @@ void Parameters_Set_MC_Output_Configuration( State *state, bool configuration_st
     }
 }
 
+void Parameters_Set_MC_Output_Trajectory( State *state, bool trajectory, int n_bits,
+                                          int idx_image, int idx_chain ) noexcept
+{
+    try
+    {
+        std::shared_ptr<Data::Spin_System> image;
+        std::shared_ptr<Data::Spin_System_Chain> chain;
+
+        // Fetch correct indices and pointers
+        from_indices( state, idx_image, idx_chain, image, chain );
+
+        image->Lock();
+        image->mc_parameters->output_trajectory = trajectory;
+        image->mc_parameters->output_trajectory_bits = n_bits;
+        image->Unlock();
+    }
+    catch( ... )
+    {
+        spirit_handle_exception_api(idx_image, idx_chain);
+    }
+}
+
 void Parameters_Set_MC_N_Iterations( State *state, int n_iterations, int n_iterations_log, 
                                      int idx_image, int idx_chain ) noexcept
 {
@@ -498,6 +584,27 @@ void Parameters_Set_MC_N_Iterations( State *state, int n_iterations, int n_itera
     }
 }
 
+void Parameters_Set_MC_N_Iterations_Amortize( State *state, int n_iterations_amortize,
+                                               int idx_image, int idx_chain ) noexcept
+{
+    try
+    {
+        std::shared_ptr<Data::Spin_System> image;
+        std::shared_ptr<Data::Spin_System_Chain> chain;
+
+        // Fetch correct indices and pointers
+        from_indices( state, idx_image, idx_chain, image, chain );
+
+        image->Lock();
+        image->mc_parameters->n_iterations_amortize = n_iterations_amortize;
+        image->Unlock();
+    }
+    catch( ... )
+    {
+        spirit_handle_exception_api(idx_image, idx_chain);
+    }
+}
+
 
 // Set MG Simulation Parameters
 void Parameters_Set_MC_Temperature( State *state, float T, int idx_image, int idx_chain ) noexcept
@@ -550,6 +657,64 @@ void Parameters_Set_MC_Acceptance_Ratio( State *state, float ratio, int idx_imag
     }
 }
 
+void Parameters_Set_MC_Random_Sample( State *state, bool random_sample, int idx_image, int idx_chain ) noexcept
+{
+    try
+    {
+        std::shared_ptr<Data::Spin_System> image;
+        std::shared_ptr<Data::Spin_System_Chain> chain;
+
+        // Fetch correct indices and pointers
+        from_indices( state, idx_image, idx_chain, image, chain );
+
+        image->Lock();
+
+        image->mc_parameters->metropolis_random_sample = random_sample;
+
+        Log(Utility::Log_Level::Info, Utility::Log_Sender::API,
+            fmt::format("Set MC random sample to {}", random_sample), idx_image, idx_chain);
+
+        image->Unlock();
+    }
+    catch( ... )
+    {
+        spirit_handle_exception_api(idx_image, idx_chain);
+    }
+}
+
+void Parameters_Set_MC_Algorithm( State *state, int algorithm, int idx_image, int idx_chain ) noexcept
+{
+    try
+    {
+        std::shared_ptr<Data::Spin_System> image;
+        std::shared_ptr<Data::Spin_System_Chain> chain;
+
+        // Fetch correct indices and pointers
+        from_indices( state, idx_image, idx_chain, image, chain );
+
+        if( algorithm != MC_Algorithm_Metropolis && algorithm != MC_Algorithm_Heat_Bath )
+        {
+            Log(Utility::Log_Level::Warning, Utility::Log_Sender::API,
+                fmt::format("Unknown MC algorithm {}", algorithm), idx_image, idx_chain);
+            return;
+        }
+
+        image->Lock();
+
+        image->mc_parameters->algorithm = static_cast<Data::MC_Algorithm>(algorithm);
+
+        Log(Utility::Log_Level::Info, Utility::Log_Sender::API,
+            fmt::format("Set MC algorithm to {}", algorithm == MC_Algorithm_Heat_Bath ? "heat bath" : "Metropolis"),
+            idx_image, idx_chain);
+
+        image->Unlock();
+    }
+    catch( ... )
+    {
+        spirit_handle_exception_api(idx_image, idx_chain);
+    }
+}
+
 /*------------------------------------------------------------------------------------------------------ */
 /*---------------------------------- Set GNEB ---------------------------------------------------------- */
 /*------------------------------------------------------------------------------------------------------ */
@@ -699,6 +864,29 @@ void Parameters_Set_GNEB_N_Iterations( State *state, int n_iterations, int n_ite
     }
 }
 
+void Parameters_Set_GNEB_N_Iterations_Amortize( State *state, int n_iterations_amortize,
+                                                 int idx_chain ) noexcept
+{
+    int idx_image = -1;
+
+    try
+    {
+        std::shared_ptr<Data::Spin_System> image;
+        std::shared_ptr<Data::Spin_System_Chain> chain;
+
+        // Fetch correct indices and pointers
+        from_indices( state, idx_image, idx_chain, image, chain );
+
+        chain->Lock();
+        chain->gneb_parameters->n_iterations_amortize = n_iterations_amortize;
+        chain->Unlock();
+    }
+    catch( ... )
+    {
+        spirit_handle_exception_api(idx_image, idx_chain);
+    }
+}
+
 // Set GNEB Calculation Parameters
 void Parameters_Set_GNEB_Convergence(State *state, float convergence, int idx_image, int idx_chain) noexcept
 {
@@ -828,6 +1016,31 @@ void Parameters_Set_GNEB_N_Energy_Interpolations(State *state, int n, int idx_ch
     }
 }
 
+void Parameters_Set_GNEB_Threads_Per_Image(State *state, int n_threads, int idx_chain) noexcept
+{
+    int idx_image = -1;
+
+    try
+    {
+        std::shared_ptr<Data::Spin_System> image;
+        std::shared_ptr<Data::Spin_System_Chain> chain;
+
+        // Fetch correct indices and pointers
+        from_indices( state, idx_image, idx_chain, image, chain );
+
+        chain->Lock();
+        chain->gneb_parameters->n_threads_per_image = std::max(0, n_threads);
+        chain->Unlock();
+
+        Log(Utility::Log_Level::Info, Utility::Log_Sender::API,
+            fmt::format("Set GNEB threads per image = {}", std::max(0, n_threads)), idx_image, idx_chain);
+    }
+    catch( ... )
+    {
+        spirit_handle_exception_api(idx_image, idx_chain);
+    }
+}
+
 /*------------------------------------------------------------------------------------------------------ */
 /*---------------------------------- Get LLG ----------------------------------------------------------- */
 /*------------------------------------------------------------------------------------------------------ */
@@ -938,6 +1151,26 @@ void Parameters_Get_LLG_Output_Configuration( State *state, bool * configuration
     }
 }
 
+void Parameters_Get_LLG_Output_Trajectory( State *state, bool * trajectory, int * n_bits,
+                                           int idx_image, int idx_chain ) noexcept
+{
+    try
+    {
+        std::shared_ptr<Data::Spin_System> image;
+        std::shared_ptr<Data::Spin_System_Chain> chain;
+
+        // Fetch correct indices and pointers
+        from_indices( state, idx_image, idx_chain, image, chain );
+
+        *trajectory = image->llg_parameters->output_trajectory;
+        *n_bits = image->llg_parameters->output_trajectory_bits;
+    }
+    catch( ... )
+    {
+        spirit_handle_exception_api(idx_image, idx_chain);
+    }
+}
+
 void Parameters_Get_LLG_N_Iterations( State *state, int * iterations, int * iterations_log, 
                                       int idx_image, int idx_chain ) noexcept
 {
@@ -959,6 +1192,44 @@ void Parameters_Get_LLG_N_Iterations( State *state, int * iterations, int * iter
     }
 }
 
+int Parameters_Get_LLG_N_Iterations_Observables( State *state, int idx_image, int idx_chain ) noexcept
+{
+    try
+    {
+        std::shared_ptr<Data::Spin_System> image;
+        std::shared_ptr<Data::Spin_System_Chain> chain;
+
+        // Fetch correct indices and pointers
+        from_indices( state, idx_image, idx_chain, image, chain );
+
+        return (int)image->llg_parameters->n_iterations_observables;
+    }
+    catch( ... )
+    {
+        spirit_handle_exception_api(idx_image, idx_chain);
+        return 0;
+    }
+}
+
+int Parameters_Get_LLG_N_Iterations_Amortize( State *state, int idx_image, int idx_chain ) noexcept
+{
+    try
+    {
+        std::shared_ptr<Data::Spin_System> image;
+        std::shared_ptr<Data::Spin_System_Chain> chain;
+
+        // Fetch correct indices and pointers
+        from_indices( state, idx_image, idx_chain, image, chain );
+
+        return (int)image->llg_parameters->n_iterations_amortize;
+    }
+    catch( ... )
+    {
+        spirit_handle_exception_api(idx_image, idx_chain);
+        return 0;
+    }
+}
+
 // Get LLG Simulation Parameters
 bool Parameters_Get_LLG_Direct_Minimization(State *state, int idx_image, int idx_chain) noexcept
 {
@@ -1218,6 +1489,26 @@ void Parameters_Get_MC_Output_Configuration( State *state, bool * configuration_
     }
 }
 
+void Parameters_Get_MC_Output_Trajectory( State *state, bool * trajectory, int * n_bits,
+                                          int idx_image, int idx_chain ) noexcept
+{
+    try
+    {
+        std::shared_ptr<Data::Spin_System> image;
+        std::shared_ptr<Data::Spin_System_Chain> chain;
+
+        // Fetch correct indices and pointers
+        from_indices( state, idx_image, idx_chain, image, chain );
+
+        *trajectory = image->mc_parameters->output_trajectory;
+        *n_bits = image->mc_parameters->output_trajectory_bits;
+    }
+    catch( ... )
+    {
+        spirit_handle_exception_api(idx_image, idx_chain);
+    }
+}
+
 void Parameters_Get_MC_N_Iterations( State *state, int * iterations, int * iterations_log, 
                                      int idx_image, int idx_chain ) noexcept
 {
@@ -1239,6 +1530,25 @@ void Parameters_Get_MC_N_Iterations( State *state, int * iterations, int * itera
     }
 }
 
+int Parameters_Get_MC_N_Iterations_Amortize( State *state, int idx_image, int idx_chain ) noexcept
+{
+    try
+    {
+        std::shared_ptr<Data::Spin_System> image;
+        std::shared_ptr<Data::Spin_System_Chain> chain;
+
+        // Fetch correct indices and pointers
+        from_indices( state, idx_image, idx_chain, image, chain );
+
+        return (int)image->mc_parameters->n_iterations_amortize;
+    }
+    catch( ... )
+    {
+        spirit_handle_exception_api(idx_image, idx_chain);
+        return 0;
+    }
+}
+
 // Get MC Simulation Parameters
 float Parameters_Get_MC_Temperature(State *state, int idx_image, int idx_chain) noexcept
 {
@@ -1278,6 +1588,44 @@ float Parameters_Get_MC_Acceptance_Ratio(State *state, int idx_image, int idx_ch
     }
 }
 
+bool Parameters_Get_MC_Random_Sample(State *state, int idx_image, int idx_chain) noexcept
+{
+    try
+    {
+        std::shared_ptr<Data::Spin_System> image;
+        std::shared_ptr<Data::Spin_System_Chain> chain;
+
+        // Fetch correct indices and pointers
+        from_indices( state, idx_image, idx_chain, image, chain );
+
+        return image->mc_parameters->metropolis_random_sample;
+    }
+    catch( ... )
+    {
+        spirit_handle_exception_api(idx_image, idx_chain);
+        return false;
+    }
+}
+
+int Parameters_Get_MC_Algorithm(State *state, int idx_image, int idx_chain) noexcept
+{
+    try
+    {
+        std::shared_ptr<Data::Spin_System> image;
+        std::shared_ptr<Data::Spin_System_Chain> chain;
+
+        // Fetch correct indices and pointers
+        from_indices( state, idx_image, idx_chain, image, chain );
+
+        return static_cast<int>(image->mc_parameters->algorithm);
+    }
+    catch( ... )
+    {
+        spirit_handle_exception_api(idx_image, idx_chain);
+        return MC_Algorithm_Metropolis;
+    }
+}
+
 /*------------------------------------------------------------------------------------------------------ */
 /*---------------------------------- Get GNEB ----------------------------------------------------------- */
 /*------------------------------------------------------------------------------------------------------ */
@@ -1418,6 +1766,27 @@ void Parameters_Get_GNEB_N_Iterations( State *state, int * iterations, int * ite
     }
 }
 
+int Parameters_Get_GNEB_N_Iterations_Amortize( State *state, int idx_chain ) noexcept
+{
+    int idx_image = -1;
+
+    try
+    {
+        std::shared_ptr<Data::Spin_System> image;
+        std::shared_ptr<Data::Spin_System_Chain> chain;
+
+        // Fetch correct indices and pointers
+        from_indices( state, idx_image, idx_chain, image, chain );
+
+        return (int)chain->gneb_parameters->n_iterations_amortize;
+    }
+    catch( ... )
+    {
+        spirit_handle_exception_api(idx_image, idx_chain);
+        return 0;
+    }
+}
+
 // Get GNEB Calculation Parameters
 float Parameters_Get_GNEB_Convergence(State *state, int idx_image, int idx_chain) noexcept
 {
@@ -1498,4 +1867,25 @@ int Parameters_Get_GNEB_N_Energy_Interpolations(State *state, int idx_chain) noe
         spirit_handle_exception_api(idx_image, idx_chain);
         return 0;
     }
+}
+
+int Parameters_Get_GNEB_Threads_Per_Image(State *state, int idx_chain) noexcept
+{
+    int idx_image = -1;
+
+    try
+    {
+        std::shared_ptr<Data::Spin_System> image;
+        std::shared_ptr<Data::Spin_System_Chain> chain;
+
+        // Fetch correct indices and pointers
+        from_indices( state, idx_image, idx_chain, image, chain );
+
+        return chain->gneb_parameters->n_threads_per_image;
+    }
+    catch( ... )
+    {
+        spirit_handle_exception_api(idx_image, idx_chain);
+        return 0;
+    }
 }
\ No newline at end of file
@@ -15,15 +15,35 @@ void Quantity_Get_Magnetization(State * state,  float m[3], int idx_image, int i
         // Fetch correct indices and pointers
         from_indices( state, idx_image, idx_chain, image, chain );
         
-        // image->Lock(); // Mutex locks in these functions may cause problems with the performance of UIs
-        
-        auto mag = Engine::Vectormath::Magnetization(*image->spins);
-        image->M = Vector3{ mag[0], mag[1], mag[2] };
+        // While a simulation is running, the magnetization is calculated from the last published
+        //      snapshot, so that the caller does not wait for the running method
+        bool running = image->iteration_allowed || chain->iteration_allowed ||
+                        state->collection->iteration_allowed;
+        auto snapshot = running ? image->GetSnapshot() : nullptr;
+        if ( snapshot )
+        {
+            auto M = Engine::Vectormath::Magnetization(snapshot->spins);
+            for (int i=0; i<3; ++i)
+                m[i] = (float)M[i];
+            return;
+        }
 
-        // image->Unlock();
+        // Otherwise it is only recalculated if the spins changed
+        Vector3 M{0, 0, 0};
+        image->Lock();
+        try
+        {
+            image->UpdateMagnetizationIfOutdated();
+            M = image->M;
+        }
+        catch( ... )
+        {
+            spirit_handle_exception_api(idx_image, idx_chain);
+        }
+        image->Unlock();
         
         for (int i=0; i<3; ++i) 
-            m[i] = (float)mag[i];
+            m[i] = (float)M[i];
     }
     catch( ... )
     {
@@ -8,8 +8,40 @@
 #include <engine/Method_GNEB.hpp>
 #include <engine/Method_MMF.hpp>
 #include <utility/Logging.hpp>
+#include <utility/Timing.hpp>
 #include <utility/Exception.hpp>
 
+#include <algorithm>
+#include <thread>
+#include <chrono>
+
+
+// Prepare the method stored in the State for a further run, if it is of the requested kind
+// and can continue on the given systems. Its solver state then persists across the calls.
+bool Resume_Method( std::shared_ptr<Engine::Method> method, const std::string & method_type, 
+                    const std::string & solver_type, 
+                    const std::vector<std::shared_ptr<Data::Spin_System>> & systems )
+{
+    if ( !method || method->Name() != method_type )
+        return false;
+    // The MC method does not use a solver
+    if ( method_type != "MC" && method->SolverName() != solver_type )
+        return false;
+    if ( !method->Resumable(systems) )
+        return false;
+
+    method->Resume();
+    return true;
+}
+
+// Wait until a stopped method has returned from `Iterate`. It may still be writing its final
+// output, and it resets the iteration_allowed flags of its systems at the end, which would also
+// stop a run that was started on them in the meantime.
+void Wait_For_Method( std::shared_ptr<Engine::Method> method )
+{
+    while ( method && method->Running() )
+        std::this_thread::sleep_for( std::chrono::milliseconds(1) );
+}
 
 bool Get_Method( State *state, const char * c_method_type, const char * c_solver_type, 
                  int n_iterations, int n_iterations_log, int idx_image, int idx_chain, 
@@ -36,6 +68,8 @@ bool Get_Method( State *state, const char * c_method_type, const char * c_solver
                 solver = Engine::Solver::NCG;
             else if (solver_type == "VP")
                 solver = Engine::Solver::VP;
+            else if (solver_type == "BFGS")
+                solver = Engine::Solver::BFGS;
             else
             {
                 Log( Utility::Log_Level::Error, Utility::Log_Sender::API, "Invalid Solver selected: " + 
@@ -52,34 +86,38 @@ bool Get_Method( State *state, const char * c_method_type, const char * c_solver
         from_indices( state, idx_image, idx_chain, image, chain );
         
         // Determine wether to stop or start a simulation
+        //      The flags are atomic and checked by the running method in every iteration, so
+        //      they are reset without waiting for the lock, which is held for blocks of iterations
         if (image->iteration_allowed)
         {
             // Currently iterating image, so we stop
-            image->Lock();
             image->iteration_allowed = false;
-            image->Unlock();
             return false;
         }
         else if (chain->iteration_allowed)
         {
             // Currently iterating chain, so we stop
-            chain->Lock();
             chain->iteration_allowed = false;
-            chain->Unlock();
             return false;
         }
         else if (state->collection->iteration_allowed)
         {
             // Currently iterating collection, so we stop
-            // collection->Lock();
             state->collection->iteration_allowed = false;
-            // collection->Unlock();
             return false;
         }
         else
         {
             // ------ Nothing is iterating, so we could start a simulation ------
 
+            // The method which was last run in the same place may still be finishing
+            if (method_type == "LLG" || method_type == "MC")
+                Wait_For_Method(state->method_image[idx_chain][idx_image]);
+            else if (method_type == "GNEB")
+                Wait_For_Method(state->method_chain[idx_chain]);
+            else if (method_type == "MMF")
+                Wait_For_Method(state->method_collection);
+
             // Lock the chain in order to prevent unexpected things
             chain->Lock();
 
@@ -90,7 +128,9 @@ bool Get_Method( State *state, const char * c_method_type, const char * c_solver
                 if (n_iterations > 0) image->llg_parameters->n_iterations = n_iterations;
                 if (n_iterations_log > 0) image->llg_parameters->n_iterations_log = n_iterations_log;
 
-                if (solver == Engine::Solver::SIB)
+                if (Resume_Method(state->method_image[idx_chain][idx_image], method_type, solver_type, { image }))
+                    method = state->method_image[idx_chain][idx_image];
+                else if (solver == Engine::Solver::SIB)
                     method = std::shared_ptr<Engine::Method>( 
                         new Engine::Method_LLG<Engine::Solver::SIB>( image, idx_image, idx_chain ) );
                 else if (solver == Engine::Solver::Heun)
@@ -105,12 +145,21 @@ bool Get_Method( State *state, const char * c_method_type, const char * c_solver
                 else if (solver == Engine::Solver::VP)
                     method = std::shared_ptr<Engine::Method>(
                         new Engine::Method_LLG<Engine::Solver::VP>( image, idx_image, idx_chain ) );
+                else if (solver == Engine::Solver::BFGS)
+                    method = std::shared_ptr<Engine::Method>(
+                        new Engine::Method_LLG<Engine::Solver::BFGS>( image, idx_image, idx_chain ) );
             }
             else if (method_type == "MC")
             {
                 image->iteration_allowed = true;
-                method = std::shared_ptr<Engine::Method>(
-                    new Engine::Method_MC( image, idx_image, idx_chain ) );
+                if (n_iterations > 0) image->mc_parameters->n_iterations = n_iterations;
+                if (n_iterations_log > 0) image->mc_parameters->n_iterations_log = n_iterations_log;
+
+                if (Resume_Method(state->method_image[idx_chain][idx_image], method_type, solver_type, { image }))
+                    method = state->method_image[idx_chain][idx_image];
+                else
+                    method = std::shared_ptr<Engine::Method>(
+                        new Engine::Method_MC( image, idx_image, idx_chain ) );
             }
             else if (method_type == "GNEB")
             {
@@ -138,7 +187,9 @@ bool Get_Method( State *state, const char * c_method_type, const char * c_solver
                     if (n_iterations_log > 0) 
                         chain->gneb_parameters->n_iterations_log = n_iterations_log;
 
-                    if (solver == Engine::Solver::SIB)
+                    if (Resume_Method(state->method_chain[idx_chain], method_type, solver_type, chain->images))
+                        method = state->method_chain[idx_chain];
+                    else if (solver == Engine::Solver::SIB)
                         method = std::shared_ptr<Engine::Method>(
                             new Engine::Method_GNEB<Engine::Solver::SIB>( chain, idx_chain ) );
                     else if (solver == Engine::Solver::Heun)
@@ -153,15 +204,13 @@ bool Get_Method( State *state, const char * c_method_type, const char * c_solver
                     else if (solver == Engine::Solver::VP)
                         method = std::shared_ptr<Engine::Method>(
                             new Engine::Method_GNEB<Engine::Solver::VP>( chain, idx_chain ) );
+                    else if (solver == Engine::Solver::BFGS)
+                        method = std::shared_ptr<Engine::Method>(
+                            new Engine::Method_GNEB<Engine::Solver::BFGS>( chain, idx_chain ) );
                 }
             }
             else if (method_type == "MMF")
             {
-                Log( Utility::Log_Level::Error, Utility::Log_Sender::API, 
-                        "MMF is not yet implemented!" );
-                chain->Unlock();
-                return false;
-                
                 if (Simulation_Running_Anywhere_Collection(state))
                 {
                     Log( Utility::Log_Level::Error, Utility::Log_Sender::API, 
@@ -178,7 +227,14 @@ bool Get_Method( State *state, const char * c_method_type, const char * c_solver
                     if (n_iterations_log > 0) 
                         state->collection->parameters->n_iterations_log = n_iterations_log;
 
-                    if (solver == Engine::Solver::SIB)
+                    // The MMF method iterates the last image of each chain
+                    std::vector<std::shared_ptr<Data::Spin_System>> systems(0);
+                    for (auto& c : state->collection->chains)
+                        systems.push_back(c->images.back());
+
+                    if (Resume_Method(state->method_collection, method_type, solver_type, systems))
+                        method = state->method_collection;
+                    else if (solver == Engine::Solver::SIB)
                         method = std::shared_ptr<Engine::Method>(
                             new Engine::Method_MMF<Engine::Solver::SIB>( state->collection, idx_chain ) );
                     else if (solver == Engine::Solver::Heun)
@@ -193,6 +249,9 @@ bool Get_Method( State *state, const char * c_method_type, const char * c_solver
                     else if (solver == Engine::Solver::VP)
                         method = std::shared_ptr<Engine::Method>(
                             new Engine::Method_MMF<Engine::Solver::VP>( state->collection, idx_chain ) );
+                    else if (solver == Engine::Solver::BFGS)
+                        method = std::shared_ptr<Engine::Method>(
+                            new Engine::Method_MMF<Engine::Solver::BFGS>( state->collection, idx_chain ) );
                 }
             }
             else
@@ -270,34 +329,22 @@ void Simulation_Stop_All(State *state) noexcept
 {
     try
     {
+        // The flags are atomic, so they are reset without waiting for the running methods
+
         // MMF
-        // collection->Lock();
         state->collection->iteration_allowed = false;
-        // collection->Unlock();
 
         // GNEB
-        state->active_chain->Lock();
         state->active_chain->iteration_allowed = false;
-        state->active_chain->Unlock();
         for (int i=0; i<state->noc; ++i)
-        {
-            state->collection->chains[i]->Lock();
             state->collection->chains[i]->iteration_allowed = false;
-            state->collection->chains[i]->Unlock();
-        }
 
         // LLG
-        state->active_image->Lock();
         state->active_image->iteration_allowed = false;
-        state->active_image->Unlock();
         for (int ichain=0; ichain<state->noc; ++ichain)
         {
             for (int img = 0; img < state->collection->chains[ichain]->noi; ++img)
-            {
-                state->collection->chains[ichain]->images[img]->Lock();
                 state->collection->chains[ichain]->images[img]->iteration_allowed = false;
-                state->collection->chains[ichain]->images[img]->Unlock();
-            }
         }
     }
     catch( ... )
@@ -635,3 +682,50 @@ bool Simulation_Running_Anywhere_Collection(State *state) noexcept
         return false;        
     }
 }
+
+
+int Simulation_Get_N_Timings(State *state) noexcept
+{
+    try
+    {
+        return Utility::Timing::Get_Counters().size();
+    }
+    catch( ... )
+    {
+        spirit_handle_exception_api(-1, -1);
+        return 0;
+    }
+}
+
+int Simulation_Get_Timings(State *state, const char ** names, float * seconds, int * calls, int n) noexcept
+{
+    try
+    {
+        auto counters = Utility::Timing::Get_Counters();
+        int n_timings = std::min(n, (int)counters.size());
+        for (int i = 0; i < n_timings; ++i)
+        {
+            names[i]   = counters[i].name;
+            seconds[i] = (float)counters[i].seconds;
+            calls[i]   = (int)counters[i].calls;
+        }
+        return n_timings;
+    }
+    catch( ... )
+    {
+        spirit_handle_exception_api(-1, -1);
+        return 0;
+    }
+}
+
+void Simulation_Reset_Timings(State *state) noexcept
+{
+    try
+    {
+        Utility::Timing::Reset_Counters();
+    }
+    catch( ... )
+    {
+        spirit_handle_exception_api(-1, -1);
+    }
+}
@@ -256,6 +256,7 @@ void State_Delete(State * state) noexcept
         
         // Final file writing (input, positions, neighbours)
         Save_Initial_Final( state, false );
+        IO::Flush_Output();
 
         // Timing
         auto now = system_clock::now();
@@ -4,6 +4,8 @@
 #include <utility/Logging.hpp>
 #include <utility/Exception.hpp>
 
+#include <algorithm>
+
 int System_Get_Index(State * state) noexcept
 {
     try
@@ -46,6 +48,8 @@ scalar * System_Get_Spin_Directions(State * state, int idx_image, int idx_chain)
         // Fetch correct indices and pointers
         from_indices( state, idx_image, idx_chain, image, chain );
         
+        // The spins may be written through the returned pointer
+        image->SpinsChanged();
         return (scalar *)(*image->spins)[0].data();
     }
     catch( ... )
@@ -55,6 +59,90 @@ scalar * System_Get_Spin_Directions(State * state, int idx_image, int idx_chain)
     }
 }
 
+void System_Spins_Changed(State * state, int idx_image, int idx_chain) noexcept
+{
+    try
+    {
+        std::shared_ptr<Data::Spin_System> image;
+        std::shared_ptr<Data::Spin_System_Chain> chain;
+        
+        // Fetch correct indices and pointers
+        from_indices( state, idx_image, idx_chain, image, chain );
+        
+        image->SpinsChanged();
+    }
+    catch( ... )
+    {
+        spirit_handle_exception_api(idx_image, idx_chain);
+    }
+}
+
+int System_Get_Spin_Snapshot(State * state, scalar * spins, int idx_image, int idx_chain) noexcept
+{
+    try
+    {
+        std::shared_ptr<Data::Spin_System> image;
+        std::shared_ptr<Data::Spin_System_Chain> chain;
+        
+        // Fetch correct indices and pointers
+        from_indices( state, idx_image, idx_chain, image, chain );
+
+        // Without a running simulation, the snapshot can be updated without waiting
+        bool running = image->iteration_allowed || chain->iteration_allowed ||
+                        state->collection->iteration_allowed;
+        if ( !running && image->SnapshotOutdated() )
+        {
+            image->Lock();
+            try
+            {
+                image->PublishSnapshot(0);
+            }
+            catch( ... )
+            {
+                spirit_handle_exception_api(idx_image, idx_chain);
+            }
+            image->Unlock();
+        }
+
+        auto snapshot = image->GetSnapshot();
+        if ( !snapshot )
+            return -1;
+
+        int nos = std::min(image->nos, (int)snapshot->spins.size());
+        for (int i=0; i<nos; ++i)
+        {
+            for (int dim=0; dim<3; ++dim)
+                spins[3*i+dim] = snapshot->spins[i][dim];
+        }
+        return snapshot->iteration;
+    }
+    catch( ... )
+    {
+        spirit_handle_exception_api(idx_image, idx_chain);
+        return -1;
+    }
+}
+
+void System_Set_Snapshot_Interval(State * state, int n_iterations, int idx_image, int idx_chain) noexcept
+{
+    try
+    {
+        std::shared_ptr<Data::Spin_System> image;
+        std::shared_ptr<Data::Spin_System_Chain> chain;
+        
+        // Fetch correct indices and pointers
+        from_indices( state, idx_image, idx_chain, image, chain );
+
+        image->Lock();
+        image->n_iterations_snapshot = n_iterations;
+        image->Unlock();
+    }
+    catch( ... )
+    {
+        spirit_handle_exception_api(idx_image, idx_chain);
+    }
+}
+
 scalar * System_Get_Effective_Field(State * state, int idx_image, int idx_chain) noexcept
 {
     try
@@ -64,6 +152,25 @@ scalar * System_Get_Effective_Field(State * state, int idx_image, int idx_chain)
         
         // Fetch correct indices and pointers
         from_indices( state, idx_image, idx_chain, image, chain );
+
+        // While a simulation is running, the effective field would have to be calculated with the
+        //      work buffers of the running method, so the last calculated field is returned
+        bool running = image->iteration_allowed || chain->iteration_allowed ||
+                        state->collection->iteration_allowed;
+        if ( running )
+            return image->effective_field[0].data();
+
+        // Otherwise it is only recalculated if the spins changed
+        image->Lock();
+        try
+        {
+            image->UpdateEffectiveFieldIfOutdated();
+        }
+        catch( ... )
+        {
+            spirit_handle_exception_api(idx_image, idx_chain);
+        }
+        image->Unlock();
         return image->effective_field[0].data();
     }
     catch( ... )
@@ -101,8 +208,29 @@ float System_Get_Energy(State * state, int idx_image, int idx_chain) noexcept
         
         // Fetch correct indices and pointers
         from_indices( state, idx_image, idx_chain, image, chain );
-        
-        return (float)image->E;
+
+        // While a simulation is running, the energy which was published with the last snapshot
+        //      is returned, so that the caller does not wait for the running method
+        bool running = image->iteration_allowed || chain->iteration_allowed ||
+                        state->collection->iteration_allowed;
+        auto snapshot = running ? image->GetSnapshot() : nullptr;
+        if ( snapshot )
+            return (float)snapshot->energy;
+
+        // Otherwise it is only recalculated if the spins changed
+        scalar E = 0;
+        image->Lock();
+        try
+        {
+            image->UpdateEnergyIfOutdated();
+            E = image->E;
+        }
+        catch( ... )
+        {
+            spirit_handle_exception_api(idx_image, idx_chain);
+        }
+        image->Unlock();
+        return (float)E;
     }
     catch( ... )
     {
@@ -120,11 +248,21 @@ void System_Get_Energy_Array(State * state, float * energies, int idx_image, int
         
         // Fetch correct indices and pointers
         from_indices( state, idx_image, idx_chain, image, chain );
-        
-        for (unsigned int i=0; i<image->E_array.size(); ++i)
+
+        image->Lock();
+        try
+        {
+            image->UpdateEnergyIfOutdated();
+            for (unsigned int i=0; i<image->E_array.size(); ++i)
+            {
+                energies[i] = (float)image->E_array[i].second;
+            }
+        }
+        catch( ... )
         {
-            energies[i] = (float)image->E_array[i].second;
+            spirit_handle_exception_api(idx_image, idx_chain);
         }
+        image->Unlock();
     }
     catch( ... )
     {
@@ -142,14 +280,28 @@ void System_Print_Energy_Array(State * state, int idx_image, int idx_chain) noex
         // Fetch correct indices and pointers
         from_indices( state, idx_image, idx_chain, image, chain );
         
+        scalar E = 0;
+        std::vector<std::pair<std::string, scalar>> E_array;
+        image->Lock();
+        try
+        {
+            image->UpdateEnergyIfOutdated();
+            E = image->E;
+            E_array = image->E_array;
+        }
+        catch( ... )
+        {
+            spirit_handle_exception_api(idx_image, idx_chain);
+        }
+        image->Unlock();
         scalar nd = 1/(scalar)image->nos;
 
-        std::cerr << "E_tot = " << image->E*nd << "  ||  ";
+        std::cerr << "E_tot = " << E*nd << "  ||  ";
 
-        for (unsigned int i=0; i<image->E_array.size(); ++i)
+        for (unsigned int i=0; i<E_array.size(); ++i)
         {
-            std::cerr << image->E_array[i].first << " = " << image->E_array[i].second*nd;
-            if (i < image->E_array.size()-1) std::cerr << "  |  ";
+            std::cerr << E_array[i].first << " = " << E_array[i].second*nd;
+            if (i < E_array.size()-1) std::cerr << "  |  ";
         }
         std::cerr << std::endl;
     }
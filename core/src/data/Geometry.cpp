@@ -43,10 +43,6 @@ namespace Data
 
         // Calculate the type of geometry
         this->calculateGeometryType();
-
-        // For updates of triangulation and tetrahedra
-        this->last_update_n_cell_step = -1;
-        this->last_update_n_cells = intfield(3, -1);
     }
 
 
@@ -102,6 +98,14 @@ namespace Data
 
     const std::vector<triangle_t>& Geometry::triangulation(int n_cell_step)
     {
+        std::lock_guard<std::mutex> guard(this->cache.mutex);
+
+        // Check if the triangulation for this n_cell_step has already been calculated
+        auto cached = this->cache.triangulations.find(n_cell_step);
+        if (cached != this->cache.triangulations.end())
+            return cached->second;
+        auto& _triangulation = this->cache.triangulations[n_cell_step];
+
         // Only every n_cell_step'th cell is used. So we check if there is still enough cells in all
         //      directions. Note: when visualising, 'n_cell_step' can be used to e.g. olny visualise
         //      every 2nd spin.
@@ -109,159 +113,130 @@ namespace Data
              (n_cells[1]/n_cell_step < 2 && n_cells[1] > 1) ||
              (n_cells[2]/n_cell_step < 2 && n_cells[2] > 1) )
         {
-            _triangulation.clear();
             return _triangulation;
         }
 
         // 2D: triangulation
         if (this->dimensionality == 2)
         {
-            // Check if the tetrahedra for this combination of n_cells and n_cell_step has already been calculated
-            if (this->last_update_n_cell_step != n_cell_step ||
-                this->last_update_n_cells[0]  != n_cells[0]  ||
-                this->last_update_n_cells[1]  != n_cells[1]  ||
-                this->last_update_n_cells[2]  != n_cells[2]  )
-            {
-                this->last_update_n_cell_step = n_cell_step;
-                this->last_update_n_cells[0]  = n_cells[0];
-                this->last_update_n_cells[1]  = n_cells[1];
-                this->last_update_n_cells[2]  = n_cells[2];
-                
-                _triangulation.clear();
-
-                std::vector<vector2_t> points;
-                points.resize(positions.size());
+            std::vector<vector2_t> points;
+            points.resize(positions.size());
 
-                int icell = 0, idx;
-                for (int cell_c=0; cell_c<n_cells[2]; cell_c+=n_cell_step)
+            int icell = 0, idx;
+            for (int cell_c=0; cell_c<n_cells[2]; cell_c+=n_cell_step)
+            {
+                for (int cell_b=0; cell_b<n_cells[1]; cell_b+=n_cell_step)
                 {
-                    for (int cell_b=0; cell_b<n_cells[1]; cell_b+=n_cell_step)
+                    for (int cell_a=0; cell_a<n_cells[0]; cell_a+=n_cell_step)
                     {
-                        for (int cell_a=0; cell_a<n_cells[0]; cell_a+=n_cell_step)
+                        for (int ibasis=0; ibasis < n_cell_atoms; ++ibasis)
                         {
-                            for (int ibasis=0; ibasis < n_cell_atoms; ++ibasis)
-                            {
-                                idx = ibasis + n_cell_atoms*cell_a + n_cell_atoms*n_cells[0]*cell_b + n_cell_atoms*n_cells[0]*n_cells[1]*cell_c;
-                                points[icell].x = positions[idx][0];
-                                points[icell].y = positions[idx][1];
-                                ++icell;
-                            }
+                            idx = ibasis + n_cell_atoms*cell_a + n_cell_atoms*n_cells[0]*cell_b + n_cell_atoms*n_cells[0]*n_cells[1]*cell_c;
+                            points[icell].x = positions[idx][0];
+                            points[icell].y = positions[idx][1];
+                            ++icell;
                         }
                     }
                 }
-                _triangulation = compute_delaunay_triangulation_2D(points);
             }
+            _triangulation = compute_delaunay_triangulation_2D(points);
         }// endif 2D
         // 0D, 1D and 3D give no triangulation
-        else
-        {
-            _triangulation.clear();
-        }
         return _triangulation;
     }
 
     const std::vector<tetrahedron_t>& Geometry::tetrahedra(int n_cell_step)
     {
+        std::lock_guard<std::mutex> guard(this->cache.mutex);
+
+        // Check if the tetrahedra for this n_cell_step have already been calculated
+        auto cached = this->cache.tetrahedra.find(n_cell_step);
+        if (cached != this->cache.tetrahedra.end())
+            return cached->second;
+        auto& _tetrahedra = this->cache.tetrahedra[n_cell_step];
+
         // Only every n_cell_step'th cell is used. So we check if there is still enough cells in all
         //      directions. Note: when visualising, 'n_cell_step' can be used to e.g. olny visualise
         //      every 2nd spin.
         if (n_cells[0]/n_cell_step < 2 || n_cells[1]/n_cell_step < 2 || n_cells[2]/n_cell_step < 2)
         {
-            _tetrahedra.clear();
             return _tetrahedra;
         }
 
         // 3D: Tetrahedra
         if (this->dimensionality == 3)
         {
-            // Check if the tetrahedra for this combination of n_cells and n_cell_step has already been calculated
-            if (this->last_update_n_cell_step != n_cell_step ||
-                this->last_update_n_cells[0]  != n_cells[0]  ||
-                this->last_update_n_cells[1]  != n_cells[1]  ||
-                this->last_update_n_cells[2]  != n_cells[2]  )
-            {
-                this->last_update_n_cell_step = n_cell_step;
-                this->last_update_n_cells[0]  = n_cells[0];
-                this->last_update_n_cells[1]  = n_cells[1];
-                this->last_update_n_cells[2]  = n_cells[2];
-
-                // If we have only one spin in the basis our lattice is a simple regular geometry
-                bool is_simple_regular_geometry = n_cell_atoms == 1;
+            // If we have only one spin in the basis our lattice is a simple regular geometry
+            bool is_simple_regular_geometry = n_cell_atoms == 1;
 
-                // If we have a simple regular geometry everything can be calculated by hand
-                if (is_simple_regular_geometry)
+            // If we have a simple regular geometry everything can be calculated by hand
+            if (is_simple_regular_geometry)
+            {
+                int cell_indices[] = {
+                    0, 1, 5, 3,
+                    1, 3, 2, 5,
+                    3, 2, 5, 6,
+                    7, 6, 5, 3,
+                    4, 7, 5, 3,
+                    0, 4, 3, 5
+                    };
+                int x_offset = 1;
+                int y_offset = n_cells[0]/n_cell_step;
+                int z_offset = n_cells[0]/n_cell_step*n_cells[1]/n_cell_step;
+                int offsets[] = {
+                    0, x_offset, x_offset+y_offset, y_offset,
+                    z_offset, x_offset+z_offset, x_offset+y_offset+z_offset, y_offset+z_offset
+                    };
+            
+                for (int ix = 0; ix < (n_cells[0]-1)/n_cell_step; ix++)
                 {
-                    _tetrahedra.clear();
-                    int cell_indices[] = {
-                        0, 1, 5, 3,
-                        1, 3, 2, 5,
-                        3, 2, 5, 6,
-                        7, 6, 5, 3,
-                        4, 7, 5, 3,
-                        0, 4, 3, 5
-                        };
-                    int x_offset = 1;
-                    int y_offset = n_cells[0]/n_cell_step;
-                    int z_offset = n_cells[0]/n_cell_step*n_cells[1]/n_cell_step;
-                    int offsets[] = {
-                        0, x_offset, x_offset+y_offset, y_offset,
-                        z_offset, x_offset+z_offset, x_offset+y_offset+z_offset, y_offset+z_offset
-                        };
-                
-                    for (int ix = 0; ix < (n_cells[0]-1)/n_cell_step; ix++)
+                    for (int iy = 0; iy < (n_cells[1]-1)/n_cell_step; iy++)
                     {
-                        for (int iy = 0; iy < (n_cells[1]-1)/n_cell_step; iy++)
+                        for (int iz = 0; iz < (n_cells[2]-1)/n_cell_step; iz++)
                         {
-                            for (int iz = 0; iz < (n_cells[2]-1)/n_cell_step; iz++)
+                            int base_index = ix*x_offset+iy*y_offset+iz*z_offset;
+                            for (int j = 0; j < 6; j++)
                             {
-                                int base_index = ix*x_offset+iy*y_offset+iz*z_offset;
-                                for (int j = 0; j < 6; j++)
+                                tetrahedron_t tetrahedron;
+                                for (int k = 0; k < 4; k++)
                                 {
-                                    tetrahedron_t tetrahedron;
-                                    for (int k = 0; k < 4; k++)
-                                    {
-                                        int index = base_index + offsets[cell_indices[j*4+k]];
-                                        tetrahedron[k] = index;
-                                    }
-                                    _tetrahedra.push_back(tetrahedron);
+                                    int index = base_index + offsets[cell_indices[j*4+k]];
+                                    tetrahedron[k] = index;
                                 }
+                                _tetrahedra.push_back(tetrahedron);
                             }
                         }
                     }
                 }
-                // For general basis cells we calculate the Delaunay tetrahedra
-                else 
-                {
-                    std::vector<vector3_t> points;
-                    points.resize(positions.size());
+            }
+            // For general basis cells we calculate the Delaunay tetrahedra
+            else 
+            {
+                std::vector<vector3_t> points;
+                points.resize(positions.size());
 
-                    int icell = 0, idx;
-                    for (int cell_c=0; cell_c<n_cells[2]; cell_c+=n_cell_step)
+                int icell = 0, idx;
+                for (int cell_c=0; cell_c<n_cells[2]; cell_c+=n_cell_step)
+                {
+                    for (int cell_b=0; cell_b<n_cells[1]; cell_b+=n_cell_step)
                     {
-                        for (int cell_b=0; cell_b<n_cells[1]; cell_b+=n_cell_step)
+                        for (int cell_a=0; cell_a<n_cells[0]; cell_a+=n_cell_step)
                         {
-                            for (int cell_a=0; cell_a<n_cells[0]; cell_a+=n_cell_step)
+                            for (int ibasis=0; ibasis < n_cell_atoms; ++ibasis)
                             {
-                                for (int ibasis=0; ibasis < n_cell_atoms; ++ibasis)
-                                {
-                                    idx = ibasis + n_cell_atoms*cell_a + n_cell_atoms*n_cells[0]*cell_b + n_cell_atoms*n_cells[0]*n_cells[1]*cell_c;
-                                    points[icell].x = positions[idx][0];
-                                    points[icell].y = positions[idx][1];
-                                    points[icell].z = positions[idx][2];
-                                    ++icell;
-                                }
+                                idx = ibasis + n_cell_atoms*cell_a + n_cell_atoms*n_cells[0]*cell_b + n_cell_atoms*n_cells[0]*n_cells[1]*cell_c;
+                                points[icell].x = positions[idx][0];
+                                points[icell].y = positions[idx][1];
+                                points[icell].z = positions[idx][2];
+                                ++icell;
                             }
                         }
                     }
-                    _tetrahedra = compute_delaunay_triangulation_3D(points);
                 }
+                _tetrahedra = compute_delaunay_triangulation_3D(points);
             }
         } // endif 3D
         // 0-2 D gives no tetrahedra
-        else
-        {
-            _tetrahedra.clear();
-        }
         return _tetrahedra;
     }
 
@@ -8,7 +8,7 @@ namespace Data
             std::shared_ptr<Pinning> pinning, scalar spring_constant, int n_E_interpolations) :
         Parameters_Method_Solver(output_folder, output_file_tag, {output[0], output[1], output[2]}, 
             n_iterations, n_iterations_log, max_walltime_sec, pinning, force_convergence, 1e-3),
-        spring_constant(spring_constant), n_E_interpolations(n_E_interpolations),
+        spring_constant(spring_constant), n_E_interpolations(n_E_interpolations), n_threads_per_image(0),
         output_energies_step(output[3]), output_energies_interpolated(output[4]), 
         output_energies_divide_by_nspins(output[5]), output_chain_step(output[6]),
         output_energies_add_readability_lines(output[7]), output_chain_filetype(output_chain_filetype),
@@ -1,4 +1,5 @@
 #include <data/Parameters_Method_LLG.hpp>
+#include <io/Fileformat.hpp>
 
 namespace Data
 {
@@ -18,9 +19,11 @@ namespace Data
         damping(damping_i), beta(beta), temperature(temperature_i),
         temperature_gradient_direction(temperature_gradient_direction),
         temperature_gradient_inclination(temperature_gradient_inclination),
-        rng_seed(rng_seed), prng(std::mt19937(rng_seed)), stt_use_gradient(stt_use_gradient), 
+        rng_seed(rng_seed), prng(std::mt19937(rng_seed)), rng_counter(0), stt_use_gradient(stt_use_gradient), 
         stt_magnitude(stt_magnitude_i), stt_polarisation_normal(stt_polarisation_normal_i),
-        direct_minimization(false)
+        direct_minimization(false), n_iterations_observables(0),
+        output_trajectory(false), output_trajectory_bits(16),
+        output_energy_spin_resolved_filetype(int(IO::VF_FileFormat::OVF_BIN8))
     {
     }
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include <data/Parameters_Method.hpp>
+#include <engine/Vectormath.hpp>
 
 namespace Data
 {
@@ -80,4 +81,15 @@ namespace Data
 			}
 		}
 	}
+
+	void Pinning::Update_Geometry(std::shared_ptr<Geometry> geometry)
+	{
+		// The pinning may be shared by several systems and parameter sets
+		if (geometry == this->geometry) return;
+		this->mask_unpinned = Engine::Vectormath::change_dimensions(this->mask_unpinned, *this->geometry, *geometry, 1);
+		// Without SPIRIT_ENABLE_PINNING, no pinned cells are stored
+		if (this->mask_pinned_cells.size() > 0)
+			this->mask_pinned_cells = Engine::Vectormath::change_dimensions(this->mask_pinned_cells, *this->geometry, *geometry, {0,0,0});
+		this->geometry = geometry;
+	}
 }
\ No newline at end of file
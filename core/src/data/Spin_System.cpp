@@ -13,7 +13,9 @@
 namespace Data
 {
 	Spin_System::Spin_System(std::unique_ptr<Engine::Hamiltonian> hamiltonian, std::shared_ptr<Geometry> geometry, std::unique_ptr<Parameters_Method_LLG> llg_params, std::unique_ptr<Parameters_Method_MC> mc_params, bool iteration_allowed) :
-		iteration_allowed(iteration_allowed), hamiltonian(std::move(hamiltonian)), geometry(geometry), llg_parameters(std::move(llg_params)), mc_parameters(std::move(mc_params))
+		iteration_allowed(iteration_allowed), hamiltonian(std::move(hamiltonian)), geometry(geometry), llg_parameters(std::move(llg_params)), mc_parameters(std::move(mc_params)),
+		spins_version(1), energy_version(0), effective_field_version(0), magnetization_version(0),
+		n_iterations_snapshot(0)
 	{
 
 		// Get Number of Spins
@@ -38,9 +40,17 @@ namespace Data
 
 		this->E = other.E;
 		this->E_array = other.E_array;
+		this->M = other.M;
 		this->effective_field = other.effective_field;
 
-		this->geometry = std::shared_ptr<Data::Geometry>(new Data::Geometry(*other.geometry));
+		// The copied observables are valid as long as the copied spins are not changed
+		this->spins_version = 1;
+		this->energy_version          = other.energy_version          == other.spins_version ? 1 : 0;
+		this->effective_field_version = other.effective_field_version == other.spins_version ? 1 : 0;
+		this->magnetization_version   = other.magnetization_version   == other.spins_version ? 1 : 0;
+
+		// The geometry is immutable and therefore shared, each copy only owns its spins and parameters
+		this->geometry = other.geometry;
 		
 		if (other.hamiltonian->Name() == "Heisenberg")
 		{
@@ -56,6 +66,7 @@ namespace Data
 		this->mc_parameters = std::shared_ptr<Data::Parameters_Method_MC>(new Data::Parameters_Method_MC(*other.mc_parameters));
 
 		this->iteration_allowed = false;
+		this->n_iterations_snapshot = other.n_iterations_snapshot;
 	}
 
 	// Copy Assignment operator
@@ -68,9 +79,17 @@ namespace Data
 
 			this->E = other.E;
 			this->E_array = other.E_array;
+			this->M = other.M;
 			this->effective_field = other.effective_field;
 
-			this->geometry = std::shared_ptr<Data::Geometry>(new Data::Geometry(*other.geometry));
+			// Start from a new version, so that observables calculated for the previous spins are not reused
+			std::uint64_t version = std::max(this->spins_version.load(), other.spins_version.load()) + 1;
+			this->spins_version = version;
+			this->energy_version          = other.energy_version          == other.spins_version ? version : 0;
+			this->effective_field_version = other.effective_field_version == other.spins_version ? version : 0;
+			this->magnetization_version   = other.magnetization_version   == other.spins_version ? version : 0;
+
+			this->geometry = other.geometry;
 			
 			if (other.hamiltonian->Name() == "Heisenberg")
 			{
@@ -86,23 +105,128 @@ namespace Data
 			this->mc_parameters = std::shared_ptr<Data::Parameters_Method_MC>(new Data::Parameters_Method_MC(*other.mc_parameters));
 
 			this->iteration_allowed = false;
+			this->n_iterations_snapshot = other.n_iterations_snapshot;
 		}
 
 		return *this;
 	}
 
+	void Spin_System::Unshare_Geometry()
+	{
+		this->geometry = std::shared_ptr<Data::Geometry>(new Data::Geometry(*this->geometry));
+		if (this->hamiltonian->Name() == "Heisenberg")
+			std::static_pointer_cast<Engine::Hamiltonian_Heisenberg>(this->hamiltonian)->Update_Geometry(this->geometry);
+		this->HamiltonianChanged();
+	}
+
 	void Spin_System::UpdateEnergy()
 	{
+		std::lock_guard<std::mutex> guard(this->observables_mutex);
+		this->Calculate_Energy();
+	}
+
+	void Spin_System::UpdateEffectiveField()
+	{
+		std::lock_guard<std::mutex> guard(this->observables_mutex);
+		this->Calculate_Effective_Field();
+	}
+
+	void Spin_System::UpdateMagnetization()
+	{
+		std::lock_guard<std::mutex> guard(this->observables_mutex);
+		this->Calculate_Magnetization();
+	}
+
+	void Spin_System::UpdateEnergyIfOutdated()
+	{
+		std::lock_guard<std::mutex> guard(this->observables_mutex);
+		if (this->energy_version != this->spins_version)
+			this->Calculate_Energy();
+	}
+
+	void Spin_System::UpdateEffectiveFieldIfOutdated()
+	{
+		std::lock_guard<std::mutex> guard(this->observables_mutex);
+		if (this->effective_field_version != this->spins_version)
+			this->Calculate_Effective_Field();
+	}
+
+	void Spin_System::UpdateMagnetizationIfOutdated()
+	{
+		std::lock_guard<std::mutex> guard(this->observables_mutex);
+		if (this->magnetization_version != this->spins_version)
+			this->Calculate_Magnetization();
+	}
+
+	void Spin_System::SetEnergy(scalar energy)
+	{
+		std::lock_guard<std::mutex> guard(this->observables_mutex);
+		this->E = energy;
+	}
+
+	void Spin_System::PublishSnapshot(int iteration)
+	{
+		// The spare buffer can only be reused if no reader holds it any more
+		if (!this->snapshot_spare || this->snapshot_spare.use_count() > 1)
+			this->snapshot_spare = std::make_shared<Spin_Snapshot>();
+
+		this->snapshot_spare->spins         = *this->spins;
+		this->snapshot_spare->iteration     = iteration;
+		this->snapshot_spare->energy        = this->E;
+		this->snapshot_spare->spins_version = this->spins_version;
+
+		// Swap the pointers, so that readers never see a partially written snapshot
+		this->snapshot_spare = std::atomic_exchange(&this->snapshot, this->snapshot_spare);
+	}
+
+	std::shared_ptr<const Spin_Snapshot> Spin_System::GetSnapshot() const
+	{
+		return std::atomic_load(&this->snapshot);
+	}
+
+	bool Spin_System::SnapshotOutdated() const
+	{
+		auto current = this->GetSnapshot();
+		return !current || current->spins_version != this->spins_version;
+	}
+
+	void Spin_System::SpinsChanged()
+	{
+		++this->spins_version;
+	}
+
+	void Spin_System::HamiltonianChanged()
+	{
+		// The observables depend on the spins and the Hamiltonian in the same way
+		++this->spins_version;
+	}
+
+	// The version is read before the calculation, so that a change of the spins during
+	//		the calculation leads to a recalculation by the next lazy update
+	void Spin_System::Calculate_Energy()
+	{
+		std::uint64_t version = this->spins_version;
 		this->E_array = this->hamiltonian->Energy_Contributions(*this->spins);
 		scalar sum = 0;
 		for (auto E : E_array) sum += E.second;
 		this->E = sum;
+		this->energy_version = version;
 	}
 
-	void Spin_System::UpdateEffectiveField()
+	void Spin_System::Calculate_Effective_Field()
 	{
+		std::uint64_t version = this->spins_version;
 		this->hamiltonian->Gradient(*this->spins, this->effective_field);
 		Engine::Vectormath::scale(this->effective_field, -1);
+		this->effective_field_version = version;
+	}
+
+	void Spin_System::Calculate_Magnetization()
+	{
+		std::uint64_t version = this->spins_version;
+		auto mag = Engine::Vectormath::Magnetization(*this->spins);
+		this->M = Vector3{ mag[0], mag[1], mag[2] };
+		this->magnetization_version = version;
 	}
 
 	void Spin_System::Lock() const
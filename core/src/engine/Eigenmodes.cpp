@@ -0,0 +1,113 @@
+#include <engine/Eigenmodes.hpp>
+#include <engine/Vectormath.hpp>
+#include <engine/Manifoldmath.hpp>
+
+#include <Eigen/Dense>
+
+#include <random>
+#include <cmath>
+#include <algorithm>
+
+namespace Engine
+{
+    namespace Eigenmodes
+    {
+        void Tangent_Hessian_Vector_Product(Hamiltonian & hamiltonian, const vectorfield & spins,
+            const vectorfield & gradient, const vectorfield & vec, vectorfield & out)
+        {
+            int nos = spins.size();
+
+            // Make sure the input lies in the tangent space
+            vectorfield vec_tangent = vec;
+            Manifoldmath::project_tangential(vec_tangent, spins);
+
+            hamiltonian.Hessian_Vector_Product(spins, vec_tangent, out);
+
+            // Curvature of the sphere: subtract the projection of the gradient onto each spin
+            #pragma omp parallel for
+            for (int i = 0; i < nos; ++i)
+                out[i] -= spins[i].dot(gradient[i]) * vec_tangent[i];
+
+            Manifoldmath::project_tangential(out, spins);
+        }
+
+        scalar Lowest_Tangent_Eigenmode(Hamiltonian & hamiltonian, const vectorfield & spins,
+            const vectorfield & gradient, vectorfield & mode,
+            int n_lanczos_vectors, int n_restarts_max, scalar tolerance)
+        {
+            int nos = spins.size();
+            // The tangent space has 2N dimensions
+            int m = std::max(1, std::min(n_lanczos_vectors, 2*nos));
+
+            // Starting vector: the previous mode if possible, otherwise a random tangent vector
+            Manifoldmath::project_tangential(mode, spins);
+            scalar mode_norm = Manifoldmath::norm(mode);
+            if (!(mode_norm > 1e-12))
+            {
+                std::mt19937 prng(2006);
+                Vectormath::get_random_vectorfield(prng, mode);
+                Manifoldmath::project_tangential(mode, spins);
+            }
+            Manifoldmath::normalize(mode);
+
+            std::vector<vectorfield> basis(m + 1, vectorfield(nos, {0,0,0}));
+            vectorfield w(nos, {0,0,0});
+            scalar eigenvalue = 0;
+
+            for (int i_restart = 0; i_restart < n_restarts_max; ++i_restart)
+            {
+                VectorX alpha = VectorX::Zero(m);
+                VectorX beta  = VectorX::Zero(m);
+                Vectormath::set_c_a(1, mode, basis[0]);
+
+                // Lanczos recursion with full reorthogonalization against the current basis
+                int n_basis = m;
+                for (int j = 0; j < m; ++j)
+                {
+                    Tangent_Hessian_Vector_Product(hamiltonian, spins, gradient, basis[j], w);
+                    alpha[j] = Vectormath::dot(basis[j], w);
+                    for (int k = 0; k <= j; ++k)
+                        Vectormath::add_c_a(-Vectormath::dot(basis[k], w), basis[k], w);
+
+                    beta[j] = Manifoldmath::norm(w);
+                    if (beta[j] < 1e-12)
+                    {
+                        // An invariant subspace has been found
+                        n_basis = j + 1;
+                        beta[j] = 0;
+                        break;
+                    }
+                    Vectormath::set_c_a(1/beta[j], w, basis[j+1]);
+                }
+
+                // Lowest eigenpair of the tridiagonal matrix
+                MatrixX tridiagonal = MatrixX::Zero(n_basis, n_basis);
+                for (int j = 0; j < n_basis; ++j)
+                {
+                    tridiagonal(j, j) = alpha[j];
+                    if (j + 1 < n_basis)
+                    {
+                        tridiagonal(j, j+1) = beta[j];
+                        tridiagonal(j+1, j) = beta[j];
+                    }
+                }
+                Eigen::SelfAdjointEigenSolver<MatrixX> tridiagonal_solver(tridiagonal);
+                eigenvalue = tridiagonal_solver.eigenvalues()[0];
+                VectorX y  = tridiagonal_solver.eigenvectors().col(0);
+
+                // Ritz vector, which is the starting vector of the next restart
+                Vectormath::fill(mode, {0,0,0});
+                for (int j = 0; j < n_basis; ++j)
+                    Vectormath::add_c_a(y[j], basis[j], mode);
+                Manifoldmath::normalize(mode);
+
+                // Norm of the residual H*x - lambda*x
+                scalar residual = std::abs(beta[n_basis-1] * y[n_basis-1]);
+                if (residual < tolerance * std::max(scalar(1), std::abs(eigenvalue)))
+                    break;
+            }
+
+            return eigenvalue;
+        }
+    }
+}
@@ -0,0 +1,176 @@
+#include <engine/FFT.hpp>
+#include <utility/Constants.hpp>
+
+#include <cmath>
+#include <algorithm>
+
+using Utility::Constants::Pi;
+
+namespace Engine
+{
+    namespace FFT
+    {
+        int Next_Power_of_Two(int n)
+        {
+            int m = 1;
+            while (m < n) m <<= 1;
+            return m;
+        }
+
+        FFT_Plan_1D::FFT_Plan_1D(int n) : n(n)
+        {
+            this->is_power_of_two = (n > 0) && ((n & (n-1)) == 0);
+
+            if (this->is_power_of_two)
+            {
+                // Bit reversal permutation
+                this->bit_reversal = std::vector<int>(n, 0);
+                int n_bits = 0;
+                while ((1 << n_bits) < n) ++n_bits;
+                for (int i = 0; i < n; ++i)
+                {
+                    int rev = 0;
+                    for (int b = 0; b < n_bits; ++b)
+                        if (i & (1 << b)) rev |= 1 << (n_bits - 1 - b);
+                    this->bit_reversal[i] = rev;
+                }
+
+                // Twiddle factors
+                this->twiddles = cpxfield(std::max(1, n/2));
+                for (int k = 0; k < n/2; ++k)
+                    this->twiddles[k] = std::polar(scalar(1), scalar(-2*Pi*k/n));
+            }
+            else
+            {
+                // Bluestein: express the DFT as a convolution of length m >= 2n-1
+                int m = Next_Power_of_Two(2*n - 1);
+                this->sub_plan = std::make_shared<FFT_Plan_1D>(m);
+
+                // The chirp angle is evaluated with k^2 mod 2n to retain precision for large n
+                this->chirp = cpxfield(n);
+                for (long long k = 0; k < n; ++k)
+                    this->chirp[k] = std::polar(scalar(1), scalar(-Pi * ((k*k) % (2*n)) / n));
+
+                this->chirp_kernel_k = cpxfield(m, 0);
+                this->chirp_kernel_k[0] = std::conj(this->chirp[0]);
+                for (int k = 1; k < n; ++k)
+                {
+                    this->chirp_kernel_k[k]   = std::conj(this->chirp[k]);
+                    this->chirp_kernel_k[m-k] = std::conj(this->chirp[k]);
+                }
+                this->sub_plan->Transform(this->chirp_kernel_k.data());
+                // Fold the normalization of the inverse sub-transform into the kernel
+                for (auto& c : this->chirp_kernel_k)
+                    c /= scalar(m);
+            }
+        }
+
+        void FFT_Plan_1D::Transform_Radix2(cpx * data, bool inverse) const
+        {
+            for (int i = 0; i < n; ++i)
+            {
+                int j = this->bit_reversal[i];
+                if (i < j) std::swap(data[i], data[j]);
+            }
+
+            for (int len = 2; len <= n; len <<= 1)
+            {
+                int half = len/2;
+                int step = n/len;
+                for (int i = 0; i < n; i += len)
+                {
+                    for (int j = 0; j < half; ++j)
+                    {
+                        cpx w = inverse ? std::conj(this->twiddles[j*step]) : this->twiddles[j*step];
+                        cpx u = data[i+j];
+                        cpx v = data[i+j+half] * w;
+                        data[i+j]      = u + v;
+                        data[i+j+half] = u - v;
+                    }
+                }
+            }
+        }
+
+        void FFT_Plan_1D::Transform(cpx * data, bool inverse) const
+        {
+            if (n <= 1) return;
+
+            if (this->is_power_of_two)
+            {
+                Transform_Radix2(data, inverse);
+                return;
+            }
+
+            // The inverse transform is the conjugate of the forward transform of the conjugate
+            int m = this->sub_plan->n;
+            cpxfield work(m, 0);
+            for (int k = 0; k < n; ++k)
+                work[k] = (inverse ? std::conj(data[k]) : data[k]) * this->chirp[k];
+
+            this->sub_plan->Transform(work.data());
+            for (int k = 0; k < m; ++k)
+                work[k] *= this->chirp_kernel_k[k];
+            this->sub_plan->Transform(work.data(), true);
+
+            for (int k = 0; k < n; ++k)
+            {
+                cpx x = work[k] * this->chirp[k];
+                data[k] = inverse ? std::conj(x) : x;
+            }
+        }
+
+
+        FFT_Plan::FFT_Plan(std::array<int,3> dims) :
+            dims(dims), n_total(dims[0]*dims[1]*dims[2]),
+            plans{ FFT_Plan_1D(dims[0]), FFT_Plan_1D(dims[1]), FFT_Plan_1D(dims[2]) }
+        {
+        }
+
+        void FFT_Plan::Transform(cpx * data, bool inverse) const
+        {
+            const int n0 = dims[0], n1 = dims[1], n2 = dims[2];
+
+            // Axis 0 is contiguous
+            if (n0 > 1)
+            {
+                #pragma omp parallel for
+                for (int line = 0; line < n1*n2; ++line)
+                    plans[0].Transform(data + line*n0, inverse);
+            }
+
+            // Axes 1 and 2 are gathered into a contiguous buffer per line
+            if (n1 > 1)
+            {
+                #pragma omp parallel
+                {
+                    cpxfield buffer(n1);
+                    #pragma omp for
+                    for (int line = 0; line < n0*n2; ++line)
+                    {
+                        int i = line % n0, k = line / n0;
+                        cpx * start = data + i + k*n0*n1;
+                        for (int j = 0; j < n1; ++j) buffer[j] = start[j*n0];
+                        plans[1].Transform(buffer.data(), inverse);
+                        for (int j = 0; j < n1; ++j) start[j*n0] = buffer[j];
+                    }
+                }
+            }
+
+            if (n2 > 1)
+            {
+                #pragma omp parallel
+                {
+                    cpxfield buffer(n2);
+                    #pragma omp for
+                    for (int line = 0; line < n0*n1; ++line)
+                    {
+                        cpx * start = data + line;
+                        for (int k = 0; k < n2; ++k) buffer[k] = start[k*n0*n1];
+                        plans[2].Transform(buffer.data(), inverse);
+                        for (int k = 0; k < n2; ++k) start[k*n0*n1] = buffer[k];
+                    }
+                }
+            }
+        }
+    }
+}
@@ -89,6 +89,51 @@ namespace Engine
         }
     }
 
+    void Hamiltonian::Sparse_Hessian(const vectorfield & spins, SpMatrixX & hessian)
+    {
+        int nos = spins.size();
+        MatrixX hessian_dense = MatrixX::Zero(3*nos, 3*nos);
+        this->Hessian(spins, hessian_dense);
+        hessian = hessian_dense.sparseView();
+    }
+
+    void Hamiltonian::Hessian_Vector_Product(const vectorfield & spins, const vectorfield & vec, vectorfield & out)
+    {
+        this->Hessian_Vector_Product_FD(spins, vec, out);
+    }
+
+    void Hamiltonian::Hessian_Vector_Product_FD(const vectorfield & spins, const vectorfield & vec, vectorfield & out)
+    {
+        int nos = spins.size();
+
+        // Scale the step so that no spin component is displaced by more than delta
+        scalar vec_max = 0;
+        for (int i = 0; i < nos; ++i)
+            vec_max = std::max(vec_max, vec[i].cwiseAbs().maxCoeff());
+        if (vec_max == 0)
+        {
+            Vectormath::fill(out, {0,0,0});
+            return;
+        }
+        scalar step = delta / vec_max;
+
+        vectorfield spins_plus(nos);
+        vectorfield spins_minus(nos);
+        Vectormath::set_c_a(1, spins, spins_plus);
+        Vectormath::add_c_a(step, vec, spins_plus);
+        Vectormath::set_c_a(1, spins, spins_minus);
+        Vectormath::add_c_a(-step, vec, spins_minus);
+
+        vectorfield grad_plus(nos);
+        vectorfield grad_minus(nos);
+        this->Gradient(spins_plus, grad_plus);
+        this->Gradient(spins_minus, grad_minus);
+
+        // out = (grad_plus - grad_minus) / (2*step)
+        Vectormath::set_c_a(0.5/step, grad_plus, out);
+        Vectormath::add_c_a(-0.5/step, grad_minus, out);
+    }
+
     void Hamiltonian::Gradient(const vectorfield & spins, vectorfield & gradient)
     {
         this->Gradient_FD(spins, gradient);
@@ -133,6 +178,12 @@ namespace Engine
         return sum;
     }
 
+    scalar Hamiltonian::Energy_and_Gradient(const vectorfield & spins, vectorfield & gradient)
+    {
+        this->Gradient(spins, gradient);
+        return this->Energy(spins);
+    }
+
     std::vector<std::pair<std::string, scalar>> Hamiltonian::Energy_Contributions(const vectorfield & spins)
     {
         Energy_Contributions_per_Spin(spins, this->energy_contributions_per_spin);
@@ -158,6 +209,32 @@ namespace Engine
             "Tried to use  Hamiltonian::Energy_Single_Spin() of the Hamiltonian base class!");
     }
 
+    scalar Hamiltonian::Energy_Single_Spin_Diff(int ispin, const vectorfield & spins, const Vector3 & spin_new)
+    {
+        vectorfield spins_new = spins;
+        spins_new[ispin] = spin_new;
+        return this->Energy(spins_new) - this->Energy(spins);
+    }
+
+    Vector3 Hamiltonian::Effective_Field_Single_Spin(int ispin, const vectorfield & spins)
+    {
+        // The even terms cancel in the difference between v and -v
+        Vector3 field{0, 0, 0};
+        for (int dim = 0; dim < 3; ++dim)
+        {
+            Vector3 v{0, 0, 0};
+            v[dim] = 1;
+            field[dim] = -0.5 * (this->Energy_Single_Spin_Diff(ispin, spins, v) - this->Energy_Single_Spin_Diff(ispin, spins, -v));
+        }
+        return field;
+    }
+
+    bool Hamiltonian::Interaction_Graph(intfield & offsets, intfield & neighbours)
+    {
+        // Without further knowledge, every spin may interact with every other spin
+        return false;
+    }
+
     static const std::string name = "--";
     const std::string& Hamiltonian::Name()
     {
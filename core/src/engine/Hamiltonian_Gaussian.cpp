@@ -105,11 +105,25 @@ namespace Engine
             // Distance between spin and gaussian center
             scalar l = 1 - this->center[i].dot(spins[ispin]); //Utility::Manifoldmath::Dist_Greatcircle(this->center[i], n);
             // Energy contribution
-            this->energy_contributions_per_spin[0].second[ispin] += this->amplitude[i] * std::exp(-std::pow(l, 2) / (2.0*std::pow(this->width[i], 2)));
+            Energy += this->amplitude[i] * std::exp(-std::pow(l, 2) / (2.0*std::pow(this->width[i], 2)));
         }
         return Energy;
     }
 
+    scalar Hamiltonian_Gaussian::Energy_Single_Spin_Diff(int ispin, const vectorfield & spins, const Vector3 & spin_new)
+    {
+        // The spins do not interact, so only the energy of the spin itself changes
+        scalar Ediff = 0;
+        for (int i = 0; i < this->n_gaussians; ++i)
+        {
+            scalar l_old = 1 - this->center[i].dot(spins[ispin]);
+            scalar l_new = 1 - this->center[i].dot(spin_new);
+            Ediff += this->amplitude[i] * ( std::exp(-std::pow(l_new, 2) / (2.0*std::pow(this->width[i], 2)))
+                                          - std::exp(-std::pow(l_old, 2) / (2.0*std::pow(this->width[i], 2))) );
+        }
+        return Ediff;
+    }
+
     // Hamiltonian name as string
     static const std::string name = "Gaussian";
     const std::string& Hamiltonian_Gaussian::Name() { return name; }
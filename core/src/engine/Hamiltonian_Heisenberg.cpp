@@ -5,9 +5,12 @@
 #include <engine/Neighbours.hpp>
 #include <data/Spin_System.hpp>
 #include <utility/Constants.hpp>
+#include <utility/Timing.hpp>
 
 #include <Eigen/Dense>
 
+#include <algorithm>
+
 using namespace Data;
 using namespace Utility;
 using Utility::Constants::mu_B;
@@ -16,6 +19,25 @@ using Utility::Constants::Pi;
 using Engine::Vectormath::check_atom_type;
 using Engine::Vectormath::idx_from_pair;
 
+namespace
+{
+    // Wall time and number of calls of the individual terms (see Simulation_Get_Timings)
+    Timing::Counter timing_energy_zeeman("Hamiltonian/Energy/Zeeman");
+    Timing::Counter timing_energy_anisotropy("Hamiltonian/Energy/Anisotropy");
+    Timing::Counter timing_energy_exchange("Hamiltonian/Energy/Exchange");
+    Timing::Counter timing_energy_dmi("Hamiltonian/Energy/DMI");
+    Timing::Counter timing_energy_ddi("Hamiltonian/Energy/DDI");
+    Timing::Counter timing_energy_quadruplet("Hamiltonian/Energy/Quadruplet");
+    Timing::Counter timing_gradient_zeeman("Hamiltonian/Gradient/Zeeman");
+    Timing::Counter timing_gradient_anisotropy("Hamiltonian/Gradient/Anisotropy");
+    Timing::Counter timing_gradient_exchange("Hamiltonian/Gradient/Exchange");
+    Timing::Counter timing_gradient_dmi("Hamiltonian/Gradient/DMI");
+    Timing::Counter timing_gradient_ddi("Hamiltonian/Gradient/DDI");
+    Timing::Counter timing_gradient_quadruplet("Hamiltonian/Gradient/Quadruplet");
+    Timing::Counter timing_hessian("Hamiltonian/Hessian");
+    Timing::Counter timing_hessian_vector_product("Hamiltonian/Hessian_Vector_Product");
+}
+
 namespace Engine
 {
     // Construct a Heisenberg Hamiltonian with pairs
@@ -25,7 +47,7 @@ namespace Engine
         intfield anisotropy_indices, scalarfield anisotropy_magnitudes, vectorfield anisotropy_normals,
         pairfield exchange_pairs, scalarfield exchange_magnitudes,
         pairfield dmi_pairs, scalarfield dmi_magnitudes, vectorfield dmi_normals,
-        scalar ddi_radius,
+        DDI_Method ddi_method, scalar ddi_radius,
         quadrupletfield quadruplets, scalarfield quadruplet_magnitudes,
         std::shared_ptr<Data::Geometry> geometry,
         intfield boundary_conditions
@@ -37,7 +59,7 @@ namespace Engine
         exchange_pairs(exchange_pairs), exchange_magnitudes(exchange_magnitudes), exchange_n_shells(0),
         dmi_pairs(dmi_pairs), dmi_magnitudes(dmi_magnitudes), dmi_normals(dmi_normals), dmi_n_shells(0),
         quadruplets(quadruplets), quadruplet_magnitudes(quadruplet_magnitudes),
-        ddi_cutoff_radius(ddi_radius)
+        ddi_method(ddi_method), ddi_cutoff_radius(ddi_radius)
     {
         #if defined SPIRIT_USE_OPENMP
         for (int i = 0; i < exchange_pairs.size(); ++i)
@@ -57,10 +79,8 @@ namespace Engine
         }
         #endif
 
-        // Generate DDI pairs, magnitudes, normals
-        this->Update_DDI_Pairs();
-
-        this->Update_Energy_Contributions();
+        // Generate neighbour tables, DDI pairs or kernel and energy contributions
+        this->Update_Interactions();
     }
 
     // Construct a Heisenberg Hamiltonian from shells
@@ -70,7 +90,7 @@ namespace Engine
         intfield anisotropy_indices, scalarfield anisotropy_magnitudes, vectorfield anisotropy_normals,
         scalarfield exchange_magnitudes,
         scalarfield dmi_magnitudes, int dm_chirality,
-        scalar ddi_radius,
+        DDI_Method ddi_method, scalar ddi_radius,
         quadrupletfield quadruplets, scalarfield quadruplet_magnitudes,
         std::shared_ptr<Data::Geometry> geometry,
         intfield boundary_conditions
@@ -82,7 +102,7 @@ namespace Engine
         anisotropy_indices(anisotropy_indices), anisotropy_magnitudes(anisotropy_magnitudes), anisotropy_normals(anisotropy_normals),
         exchange_n_shells(exchange_magnitudes.size()),
         dmi_n_shells(dmi_magnitudes.size()),
-        ddi_cutoff_radius(ddi_radius)
+        ddi_method(ddi_method), ddi_cutoff_radius(ddi_radius)
     {
         #if defined SPIRIT_USE_OPENMP
         // When parallelising (cuda or openmp), we need all neighbours per spin
@@ -109,27 +129,263 @@ namespace Engine
             this->dmi_magnitudes.push_back(dmi_magnitudes[dmi_shells[ineigh]]);
         }
 
-        // Generate DDI pairs, magnitudes, normals
-        this->Update_DDI_Pairs();
+        // Generate neighbour tables, DDI pairs or kernel and energy contributions
+        this->Update_Interactions();
+    }
+
+    void Hamiltonian_Heisenberg::Update_Interactions()
+    {
+        // The tables are built anew instead of modified, as other copies may share them
+        auto tables = std::make_shared<Interaction_Tables>();
+
+        // Exchange
+        intfield pair_indices, directions;
+        this->Build_Neighbour_Table(this->exchange_pairs, tables->exchange_table, pair_indices, directions);
+        tables->exchange_table_magnitudes = scalarfield(pair_indices.size());
+        for (unsigned int k = 0; k < pair_indices.size(); ++k)
+            tables->exchange_table_magnitudes[k] = this->exchange_magnitudes[pair_indices[k]];
+
+        // DMI
+        this->Build_Neighbour_Table(this->dmi_pairs, tables->dmi_table, pair_indices, directions);
+        tables->dmi_table_vectors = vectorfield(pair_indices.size());
+        for (unsigned int k = 0; k < pair_indices.size(); ++k)
+            tables->dmi_table_vectors[k] = directions[k] * this->dmi_magnitudes[pair_indices[k]] * this->dmi_normals[pair_indices[k]];
+
+        // Quadruplets
+        this->Build_Quadruplet_Sites(tables->quadruplet_sites_per_basis);
+
+        this->interaction_tables = tables;
+
+        // DDI
+        this->Update_DDI();
 
         this->Update_Energy_Contributions();
     }
 
-    void Hamiltonian_Heisenberg::Update_DDI_Pairs()
+    void Hamiltonian_Heisenberg::Update_Geometry(std::shared_ptr<Data::Geometry> geometry)
     {
-        this->ddi_pairs      = Engine::Neighbours::Get_Pairs_in_Radius(*this->geometry, this->ddi_cutoff_radius);
-        this->ddi_magnitudes = scalarfield(this->ddi_pairs.size());
-        this->ddi_normals    = vectorfield(this->ddi_pairs.size());
+        this->geometry = geometry;
+        this->Update_Interactions();
+    }
 
-        scalar magnitude;
-        Vector3 normal;
+    void Hamiltonian_Heisenberg::Build_Quadruplet_Sites(std::vector<std::vector<Quadruplet_Site>> & sites_per_basis)
+    {
+        sites_per_basis = std::vector<std::vector<Quadruplet_Site>>(geometry->n_cell_atoms);
+        for (unsigned int iquad = 0; iquad < quadruplets.size(); ++iquad)
+        {
+            const auto& quad = quadruplets[iquad];
+            std::array<int, 3> d_j = { quad.d_j[0], quad.d_j[1], quad.d_j[2] };
+            std::array<int, 3> d_k = { quad.d_k[0], quad.d_k[1], quad.d_k[2] };
+            std::array<int, 3> d_l = { quad.d_l[0], quad.d_l[1], quad.d_l[2] };
+            std::array<std::pair<int, std::array<int, 3>>, 4> sites = {{
+                { quad.i, {0, 0, 0} },
+                { quad.j, {-d_j[0], -d_j[1], -d_j[2]} },
+                { quad.k, {-d_k[0], -d_k[1], -d_k[2]} },
+                { quad.l, {-d_l[0], -d_l[1], -d_l[2]} } }};
+
+            for (int isite = 0; isite < 4; ++isite)
+            {
+                auto& list = sites_per_basis[sites[isite].first];
+                // An atom may take part in the same quadruplet more than once
+                bool duplicate = false;
+                for (auto& site : list)
+                    duplicate = duplicate || (site.iquad == (int)iquad && site.translations == sites[isite].second);
+                if (!duplicate)
+                    list.push_back({ (int)iquad, sites[isite].second });
+            }
+        }
+    }
 
-        for (unsigned int i = 0; i < this->ddi_pairs.size(); ++i)
+    void Hamiltonian_Heisenberg::Build_Neighbour_Table(const pairfield & pairs, Neighbour_Table & table, intfield & pair_indices, intfield & directions)
+    {
+        const int nos = geometry->nos;
+        const int N   = geometry->n_cell_atoms;
+
+        #ifndef _OPENMP
+        // The pairs are unique, so each pair also has to be entered for spin j
+        const bool add_inverse = true;
+        #else
+        // The pairs contain both directions
+        const bool add_inverse = false;
+        #endif
+
+        // Count the neighbours of each spin
+        intfield n_neighbours(nos, 0);
+        for (int icell = 0; icell < geometry->n_cells_total; ++icell)
+        {
+            for (unsigned int ipair = 0; ipair < pairs.size(); ++ipair)
+            {
+                int ispin = pairs[ipair].i + icell*N;
+                int jspin = idx_from_pair(ispin, boundary_conditions, geometry->n_cells, N, geometry->atom_types, pairs[ipair]);
+                if (jspin >= 0)
+                {
+                    ++n_neighbours[ispin];
+                    if (add_inverse) ++n_neighbours[jspin];
+                }
+            }
+        }
+
+        table.offsets = intfield(nos+1, 0);
+        for (int ispin = 0; ispin < nos; ++ispin)
+            table.offsets[ispin+1] = table.offsets[ispin] + n_neighbours[ispin];
+
+        // Fill in the neighbours
+        int n_entries = table.offsets[nos];
+        table.neighbours = intfield(n_entries);
+        pair_indices     = intfield(n_entries);
+        directions       = intfield(n_entries);
+        intfield cursor(table.offsets.begin(), table.offsets.end()-1);
+        for (int icell = 0; icell < geometry->n_cells_total; ++icell)
         {
-            Engine::Neighbours::DDI_from_Pair(
-                *this->geometry,
-                { this->ddi_pairs[i].i, this->ddi_pairs[i].j, this->ddi_pairs[i].translations },
-                this->ddi_magnitudes[i], this->ddi_normals[i]);
+            for (unsigned int ipair = 0; ipair < pairs.size(); ++ipair)
+            {
+                int ispin = pairs[ipair].i + icell*N;
+                int jspin = idx_from_pair(ispin, boundary_conditions, geometry->n_cells, N, geometry->atom_types, pairs[ipair]);
+                if (jspin >= 0)
+                {
+                    int k = cursor[ispin]++;
+                    table.neighbours[k] = jspin;
+                    pair_indices[k]     = ipair;
+                    directions[k]       = 1;
+                    if (add_inverse)
+                    {
+                        k = cursor[jspin]++;
+                        table.neighbours[k] = ispin;
+                        pair_indices[k]     = ipair;
+                        directions[k]       = -1;
+                    }
+                }
+            }
+        }
+    }
+
+    void Hamiltonian_Heisenberg::Update_DDI()
+    {
+        this->ddi_pairs      = pairfield(0);
+        this->ddi_magnitudes = scalarfield(0);
+        this->ddi_normals    = vectorfield(0);
+        this->ddi_buffers    = DDI_Buffers();
+        auto tables = std::make_shared<DDI_Tables>();
+        tables->ddi_pairs_per_basis = std::vector<intfield>(this->geometry->n_cell_atoms);
+
+        if (this->ddi_method == DDI_Method::Cutoff)
+        {
+            this->ddi_pairs      = Engine::Neighbours::Get_Pairs_in_Radius(*this->geometry, this->ddi_cutoff_radius);
+            this->ddi_magnitudes = scalarfield(this->ddi_pairs.size());
+            this->ddi_normals    = vectorfield(this->ddi_pairs.size());
+
+            for (unsigned int i = 0; i < this->ddi_pairs.size(); ++i)
+            {
+                Engine::Neighbours::DDI_from_Pair(
+                    *this->geometry,
+                    { this->ddi_pairs[i].i, this->ddi_pairs[i].j, this->ddi_pairs[i].translations },
+                    this->ddi_magnitudes[i], this->ddi_normals[i]);
+            }
+
+            for (unsigned int i = 0; i < this->ddi_pairs.size(); ++i)
+            {
+                if (this->ddi_magnitudes[i] > 0.0)
+                    tables->ddi_pairs_per_basis[this->ddi_pairs[i].i].push_back(i);
+            }
+        }
+        else if (this->ddi_method == DDI_Method::FFT)
+        {
+            this->Prepare_DDI_FFT(*tables);
+        }
+
+        this->ddi_tables = tables;
+    }
+
+    void Hamiltonian_Heisenberg::Prepare_DDI_FFT(DDI_Tables & tables)
+    {
+        // The translations are in angstr�m, so the |r|[m] becomes |r|[m]*10^-10
+        const scalar mult = mu_0 * std::pow(mu_B, 2) / ( 4*Pi * 1e-30 );
+
+        const int N = geometry->n_cell_atoms;
+        const auto& n_cells = geometry->n_cells;
+
+        // Periodic directions are transformed on the lattice itself, open directions are
+        // zero-padded so that the cyclic convolution does not wrap around
+        std::array<int, 3> dims;
+        for (int d = 0; d < 3; ++d)
+        {
+            if (boundary_conditions[d])
+                dims[d] = n_cells[d];
+            else
+                dims[d] = FFT::Next_Power_of_Two(2*n_cells[d] - 1);
+        }
+        tables.ddi_fft_plan = FFT::FFT_Plan(dims);
+        const int n_grid = tables.ddi_fft_plan.n_total;
+
+        // Lattice translations which contribute to a grid offset e, where the field at
+        // cell c is the convolution sum over c' of tensor(c-c') * moment(c')
+        auto translations_for_offset = [&](int d, int e)
+        {
+            std::vector<int> translations(0);
+            int n = n_cells[d];
+            if (!boundary_conditions[d])
+            {
+                if (e < n) translations.push_back(-e);
+                else if (e > dims[d] - n) translations.push_back(dims[d] - e);
+            }
+            else if (this->ddi_cutoff_radius > 0)
+            {
+                // All periodic images within the translation range of Get_Pairs_in_Radius
+                for (int t = -e - n; t <= n; t += n)
+                    if (std::abs(t) <= n) translations.push_back(t);
+            }
+            else
+            {
+                // Minimum image convention
+                translations.push_back(e <= n/2 ? -e : n - e);
+            }
+            return translations;
+        };
+
+        tables.ddi_tensors = scalarfield(N*N*6*n_grid, 0);
+        for (int ia = 0; ia < N; ++ia)
+        {
+            for (int ib = 0; ib < N; ++ib)
+            {
+                scalar * tensor = &tables.ddi_tensors[(ia*N + ib)*6*n_grid];
+                for (int ec = 0; ec < dims[2]; ++ec)
+                {
+                    for (int eb = 0; eb < dims[1]; ++eb)
+                    {
+                        for (int ea = 0; ea < dims[0]; ++ea)
+                        {
+                            int idx = ddi_fft_idx(dims, ea, eb, ec);
+                            for (int ta : translations_for_offset(0, ea))
+                            for (int tb : translations_for_offset(1, eb))
+                            for (int tc : translations_for_offset(2, ec))
+                            {
+                                scalar magnitude;
+                                Vector3 n;
+                                Engine::Neighbours::DDI_from_Pair(*this->geometry, { ia, ib, {ta, tb, tc} }, magnitude, n);
+                                if (magnitude < 1e-6) continue;
+                                if (this->ddi_cutoff_radius > 0 && magnitude >= this->ddi_cutoff_radius) continue;
+
+                                scalar prefactor = mult / std::pow(magnitude, 3.0);
+                                tensor[0*n_grid + idx] += prefactor * (3*n[0]*n[0] - 1);
+                                tensor[1*n_grid + idx] += prefactor * (3*n[0]*n[1]);
+                                tensor[2*n_grid + idx] += prefactor * (3*n[0]*n[2]);
+                                tensor[3*n_grid + idx] += prefactor * (3*n[1]*n[1] - 1);
+                                tensor[4*n_grid + idx] += prefactor * (3*n[1]*n[2]);
+                                tensor[5*n_grid + idx] += prefactor * (3*n[2]*n[2] - 1);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        // Transform the tensors, including the normalization of the inverse transform
+        tables.ddi_tensors_k = FFT::cpxfield(N*N*6*n_grid);
+        for (int block = 0; block < N*N*6; ++block)
+        {
+            for (int idx = 0; idx < n_grid; ++idx)
+                tables.ddi_tensors_k[block*n_grid + idx] = tables.ddi_tensors[block*n_grid + idx] / scalar(n_grid);
+            tables.ddi_fft_plan.Transform(&tables.ddi_tensors_k[block*n_grid]);
         }
     }
 
@@ -166,7 +422,7 @@ namespace Engine
         }
         else this->idx_dmi = -1;
         // Dipole-Dipole
-        if (this->ddi_pairs.size() > 0)
+        if (this->ddi_pairs.size() > 0 || this->ddi_method == DDI_Method::FFT)
         {
             this->energy_contributions_per_spin.push_back({"DD", scalarfield(0) });
             this->idx_ddi = this->energy_contributions_per_spin.size()-1;
@@ -215,6 +471,7 @@ namespace Engine
 
     void Hamiltonian_Heisenberg::E_Zeeman(const vectorfield & spins, scalarfield & Energy)
     {
+        Timing::Scope timing(timing_energy_zeeman);
         const int N = geometry->n_cell_atoms;
 
         #pragma omp parallel for
@@ -231,6 +488,7 @@ namespace Engine
 
     void Hamiltonian_Heisenberg::E_Anisotropy(const vectorfield & spins, scalarfield & Energy)
     {
+        Timing::Scope timing(timing_energy_anisotropy);
         const int N = geometry->n_cell_atoms;
 
         #pragma omp parallel for
@@ -247,74 +505,66 @@ namespace Engine
 
     void Hamiltonian_Heisenberg::E_Exchange(const vectorfield & spins, scalarfield & Energy)
     {
+        Timing::Scope timing(timing_energy_exchange);
+        const auto& tables = *this->interaction_tables;
+        const auto& offsets    = tables.exchange_table.offsets;
+        const auto& neighbours = tables.exchange_table.neighbours;
+
         #pragma omp parallel for
-        for (unsigned int icell = 0; icell < geometry->n_cells_total; ++icell)
+        for (int ispin = 0; ispin < geometry->nos; ++ispin)
         {
-            for (unsigned int i_pair = 0; i_pair < exchange_pairs.size(); ++i_pair)
-            {
-                int ispin = exchange_pairs[i_pair].i + icell*geometry->n_cell_atoms;
-                int jspin = idx_from_pair(ispin, boundary_conditions, geometry->n_cells, geometry->n_cell_atoms, geometry->atom_types, exchange_pairs[i_pair]);
-                if (jspin >= 0)
-                {
-                    Energy[ispin] -= 0.5 * exchange_magnitudes[i_pair] * spins[ispin].dot(spins[jspin]);
-                    #ifndef _OPENMP
-                    Energy[jspin] -= 0.5 * exchange_magnitudes[i_pair] * spins[ispin].dot(spins[jspin]);
-                    #endif
-                }
-            }
+            for (int k = offsets[ispin]; k < offsets[ispin+1]; ++k)
+                Energy[ispin] -= 0.5 * tables.exchange_table_magnitudes[k] * spins[ispin].dot(spins[neighbours[k]]);
         }
     }
 
     void Hamiltonian_Heisenberg::E_DMI(const vectorfield & spins, scalarfield & Energy)
     {
+        Timing::Scope timing(timing_energy_dmi);
+        const auto& tables = *this->interaction_tables;
+        const auto& offsets    = tables.dmi_table.offsets;
+        const auto& neighbours = tables.dmi_table.neighbours;
+
         #pragma omp parallel for
-        for (unsigned int icell = 0; icell < geometry->n_cells_total; ++icell)
+        for (int ispin = 0; ispin < geometry->nos; ++ispin)
         {
-            for (unsigned int i_pair = 0; i_pair < dmi_pairs.size(); ++i_pair)
-            {
-                int ispin = dmi_pairs[i_pair].i + icell*geometry->n_cell_atoms;
-                int jspin = idx_from_pair(ispin, boundary_conditions, geometry->n_cells, geometry->n_cell_atoms, geometry->atom_types, dmi_pairs[i_pair]);
-                if (jspin >= 0)
-                {
-                    Energy[ispin] -= 0.5 * dmi_magnitudes[i_pair] * dmi_normals[i_pair].dot(spins[ispin].cross(spins[jspin]));
-                    #ifndef _OPENMP
-                    Energy[jspin] -= 0.5 * dmi_magnitudes[i_pair] * dmi_normals[i_pair].dot(spins[ispin].cross(spins[jspin]));
-                    #endif
-                }
-            }
+            for (int k = offsets[ispin]; k < offsets[ispin+1]; ++k)
+                Energy[ispin] -= 0.5 * tables.dmi_table_vectors[k].dot(spins[ispin].cross(spins[neighbours[k]]));
         }
     }
 
     void Hamiltonian_Heisenberg::E_DDI(const vectorfield & spins, scalarfield & Energy)
     {
+        Timing::Scope timing(timing_energy_ddi);
+        if (this->ddi_method == DDI_Method::FFT)
+        {
+            this->Field_DDI_FFT(spins, this->ddi_buffers.field);
+
+            #pragma omp parallel for
+            for (int ispin = 0; ispin < geometry->nos; ++ispin)
+                Energy[ispin] -= 0.5 * this->mu_s[ispin % geometry->n_cell_atoms] * spins[ispin].dot(this->ddi_buffers.field[ispin]);
+            return;
+        }
+
         // The translations are in angstr�m, so the |r|[m] becomes |r|[m]*10^-10
         const scalar mult = mu_0 * std::pow(mu_B, 2) / ( 4*Pi * 1e-30 );
 
-        scalar result = 0.0;
-
-        for (unsigned int i_pair = 0; i_pair < ddi_pairs.size(); ++i_pair)
+        // The DDI pairs are not reduced to unique pairs, so each spin only accumulates its own share
+        #pragma omp parallel for
+        for (int icell = 0; icell < geometry->n_cells_total; ++icell)
         {
-            if (ddi_magnitudes[i_pair] > 0.0)
+            for (unsigned int i_pair = 0; i_pair < ddi_pairs.size(); ++i_pair)
             {
-                for (int da = 0; da < geometry->n_cells[0]; ++da)
+                if (ddi_magnitudes[i_pair] > 0.0)
                 {
-                    for (int db = 0; db < geometry->n_cells[1]; ++db)
+                    int i = ddi_pairs[i_pair].i;
+                    int j = ddi_pairs[i_pair].j;
+                    int ispin = i + icell*geometry->n_cell_atoms;
+                    int jspin = idx_from_pair(ispin, boundary_conditions, geometry->n_cells, geometry->n_cell_atoms, geometry->atom_types, ddi_pairs[i_pair]);
+                    if (jspin >= 0)
                     {
-                        for (int dc = 0; dc < geometry->n_cells[2]; ++dc)
-                        {
-                            std::array<int, 3 > translations = { da, db, dc };
-                            int i = ddi_pairs[i_pair].i;
-                            int j = ddi_pairs[i_pair].j;
-                            int ispin = i + Vectormath::idx_from_translations(geometry->n_cells, geometry->n_cell_atoms, translations);
-                            int jspin = idx_from_pair(ispin, boundary_conditions, geometry->n_cells, geometry->n_cell_atoms, geometry->atom_types, ddi_pairs[i_pair]);
-                            if (jspin >= 0)
-                            {
-                                Energy[ispin] -= 0.5 * this->mu_s[i] * this->mu_s[j] * mult / std::pow(ddi_magnitudes[i_pair], 3.0) *
-                                    (3 * spins[ispin].dot(ddi_normals[i_pair]) * spins[ispin].dot(ddi_normals[i_pair]) - spins[ispin].dot(spins[ispin]));
-                                Energy[jspin] -= 0.5 * this->mu_s[i] * this->mu_s[j] * mult / std::pow(ddi_magnitudes[i_pair], 3.0) *
-                                    (3 * spins[ispin].dot(ddi_normals[i_pair]) * spins[ispin].dot(ddi_normals[i_pair]) - spins[ispin].dot(spins[ispin]));
-                            }
-                        }
+                        Energy[ispin] -= 0.5 * this->mu_s[i] * this->mu_s[j] * mult / std::pow(ddi_magnitudes[i_pair], 3.0) *
+                            (3 * spins[ispin].dot(ddi_normals[i_pair]) * spins[jspin].dot(ddi_normals[i_pair]) - spins[ispin].dot(spins[jspin]));
                     }
                 }
             }
@@ -324,6 +574,7 @@ namespace Engine
 
     void Hamiltonian_Heisenberg::E_Quadruplet(const vectorfield & spins, scalarfield & Energy)
     {
+        Timing::Scope timing(timing_energy_quadruplet);
         for (unsigned int iquad = 0; iquad < quadruplets.size(); ++iquad)
         {
             for (int da = 0; da < geometry->n_cells[0]; ++da)
@@ -355,6 +606,7 @@ namespace Engine
 
     scalar Hamiltonian_Heisenberg::Energy_Single_Spin(int ispin_in, const vectorfield & spins)
     {
+        const auto& tables = *this->interaction_tables;
         int icell  = ispin_in / this->geometry->n_cell_atoms;
         int ibasis = ispin_in - icell*this->geometry->n_cell_atoms;
         scalar Energy = 0;
@@ -382,79 +634,37 @@ namespace Engine
         // Exchange
         if (this->idx_exchange >= 0)
         {
-            for (unsigned int ipair = 0; ipair < exchange_pairs.size(); ++ipair)
-            {
-                if (exchange_pairs[ipair].i == ibasis)
-                {
-                    int ispin = exchange_pairs[ipair].i + icell*geometry->n_cell_atoms;
-                    int jspin = idx_from_pair(ispin, boundary_conditions, geometry->n_cells, geometry->n_cell_atoms, geometry->atom_types, exchange_pairs[ipair]);
-                    if (jspin >= 0)
-                    {
-                        Energy -= 0.5 * this->exchange_magnitudes[ipair] * spins[ispin].dot(spins[jspin]);
-                    }
-                    #ifndef _OPENMP
-                    jspin = idx_from_pair(ispin, boundary_conditions, geometry->n_cells, geometry->n_cell_atoms, geometry->atom_types, exchange_pairs[ipair], true);
-                    if (jspin >= 0)
-                    {
-                        Energy -= 0.5 * this->exchange_magnitudes[ipair] * spins[ispin].dot(spins[jspin]);
-                    }
-                    #endif
-                }
-            }
+            for (int k = tables.exchange_table.offsets[ispin_in]; k < tables.exchange_table.offsets[ispin_in+1]; ++k)
+                Energy -= 0.5 * tables.exchange_table_magnitudes[k] * spins[ispin_in].dot(spins[tables.exchange_table.neighbours[k]]);
         }
 
         // DMI
         if (this->idx_dmi >= 0)
         {
-            for (unsigned int ipair = 0; ipair < dmi_pairs.size(); ++ipair)
-            {
-                if (dmi_pairs[ipair].i == ibasis)
-                {
-                    int ispin = dmi_pairs[ipair].i + icell*geometry->n_cell_atoms;
-                    int jspin = idx_from_pair(ispin, boundary_conditions, geometry->n_cells, geometry->n_cell_atoms, geometry->atom_types, dmi_pairs[ipair]);
-                    if (jspin >= 0)
-                    {
-                        Energy -= 0.5 * this->dmi_magnitudes[ipair] * this->dmi_normals[ipair].dot(spins[ispin].cross(spins[jspin]));
-                    }
-                    #ifndef _OPENMP
-                    jspin = idx_from_pair(ispin, boundary_conditions, geometry->n_cells, geometry->n_cell_atoms, geometry->atom_types, dmi_pairs[ipair], true);
-                    if (jspin >= 0)
-                    {
-                        Energy += 0.5 * this->dmi_magnitudes[ipair] * this->dmi_normals[ipair].dot(spins[ispin].cross(spins[jspin]));
-                    }
-                    #endif
-                }
-            }
+            for (int k = tables.dmi_table.offsets[ispin_in]; k < tables.dmi_table.offsets[ispin_in+1]; ++k)
+                Energy -= 0.5 * tables.dmi_table_vectors[k].dot(spins[ispin_in].cross(spins[tables.dmi_table.neighbours[k]]));
         }
 
         // DDI
-        if (this->idx_ddi >= 0)
+        if (this->idx_ddi >= 0 && this->ddi_method == DDI_Method::FFT)
+        {
+            if (check_atom_type(this->geometry->atom_types[ispin_in]))
+                Energy -= 0.5 * this->mu_s[ibasis] * spins[ispin_in].dot(this->Field_DDI_Single_Spin(ispin_in, spins));
+        }
+        else if (this->idx_ddi >= 0)
         {
-            for (unsigned int ipair = 0; ipair < ddi_pairs.size(); ++ipair)
+            // The translations are in angstr�m, so the |r|[m] becomes |r|[m]*10^-10
+            const scalar mult = mu_0 * std::pow(mu_B, 2) / ( 4*Pi * 1e-30 );
+
+            // The DDI pairs contain both directions of each pair, so there is no inverted pair
+            for (int ipair : ddi_tables->ddi_pairs_per_basis[ibasis])
             {
-                if (ddi_pairs[ipair].i == ibasis)
+                int ispin = ddi_pairs[ipair].i + icell*geometry->n_cell_atoms;
+                int jspin = idx_from_pair(ispin, boundary_conditions, geometry->n_cells, geometry->n_cell_atoms, geometry->atom_types, ddi_pairs[ipair]);
+                if (jspin >= 0)
                 {
-                    // The translations are in angstr�m, so the |r|[m] becomes |r|[m]*10^-10
-                    const scalar mult = 0.5 * this->mu_s[ddi_pairs[ipair].i] * this->mu_s[ddi_pairs[ipair].j]
-                        * Utility::Constants::mu_0 * std::pow(Utility::Constants::mu_B, 2) / ( 4*Utility::Constants::Pi * 1e-30 );
-
-                    int ispin = ddi_pairs[ipair].i + icell*geometry->n_cell_atoms;
-                    int jspin = idx_from_pair(ispin, boundary_conditions, geometry->n_cells, geometry->n_cell_atoms, geometry->atom_types, ddi_pairs[ipair]);
-
-                    if (jspin >= 0)
-                    {
-                        Energy -= mult / std::pow(this->ddi_magnitudes[ipair], 3.0) *
-                            (3 * spins[ispin].dot(this->ddi_normals[ipair]) * spins[ispin].dot(this->ddi_normals[ipair]) - spins[ispin].dot(spins[ispin]));
-
-                    }
-                    #ifndef _OPENMP
-                    jspin = idx_from_pair(ispin, boundary_conditions, geometry->n_cells, geometry->n_cell_atoms, geometry->atom_types, dmi_pairs[ipair], true);
-                    if (jspin >= 0)
-                    {
-                        Energy += mult / std::pow(this->ddi_magnitudes[ipair], 3.0) *
-                            (3 * spins[ispin].dot(this->ddi_normals[ipair]) * spins[ispin].dot(this->ddi_normals[ipair]) - spins[ispin].dot(spins[ispin]));
-                    }
-                    #endif
+                    Energy -= 0.5 * this->mu_s[ddi_pairs[ipair].i] * this->mu_s[ddi_pairs[ipair].j] * mult / std::pow(this->ddi_magnitudes[ipair], 3.0) *
+                        (3 * spins[ispin].dot(this->ddi_normals[ipair]) * spins[jspin].dot(this->ddi_normals[ipair]) - spins[ispin].dot(spins[jspin]));
                 }
             }
         }
@@ -494,6 +704,285 @@ namespace Engine
         return Energy;
     }
 
+    scalar Hamiltonian_Heisenberg::Energy_Single_Spin_Diff(int ispin, const vectorfield & spins, const Vector3 & spin_new)
+    {
+        const auto& tables = *this->interaction_tables;
+        if (!check_atom_type(this->geometry->atom_types[ispin]))
+            return 0;
+
+        const int N      = geometry->n_cell_atoms;
+        const int icell  = ispin / N;
+        const int ibasis = ispin - icell*N;
+        const Vector3 & spin_old = spins[ispin];
+        const Vector3 spin_diff  = spin_new - spin_old;
+        scalar Ediff = 0;
+
+        // External field
+        if (this->idx_zeeman >= 0)
+            Ediff -= this->mu_s[ibasis] * this->external_field_magnitude * this->external_field_normal.dot(spin_diff);
+
+        // Anisotropy
+        if (this->idx_anisotropy >= 0)
+        {
+            for (unsigned int iani = 0; iani < anisotropy_indices.size(); ++iani)
+            {
+                if (anisotropy_indices[iani] == ibasis)
+                    Ediff -= this->anisotropy_magnitudes[iani] * ( std::pow(anisotropy_normals[iani].dot(spin_new), 2.0)
+                                                                 - std::pow(anisotropy_normals[iani].dot(spin_old), 2.0) );
+            }
+        }
+
+        // The pair energies are linear in the spin, unless a spin interacts with its own periodic image.
+        // For exchange and DMI the energy of such a pair does not depend on the spin direction.
+
+        // Exchange
+        if (this->idx_exchange >= 0)
+        {
+            for (int k = tables.exchange_table.offsets[ispin]; k < tables.exchange_table.offsets[ispin+1]; ++k)
+            {
+                int jspin = tables.exchange_table.neighbours[k];
+                if (jspin != ispin)
+                    Ediff -= tables.exchange_table_magnitudes[k] * spin_diff.dot(spins[jspin]);
+            }
+        }
+
+        // DMI
+        if (this->idx_dmi >= 0)
+        {
+            for (int k = tables.dmi_table.offsets[ispin]; k < tables.dmi_table.offsets[ispin+1]; ++k)
+            {
+                int jspin = tables.dmi_table.neighbours[k];
+                if (jspin != ispin)
+                    Ediff -= tables.dmi_table_vectors[k].dot(spin_diff.cross(spins[jspin]));
+            }
+        }
+
+        // DDI
+        if (this->idx_ddi >= 0 && this->ddi_method == DDI_Method::FFT)
+        {
+            // The field contains the spin's own periodic images, which have to be treated separately
+            const scalar mu = this->mu_s[ibasis];
+            Vector3 field = this->Field_DDI_Single_Spin(ispin, spins) - this->Field_DDI_Periodic_Images(ibasis, mu*spin_old);
+            Ediff -= mu * spin_diff.dot(field);
+            Ediff -= 0.5 * mu * ( spin_new.dot(this->Field_DDI_Periodic_Images(ibasis, mu*spin_new))
+                                - spin_old.dot(this->Field_DDI_Periodic_Images(ibasis, mu*spin_old)) );
+        }
+        else if (this->idx_ddi >= 0)
+        {
+            // The translations are in angstr�m, so the |r|[m] becomes |r|[m]*10^-10
+            const scalar mult = mu_0 * std::pow(mu_B, 2) / ( 4*Pi * 1e-30 );
+
+            for (int ipair : ddi_tables->ddi_pairs_per_basis[ibasis])
+            {
+                int jspin = idx_from_pair(ispin, boundary_conditions, geometry->n_cells, N, geometry->atom_types, ddi_pairs[ipair]);
+                if (jspin < 0)
+                    continue;
+                const Vector3 & normal = this->ddi_normals[ipair];
+                scalar prefactor = this->mu_s[ddi_pairs[ipair].i] * this->mu_s[ddi_pairs[ipair].j] * mult / std::pow(this->ddi_magnitudes[ipair], 3.0);
+                if (jspin != ispin)
+                {
+                    Ediff -= prefactor * (3 * spin_diff.dot(normal) * spins[jspin].dot(normal) - spin_diff.dot(spins[jspin]));
+                }
+                else
+                {
+                    // Both directions of the pair are in the list of this atom
+                    Ediff -= 0.5 * prefactor * 3 * (std::pow(spin_new.dot(normal), 2.0) - std::pow(spin_old.dot(normal), 2.0));
+                }
+            }
+        }
+
+        // Quadruplets
+        if (this->idx_quadruplet >= 0)
+        {
+            const auto& n_cells = geometry->n_cells;
+            auto t_i = Vectormath::translations_from_idx(n_cells, N, ispin);
+            for (auto& site : tables.quadruplet_sites_per_basis[ibasis])
+            {
+                // The quadruplets are periodic in all directions (see E_Quadruplet)
+                int da = ((t_i[0] + site.translations[0]) % n_cells[0] + n_cells[0]) % n_cells[0];
+                int db = ((t_i[1] + site.translations[1]) % n_cells[1] + n_cells[1]) % n_cells[1];
+                int dc = ((t_i[2] + site.translations[2]) % n_cells[2] + n_cells[2]) % n_cells[2];
+                int spins_quad[4];
+                if (!this->quadruplet_spins(site.iquad, da + n_cells[0]*(db + n_cells[1]*dc), spins_quad[0], spins_quad[1], spins_quad[2], spins_quad[3]))
+                    continue;
+
+                Vector3 s_old[4], s_new[4];
+                for (int a = 0; a < 4; ++a)
+                {
+                    s_old[a] = spins[spins_quad[a]];
+                    s_new[a] = (spins_quad[a] == ispin) ? spin_new : s_old[a];
+                }
+                Ediff -= quadruplet_magnitudes[site.iquad] * ( s_new[0].dot(s_new[1]) * s_new[2].dot(s_new[3])
+                                                             - s_old[0].dot(s_old[1]) * s_old[2].dot(s_old[3]) );
+            }
+        }
+
+        return Ediff;
+    }
+
+
+    Vector3 Hamiltonian_Heisenberg::Effective_Field_Single_Spin(int ispin, const vectorfield & spins)
+    {
+        const auto& tables = *this->interaction_tables;
+        Vector3 field{0, 0, 0};
+        if (!check_atom_type(this->geometry->atom_types[ispin]))
+            return field;
+
+        const int N      = geometry->n_cell_atoms;
+        const int ibasis = ispin % N;
+
+        // The anisotropy is even in the spin and does not contribute.
+        // The same holds for pairs of a spin with its own periodic images.
+
+        // External field
+        if (this->idx_zeeman >= 0)
+            field += this->mu_s[ibasis] * this->external_field_magnitude * this->external_field_normal;
+
+        // Exchange
+        if (this->idx_exchange >= 0)
+        {
+            for (int k = tables.exchange_table.offsets[ispin]; k < tables.exchange_table.offsets[ispin+1]; ++k)
+            {
+                int jspin = tables.exchange_table.neighbours[k];
+                if (jspin != ispin)
+                    field += tables.exchange_table_magnitudes[k] * spins[jspin];
+            }
+        }
+
+        // DMI
+        if (this->idx_dmi >= 0)
+        {
+            for (int k = tables.dmi_table.offsets[ispin]; k < tables.dmi_table.offsets[ispin+1]; ++k)
+            {
+                int jspin = tables.dmi_table.neighbours[k];
+                if (jspin != ispin)
+                    field += spins[jspin].cross(tables.dmi_table_vectors[k]);
+            }
+        }
+
+        // DDI
+        if (this->idx_ddi >= 0 && this->ddi_method == DDI_Method::FFT)
+        {
+            const scalar mu = this->mu_s[ibasis];
+            field += mu * ( this->Field_DDI_Single_Spin(ispin, spins) - this->Field_DDI_Periodic_Images(ibasis, mu*spins[ispin]) );
+        }
+        else if (this->idx_ddi >= 0)
+        {
+            // The translations are in angstr�m, so the |r|[m] becomes |r|[m]*10^-10
+            const scalar mult = mu_0 * std::pow(mu_B, 2) / ( 4*Pi * 1e-30 );
+
+            for (int ipair : ddi_tables->ddi_pairs_per_basis[ibasis])
+            {
+                int jspin = idx_from_pair(ispin, boundary_conditions, geometry->n_cells, N, geometry->atom_types, ddi_pairs[ipair]);
+                if (jspin < 0 || jspin == ispin)
+                    continue;
+                const Vector3 & normal = this->ddi_normals[ipair];
+                scalar prefactor = this->mu_s[ddi_pairs[ipair].i] * this->mu_s[ddi_pairs[ipair].j] * mult / std::pow(this->ddi_magnitudes[ipair], 3.0);
+                field += prefactor * (3 * spins[jspin].dot(normal) * normal - spins[jspin]);
+            }
+        }
+
+        // Quadruplets
+        if (this->idx_quadruplet >= 0)
+        {
+            const auto& n_cells = geometry->n_cells;
+            auto t_i = Vectormath::translations_from_idx(n_cells, N, ispin);
+            for (auto& site : tables.quadruplet_sites_per_basis[ibasis])
+            {
+                int da = ((t_i[0] + site.translations[0]) % n_cells[0] + n_cells[0]) % n_cells[0];
+                int db = ((t_i[1] + site.translations[1]) % n_cells[1] + n_cells[1]) % n_cells[1];
+                int dc = ((t_i[2] + site.translations[2]) % n_cells[2] + n_cells[2]) % n_cells[2];
+                int q[4];
+                if (!this->quadruplet_spins(site.iquad, da + n_cells[0]*(db + n_cells[1]*dc), q[0], q[1], q[2], q[3]))
+                    continue;
+
+                // Only quadruplets in which the spin appears once are linear in it
+                if ((q[0] == ispin) + (q[1] == ispin) + (q[2] == ispin) + (q[3] == ispin) != 1)
+                    continue;
+                const scalar K = quadruplet_magnitudes[site.iquad];
+                if (q[0] == ispin)      field += K * spins[q[2]].dot(spins[q[3]]) * spins[q[1]];
+                else if (q[1] == ispin) field += K * spins[q[2]].dot(spins[q[3]]) * spins[q[0]];
+                else if (q[2] == ispin) field += K * spins[q[0]].dot(spins[q[1]]) * spins[q[3]];
+                else                    field += K * spins[q[0]].dot(spins[q[1]]) * spins[q[2]];
+            }
+        }
+
+        return field;
+    }
+
+
+    bool Hamiltonian_Heisenberg::Interaction_Graph(intfield & offsets, intfield & neighbours)
+    {
+        const auto& tables = *this->interaction_tables;
+        // With the FFT method, the DDI couples all spins
+        if (this->idx_ddi >= 0 && this->ddi_method == DDI_Method::FFT)
+            return false;
+
+        const int nos = geometry->nos;
+        const int N   = geometry->n_cell_atoms;
+        std::vector<std::vector<int>> graph(nos);
+        auto connect = [&graph] (int ispin, int jspin)
+        {
+            if (ispin != jspin)
+            {
+                graph[ispin].push_back(jspin);
+                graph[jspin].push_back(ispin);
+            }
+        };
+
+        // Exchange and DMI
+        for (int ispin = 0; ispin < nos; ++ispin)
+        {
+            for (int k = tables.exchange_table.offsets[ispin]; k < tables.exchange_table.offsets[ispin+1]; ++k)
+                connect(ispin, tables.exchange_table.neighbours[k]);
+            for (int k = tables.dmi_table.offsets[ispin]; k < tables.dmi_table.offsets[ispin+1]; ++k)
+                connect(ispin, tables.dmi_table.neighbours[k]);
+        }
+
+        // Dipole-Dipole
+        if (this->idx_ddi >= 0)
+        {
+            for (int icell = 0; icell < geometry->n_cells_total; ++icell)
+            {
+                for (unsigned int i_pair = 0; i_pair < ddi_pairs.size(); ++i_pair)
+                {
+                    int ispin = ddi_pairs[i_pair].i + icell*N;
+                    int jspin = idx_from_pair(ispin, boundary_conditions, geometry->n_cells, N, geometry->atom_types, ddi_pairs[i_pair]);
+                    if (jspin >= 0)
+                        connect(ispin, jspin);
+                }
+            }
+        }
+
+        // Quadruplets
+        for (unsigned int iquad = 0; iquad < quadruplets.size(); ++iquad)
+        {
+            for (int icell = 0; icell < geometry->n_cells_total; ++icell)
+            {
+                int spins_quad[4];
+                if (this->quadruplet_spins(iquad, icell, spins_quad[0], spins_quad[1], spins_quad[2], spins_quad[3]))
+                {
+                    for (int a = 0; a < 4; ++a)
+                        for (int b = a+1; b < 4; ++b)
+                            connect(spins_quad[a], spins_quad[b]);
+                }
+            }
+        }
+
+        // Remove duplicates and pack
+        offsets = intfield(nos + 1, 0);
+        neighbours.clear();
+        for (int ispin = 0; ispin < nos; ++ispin)
+        {
+            auto& g = graph[ispin];
+            std::sort(g.begin(), g.end());
+            g.erase(std::unique(g.begin(), g.end()), g.end());
+            neighbours.insert(neighbours.end(), g.begin(), g.end());
+            offsets[ispin+1] = neighbours.size();
+        }
+        return true;
+    }
+
 
     void Hamiltonian_Heisenberg::Gradient(const vectorfield & spins, vectorfield & gradient)
     {
@@ -517,8 +1006,33 @@ namespace Engine
         this->Gradient_Quadruplet(spins, gradient);
     }
 
+    scalar Hamiltonian_Heisenberg::Energy_and_Gradient(const vectorfield & spins, vectorfield & gradient)
+    {
+        // Each term is a homogeneous polynomial of degree k in the spins, so that
+        //      its energy is s*grad(E_k)/k. The gradient is accumulated by degree.
+        Vectormath::fill(gradient, {0,0,0});
+
+        // Degree 4: quadruplets
+        this->Gradient_Quadruplet(spins, gradient);
+        scalar sg_4 = Vectormath::dot(spins, gradient);
+
+        // Degree 1: external field
+        Gradient_Zeeman(gradient);
+        scalar sg_1 = Vectormath::dot(spins, gradient) - sg_4;
+
+        // Degree 2: anisotropy, exchange, DMI and DDI
+        Gradient_Anisotropy(spins, gradient);
+        this->Gradient_Exchange(spins, gradient);
+        this->Gradient_DMI(spins, gradient);
+        this->Gradient_DDI(spins, gradient);
+        scalar sg_2 = Vectormath::dot(spins, gradient) - sg_4 - sg_1;
+
+        return sg_1 + sg_2/2 + sg_4/4;
+    }
+
     void Hamiltonian_Heisenberg::Gradient_Zeeman(vectorfield & gradient)
     {
+        Timing::Scope timing(timing_gradient_zeeman);
         const int N = geometry->n_cell_atoms;
 
         #pragma omp parallel for
@@ -535,6 +1049,7 @@ namespace Engine
 
     void Hamiltonian_Heisenberg::Gradient_Anisotropy(const vectorfield & spins, vectorfield & gradient)
     {
+        Timing::Scope timing(timing_gradient_anisotropy);
         const int N = geometry->n_cell_atoms;
 
         #pragma omp parallel for
@@ -551,81 +1066,202 @@ namespace Engine
 
     void Hamiltonian_Heisenberg::Gradient_Exchange(const vectorfield & spins, vectorfield & gradient)
     {
+        Timing::Scope timing(timing_gradient_exchange);
+        const auto& tables = *this->interaction_tables;
+        const auto& offsets    = tables.exchange_table.offsets;
+        const auto& neighbours = tables.exchange_table.neighbours;
+
         #pragma omp parallel for
-        for (int icell = 0; icell < geometry->n_cells_total; ++icell)
+        for (int ispin = 0; ispin < geometry->nos; ++ispin)
         {
-            for (unsigned int i_pair = 0; i_pair < exchange_pairs.size(); ++i_pair)
-            {
-                int ispin = exchange_pairs[i_pair].i + icell*geometry->n_cell_atoms;
-                int jspin = idx_from_pair(ispin, boundary_conditions, geometry->n_cells, geometry->n_cell_atoms, geometry->atom_types, exchange_pairs[i_pair]);
-                if (jspin >= 0)
-                {
-                    gradient[ispin] -= exchange_magnitudes[i_pair] * spins[jspin];
-                    #ifndef _OPENMP
-                    gradient[jspin] -= exchange_magnitudes[i_pair] * spins[ispin];
-                    #endif
-                }
-            }
+            for (int k = offsets[ispin]; k < offsets[ispin+1]; ++k)
+                gradient[ispin] -= tables.exchange_table_magnitudes[k] * spins[neighbours[k]];
         }
     }
 
     void Hamiltonian_Heisenberg::Gradient_DMI(const vectorfield & spins, vectorfield & gradient)
     {
+        Timing::Scope timing(timing_gradient_dmi);
+        const auto& tables = *this->interaction_tables;
+        const auto& offsets    = tables.dmi_table.offsets;
+        const auto& neighbours = tables.dmi_table.neighbours;
+
         #pragma omp parallel for
-        for (int icell = 0; icell < geometry->n_cells_total; ++icell)
+        for (int ispin = 0; ispin < geometry->nos; ++ispin)
         {
-            for (unsigned int i_pair = 0; i_pair < dmi_pairs.size(); ++i_pair)
-            {
-                int ispin = dmi_pairs[i_pair].i + icell*geometry->n_cell_atoms;
-                int jspin = idx_from_pair(ispin, boundary_conditions, geometry->n_cells, geometry->n_cell_atoms, geometry->atom_types, dmi_pairs[i_pair]);
-                if (jspin >= 0)
-                {
-                    gradient[ispin] -= dmi_magnitudes[i_pair] * spins[jspin].cross(dmi_normals[i_pair]);
-                    #ifndef _OPENMP
-                    gradient[jspin] += dmi_magnitudes[i_pair] * spins[ispin].cross(dmi_normals[i_pair]);
-                    #endif
-                }
-            }
+            for (int k = offsets[ispin]; k < offsets[ispin+1]; ++k)
+                gradient[ispin] -= spins[neighbours[k]].cross(tables.dmi_table_vectors[k]);
         }
     }
 
     void Hamiltonian_Heisenberg::Gradient_DDI(const vectorfield & spins, vectorfield & gradient)
     {
+        Timing::Scope timing(timing_gradient_ddi);
+        if (this->ddi_method == DDI_Method::FFT)
+        {
+            this->Field_DDI_FFT(spins, this->ddi_buffers.field);
+
+            #pragma omp parallel for
+            for (int ispin = 0; ispin < geometry->nos; ++ispin)
+                gradient[ispin] -= this->mu_s[ispin % geometry->n_cell_atoms] * this->ddi_buffers.field[ispin];
+            return;
+        }
+
         // The translations are in angstr�m, so the |r|[m] becomes |r|[m]*10^-10
         const scalar mult = mu_0 * std::pow(mu_B, 2) / ( 4*Pi * 1e-30 );
-        
-        for (unsigned int i_pair = 0; i_pair < ddi_pairs.size(); ++i_pair)
+
+        // The DDI pairs are not reduced to unique pairs, so each spin only accumulates its own share
+        #pragma omp parallel for
+        for (int icell = 0; icell < geometry->n_cells_total; ++icell)
         {
-            if (ddi_magnitudes[i_pair] > 0.0)
+            for (unsigned int i_pair = 0; i_pair < ddi_pairs.size(); ++i_pair)
             {
-                for (int da = 0; da < geometry->n_cells[0]; ++da)
+                if (ddi_magnitudes[i_pair] > 0.0)
                 {
-                    for (int db = 0; db < geometry->n_cells[1]; ++db)
+                    scalar skalar_contrib = mult / std::pow(ddi_magnitudes[i_pair], 3.0);
+                    int i = ddi_pairs[i_pair].i;
+                    int j = ddi_pairs[i_pair].j;
+                    int ispin = i + icell*geometry->n_cell_atoms;
+                    int jspin = idx_from_pair(ispin, boundary_conditions, geometry->n_cells, geometry->n_cell_atoms, geometry->atom_types, ddi_pairs[i_pair]);
+                    if (jspin >= 0)
                     {
-                        for (int dc = 0; dc < geometry->n_cells[2]; ++dc)
-                        {
-                            scalar skalar_contrib = mult / std::pow(ddi_magnitudes[i_pair], 3.0);
-                            std::array<int, 3 > translations = { da, db, dc };
-
-                            int i = ddi_pairs[i_pair].i;
-                            int j = ddi_pairs[i_pair].j;
-                            int ispin = i + Vectormath::idx_from_translations(geometry->n_cells, geometry->n_cell_atoms, translations);	
-                            int jspin = idx_from_pair(ispin, boundary_conditions, geometry->n_cells, geometry->n_cell_atoms, geometry->atom_types, ddi_pairs[i_pair]);
-                            if (jspin >= 0)
-                            {
-                                gradient[ispin] -= this->mu_s[j] * skalar_contrib * (3 * ddi_normals[i_pair] * spins[jspin].dot(ddi_normals[i_pair]) - spins[jspin]);
-                                gradient[jspin] -= this->mu_s[i] * skalar_contrib * (3 * ddi_normals[i_pair] * spins[ispin].dot(ddi_normals[i_pair]) - spins[ispin]);
-                            }
-                        }
+                        gradient[ispin] -= this->mu_s[i] * this->mu_s[j] * skalar_contrib * (3 * ddi_normals[i_pair] * spins[jspin].dot(ddi_normals[i_pair]) - spins[jspin]);
                     }
                 }
             }
         }
     }//end Field_DipoleDipole
 
+    void Hamiltonian_Heisenberg::Field_DDI_FFT(const vectorfield & spins, vectorfield & field)
+    {
+        const auto& tables = *this->ddi_tables;
+        const int N = geometry->n_cell_atoms;
+        const int n_grid = tables.ddi_fft_plan.n_total;
+        const auto& n_cells = geometry->n_cells;
+
+        // The work buffers are allocated on first use, as they are not copied with the Hamiltonian
+        auto& buffers = this->ddi_buffers;
+        if (buffers.moments_k.size() != std::size_t(N*3*n_grid))
+        {
+            buffers.moments_k = FFT::cpxfield(N*3*n_grid);
+            buffers.field_k   = FFT::cpxfield(3*n_grid);
+        }
+        if (field.size() != spins.size())
+            field = vectorfield(spins.size());
+
+        // Scatter the magnetic moments onto the padded grid and transform them
+        std::fill(buffers.moments_k.begin(), buffers.moments_k.end(), FFT::cpx(0));
+        #pragma omp parallel for
+        for (int icell = 0; icell < geometry->n_cells_total; ++icell)
+        {
+            int ta = icell % n_cells[0];
+            int tb = (icell / n_cells[0]) % n_cells[1];
+            int tc = icell / (n_cells[0]*n_cells[1]);
+            int idx = ddi_fft_idx(ta, tb, tc);
+            for (int ibasis = 0; ibasis < N; ++ibasis)
+            {
+                int ispin = icell*N + ibasis;
+                if (check_atom_type(this->geometry->atom_types[ispin]))
+                {
+                    for (int dim = 0; dim < 3; ++dim)
+                        buffers.moments_k[(ibasis*3 + dim)*n_grid + idx] = this->mu_s[ibasis] * spins[ispin][dim];
+                }
+            }
+        }
+        for (int block = 0; block < N*3; ++block)
+            tables.ddi_fft_plan.Transform(&buffers.moments_k[block*n_grid]);
+
+        for (int ia = 0; ia < N; ++ia)
+        {
+            // Multiply the tensors and moments in reciprocal space
+            std::fill(buffers.field_k.begin(), buffers.field_k.end(), FFT::cpx(0));
+            for (int ib = 0; ib < N; ++ib)
+            {
+                const FFT::cpx * tensor = &tables.ddi_tensors_k[(ia*N + ib)*6*n_grid];
+                const FFT::cpx * moment = &buffers.moments_k[ib*3*n_grid];
+                #pragma omp parallel for
+                for (int k = 0; k < n_grid; ++k)
+                {
+                    const FFT::cpx mx = moment[k], my = moment[n_grid + k], mz = moment[2*n_grid + k];
+                    buffers.field_k[k]            += tensor[k]*mx            + tensor[n_grid + k]*my   + tensor[2*n_grid + k]*mz;
+                    buffers.field_k[n_grid + k]   += tensor[n_grid + k]*mx   + tensor[3*n_grid + k]*my + tensor[4*n_grid + k]*mz;
+                    buffers.field_k[2*n_grid + k] += tensor[2*n_grid + k]*mx + tensor[4*n_grid + k]*my + tensor[5*n_grid + k]*mz;
+                }
+            }
+
+            // Transform back and gather the field of basis atom ia
+            for (int dim = 0; dim < 3; ++dim)
+                tables.ddi_fft_plan.Transform(&buffers.field_k[dim*n_grid], true);
+
+            #pragma omp parallel for
+            for (int icell = 0; icell < geometry->n_cells_total; ++icell)
+            {
+                int ta = icell % n_cells[0];
+                int tb = (icell / n_cells[0]) % n_cells[1];
+                int tc = icell / (n_cells[0]*n_cells[1]);
+                int idx = ddi_fft_idx(ta, tb, tc);
+                int ispin = icell*N + ia;
+                for (int dim = 0; dim < 3; ++dim)
+                    field[ispin][dim] = buffers.field_k[dim*n_grid + idx].real();
+            }
+        }
+    }
+
+
+    Vector3 Hamiltonian_Heisenberg::Field_DDI_Single_Spin(int ispin, const vectorfield & spins)
+    {
+        const auto& tables = *this->ddi_tables;
+        const int N = geometry->n_cell_atoms;
+        const int ibasis = ispin % N;
+        const int n_grid = tables.ddi_fft_plan.n_total;
+        const auto& dims = tables.ddi_fft_plan.dims;
+        auto t_i = Vectormath::translations_from_idx(geometry->n_cells, N, ispin);
+
+        Vector3 field{0, 0, 0};
+        for (int jspin = 0; jspin < geometry->nos; ++jspin)
+        {
+            if (!check_atom_type(this->geometry->atom_types[jspin])) continue;
+            int jbasis = jspin % N;
+            auto t_j = Vectormath::translations_from_idx(geometry->n_cells, N, jspin);
+            int idx = ddi_fft_idx((t_i[0] - t_j[0] + dims[0]) % dims[0],
+                                  (t_i[1] - t_j[1] + dims[1]) % dims[1],
+                                  (t_i[2] - t_j[2] + dims[2]) % dims[2]);
+            const scalar * tensor = &tables.ddi_tensors[(ibasis*N + jbasis)*6*n_grid + idx];
+            Vector3 m = this->mu_s[jbasis] * spins[jspin];
+            field[0] += tensor[0*n_grid]*m[0] + tensor[1*n_grid]*m[1] + tensor[2*n_grid]*m[2];
+            field[1] += tensor[1*n_grid]*m[0] + tensor[3*n_grid]*m[1] + tensor[4*n_grid]*m[2];
+            field[2] += tensor[2*n_grid]*m[0] + tensor[4*n_grid]*m[1] + tensor[5*n_grid]*m[2];
+        }
+        return field;
+    }
+
+    Vector3 Hamiltonian_Heisenberg::Field_DDI_Periodic_Images(int ibasis, const Vector3 & m) const
+    {
+        const auto& tables = *this->ddi_tables;
+        const int N = geometry->n_cell_atoms;
+        const int n_grid = tables.ddi_fft_plan.n_total;
+        const scalar * tensor = &tables.ddi_tensors[(ibasis*N + ibasis)*6*n_grid + ddi_fft_idx(0, 0, 0)];
+        return { tensor[0*n_grid]*m[0] + tensor[1*n_grid]*m[1] + tensor[2*n_grid]*m[2],
+                 tensor[1*n_grid]*m[0] + tensor[3*n_grid]*m[1] + tensor[4*n_grid]*m[2],
+                 tensor[2*n_grid]*m[0] + tensor[4*n_grid]*m[1] + tensor[5*n_grid]*m[2] };
+    }
+
+    bool Hamiltonian_Heisenberg::quadruplet_spins(int iquad, int icell, int & ispin, int & jspin, int & kspin, int & lspin) const
+    {
+        const auto& quad = quadruplets[iquad];
+        const auto& n_cells = geometry->n_cells;
+        std::array<int, 3> translations = { icell % n_cells[0], (icell / n_cells[0]) % n_cells[1], icell / (n_cells[0]*n_cells[1]) };
+        ispin = quad.i + Vectormath::idx_from_translations(n_cells, geometry->n_cell_atoms, translations);
+        jspin = quad.j + Vectormath::idx_from_translations(n_cells, geometry->n_cell_atoms, translations, quad.d_j);
+        kspin = quad.k + Vectormath::idx_from_translations(n_cells, geometry->n_cell_atoms, translations, quad.d_k);
+        lspin = quad.l + Vectormath::idx_from_translations(n_cells, geometry->n_cell_atoms, translations, quad.d_l);
+        return check_atom_type(this->geometry->atom_types[ispin]) && check_atom_type(this->geometry->atom_types[jspin]) &&
+               check_atom_type(this->geometry->atom_types[kspin]) && check_atom_type(this->geometry->atom_types[lspin]);
+    }
 
     void Hamiltonian_Heisenberg::Gradient_Quadruplet(const vectorfield & spins, vectorfield & gradient)
     {
+        Timing::Scope timing(timing_gradient_quadruplet);
         for (unsigned int iquad = 0; iquad < quadruplets.size(); ++iquad)
         {
             int i = quadruplets[iquad].i;
@@ -661,135 +1297,187 @@ namespace Engine
 
     void Hamiltonian_Heisenberg::Hessian(const vectorfield & spins, MatrixX & hessian)
     {
+        SpMatrixX sparse_hessian;
+        this->Sparse_Hessian(spins, sparse_hessian);
+        hessian = MatrixX(sparse_hessian);
+    }
+
+    void Hamiltonian_Heisenberg::Sparse_Hessian(const vectorfield & spins, SpMatrixX & hessian)
+    {
+        Timing::Scope timing(timing_hessian);
+        const auto& tables = *this->interaction_tables;
         int nos = spins.size();
+        const int N = geometry->n_cell_atoms;
 
-        // Set to zero
-        hessian.setZero();
+        // The Hessian is assembled from 3x3 blocks, which are summed up by setFromTriplets
+        std::vector<Eigen::Triplet<scalar>> triplets;
+        triplets.reserve( 9 * ( nos * anisotropy_indices.size()/std::max(N, 1)
+                              + tables.exchange_table.neighbours.size() + tables.dmi_table.neighbours.size()
+                              + nos * ddi_pairs.size()/std::max(N, 1)
+                              + (this->ddi_method == DDI_Method::FFT ? nos : 0) * nos
+                              + 12 * geometry->n_cells_total * quadruplets.size() ) );
+        auto add_block = [&triplets] (int ispin, int jspin, const Matrix3 & block)
+        {
+            for (int alpha = 0; alpha < 3; ++alpha)
+                for (int beta = 0; beta < 3; ++beta)
+                    if (block(alpha, beta) != 0)
+                        triplets.push_back( Eigen::Triplet<scalar>(3*ispin + alpha, 3*jspin + beta, block(alpha, beta)) );
+        };
 
-        // Single Spin elements
-        for (int da = 0; da < geometry->n_cells[0]; ++da)
+        // Anisotropy
+        for (int icell = 0; icell < geometry->n_cells_total; ++icell)
         {
-            for (int db = 0; db < geometry->n_cells[1]; ++db)
+            for (unsigned int iani = 0; iani < anisotropy_indices.size(); ++iani)
             {
-                for (int dc = 0; dc < geometry->n_cells[2]; ++dc)
-                {
-                    std::array<int, 3 > translations = { da, db, dc };
-                    int icell = Vectormath::idx_from_translations(geometry->n_cells, geometry->n_cell_atoms, translations);
-                    for (int alpha = 0; alpha < 3; ++alpha)
-                    {
-                        for ( int beta = 0; beta < 3; ++beta )
-                        {
-                            for (unsigned int i = 0; i < anisotropy_indices.size(); ++i)
-                            {
-                                if ( check_atom_type(this->geometry->atom_types[anisotropy_indices[i]]) )
-                                {
-                                    int idx_i = 3 * icell + anisotropy_indices[i] + alpha;
-                                    int idx_j = 3 * icell + anisotropy_indices[i] + beta;
-                                    // scalar x = -2.0*this->anisotropy_magnitudes[i] * std::pow(this->anisotropy_normals[i][alpha], 2);
-                                    hessian( idx_i, idx_j ) += -2.0 * this->anisotropy_magnitudes[i] * 
-                                                                    this->anisotropy_normals[i][alpha] * 
-                                                                    this->anisotropy_normals[i][beta];
-                                }
-                            }
-                        }
-                    }
-                }
+                int ispin = icell*N + anisotropy_indices[iani];
+                if (check_atom_type(this->geometry->atom_types[ispin]))
+                    add_block(ispin, ispin, -2.0 * this->anisotropy_magnitudes[iani] * this->anisotropy_normals[iani] * this->anisotropy_normals[iani].transpose());
             }
         }
 
-        // Spin Pair elements
-        // Exchange
-        for (int da = 0; da < geometry->n_cells[0]; ++da)
+        // Exchange and DMI (the neighbour tables contain both directions of each pair)
+        for (int ispin = 0; ispin < nos; ++ispin)
         {
-            for (int db = 0; db < geometry->n_cells[1]; ++db)
+            for (int k = tables.exchange_table.offsets[ispin]; k < tables.exchange_table.offsets[ispin+1]; ++k)
+                add_block(ispin, tables.exchange_table.neighbours[k], -tables.exchange_table_magnitudes[k] * Matrix3::Identity());
+
+            for (int k = tables.dmi_table.offsets[ispin]; k < tables.dmi_table.offsets[ispin+1]; ++k)
             {
-                for (int dc = 0; dc < geometry->n_cells[2]; ++dc)
+                // The gradient contribution -s_j x D corresponds to the block -[D]_x
+                const Vector3 & D = tables.dmi_table_vectors[k];
+                Matrix3 block;
+                block <<     0,  D[2], -D[1],
+                         -D[2],     0,  D[0],
+                          D[1], -D[0],     0;
+                add_block(ispin, tables.dmi_table.neighbours[k], -block);
+            }
+        }
+
+        // Dipole-Dipole
+        if (this->ddi_method == DDI_Method::Cutoff)
+        {
+            // The translations are in angstr�m, so the |r|[m] becomes |r|[m]*10^-10
+            const scalar mult = mu_0 * std::pow(mu_B, 2) / ( 4*Pi * 1e-30 );
+
+            for (int icell = 0; icell < geometry->n_cells_total; ++icell)
+            {
+                for (unsigned int i_pair = 0; i_pair < ddi_pairs.size(); ++i_pair)
                 {
-                    std::array<int, 3 > translations = { da, db, dc };
-                    for (unsigned int i_pair = 0; i_pair < this->exchange_pairs.size(); ++i_pair)
+                    if (ddi_magnitudes[i_pair] > 0.0)
                     {
-                        int ispin = exchange_pairs[i_pair].i + Vectormath::idx_from_translations(geometry->n_cells, geometry->n_cell_atoms, translations);
-                        int jspin = idx_from_pair(ispin, boundary_conditions, geometry->n_cells, geometry->n_cell_atoms, geometry->atom_types, exchange_pairs[i_pair]);
+                        scalar skalar_contrib = mult / std::pow(ddi_magnitudes[i_pair], 3.0);
+                        int i = ddi_pairs[i_pair].i;
+                        int j = ddi_pairs[i_pair].j;
+                        int ispin = i + icell*N;
+                        int jspin = idx_from_pair(ispin, boundary_conditions, geometry->n_cells, N, geometry->atom_types, ddi_pairs[i_pair]);
                         if (jspin >= 0)
                         {
-                            for (int alpha = 0; alpha < 3; ++alpha)
-                            {
-                                int i = 3 * ispin + alpha;
-                                int j = 3 * jspin + alpha;
-
-                                hessian(i, j) += -exchange_magnitudes[i_pair];
-                                #ifndef _OPENMP
-                                hessian(j, i) += -exchange_magnitudes[i_pair];
-                                #endif
-                            }
+                            const Vector3 & n = ddi_normals[i_pair];
+                            add_block(ispin, jspin, -this->mu_s[i] * this->mu_s[j] * skalar_contrib * (3 * n * n.transpose() - Matrix3::Identity()));
                         }
                     }
                 }
             }
         }
-
-        // DMI
-        for (int da = 0; da < geometry->n_cells[0]; ++da)
+        else if (this->ddi_method == DDI_Method::FFT)
         {
-            for (int db = 0; db < geometry->n_cells[1]; ++db)
+            // The FFT method couples all spins, so the blocks are taken from the real space
+            // tensors in the same way as in Field_DDI_Single_Spin
+            const auto& ddi = *this->ddi_tables;
+            const int n_grid = ddi.ddi_fft_plan.n_total;
+            const auto& dims = ddi.ddi_fft_plan.dims;
+            for (int ispin = 0; ispin < nos; ++ispin)
             {
-                for (int dc = 0; dc < geometry->n_cells[2]; ++dc)
+                if (!check_atom_type(this->geometry->atom_types[ispin])) continue;
+                int ibasis = ispin % N;
+                auto t_i = Vectormath::translations_from_idx(geometry->n_cells, N, ispin);
+                for (int jspin = 0; jspin < nos; ++jspin)
                 {
-                    std::array<int, 3 > translations = { da, db, dc };
-                    for (unsigned int i_pair = 0; i_pair < this->dmi_pairs.size(); ++i_pair)
-                    {
-                        int ispin = dmi_pairs[i_pair].i + Vectormath::idx_from_translations(geometry->n_cells, geometry->n_cell_atoms, translations);
-                        int jspin = idx_from_pair(ispin, boundary_conditions, geometry->n_cells, geometry->n_cell_atoms, geometry->atom_types, dmi_pairs[i_pair]);
-                        if (jspin >= 0)
-                        {
-                            int i = 3*ispin;
-                            int j = 3*jspin;
-
-                            hessian(i+2, j+1) +=  dmi_magnitudes[i_pair] * dmi_normals[i_pair][0];
-                            hessian(i+1, j+2) += -dmi_magnitudes[i_pair] * dmi_normals[i_pair][0];
-                            hessian(i, j+2)   +=  dmi_magnitudes[i_pair] * dmi_normals[i_pair][1];
-                            hessian(i+2, j)   += -dmi_magnitudes[i_pair] * dmi_normals[i_pair][1];
-                            hessian(i+1, j)   +=  dmi_magnitudes[i_pair] * dmi_normals[i_pair][2];
-                            hessian(i, j+1)   += -dmi_magnitudes[i_pair] * dmi_normals[i_pair][2];
-
-                            #ifndef _OPENMP
-                            hessian(j+1, i+2) +=  dmi_magnitudes[i_pair] * dmi_normals[i_pair][0];
-                            hessian(j+2, i+1) += -dmi_magnitudes[i_pair] * dmi_normals[i_pair][0];
-                            hessian(j+2, i)   +=  dmi_magnitudes[i_pair] * dmi_normals[i_pair][1];
-                            hessian(j, i+2)   += -dmi_magnitudes[i_pair] * dmi_normals[i_pair][1];
-                            hessian(j, i+1)   +=  dmi_magnitudes[i_pair] * dmi_normals[i_pair][2];
-                            hessian(j+1, i)   += -dmi_magnitudes[i_pair] * dmi_normals[i_pair][2];
-                            #endif
-                        }
-                    }
+                    if (!check_atom_type(this->geometry->atom_types[jspin])) continue;
+                    int jbasis = jspin % N;
+                    auto t_j = Vectormath::translations_from_idx(geometry->n_cells, N, jspin);
+                    int idx = ddi_fft_idx((t_i[0] - t_j[0] + dims[0]) % dims[0],
+                                          (t_i[1] - t_j[1] + dims[1]) % dims[1],
+                                          (t_i[2] - t_j[2] + dims[2]) % dims[2]);
+                    const scalar * tensor = &ddi.ddi_tensors[(ibasis*N + jbasis)*6*n_grid + idx];
+                    Matrix3 block;
+                    block << tensor[0*n_grid], tensor[1*n_grid], tensor[2*n_grid],
+                             tensor[1*n_grid], tensor[3*n_grid], tensor[4*n_grid],
+                             tensor[2*n_grid], tensor[4*n_grid], tensor[5*n_grid];
+                    add_block(ispin, jspin, -this->mu_s[ibasis] * this->mu_s[jbasis] * block);
                 }
             }
         }
 
-        //// Dipole-Dipole
-        //for (unsigned int i_pair = 0; i_pair < this->DD_indices.size(); ++i_pair)
-        //{
-        //	// indices
-        //	int idx_1 = DD_indices[i_pair][0];
-        //	int idx_2 = DD_indices[i_pair][1];
-        //	// prefactor
-        //	scalar prefactor = 0.0536814951168
-        //		* this->mu_s[idx_1] * this->mu_s[idx_2]
-        //		/ std::pow(DD_magnitude[i_pair], 3);
-        //	// components
-        //	for (int alpha = 0; alpha < 3; ++alpha)
-        //	{
-        //		for (int beta = 0; beta < 3; ++beta)
-        //		{
-        //			int idx_h = idx_1 + alpha*nos + 3 * nos*(idx_2 + beta*nos);
-        //			if (alpha == beta)
-        //				hessian[idx_h] += prefactor;
-        //			hessian[idx_h] += -3.0*prefactor*DD_normal[i_pair][alpha] * DD_normal[i_pair][beta];
-        //		}
-        //	}
-        //}
+        // Quadruplets
+        for (unsigned int iquad = 0; iquad < quadruplets.size(); ++iquad)
+        {
+            scalar K = quadruplet_magnitudes[iquad];
+            for (int icell = 0; icell < geometry->n_cells_total; ++icell)
+            {
+                int ispin, jspin, kspin, lspin;
+                if (!this->quadruplet_spins(iquad, icell, ispin, jspin, kspin, lspin))
+                    continue;
+
+                const Vector3 & s_i = spins[ispin];
+                const Vector3 & s_j = spins[jspin];
+                const Vector3 & s_k = spins[kspin];
+                const Vector3 & s_l = spins[lspin];
+
+                Matrix3 block_ij = -K * s_k.dot(s_l) * Matrix3::Identity();
+                Matrix3 block_kl = -K * s_i.dot(s_j) * Matrix3::Identity();
+                Matrix3 block_ik = -K * s_j * s_l.transpose();
+                Matrix3 block_il = -K * s_j * s_k.transpose();
+                Matrix3 block_jk = -K * s_i * s_l.transpose();
+                Matrix3 block_jl = -K * s_i * s_k.transpose();
+
+                add_block(ispin, jspin, block_ij); add_block(jspin, ispin, block_ij);
+                add_block(kspin, lspin, block_kl); add_block(lspin, kspin, block_kl);
+                add_block(ispin, kspin, block_ik); add_block(kspin, ispin, block_ik.transpose());
+                add_block(ispin, lspin, block_il); add_block(lspin, ispin, block_il.transpose());
+                add_block(jspin, kspin, block_jk); add_block(kspin, jspin, block_jk.transpose());
+                add_block(jspin, lspin, block_jl); add_block(lspin, jspin, block_jl.transpose());
+            }
+        }
+
+        hessian.resize(3*nos, 3*nos);
+        hessian.setFromTriplets(triplets.begin(), triplets.end());
+    }
+
+    void Hamiltonian_Heisenberg::Hessian_Vector_Product(const vectorfield & spins, const vectorfield & vec, vectorfield & out)
+    {
+        Timing::Scope timing(timing_hessian_vector_product);
+        // Set to zero
+        Vectormath::fill(out, {0,0,0});
+
+        // Apart from Zeeman and quadruplets, the gradient is linear in the spins,
+        // so the corresponding part of the Hessian is applied by evaluating the gradient on vec
+        this->Gradient_Anisotropy(vec, out);
+        this->Gradient_Exchange(vec, out);
+        this->Gradient_DMI(vec, out);
+        this->Gradient_DDI(vec, out);
 
         // Quadruplets
+        for (unsigned int iquad = 0; iquad < quadruplets.size(); ++iquad)
+        {
+            scalar K = quadruplet_magnitudes[iquad];
+            for (int icell = 0; icell < geometry->n_cells_total; ++icell)
+            {
+                int ispin, jspin, kspin, lspin;
+                if (!this->quadruplet_spins(iquad, icell, ispin, jspin, kspin, lspin))
+                    continue;
+
+                scalar s_ij = spins[ispin].dot(spins[jspin]);
+                scalar s_kl = spins[kspin].dot(spins[lspin]);
+                scalar d_ij = vec[ispin].dot(spins[jspin]) + spins[ispin].dot(vec[jspin]);
+                scalar d_kl = vec[kspin].dot(spins[lspin]) + spins[kspin].dot(vec[lspin]);
+
+                out[ispin] -= K * (vec[jspin] * s_kl + spins[jspin] * d_kl);
+                out[jspin] -= K * (vec[ispin] * s_kl + spins[ispin] * d_kl);
+                out[kspin] -= K * (d_ij * spins[lspin] + s_ij * vec[lspin]);
+                out[lspin] -= K * (d_ij * spins[kspin] + s_ij * vec[kspin]);
+            }
+        }
     }
 
     // Hamiltonian name as string
@@ -5,9 +5,14 @@
 #include <engine/Neighbours.hpp>
 #include <data/Spin_System.hpp>
 #include <utility/Constants.hpp>
+#include <utility/Logging.hpp>
 
 #include <Eigen/Dense>
 
+#include <mutex>
+
+#include <fmt/format.h>
+
 using namespace Data;
 using namespace Utility;
 using Utility::Constants::mu_B;
@@ -16,6 +21,19 @@ using Utility::Constants::Pi;
 using Engine::Vectormath::cu_check_atom_type;
 using Engine::Vectormath::cu_idx_from_pair;
 
+namespace
+{
+    // Log a warning the first time a function falls back to the generic implementation
+    void Warn_Fallback_Once(std::once_flag & flag, const std::string & function, const std::string & fallback)
+    {
+        std::call_once(flag, [&]()
+        {
+            Log(Log_Level::Warning, Log_Sender::All, fmt::format(
+                "Hamiltonian_Heisenberg::{} is not implemented for CUDA, {}.", function, fallback));
+        });
+    }
+}
+
 namespace Engine
 {
     Hamiltonian_Heisenberg::Hamiltonian_Heisenberg(
@@ -24,7 +42,7 @@ namespace Engine
         intfield anisotropy_indices, scalarfield anisotropy_magnitudes, vectorfield anisotropy_normals,
         pairfield exchange_pairs, scalarfield exchange_magnitudes,
         pairfield dmi_pairs, scalarfield dmi_magnitudes, vectorfield dmi_normals,
-        scalar ddi_radius,
+        DDI_Method ddi_method, scalar ddi_radius,
         quadrupletfield quadruplets, scalarfield quadruplet_magnitudes,
         std::shared_ptr<Data::Geometry> geometry,
         intfield boundary_conditions
@@ -35,7 +53,8 @@ namespace Engine
         anisotropy_indices(anisotropy_indices), anisotropy_magnitudes(anisotropy_magnitudes), anisotropy_normals(anisotropy_normals),
         exchange_pairs(exchange_pairs), exchange_magnitudes(exchange_magnitudes), exchange_n_shells(0),
         dmi_pairs(dmi_pairs), dmi_magnitudes(dmi_magnitudes), dmi_normals(dmi_normals), dmi_n_shells(0),
-        quadruplets(quadruplets), quadruplet_magnitudes(quadruplet_magnitudes)
+        quadruplets(quadruplets), quadruplet_magnitudes(quadruplet_magnitudes),
+        ddi_method(ddi_method), ddi_cutoff_radius(ddi_radius)
     {
         // Duplicate all exchange and DMI pairs in order to have them as neighbours
         for (int i = 0; i < exchange_pairs.size(); ++i)
@@ -54,10 +73,8 @@ namespace Engine
             this->dmi_normals.push_back(-dmi_normals[i]);
         }
 
-        // Generate DDI pairs, magnitudes, normals
-        this->Update_DDI_Pairs();
-
-        this->Update_Energy_Contributions();
+        // Generate DDI pairs, magnitudes, normals and energy contributions
+        this->Update_Interactions();
     }
 
     Hamiltonian_Heisenberg::Hamiltonian_Heisenberg(
@@ -66,7 +83,7 @@ namespace Engine
         intfield anisotropy_indices, scalarfield anisotropy_magnitudes, vectorfield anisotropy_normals,
         scalarfield exchange_magnitudes,
         scalarfield dmi_magnitudes, int dm_chirality,
-        scalar ddi_radius,
+        DDI_Method ddi_method, scalar ddi_radius,
         quadrupletfield quadruplets, scalarfield quadruplet_magnitudes,
         std::shared_ptr<Data::Geometry> geometry,
         intfield boundary_conditions
@@ -77,7 +94,8 @@ namespace Engine
         external_field_magnitude(external_field_magnitude * mu_B), external_field_normal(external_field_normal),
         anisotropy_indices(anisotropy_indices), anisotropy_magnitudes(anisotropy_magnitudes), anisotropy_normals(anisotropy_normals),
         exchange_n_shells(exchange_magnitudes.size()),
-        dmi_n_shells(dmi_magnitudes.size())
+        dmi_n_shells(dmi_magnitudes.size()),
+        ddi_method(ddi_method), ddi_cutoff_radius(ddi_radius)
     {
         // When parallelising (cuda or openmp), we need all neighbours per spin
         const bool remove_redundant = false;
@@ -99,15 +117,44 @@ namespace Engine
             this->dmi_magnitudes.push_back(dmi_magnitudes[dmi_shells[ineigh]]);
         }
 
-        // Generate DDI pairs, magnitudes, normals
-        this->Update_DDI_Pairs();
+        // Generate DDI pairs, magnitudes, normals and energy contributions
+        this->Update_Interactions();
+    }
+
+
+    void Hamiltonian_Heisenberg::Update_Interactions()
+    {
+        // The CUDA kernels operate directly on the pair lists, so no neighbour tables are built
+        this->Update_DDI();
 
         this->Update_Energy_Contributions();
     }
 
+    void Hamiltonian_Heisenberg::Update_Geometry(std::shared_ptr<Data::Geometry> geometry)
+    {
+        this->geometry = geometry;
+        this->Update_Interactions();
+    }
 
-    void Hamiltonian_Heisenberg::Update_DDI_Pairs()
+    void Hamiltonian_Heisenberg::Update_DDI()
     {
+        // The FFT convolution is not available on the GPU, so the direct summation is used instead
+        if (this->ddi_method == DDI_Method::FFT)
+        {
+            Log(Log_Level::Error, Log_Sender::All, fmt::format(
+                "The FFT method for the dipole-dipole interaction is not available with CUDA. "
+                "Falling back to the cutoff method with radius {}.", this->ddi_cutoff_radius));
+            this->ddi_method = DDI_Method::Cutoff;
+        }
+
+        if (this->ddi_method == DDI_Method::None)
+        {
+            this->ddi_pairs      = pairfield(0);
+            this->ddi_magnitudes = scalarfield(0);
+            this->ddi_normals    = vectorfield(0);
+            return;
+        }
+
         this->ddi_pairs      = Engine::Neighbours::Get_Pairs_in_Radius(*this->geometry, this->ddi_cutoff_radius);
         this->ddi_magnitudes = scalarfield(this->ddi_pairs.size());
         this->ddi_normals    = vectorfield(this->ddi_pairs.size());
@@ -394,6 +441,31 @@ namespace Engine
     }
 
 
+    scalar Hamiltonian_Heisenberg::Energy_and_Gradient(const vectorfield & spins, vectorfield & gradient)
+    {
+        // Each term is a homogeneous polynomial of degree k in the spins, so that
+        //      its energy is s*grad(E_k)/k. The gradient is accumulated by degree.
+        Vectormath::fill(gradient, {0,0,0});
+
+        // Degree 4: quadruplets
+        this->Gradient_Quadruplet(spins, gradient);
+        scalar sg_4 = Vectormath::dot(spins, gradient);
+
+        // Degree 1: external field
+        Gradient_Zeeman(gradient);
+        scalar sg_1 = Vectormath::dot(spins, gradient) - sg_4;
+
+        // Degree 2: anisotropy, exchange, DMI and DDI
+        Gradient_Anisotropy(spins, gradient);
+        this->Gradient_Exchange(spins, gradient);
+        this->Gradient_DMI(spins, gradient);
+        this->Gradient_DDI(spins, gradient);
+        scalar sg_2 = Vectormath::dot(spins, gradient) - sg_4 - sg_1;
+
+        return sg_1 + sg_2/2 + sg_4/4;
+    }
+
+
     __global__ void CU_Gradient_Zeeman( const int * atom_types, const int n_cell_atoms, const scalar * mu_s, const scalar external_field_magnitude, const Vector3 external_field_normal, Vector3 * gradient, size_t n_cells_total)
     {
         for(auto icell = blockIdx.x * blockDim.x + threadIdx.x;
@@ -704,6 +776,41 @@ namespace Engine
         // Quadruplets
     }
 
+    scalar Hamiltonian_Heisenberg::Energy_Single_Spin_Diff(int ispin, const vectorfield & spins, const Vector3 & spin_new)
+    {
+        static std::once_flag warned;
+        Warn_Fallback_Once(warned, "Energy_Single_Spin_Diff", "the energy difference is calculated from the total energies");
+        return Hamiltonian::Energy_Single_Spin_Diff(ispin, spins, spin_new);
+    }
+
+    Vector3 Hamiltonian_Heisenberg::Effective_Field_Single_Spin(int ispin, const vectorfield & spins)
+    {
+        static std::once_flag warned;
+        Warn_Fallback_Once(warned, "Effective_Field_Single_Spin", "the field is calculated from finite differences of the energy");
+        return Hamiltonian::Effective_Field_Single_Spin(ispin, spins);
+    }
+
+    bool Hamiltonian_Heisenberg::Interaction_Graph(intfield & offsets, intfield & neighbours)
+    {
+        static std::once_flag warned;
+        Warn_Fallback_Once(warned, "Interaction_Graph", "so Monte Carlo sweeps are not parallelised");
+        return Hamiltonian::Interaction_Graph(offsets, neighbours);
+    }
+
+    void Hamiltonian_Heisenberg::Sparse_Hessian(const vectorfield & spins, SpMatrixX & hessian)
+    {
+        static std::once_flag warned;
+        Warn_Fallback_Once(warned, "Sparse_Hessian", "the sparse Hessian is converted from the dense Hessian");
+        Hamiltonian::Sparse_Hessian(spins, hessian);
+    }
+
+    void Hamiltonian_Heisenberg::Hessian_Vector_Product(const vectorfield & spins, const vectorfield & vec, vectorfield & out)
+    {
+        static std::once_flag warned;
+        Warn_Fallback_Once(warned, "Hessian_Vector_Product", "the product is calculated from finite differences of the gradient");
+        this->Hessian_Vector_Product_FD(spins, vec, out);
+    }
+
     // Hamiltonian name as string
     static const std::string name = "Heisenberg";
     const std::string& Hamiltonian_Heisenberg::Name() { return name; }
@@ -1,6 +1,7 @@
 #include <engine/Method.hpp>
 #include <engine/Vectormath.hpp>
 #include <engine/Manifoldmath.hpp>
+#include <io/IO.hpp>
 #include <utility/Logging.hpp>
 #include <utility/Timing.hpp>
 #include <utility/Exception.hpp>
@@ -8,13 +9,24 @@
 
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
 
 using namespace Utility;
 
+namespace
+{
+    // Wall time and number of calls of the iterations and output of the methods (see Simulation_Get_Timings)
+    Timing::Counter timing_iteration("Method/Iteration");
+    Timing::Counter timing_save("Method/Save");
+
+    // Target duration of a block of iterations, during which the systems stay locked
+    const std::chrono::milliseconds t_block_target(10);
+}
+
 namespace Engine
 {
     Method::Method(std::shared_ptr<Data::Parameters_Method> parameters, int idx_img, int idx_chain) :
-        parameters(parameters), idx_image(idx_img), idx_chain(idx_chain), iteration(0), step(0)
+        parameters(parameters), idx_image(idx_img), idx_chain(idx_chain), iteration(0), iteration_start(0), step(0), running(false)
     {
         // Sender name for log messages
         this->SenderName = Log_Sender::All;
@@ -32,7 +44,7 @@ namespace Engine
             this->n_log        = 0;
 
         // Setup timings
-        for (int i = 0; i<7; ++i) this->t_iterations.push_back(system_clock::now());
+        for (int i = 0; i<7; ++i) this->t_iterations.push_back({system_clock::now(), 0});
         this->ips = 0;
         this->starttime = Timing::CurrentDateTime();
 
@@ -48,11 +60,21 @@ namespace Engine
 
     void Method::Iterate()
     {
+        //---- The method is running until `Iterate` returns, also if an exception is thrown
+        this->running = true;
+        struct Running_Reset
+        {
+            std::atomic<bool> & running;
+            ~Running_Reset() { running = false; }
+        } running_reset{ this->running };
+
         //---- Start timings
         this->starttime = Timing::CurrentDateTime();
         this->t_start = system_clock::now();
         auto t_current = system_clock::now();
         this->t_last = system_clock::now();
+        for (auto& t : this->t_iterations) t = {t_current, this->iteration};
+        double t_output_blocked = IO::Get_Output_Blocked_Time();
 
         //---- Log messages
         this->Message_Start();
@@ -60,61 +82,177 @@ namespace Engine
         //---- Initial save
         this->Save_Current(this->starttime, this->iteration, true, false);
 
-        //---- Iteration loop
-        for ( this->iteration = 0; 
-              this->ContinueIterating() &&
-              !this->Walltime_Expired(t_current - t_start); 
-              ++this->iteration )
+        //---- Initial snapshot of the spins for readers
+        this->Lock();
+        for (auto& system : this->systems) system->PublishSnapshot(this->iteration);
+        this->Unlock();
+
+        //---- Iteration loop, which continues from the last iteration if the method was resumed.
+        //      The iterations are carried out in blocks, during which the systems stay locked.
+        //      Only the cheap stopping criteria (number of iterations, iteration_allowed flags,
+        //      convergence) are checked in every iteration, while the stop file, walltime and IPS
+        //      are checked once per block. The blocks end at each log step and are adapted to take
+        //      about t_block_target, so that readers of the systems are not blocked for long.
+        int n_block_max = std::max(1L, this->parameters->n_iterations_amortize);
+        int n_block = 1;
+        this->iteration_start = this->iteration;
+        while ( this->ContinueIterating() &&
+                !this->Walltime_Expired(t_current - t_start) &&
+                !this->StopFile_Present() )
         {
-            t_current = system_clock::now();
+            auto t_block = system_clock::now();
+            int iteration_block = this->iteration;
 
             // Lock Systems
             this->Lock();
 
-            // Pre-iteration hook
-            this->Hook_Pre_Iteration();
-            // Do one single Iteration
-            this->Iteration();
-            // Post-iteration hook
-            this->Hook_Post_Iteration();
-
-            // Recalculate FPS
-            this->t_iterations.pop_front();
-            this->t_iterations.push_back(system_clock::now());
-
-            // Log Output every n_iterations_log steps
             bool log = false;
-            if (this->n_iterations_log > 0)
-                log = this->iteration > 0 && 0 == fmod(this->iteration, this->n_iterations_log);
-            if ( log )
+            for ( int i = 0; i < n_block && !log && this->ContinueIterating(); ++i, ++this->iteration )
             {
-                ++step;
-                this->Message_Step();
-                this->Save_Current(this->starttime, this->iteration, false, false);
+                // Pre-iteration hook
+                this->Hook_Pre_Iteration();
+                // Do one single Iteration
+                {
+                    Timing::Scope timing(timing_iteration);
+                    this->Iteration();
+                }
+                // The observables of the systems are now outdated
+                for (auto& system : this->systems) system->SpinsChanged();
+                // Post-iteration hook
+                this->Hook_Post_Iteration();
+
+                // Publish snapshots of the spins every n_iterations_snapshot iterations
+                for (auto& system : this->systems)
+                {
+                    if (system->n_iterations_snapshot > 0 && 0 == (this->iteration+1) % system->n_iterations_snapshot)
+                        system->PublishSnapshot(this->iteration+1);
+                }
+
+                // Log Output every n_iterations_log steps, which also ends the block
+                if (this->n_iterations_log > 0)
+                    log = this->iteration > 0 && 0 == this->iteration % this->n_iterations_log;
+                if ( log )
+                {
+                    ++step;
+                    this->Message_Step();
+                    if (Log.messages_timings)
+                        Log.SendBlock(Log_Level::Info, this->SenderName, Timing::Counters_Table(), this->idx_image, this->idx_chain);
+                    {
+                        Timing::Scope timing(timing_save);
+                        this->Save_Current(this->starttime, this->iteration, false, false);
+                    }
+                    // Publish the spins together with the energy calculated for the output
+                    for (auto& system : this->systems)
+                    {
+                        if (system->SnapshotOutdated())
+                            system->PublishSnapshot(this->iteration+1);
+                    }
+                }
             }
 
             // Unlock systems
             this->Unlock();
+
+            // Recalculate IPS
+            t_current = system_clock::now();
+            this->t_iterations.pop_front();
+            this->t_iterations.push_back({t_current, this->iteration});
+
+            // Adapt the length of the blocks. A block cut short by a log step says nothing
+            //      about the duration of a full block, so it is not grown in that case.
+            auto t_block_passed = t_current - t_block;
+            if ( t_block_passed > t_block_target && n_block > 1 )
+                n_block /= 2;
+            else if ( 2*t_block_passed < t_block_target && this->iteration - iteration_block == n_block )
+                n_block = std::min(2*n_block, n_block_max);
         }
 
         //---- Log messages
         this->Message_End();
 
         //---- Final save
-        this->Save_Current(this->starttime, this->iteration, false, true);
+        {
+            Timing::Scope timing(timing_save);
+            this->Save_Current(this->starttime, this->iteration, false, true);
+            //---- Wait until all queued output has been written to disk
+            IO::Flush_Output();
+        }
+        if (Log.messages_timings)
+            Log.SendBlock(Log_Level::Info, this->SenderName, Timing::Counters_Table(), this->idx_image, this->idx_chain);
+        t_output_blocked = IO::Get_Output_Blocked_Time() - t_output_blocked;
+        if (t_output_blocked > 0)
+            Log(Log_Level::Debug, this->SenderName,
+                fmt::format("    Time spent waiting for output: {:.3f} s", t_output_blocked), this->idx_image, this->idx_chain);
+        //---- Final snapshot of the spins, which is also used to detect modifications before a resume
+        this->Lock();
+        this->snapshots_final.clear();
+        for (auto& system : this->systems)
+        {
+            system->PublishSnapshot(this->iteration);
+            this->snapshots_final.push_back(system->GetSnapshot());
+        }
+        this->Unlock();
         //---- Finalize (set iterations_allowed to false etc.)
         this->Finalize();
     }
 
 
-    scalar Method::getIterationsPerSecond()
+    bool Method::Resumable(const std::vector<std::shared_ptr<Data::Spin_System>> & systems)
     {
-        scalar l_ips = 0.0;
-        for (unsigned int i = 0; i < t_iterations.size() - 1; ++i)
+        // A run which is still finishing cannot be continued by a second call to `Iterate`
+        if ( this->running )
+            return false;
+
+        if ( systems != this->systems || this->snapshots_final.size() != systems.size() )
+            return false;
+
+        for (unsigned int i = 0; i < systems.size(); ++i)
         {
-            l_ips += Timing::SecondsPassed(t_iterations[i+1] - t_iterations[i]);
+            auto& system = *systems[i];
+            if ( system.nos != this->nos )
+                return false;
+            // The spins array of the system may have been replaced, e.g. by copying another system
+            if ( i < this->configurations.size() && system.spins != this->configurations[i] )
+                return false;
+            // The configuration or the Hamiltonian were changed through the API (which publishes
+            //      a new snapshot or increments the version), or the spins were written directly
+            if ( system.GetSnapshot() != this->snapshots_final[i] || system.SnapshotOutdated() ||
+                 this->snapshots_final[i]->spins != *system.spins )
+                return false;
         }
-        this->ips = 1.0 / (l_ips / (t_iterations.size() - 1));
+        return true;
+    }
+
+
+    void Method::Resume()
+    {
+        this->n_iterations     = this->iteration + this->parameters->n_iterations;
+        this->n_iterations_log = this->parameters->n_iterations_log;
+        if (this->n_iterations_log > 0)
+            this->n_log        = this->parameters->n_iterations / this->n_iterations_log;
+        else
+            this->n_log        = 0;
+        this->step = 0;
+        // The parameters may have changed (e.g. the GNEB image types), so the convergence
+        //      is only checked again after the next iteration
+        this->force_max_abs_component = this->parameters->force_convergence + 1.0;
+    }
+
+
+    bool Method::Running()
+    {
+        return this->running;
+    }
+
+
+    scalar Method::getIterationsPerSecond()
+    {
+        // The time points are taken at the end of each block of iterations
+        auto& first = this->t_iterations.front();
+        auto& last  = this->t_iterations.back();
+        scalar l_ips = Timing::SecondsPassed(last.first - first.first);
+        if (l_ips > 0)
+            this->ips = (last.second - first.second) / l_ips;
         return this->ips;
     }
 
@@ -165,9 +303,9 @@ namespace Engine
 
     bool Method::ContinueIterating()
     {
+        // The stop file is only checked between the blocks of iterations (see Iterate)
         return  this->iteration < this->n_iterations &&
-                this->Iterations_Allowed() &&
-               !this->StopFile_Present();
+                this->Iterations_Allowed();
     }
 
     bool Method::Iterations_Allowed()
@@ -7,14 +7,26 @@
 #include <io/OVF_File.hpp>
 #include <utility/Cubic_Hermite_Spline.hpp>
 #include <utility/Logging.hpp>
+#include <utility/Timing.hpp>
 
 #include <iostream>
 #include <math.h>
 
+#ifdef _OPENMP
+    #include <omp.h>
+#endif
+
 #include <fmt/format.h>
 
 using namespace Utility;
 
+namespace
+{
+    // Wall time and number of calls of the phases of a GNEB iteration (see Simulation_Get_Timings)
+    Timing::Counter timing_force("GNEB/Force");
+    Timing::Counter timing_force_virtual("GNEB/Force_Virtual");
+}
+
 namespace Engine
 {
     template <Solver solver>
@@ -41,6 +53,9 @@ namespace Engine
         // Tangents
         this->tangents = std::vector<vectorfield>(this->noi, vectorfield( this->nos, { 0, 0, 0 } ));	// [noi][nos]
 
+        // Image types, of which the changes are tracked
+        this->image_types_previous = this->chain->image_type;
+
         // We assume that the chain is not converged before the first iteration
         this->force_max_abs_component = this->chain->gneb_parameters->force_convergence + 1.0;
         this->force_max_abs_component_all = std::vector<scalar>(this->noi, 0);
@@ -71,27 +86,78 @@ namespace Engine
     template <Solver solver>
     void Method_GNEB<solver>::Calculate_Force(const std::vector<std::shared_ptr<vectorfield>> & configurations, std::vector<vectorfield> & forces)
     {
+        Timing::Scope timing(timing_force);
+
         int nos = configurations[0]->size();
 
         // We assume here that we receive a vector of configurations that corresponds to the vector of systems we gave the Solver.
         //		The Solver shuld respect this, but there is no way to enforce it.
-        // Get Energy and Gradient of configurations
-        for (int img = 0; img < chain->noi; ++img)
+        // Evaluate the images, which are independent of each other: energy, geodesic distance to
+        //      the previous image and the gradient force, projected into the tangent space of the image
+        auto evaluate_image = [&](int img)
         {
             auto& image = *configurations[img];
 
-            // Calculate the Energy of the image
-            energies[img] = this->chain->images[img]->hamiltonian->Energy(image);
+            // Distance to the previous image, the reaction coordinate is summed up below
             if (img > 0)
+                Rx[img] = Manifoldmath::dist_geodesic(image, *configurations[img-1]);
+
+            if (img > 0 && img < chain->noi - 1)
             {
-                Rx[img] = Rx[img-1] + Manifoldmath::dist_geodesic(image, *configurations[img-1]);
-                if (Rx[img] - Rx[img-1] < 1e-10)
-                {
-                    Log(Log_Level::Error, Log_Sender::GNEB, std::string("The geodesic distance between two images is zero! Stopping..."), -1, this->idx_chain);
-                    this->chain->iteration_allowed = false;
-                    return;
-                }
+                // Calculate the Energy of the image, together with the gradient
+                energies[img] = this->chain->images[img]->hamiltonian->Energy_and_Gradient(image, F_gradient[img]);
+                // The gradient force (unprojected) is simply the effective field
+                Vectormath::scale(F_gradient[img], -1);
+                // We do it the following way so that the effective field can be e.g. displayed,
+                //		while the gradient force is manipulated (e.g. projected)
+                Vectormath::set_c_a(1, F_gradient[img], this->chain->images[img]->effective_field);
+
+                // Project the gradient force into the tangent space of the image
+                Manifoldmath::project_tangential(F_gradient[img], image);
+            }
+            else
+            {
+                // Calculate the Energy of the image
+                energies[img] = this->chain->images[img]->hamiltonian->Energy(image);
+            }
+        };
+
+        int threads_per_image = this->chain->gneb_parameters->n_threads_per_image;
+        #ifdef _OPENMP
+        if (threads_per_image > 0)
+        {
+            // Images are evaluated concurrently by groups of threads_per_image threads, which are used
+            //      by the nested parallel regions inside the Hamiltonian and Vectormath functions.
+            //      The dynamic schedule hands out the next image to whichever group is idle.
+            int n_groups = std::max(1, omp_get_max_threads() / threads_per_image);
+            int max_active_levels = omp_get_max_active_levels();
+            omp_set_max_active_levels(2);
+            #pragma omp parallel for schedule(dynamic, 1) num_threads(n_groups)
+            for (int img = 0; img < chain->noi; ++img)
+            {
+                omp_set_num_threads(threads_per_image);
+                evaluate_image(img);
             }
+            omp_set_max_active_levels(max_active_levels);
+        }
+        else
+        #endif
+        {
+            for (int img = 0; img < chain->noi; ++img)
+                evaluate_image(img);
+        }
+
+        // Reaction coordinate, as the sum of the distances between the images
+        Rx[0] = 0;
+        for (int img = 1; img < chain->noi; ++img)
+        {
+            if (Rx[img] < 1e-10)
+            {
+                Log(Log_Level::Error, Log_Sender::GNEB, std::string("The geodesic distance between two images is zero! Stopping..."), -1, this->idx_chain);
+                this->chain->iteration_allowed = false;
+                return;
+            }
+            Rx[img] += Rx[img-1];
         }
 
         // Calculate relevant tangent to magnetisation sphere, considering also the energies of images
@@ -101,21 +167,6 @@ namespace Engine
         // Loop over images to calculate the total force on each Image
         for (int img = 1; img < chain->noi - 1; ++img)
         {
-            auto& image = *configurations[img];
-            // We do it the following way so that the effective field can be e.g. displayed,
-            //		while the gradient force is manipulated (e.g. projected)
-            this->chain->images[img]->UpdateEffectiveField();
-            // F_gradient[img] = this->chain->images[img]->effective_field;
-            Vectormath::set_c_a(1, this->chain->images[img]->effective_field, F_gradient[img]);
-            // // this->chain->images[img]->hamiltonian->Effective_Field(image, this->chain->images[img]->effective_field);
-
-            // The gradient force (unprojected) is simply the effective field
-            // this->chain->images[img]->hamiltonian->Gradient(image, F_gradient[img]);
-            // Vectormath::scale(F_gradient[img], -1);
-
-            // Project the gradient force into the tangent space of the image
-            Manifoldmath::project_tangential(F_gradient[img], image);
-
             // Calculate Force
             if (chain->image_type[img] == Data::GNEB_Image_Type::Climbing)
             {
@@ -168,6 +219,8 @@ namespace Engine
     template <Solver solver>
     void Method_GNEB<solver>::Calculate_Force_Virtual(const std::vector<std::shared_ptr<vectorfield>> & configurations, const std::vector<vectorfield> & forces, std::vector<vectorfield> & forces_virtual)
     {
+        Timing::Scope timing(timing_force_virtual);
+
         using namespace Utility;
 
         // Calculate the cross product with the spin configuration to get direct minimization
@@ -206,9 +259,30 @@ namespace Engine
     }
 
     template <Solver solver>
-    void Method_GNEB<solver>::Hook_Pre_Iteration()
+    bool Method_GNEB<solver>::Energy_of_Force(int img, scalar & energy)
     {
+        if (chain->image_type[img] != Data::GNEB_Image_Type::Falling)
+            return false;
+        energy = this->energies[img];
+        return true;
+    }
 
+    template <Solver solver>
+    bool Method_GNEB<solver>::Force_Inverted(int img)
+    {
+        return chain->image_type[img] == Data::GNEB_Image_Type::Climbing;
+    }
+
+    template <Solver solver>
+    void Method_GNEB<solver>::Hook_Pre_Iteration()
+    {
+        // When the type of an image has changed, e.g. to climbing, the force on it is a different
+        //      function of the configuration and the solver must not rely on previous iterations
+        if (chain->image_type != this->image_types_previous)
+        {
+            this->Reset_Memory();
+            this->image_types_previous = chain->image_type;
+        }
     }
 
     template <Solver solver>
@@ -250,7 +324,7 @@ namespace Engine
         //		Rx
         chain->Rx = this->Rx;
         //		E
-        for (int img = 1; img < chain->noi; ++img) chain->images[img]->E = this->energies[img];
+        for (int img = 1; img < chain->noi; ++img) chain->images[img]->SetEnergy(this->energies[img]);
         //		Rx interpolated
         chain->Rx_interpolated = interp[0];
         //		E interpolated
@@ -406,4 +480,5 @@ namespace Engine
     template class Method_GNEB<Solver::Depondt>;
     template class Method_GNEB<Solver::NCG>;
     template class Method_GNEB<Solver::VP>;
+    template class Method_GNEB<Solver::BFGS>;
 }
@@ -6,6 +6,9 @@
 #include <io/IO.hpp>
 #include <io/OVF_File.hpp>
 #include <utility/Logging.hpp>
+#include <utility/Timing.hpp>
+
+#include <Eigen/Dense>
 
 #include <iostream>
 #include <ctime>
@@ -15,6 +18,14 @@
 
 using namespace Utility;
 
+namespace
+{
+    // Wall time and number of calls of the phases of an LLG iteration (see Simulation_Get_Timings)
+    Timing::Counter timing_force("LLG/Force");
+    Timing::Counter timing_force_virtual("LLG/Force_Virtual");
+    Timing::Counter timing_stochastic_field("LLG/Stochastic_Field");
+}
+
 namespace Engine
 {
     template <Solver solver>
@@ -45,6 +56,7 @@ namespace Engine
             {"max_torque_component", {this->force_max_abs_component}},
             {"E", {this->force_max_abs_component}},
             {"M_z", {this->force_max_abs_component}} };
+        this->iteration_observables = -1;
 
         // Create shared pointers to the method's systems' spin configurations
         this->configurations = std::vector<std::shared_ptr<vectorfield>>(this->noi);
@@ -67,11 +79,20 @@ namespace Engine
     template <Solver solver>
     void Method_LLG<solver>::Calculate_Force(const std::vector<std::shared_ptr<vectorfield>> & configurations, std::vector<vectorfield> & forces)
     {
+        Timing::Scope timing(timing_force);
+
         // Loop over images to calculate the total force on each Image
         for (unsigned int img = 0; img < this->systems.size(); ++img)
         {
             // Minus the gradient is the total Force here
-            this->systems[img]->hamiltonian->Gradient(*configurations[img], Gradient[img]);
+            if (configurations[img] == this->systems[img]->spins)
+            {
+                // For the configuration of the system itself (as opposed to e.g. a predictor
+                //      of the solver), the energy is obtained at little extra cost
+                this->systems[img]->SetEnergy( this->systems[img]->hamiltonian->Energy_and_Gradient(*configurations[img], Gradient[img]) );
+            }
+            else
+                this->systems[img]->hamiltonian->Gradient(*configurations[img], Gradient[img]);
             #ifdef SPIRIT_ENABLE_PINNING
                 Vectormath::set_c_a(1, Gradient[img], Gradient[img], this->parameters->pinning->mask_unpinned);
             #endif // SPIRIT_ENABLE_PINNING
@@ -81,18 +102,50 @@ namespace Engine
         }
     }
 
+    template <Solver solver>
+    bool Method_LLG<solver>::Energy_of_Force(int img, scalar & energy)
+    {
+        // Calculate_Force sets the energy of the system together with the gradient
+        energy = this->systems[img]->E;
+        return true;
+    }
+
     template <Solver solver>
     void Method_LLG<solver>::Calculate_Force_Virtual(const std::vector<std::shared_ptr<vectorfield>> & configurations, const std::vector<vectorfield> & forces, std::vector<vectorfield> & forces_virtual)
     {
-        using namespace Utility;
+        // With the fused kernel, this includes the generation of the stochastic field
+        Timing::Scope timing(timing_force_virtual);
 
         for (unsigned int i=0; i<configurations.size(); ++i)
         {
-            auto& image = *configurations[i];
-            auto& force = forces[i];
-            auto& force_virtual = forces_virtual[i];
             auto& parameters = *this->systems[i]->llg_parameters;
+            auto& geometry = *this->systems[i]->geometry;
+            auto& boundary_conditions = this->systems[i]->hamiltonian->boundary_conditions;
+
+            bool direct_minimization = parameters.direct_minimization || solver == Solver::VP || solver == Solver::BFGS;
+
+            // Each iteration with temperature uses a new set of random numbers
+            std::uint64_t rng_counter = parameters.rng_counter;
+            if (!direct_minimization && (parameters.temperature > 0 || parameters.temperature_gradient_inclination != 0))
+                ++parameters.rng_counter;
+
+            #if defined(SPIRIT_LLG_FUSED_KERNEL) && !defined(SPIRIT_USE_CUDA)
+                LLG::Force_Virtual_Fused(parameters, geometry, boundary_conditions, *configurations[i], forces[i],
+                    direct_minimization, rng_counter, s_c_grad, forces_virtual[i]);
+            #else
+                LLG::Force_Virtual_Passes(parameters, geometry, boundary_conditions, *configurations[i], forces[i],
+                    direct_minimization, rng_counter, this->xi, s_c_grad, temperature_distribution, forces_virtual[i]);
+            #endif
+        }
+    }
 
+    namespace LLG
+    {
+        void Force_Virtual_Passes(const Data::Parameters_Method_LLG & parameters, const Data::Geometry & geometry,
+            const intfield & boundary_conditions, const vectorfield & image, const vectorfield & force,
+            bool direct_minimization, std::uint64_t rng_counter,
+            vectorfield & xi, vectorfield & s_c_grad, scalarfield & temperature_distribution, vectorfield & force_virtual)
+        {
             //////////
             // time steps
             scalar damping = parameters.damping;
@@ -110,7 +163,7 @@ namespace Engine
             //////////
 
             // Direct minimisation
-            if (parameters.direct_minimization || solver == Solver::VP)
+            if (direct_minimization)
             {
                 dtg = parameters.dt * Constants::gamma / Constants::mu_B;
                 Vectormath::set_c_cross( dtg, image, force, force_virtual);
@@ -126,8 +179,6 @@ namespace Engine
                 {
                     if (parameters.stt_use_gradient)
                     {
-                        auto& geometry = *this->systems[0]->geometry;
-                        auto& boundary_conditions = this->systems[0]->hamiltonian->boundary_conditions;
                         // Gradient approximation for in-plane currents
                         Vectormath::directional_gradient(image, geometry, boundary_conditions, je, s_c_grad); // s_c_grad = (j_e*grad)*S
                         Vectormath::add_c_a    ( dtg * a_j * ( damping - beta ), s_c_grad, force_virtual); // TODO: a_j durch b_j ersetzen 
@@ -145,15 +196,18 @@ namespace Engine
                 // Temperature
                 if (parameters.temperature > 0 || parameters.temperature_gradient_inclination != 0)
                 {
-                    // Generate random directions
-                    Vectormath::get_random_vectorfield_unitsphere(parameters.prng, this->xi);
+                    // Generate random directions, reproducible independent of the number of threads
+                    {
+                        Timing::Scope timing(timing_stochastic_field);
+                        Vectormath::get_random_vectorfield_unitsphere(parameters.rng_seed, rng_counter, xi);
+                    }
 
                     // If we have a temperature gradient, we use the distribution (scalarfield)
                     if (parameters.temperature_gradient_inclination != 0)
                     {
                         // Calculate distribution
                         Vectormath::get_gradient_distribution(
-                            *this->systems[i]->geometry,
+                            geometry,
                             parameters.temperature_gradient_direction,
                             parameters.temperature,
                             parameters.temperature_gradient_inclination,
@@ -162,17 +216,17 @@ namespace Engine
                         scalar epsilon = sqrtdtg * Utility::Constants::k_B;
                         Vectormath::scale(temperature_distribution, epsilon);
 
-                        Vectormath::add_c_a(temperature_distribution, this->xi, force_virtual);
+                        Vectormath::add_c_a(temperature_distribution, xi, force_virtual);
 
                         Vectormath::scale(temperature_distribution, damping);
-                        Vectormath::add_c_cross(temperature_distribution, image, this->xi, force_virtual);
+                        Vectormath::add_c_cross(temperature_distribution, image, xi, force_virtual);
                     }
                     // If we only have homogeneous temperature we do it more efficiently
                     else if (parameters.temperature > 0)
                     {
                         scalar epsilon = sqrtdtg * Utility::Constants::k_B * parameters.temperature;
-                        Vectormath::add_c_a    (epsilon, this->xi, force_virtual);
-                        Vectormath::add_c_cross(epsilon * damping, image, this->xi, force_virtual);
+                        Vectormath::add_c_a    (epsilon, xi, force_virtual);
+                        Vectormath::add_c_cross(epsilon * damping, image, xi, force_virtual);
                     }
                 }
             }
@@ -181,6 +235,110 @@ namespace Engine
                 Vectormath::set_c_a(1, force_virtual, force_virtual, parameters.pinning->mask_unpinned);
             #endif // SPIRIT_ENABLE_PINNING
         }
+
+        void Force_Virtual_Fused(const Data::Parameters_Method_LLG & parameters, const Data::Geometry & geometry,
+            const intfield & boundary_conditions, const vectorfield & image, const vectorfield & force,
+            bool direct_minimization, std::uint64_t rng_counter,
+            vectorfield & s_c_grad, vectorfield & force_virtual)
+        {
+            int nos = image.size();
+            scalar damping = parameters.damping;
+            scalar beta = parameters.beta;
+            scalar a_j = parameters.stt_magnitude;
+
+            // Pre-factors of the individual terms, with c_... = 0 if the term is switched off
+            scalar dtg = parameters.dt * Constants::gamma / Constants::mu_B / (1 + damping*damping);
+            scalar sqrtdtg = dtg / std::sqrt( parameters.dt );
+            scalar c_force = dtg, c_force_cross = dtg * damping;
+            scalar c_stt = 0, c_stt_cross = 0;
+            Vector3 s_c_vec = parameters.stt_polarisation_normal;
+            bool stt_gradient = false;
+            scalar c_noise = 0;
+            bool temperature_gradient = false;
+            Vector3 gradient_direction = parameters.temperature_gradient_direction;
+            scalar gradient_offset = 0;
+
+            if (direct_minimization)
+            {
+                c_force = 0;
+                c_force_cross = parameters.dt * Constants::gamma / Constants::mu_B;
+            }
+            else
+            {
+                // STT
+                if (a_j > 0)
+                {
+                    c_stt       = dtg * a_j * ( damping - beta );
+                    c_stt_cross = dtg * a_j * ( 1 + beta * damping );
+                    if (parameters.stt_use_gradient)
+                    {
+                        // The gradient is a stencil over the neighbours, so it needs a pass of its own
+                        stt_gradient = true;
+                        Vectormath::directional_gradient(image, geometry, boundary_conditions, s_c_vec, s_c_grad);
+                    }
+                    else
+                    {
+                        // Monolayer approximation
+                        c_stt       = -c_stt;
+                        c_stt_cross = -c_stt_cross;
+                    }
+                }
+
+                // Temperature, either homogeneous or with the distribution of get_gradient_distribution
+                if (parameters.temperature > 0 || parameters.temperature_gradient_inclination != 0)
+                {
+                    c_noise = sqrtdtg * Utility::Constants::k_B;
+                    if (parameters.temperature_gradient_inclination != 0)
+                    {
+                        temperature_gradient = true;
+                        gradient_direction.normalize();
+                        scalar bmin = geometry.bounds_min.dot(gradient_direction);
+                        scalar bmax = geometry.bounds_max.dot(gradient_direction);
+                        gradient_offset = parameters.temperature - parameters.temperature_gradient_inclination*std::min(bmin, bmax);
+                    }
+                }
+            }
+
+            #pragma omp parallel for
+            for (int ispin = 0; ispin < nos; ++ispin)
+            {
+                const Vector3 & spin = image[ispin];
+                Vector3 f = c_force * force[ispin] + c_force_cross * spin.cross(force[ispin]);
+
+                if (stt_gradient)
+                    f += c_stt * s_c_grad[ispin] + c_stt_cross * s_c_grad[ispin].cross(spin);
+                else if (c_stt != 0)
+                    f += c_stt * s_c_vec + c_stt_cross * s_c_vec.cross(spin);
+
+                if (c_noise != 0)
+                {
+                    scalar temperature = parameters.temperature;
+                    if (temperature_gradient)
+                        temperature = std::min(std::max(scalar(0),
+                            parameters.temperature_gradient_inclination*gradient_direction.dot(geometry.positions[ispin]) + gradient_offset), scalar(1e30));
+                    if (temperature > 0)
+                    {
+                        Vector3 xi = Vectormath::get_random_vector_unitsphere(parameters.rng_seed, rng_counter, ispin);
+                        scalar epsilon = c_noise * temperature;
+                        f += epsilon * xi + epsilon * damping * spin.cross(xi);
+                    }
+                }
+
+                #ifdef SPIRIT_ENABLE_PINNING
+                    f *= parameters.pinning->mask_unpinned[ispin];
+                #endif // SPIRIT_ENABLE_PINNING
+
+                force_virtual[ispin] = f;
+            }
+        }
+    }
+
+
+    template <Solver solver>
+    void Method_LLG<solver>::Resume()
+    {
+        Method_Solver<solver>::Resume();
+        this->force_converged = std::vector<bool>(this->noi, false);
     }
 
 
@@ -214,16 +372,12 @@ namespace Engine
         }
 
         // --- Image Data Update
-        // Update the system's Energy
-        // ToDo: copy instead of recalculating
-        this->systems[0]->UpdateEnergy();
-
-        // ToDo: How to update eff_field without numerical overhead?
-        // systems[0]->effective_field = Gradient[0];
-        // Vectormath::scale(systems[0]->effective_field, -1);
-        Manifoldmath::project_tangential(this->forces[0], *this->systems[0]->spins);
-        Vectormath::set_c_a(1, this->forces[0], this->systems[0]->effective_field);
-        // systems[0]->UpdateEffectiveField();
+        // The energy, magnetization and effective field are calculated lazily, i.e. only when they are
+        //      needed (log steps, output, API calls) and the spins changed since the last calculation.
+        //      Only if requested, the observables are recorded every n_iterations_observables iterations.
+        long int n_iterations_observables = this->systems[0]->llg_parameters->n_iterations_observables;
+        if (n_iterations_observables > 0 && this->iteration > 0 && 0 == this->iteration % n_iterations_observables)
+            this->Record_Observables(this->iteration);
 
         // TODO: In order to update Rx with the neighbouring images etc., we need the state -> how to do this?
 
@@ -253,15 +407,29 @@ namespace Engine
     }
 
 
+    template <Solver solver>
+    void Method_LLG<solver>::Record_Observables(int iteration)
+    {
+        if (iteration == this->iteration_observables)
+            return;
+        this->iteration_observables = iteration;
+
+        auto& system = *this->systems[0];
+        system.UpdateEnergyIfOutdated();
+        system.UpdateMagnetizationIfOutdated();
+        this->history["max_torque_component"].push_back(this->force_max_abs_component);
+        this->history["E"].push_back(system.E);
+        this->history["M_z"].push_back(system.M[2]);
+    }
+
+
     template <Solver solver>
     void Method_LLG<solver>::Save_Current(std::string starttime, int iteration, bool initial, bool final)
     {
         // History save
-        this->history["max_torque_component"].push_back(this->force_max_abs_component);
-        this->systems[0]->UpdateEnergy();
-        this->history["E"].push_back(this->systems[0]->E);
-        auto mag = Engine::Vectormath::Magnetization(*this->systems[0]->spins);
-        this->history["M_z"].push_back(mag[2]);
+        this->Record_Observables(iteration);
+        // The energy contributions are written to the energy files
+        this->systems[0]->UpdateEnergyIfOutdated();
 
         // File save
         if (this->parameters->output_any)
@@ -305,11 +473,23 @@ namespace Engine
                     else if (this->systems[0]->llg_parameters->output_configuration_filetype == IO_Fileformat_OVF_csv)
                         format = IO::VF_FileFormat::OVF_CSV;
 
-                    // Spin Configuration
-                    IO::File_OVF file_ovf( spinsFile, format );
-                    file_ovf.write_segment( *( this->systems[0] )->spins, 
-                                            *( this->systems[0] )->geometry,
-                                            output_comment, append );
+                    // Spin Configuration. The archive is appended to through one File_OVF, which
+                    //      keeps track of the segments, so that the file is not read again for each segment
+                    if (append)
+                    {
+                        if (!this->archive_file)
+                            this->archive_file = std::unique_ptr<IO::File_OVF>(new IO::File_OVF(spinsFile, format));
+                        this->archive_file->write_segment( *( this->systems[0] )->spins, 
+                                                           *( this->systems[0] )->geometry,
+                                                           output_comment, true );
+                    }
+                    else
+                    {
+                        IO::File_OVF file_ovf( spinsFile, format );
+                        file_ovf.write_segment( *( this->systems[0] )->spins, 
+                                                *( this->systems[0] )->geometry,
+                                                output_comment, false );
+                    }
                 }
                 catch( ... )
                 {
@@ -322,16 +502,20 @@ namespace Engine
                 bool normalize = this->systems[0]->llg_parameters->output_energy_divide_by_nspins;
                 bool readability = this->systems[0]->llg_parameters->output_energy_add_readability_lines;
 
+                // Spin-resolved energies are written as OVF unless the text table is chosen
+                auto formatPerSpin = IO::VF_FileFormat(this->systems[0]->llg_parameters->output_energy_spin_resolved_filetype);
+                bool ovfPerSpin = formatPerSpin == IO::VF_FileFormat::OVF_BIN8 || formatPerSpin == IO::VF_FileFormat::OVF_BIN4 ||
+                                  formatPerSpin == IO::VF_FileFormat::OVF_TEXT || formatPerSpin == IO::VF_FileFormat::OVF_CSV;
+
                 // File name
                 std::string energyFile = preEnergyFile + suffix + ".txt";
-                std::string energyFilePerSpin = preEnergyFile + "-perSpin" + suffix + ".txt";
+                std::string energyFilePerSpin = preEnergyFile + "-perSpin" + suffix + (ovfPerSpin ? ".ovf" : ".txt");
 
                 // Energy
                 if (append)
                 {
                     // Check if Energy File exists and write Header if it doesn't
-                    std::ifstream f(energyFile);
-                    if (!f.good()) IO::Write_Energy_Header(*this->systems[0], energyFile, {"iteration", "E_tot"}, true, normalize, readability);
+                    if (!IO::Output_File_Exists(energyFile)) IO::Write_Energy_Header(*this->systems[0], energyFile, {"iteration", "E_tot"}, true, normalize, readability);
                     // Append Energy to File
                     IO::Append_Image_Energy(*this->systems[0], iteration, energyFile, normalize, readability);
                 }
@@ -341,7 +525,8 @@ namespace Engine
                     IO::Append_Image_Energy(*this->systems[0], iteration, energyFile, normalize, readability);
                     if (this->systems[0]->llg_parameters->output_energy_spin_resolved)
                     {
-                        IO::Write_Image_Energy_per_Spin(*this->systems[0], energyFilePerSpin, normalize, readability);
+                        IO::Write_Image_Energy_per_Spin(*this->systems[0], energyFilePerSpin, normalize, readability,
+                            ovfPerSpin ? formatPerSpin : IO::VF_FileFormat::GENERAL_TXT);
                     }
                 }
             };
@@ -373,12 +558,26 @@ namespace Engine
             if (this->systems[0]->llg_parameters->output_configuration_archive)
             {
                 writeOutputConfiguration("-archive", true);
+                if (final)
+                    this->archive_file.reset();
             }
             if (this->systems[0]->llg_parameters->output_energy_archive)
             {
                 writeOutputEnergy("-archive", true);
             }
 
+            // Compressed trajectory output (appending)
+            if (this->systems[0]->llg_parameters->output_trajectory)
+            {
+                if (initial || !this->trajectory)
+                    this->trajectory = std::unique_ptr<IO::Trajectory_Writer>(new IO::Trajectory_Writer(
+                        preSpinsFile + "-trajectory.sptraj", this->systems[0]->nos,
+                        this->systems[0]->llg_parameters->output_trajectory_bits, 32, true));
+                this->trajectory->Write_Frame(*this->systems[0]->spins, iteration, this->systems[0]->E);
+                if (final)
+                    this->trajectory.reset();
+            }
+
             // Save Log
             Log.Append_to_File();
         }
@@ -395,4 +594,5 @@ namespace Engine
     template class Method_LLG<Solver::Depondt>;
     template class Method_LLG<Solver::NCG>;
     template class Method_LLG<Solver::VP>;
+    template class Method_LLG<Solver::BFGS>;
 }
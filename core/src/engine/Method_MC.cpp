@@ -11,11 +11,36 @@
 #include <iostream>
 #include <ctime>
 #include <math.h>
+#include <algorithm>
+
+#ifdef _OPENMP
+    #include <omp.h>
+#endif
 
 using namespace Utility;
 
 namespace Engine
 {
+    // Orthonormal basis with the given unit vector as third axis
+    static Matrix3 Local_Basis(const Vector3 & axis)
+    {
+        Matrix3 local_basis;
+        if (std::abs(axis.z()) < 1-1e-10)
+        {
+            Vector3 e_z{0, 0, 1};
+            local_basis.col(2) = axis;
+            local_basis.col(0) = (local_basis.col(2).cross(e_z)).normalized();
+            local_basis.col(1) = local_basis.col(2).cross(local_basis.col(0));
+        }
+        else
+        {
+            local_basis = Matrix3::Identity();
+            if (axis.z() < 0)
+                local_basis.col(2) = -local_basis.col(2);
+        }
+        return local_basis;
+    }
+
     Method_MC::Method_MC(std::shared_ptr<Data::Spin_System> system, int idx_img, int idx_chain) :
         Method(system->mc_parameters, idx_img, idx_chain)
     {
@@ -43,42 +68,65 @@ namespace Engine
         this->cone_angle = Constants::Pi * this->parameters_mc->metropolis_cone_angle / 180.0;
         this->n_rejected = 0;
         this->acceptance_ratio_current = this->parameters_mc->acceptance_ratio_target;
+
+        // Independent random number streams for the threads of the parallel sweep
+        this->Seed_Thread_Streams();
+
+        // Spins of the same colour do not interact and can be updated in parallel
+        this->Build_Colour_Classes();
     }
 
-    // This implementation is mostly serial as parallelization is nontrivial
-    //      if the range of neighbours for each atom is not pre-defined.
-    void Method_MC::Iteration()
+    void Method_MC::Seed_Thread_Streams()
     {
-        int nos = this->systems[0]->spins->size();
+        int n_threads = 1;
+        #ifdef _OPENMP
+            n_threads = omp_get_max_threads();
+        #endif
+        // The existing streams are continued, so that a resumed run does not repeat random numbers
+        for (int ithread = this->prng_threads.size(); ithread < n_threads; ++ithread)
+        {
+            std::seed_seq seed{ this->parameters_mc->rng_seed, ithread };
+            this->prng_threads.push_back(std::mt19937(seed));
+        }
+    }
 
-        // Temporaries
-        auto& spins_old       = *this->systems[0]->spins;
-        auto  spins_new       = spins_old;
+    void Method_MC::Build_Colour_Classes()
+    {
+        this->colour_classes.clear();
 
-        // Generate randomly displaced spin configuration according to cone radius
-        // Vectormath::get_random_vectorfield_unitsphere(this->parameters_mc->prng, random_unit_vectors);
+        intfield offsets, neighbours;
+        if (!this->systems[0]->hamiltonian->Interaction_Graph(offsets, neighbours))
+            return;
 
-        // TODO: add switch between Metropolis and heat bath
-        // One Metropolis step
-        Metropolis(spins_old, spins_new);
-        Vectormath::set_c_a(1, spins_new, spins_old);
+        // Greedy colouring: each spin gets the lowest colour not taken by its neighbours.
+        // For nearest neighbours on a bipartite lattice this results in a checkerboard.
+        intfield colours(this->nos, -1);
+        std::vector<bool> taken;
+        for (int ispin = 0; ispin < this->nos; ++ispin)
+        {
+            taken.assign(offsets[ispin+1] - offsets[ispin] + 1, false);
+            for (int k = offsets[ispin]; k < offsets[ispin+1]; ++k)
+            {
+                int c = colours[neighbours[k]];
+                if (c >= 0 && c < (int)taken.size())
+                    taken[c] = true;
+            }
+            int colour = std::find(taken.begin(), taken.end(), false) - taken.begin();
+            colours[ispin] = colour;
+
+            if (colour >= (int)this->colour_classes.size())
+                this->colour_classes.resize(colour + 1);
+            this->colour_classes[colour].push_back(ispin);
+        }
     }
 
-    // Simple metropolis step
-    void Method_MC::Metropolis(const vectorfield & spins_old, vectorfield & spins_new)
+    void Method_MC::Iteration()
     {
-        this->n_rejected = 0;
-        int nos = spins_new.size();
-        auto distribution = std::uniform_real_distribution<scalar>(0, 1);
-        auto distribution_idx = std::uniform_int_distribution<>(0, nos-1);
-        scalar kB_T = Constants::k_B * this->parameters_mc->temperature;
-
-        scalar diff = 0.01;
-
-        // Cone angle feedback algorithm
-        if (this->parameters_mc->metropolis_step_cone && this->parameters_mc->metropolis_cone_adaptive)
+        // Cone angle feedback algorithm, based on the acceptance of the previous sweep
+        if (this->parameters_mc->algorithm == Data::MC_Algorithm::Metropolis &&
+            this->parameters_mc->metropolis_step_cone && this->parameters_mc->metropolis_cone_adaptive)
         {
-            this->acceptance_ratio_current = 1 - (scalar)this->n_rejected / (scalar)nos;
+            scalar diff = 0.01;
 
             if( (this->acceptance_ratio_current < this->parameters_mc->acceptance_ratio_target) && (this->cone_angle > diff) )
             {
@@ -91,111 +139,211 @@ namespace Engine
             this->parameters_mc->metropolis_cone_angle = this->cone_angle * 180.0 / Constants::Pi;
         }
 
-        // One Metropolis step for each spin
-        Vector3 e_z{0, 0, 1};
-        scalar costheta, sintheta, phi;
-        Matrix3 local_basis;
-        scalar cos_cone_angle = std::cos(cone_angle);
+        // One sweep of single spin updates
+        Sweep(*this->systems[0]->spins);
+    }
 
-        // Loop over NOS samples (on average every spin should be hit once per Metropolis step)
-        for (int idx=0; idx < nos; ++idx)
-        {
-            int ispin;
-            if (this->parameters_mc->metropolis_random_sample)
-                // Better statistics, but additional calculation of random number
-                ispin = distribution_idx(this->parameters_mc->prng);
-            else
-                // Faster, but worse statistics
-                ispin = idx;
+    // A sweep of nos single spin updates with the Metropolis or heat bath algorithm
+    //      Spins are updated in place. If the Hamiltonian provides a local interaction graph and the spins
+    //      are not sampled randomly, each colour class is swept in parallel with one random number stream per thread.
+    void Method_MC::Sweep(vectorfield & spins)
+    {
+        int nos = spins.size();
+        auto distribution_idx = std::uniform_int_distribution<>(0, nos-1);
+
+        this->n_rejected = 0;
 
-            // Sample a cone
-            if (this->parameters_mc->metropolis_step_cone)
+        if (this->parameters_mc->metropolis_random_sample || this->colour_classes.empty())
+        {
+            // Loop over NOS samples (on average every spin should be hit once per Metropolis step)
+            for (int idx=0; idx < nos; ++idx)
             {
-                // Calculate local basis for the spin
-                if (spins_old[ispin].z() < 1-1e-10)
-                {
-                    local_basis.col(2) = spins_old[ispin];
-                    local_basis.col(0) = (local_basis.col(2).cross(e_z)).normalized();
-                    local_basis.col(1) = local_basis.col(2).cross(local_basis.col(0));
-                }
+                int ispin;
+                if (this->parameters_mc->metropolis_random_sample)
+                    // Better statistics, but additional calculation of random number
+                    ispin = distribution_idx(this->parameters_mc->prng);
                 else
+                    // Faster, but worse statistics
+                    ispin = idx;
+
+                if (!Update_Spin(ispin, spins, this->parameters_mc->prng))
+                    ++this->n_rejected;
+            }
+        }
+        else
+        {
+            // The number of threads may have been changed since the last sweep, e.g. before a resumed run
+            this->Seed_Thread_Streams();
+
+            // Sweep over the colour classes, the spins within a class are independent
+            int n_rejected = 0;
+            for (auto& colour_class : this->colour_classes)
+            {
+                int n_class = colour_class.size();
+                #pragma omp parallel reduction(+:n_rejected)
                 {
-                    local_basis = Matrix3::Identity();
+                    #ifdef _OPENMP
+                        auto& prng = this->prng_threads[omp_get_thread_num()];
+                    #else
+                        auto& prng = this->parameters_mc->prng;
+                    #endif
+
+                    #pragma omp for
+                    for (int idx = 0; idx < n_class; ++idx)
+                    {
+                        if (!Update_Spin(colour_class[idx], spins, prng))
+                            ++n_rejected;
+                    }
                 }
+            }
+            this->n_rejected = n_rejected;
+        }
 
-                // Rotation angle between 0 and cone_angle degrees
-                costheta = 1 - (1 - cos_cone_angle) * distribution(this->parameters_mc->prng);
+        this->acceptance_ratio_current = 1 - (scalar)this->n_rejected / (scalar)nos;
+    }
 
-                sintheta = std::sqrt(1 - costheta*costheta);
+    bool Method_MC::Update_Spin(int ispin, vectorfield & spins, std::mt19937 & prng)
+    {
+        if (this->parameters_mc->algorithm == Data::MC_Algorithm::Heat_Bath)
+            return Heat_Bath_Spin(ispin, spins, prng);
+        else
+            return Metropolis_Spin(ispin, spins, prng);
+    }
 
-                // Random distribution of phi between 0 and 360 degrees
-                phi = 2*Constants::Pi * distribution(this->parameters_mc->prng);
+    bool Method_MC::Metropolis_Spin(int ispin, vectorfield & spins, std::mt19937 & prng)
+    {
+        auto distribution = std::uniform_real_distribution<scalar>(0, 1);
+        scalar kB_T = Constants::k_B * this->parameters_mc->temperature;
 
-                // New spin orientation in local basis
-                Vector3 local_spin_new{ sintheta * std::cos(phi),
-                                        sintheta * std::sin(phi),
-                                        costheta };
+        const Vector3 spin_old = spins[ispin];
+        Vector3 spin_new;
+        scalar costheta, sintheta, phi;
 
-                // New spin orientation in regular basis
-                spins_new[ispin] = local_basis * local_spin_new;
-            }
-            // Sample the entire unit sphere
-            else
-            {
-                // Rotation angle between 0 and 180 degrees
-                costheta = distribution(this->parameters_mc->prng);
+        // Sample a cone
+        if (this->parameters_mc->metropolis_step_cone)
+        {
+            // Calculate local basis for the spin
+            Matrix3 local_basis = Local_Basis(spin_old);
 
-                sintheta = std::sqrt(1 - costheta*costheta);
+            // Rotation angle between 0 and cone_angle degrees
+            costheta = 1 - (1 - std::cos(cone_angle)) * distribution(prng);
 
-                // Random distribution of phi between 0 and 360 degrees
-                phi = 2*Constants::Pi * distribution(this->parameters_mc->prng);
+            sintheta = std::sqrt(1 - costheta*costheta);
 
-                // New spin orientation in local basis
-                spins_new[ispin] = Vector3{ sintheta * std::cos(phi),
-                                            sintheta * std::sin(phi),
-                                            costheta };
-            }
+            // Random distribution of phi between 0 and 360 degrees
+            phi = 2*Constants::Pi * distribution(prng);
 
-            // Energy difference of configurations with and without displacement
-            scalar Eold  = this->systems[0]->hamiltonian->Energy_Single_Spin(ispin, spins_old);
-            scalar Enew  = this->systems[0]->hamiltonian->Energy_Single_Spin(ispin, spins_new);
-            scalar Ediff = Enew-Eold;
+            // New spin orientation in local basis
+            Vector3 local_spin_new{ sintheta * std::cos(phi),
+                                    sintheta * std::sin(phi),
+                                    costheta };
 
-            // Metropolis criterion: reject the step if energy rose
-            if (Ediff > 1e-14)
-            {
-                if (this->parameters_mc->temperature < 1e-12)
-                {
-                    // Restore the spin
-                    spins_new[ispin] = spins_old[ispin];
-                    // Counter for the number of rejections
-                    ++this->n_rejected;
-                }
-                else
-                {
-                    // Exponential factor
-                    scalar exp_ediff    = std::exp( -Ediff/kB_T );
-                    // Metropolis random number
-                    scalar x_metropolis = distribution(this->parameters_mc->prng);
+            // New spin orientation in regular basis
+            spin_new = local_basis * local_spin_new;
+        }
+        // Sample the entire unit sphere
+        else
+        {
+            // Rotation angle between 0 and 180 degrees
+            costheta = distribution(prng);
 
-                    // Only reject if random number is larger than exponential
-                    if (exp_ediff < x_metropolis)
-                    {
-                        // Restore the spin
-                        spins_new[ispin] = spins_old[ispin];
-                        // Counter for the number of rejections
-                        ++this->n_rejected;
-                    }
-                }
-            }
+            sintheta = std::sqrt(1 - costheta*costheta);
+
+            // Random distribution of phi between 0 and 360 degrees
+            phi = 2*Constants::Pi * distribution(prng);
+
+            // New spin orientation in local basis
+            spin_new = Vector3{ sintheta * std::cos(phi),
+                                sintheta * std::sin(phi),
+                                costheta };
         }
+
+        // Energy difference of configurations with and without displacement
+        scalar Ediff = this->systems[0]->hamiltonian->Energy_Single_Spin_Diff(ispin, spins, spin_new);
+
+        // Metropolis criterion: reject the step if energy rose
+        if (Ediff > 1e-14)
+        {
+            if (this->parameters_mc->temperature < 1e-12)
+                return false;
+
+            // Exponential factor
+            scalar exp_ediff    = std::exp( -Ediff/kB_T );
+            // Metropolis random number
+            scalar x_metropolis = distribution(prng);
+
+            // Only reject if random number is larger than exponential
+            if (exp_ediff < x_metropolis)
+                return false;
+        }
+
+        spins[ispin] = spin_new;
+        return true;
     }
 
-    // TODO:
-    // Implement heat bath algorithm, see Y. Miyatake et al, J Phys C: Solid State Phys 19, 2539 (1986)
-    // void Method_MC::HeatBath(const vectorfield & spins_old, vectorfield & spins_new)
-    // {
-    // }
+    // Heat bath algorithm, see Y. Miyatake et al, J Phys C: Solid State Phys 19, 2539 (1986)
+    //      The new spin is drawn from the Boltzmann distribution exp(h*s/kB_T) of the effective field h,
+    //      which does not depend on the spin itself. Terms which are not linear in the spin (e.g. anisotropy)
+    //      are taken into account by accepting the sample according to their energy difference, so that
+    //      for purely linear interactions every sample is accepted.
+    bool Method_MC::Heat_Bath_Spin(int ispin, vectorfield & spins, std::mt19937 & prng)
+    {
+        auto distribution = std::uniform_real_distribution<scalar>(0, 1);
+        scalar kB_T = Constants::k_B * this->parameters_mc->temperature;
+
+        const Vector3 spin_old = spins[ispin];
+        const Vector3 field = this->systems[0]->hamiltonian->Effective_Field_Single_Spin(ispin, spins);
+        const scalar field_norm = field.norm();
+
+        Vector3 spin_new;
+        if (this->parameters_mc->temperature < 1e-12)
+        {
+            // At zero temperature the spin is aligned with the field
+            if (field_norm < 1e-12)
+                return true;
+            spin_new = field / field_norm;
+        }
+        else
+        {
+            // Sample the angle to the field, the distribution of cos(theta) is proportional to exp(x*cos(theta))
+            scalar x = field_norm / kB_T;
+            scalar u = 1 - distribution(prng);
+            scalar costheta;
+            if (x > 1e-8)
+                costheta = 1 + std::log(u + (1-u)*std::exp(-2*x)) / x;
+            else
+                costheta = 2*u - 1;
+            costheta = std::max(scalar(-1), std::min(scalar(1), costheta));
+            scalar sintheta = std::sqrt(1 - costheta*costheta);
+
+            // Random distribution of phi between 0 and 360 degrees
+            scalar phi = 2*Constants::Pi * distribution(prng);
+
+            // New spin orientation in the basis of the field
+            Vector3 local_spin_new{ sintheta * std::cos(phi),
+                                    sintheta * std::sin(phi),
+                                    costheta };
+            if (field_norm > 1e-12)
+                spin_new = Local_Basis(field / field_norm) * local_spin_new;
+            else
+                spin_new = local_spin_new;
+        }
+
+        // Energy difference of the terms which are not linear in the spin
+        scalar Ediff = this->systems[0]->hamiltonian->Energy_Single_Spin_Diff(ispin, spins, spin_new)
+                        + field.dot(spin_new - spin_old);
+
+        if (Ediff > 1e-14)
+        {
+            if (this->parameters_mc->temperature < 1e-12)
+                return false;
+            if (std::exp( -Ediff/kB_T ) < distribution(prng))
+                return false;
+        }
+
+        spins[ispin] = spin_new;
+        return true;
+    }
 
     void Method_MC::Hook_Pre_Iteration()
     {
@@ -221,7 +369,17 @@ namespace Engine
         block.push_back(fmt::format("------------  Started  {} Calculation  ------------", this->Name()));
         block.push_back(fmt::format("    Going to iterate {} steps", this->n_log));
         block.push_back(fmt::format("                with {} iterations per step", this->n_iterations_log));
-        if (this->parameters_mc->metropolis_step_cone)
+        if (this->parameters_mc->algorithm == Data::MC_Algorithm::Heat_Bath)
+            block.push_back("   Heat bath algorithm");
+        else
+            block.push_back("   Metropolis algorithm");
+        if (this->parameters_mc->metropolis_random_sample)
+            block.push_back("   Random sampling of spins");
+        else if (this->colour_classes.empty())
+            block.push_back("   Sequential sweep");
+        else
+            block.push_back(fmt::format("   Parallel sweep over {} colour classes", this->colour_classes.size()));
+        if (this->parameters_mc->algorithm == Data::MC_Algorithm::Metropolis && this->parameters_mc->metropolis_step_cone)
         {
             block.push_back(fmt::format("   Target acceptance {}", this->parameters_mc->acceptance_ratio_target));
             block.push_back(fmt::format("   Cone angle (deg): {}", this->cone_angle*180/Constants::Pi));
@@ -236,7 +394,7 @@ namespace Engine
         auto t_current = system_clock::now();
 
         // Update the system's energy
-        this->systems[0]->UpdateEnergy();
+        this->systems[0]->UpdateEnergyIfOutdated();
 
         // Send log message
         std::vector<std::string> block(0);
@@ -245,11 +403,14 @@ namespace Engine
         block.push_back(fmt::format("    Iteration                 {} / {}", this->iteration, this->n_iterations));
         block.push_back(fmt::format("    Time since last step:     {}", Timing::DateTimePassed(t_current - this->t_last)));
         block.push_back(fmt::format("    Iterations / sec:         {}", this->n_iterations_log / Timing::SecondsPassed(t_current - this->t_last)));
-        if (this->parameters_mc->metropolis_step_cone)
+        block.push_back(fmt::format("    Spin updates / sec:       {}", (scalar)this->n_iterations_log * this->nos / Timing::SecondsPassed(t_current - this->t_last)));
+        if (this->parameters_mc->algorithm == Data::MC_Algorithm::Metropolis && this->parameters_mc->metropolis_step_cone)
         {
             block.push_back(fmt::format("    Current acceptance ratio: {} (target {})", this->acceptance_ratio_current, this->parameters_mc->acceptance_ratio_target));
             block.push_back(fmt::format("    Current cone angle (deg): {}", this->cone_angle*180/Constants::Pi));
         }
+        else
+            block.push_back(fmt::format("    Current acceptance ratio: {}", this->acceptance_ratio_current));
         block.push_back(fmt::format("    Total energy:             {:20.10f}", this->systems[0]->E));
         Log.SendBlock(Log_Level::All, this->SenderName, block, this->idx_image, this->idx_chain);
 
@@ -270,7 +431,7 @@ namespace Engine
             reason = "The maximum walltime has been reached";
 
         // Update the system's energy
-        this->systems[0]->UpdateEnergy();
+        this->systems[0]->UpdateEnergyIfOutdated();
 
         //---- Log messages
         std::vector<std::string> block;
@@ -280,12 +441,15 @@ namespace Engine
         block.push_back(fmt::format("----- Duration:       {}", Timing::DateTimePassed(t_end - this->t_start)));
         block.push_back(fmt::format("    Step              {} / {}", step, n_log));
         block.push_back(fmt::format("    Iteration         {} / {}", this->iteration, n_iterations));
-        block.push_back(fmt::format("    Iterations / sec: {}", this->iteration / Timing::SecondsPassed(t_end - this->t_start)));
-        if (this->parameters_mc->metropolis_step_cone)
+        block.push_back(fmt::format("    Iterations / sec: {}", (this->iteration - this->iteration_start) / Timing::SecondsPassed(t_end - this->t_start)));
+        block.push_back(fmt::format("    Spin updates / sec: {}", (scalar)(this->iteration - this->iteration_start) * this->nos / Timing::SecondsPassed(t_end - this->t_start)));
+        if (this->parameters_mc->algorithm == Data::MC_Algorithm::Metropolis && this->parameters_mc->metropolis_step_cone)
         {
             block.push_back(fmt::format("    Acceptance ratio: {} (target {})", this->acceptance_ratio_current, this->parameters_mc->acceptance_ratio_target));
             block.push_back(fmt::format("    Cone angle (deg): {}", this->cone_angle*180/Constants::Pi));
         }
+        else
+            block.push_back(fmt::format("    Acceptance ratio: {}", this->acceptance_ratio_current));
         block.push_back(fmt::format("    Total energy:     {:20.10f}", this->systems[0]->E));
         block.push_back("-----------------------------------------------------");
         Log.SendBlock(Log_Level::All, this->SenderName, block, this->idx_image, this->idx_chain);
@@ -294,6 +458,25 @@ namespace Engine
 
     void Method_MC::Save_Current(std::string starttime, int iteration, bool initial, bool final)
     {
+        if (this->parameters_mc->output_any && this->parameters_mc->output_trajectory)
+        {
+            std::string fileTag;
+            if (this->parameters_mc->output_file_tag == "<time>")
+                fileTag = starttime + "_";
+            else if (this->parameters_mc->output_file_tag != "")
+                fileTag = this->parameters_mc->output_file_tag + "_";
+            std::string trajectoryFile = this->parameters_mc->output_folder + "/" + fileTag
+                + "Image-" + fmt::format("{:0>2}", this->idx_image) + "_Spins-trajectory.sptraj";
+
+            // Compressed trajectory output (appending)
+            if (initial || !this->trajectory)
+                this->trajectory = std::unique_ptr<IO::Trajectory_Writer>(new IO::Trajectory_Writer(
+                    trajectoryFile, this->nos, this->parameters_mc->output_trajectory_bits, 32, true));
+            this->systems[0]->UpdateEnergyIfOutdated();
+            this->trajectory->Write_Frame(*this->systems[0]->spins, iteration, this->systems[0]->E);
+            if (final)
+                this->trajectory.reset();
+        }
     }
 
     // Method name as string
@@ -2,15 +2,12 @@
 #include <engine/Method_MMF.hpp>
 #include <engine/Vectormath.hpp>
 #include <engine/Manifoldmath.hpp>
+#include <engine/Eigenmodes.hpp>
 #include <io/IO.hpp>
 #include <io/OVF_File.hpp>
 #include <utility/Logging.hpp>
 
 #include <Eigen/Core>
-#include <Eigen/Eigenvalues>
-//#include <unsupported/Eigen/CXX11/Tensor>
-#include <GenEigsSolver.h>  // Also includes <MatOp/DenseGenMatProd.h>
-#include <GenEigsRealShiftSolver.h>
 
 #include <fmt/format.h>
 
@@ -34,6 +31,12 @@ namespace Engine
 		{
 			this->systems.push_back(this->collection->chains[ichain]->images.back());
 		}
+		this->noi = noc;
+		this->nos = nos;
+
+		// Create shared pointers to the method's systems' spin configurations
+		this->configurations = std::vector<std::shared_ptr<vectorfield>>(noc);
+		for (int ichain = 0; ichain < noc; ++ichain) this->configurations[ichain] = this->systems[ichain]->spins;
 
 		// History
         this->history = std::map<std::string, std::vector<scalar>>{
@@ -42,10 +45,12 @@ namespace Engine
 		// We assume that the systems are not converged before the first iteration
 		this->force_max_abs_component = this->collection->parameters->force_convergence + 1.0;
 
-		this->hessian = std::vector<MatrixX>(noc, MatrixX(3*nos, 3*nos));	// [noc][3nos]
 		// Forces
-		this->gradient   = std::vector<vectorfield>(noc, vectorfield(nos));	// [noc][3nos]
-		this->minimum_mode = std::vector<vectorfield>(noc, vectorfield(nos));	// [noc][3nos]
+		this->forces     = std::vector<vectorfield>(noc, vectorfield(nos, {0,0,0}));	// [noc][3nos]
+		this->gradient   = std::vector<vectorfield>(noc, vectorfield(nos, {0,0,0}));	// [noc][3nos]
+		// Minimum mode (zero, so that the first eigenmode calculation starts from a random vector)
+		this->minimum_mode = std::vector<vectorfield>(noc, vectorfield(nos, {0,0,0}));	// [noc][3nos]
+		this->minimum_eigenvalue = std::vector<scalar>(noc, 0);
 		this->xi = vectorfield(this->nos, {0,0,0});
 
 		// Last iteration
@@ -53,10 +58,6 @@ namespace Engine
 		this->spins_last[0] = *this->systems[0]->spins;
 		this->Rx_last = 0.0;
 
-		// Force function
-		// ToDo: move into parameters
-		this->mm_function = "Spectra Matrix"; // "Spectra Matrix" "Spectra Prefactor" "Lanczos"
-
         //---- Initialise Solver-specific variables
         this->Initialize();
     }
@@ -65,258 +66,47 @@ namespace Engine
 	template <Solver solver>
     void Method_MMF<solver>::Calculate_Force(const std::vector<std::shared_ptr<vectorfield>> & configurations, std::vector<vectorfield> & forces)
     {
-		if (this->mm_function == "Spectra Matrix")
-		{
-			this->Calculate_Force_Spectra_Matrix(configurations, forces);
-		}
-		/*else if (this->mm_function == "Spectra Prefactor")
-		{
-			this->Calculate_Force_Spectra_Prefactor(configurations, forces);
-		}
-		else if (this->mm_function == "Lanczos")
-		{
-			this->Calculate_Force_Lanczos(configurations, forces);
-		}*/
-		#ifdef SPIRIT_ENABLE_PINNING
-			Vectormath::set_c_a(1, forces[0], forces[0], this->parameters->pinning->mask_unpinned);
-		#endif // SPIRIT_ENABLE_PINNING
-    }
-
-	MatrixX projector(vectorfield & image)
-	{
-		int nos = image.size();
-		int size = 3*nos;
-
-		// Get projection matrix M=1-S, blockwise S=x*x^T
-		MatrixX proj = MatrixX::Identity(size, size);
-		for (int i = 0; i < nos; ++i)
-		{
-			proj.block<3, 3>(3*i, 3*i) -= image[i] * image[i].transpose();
-		}
-
-		return proj;
-	}
-
-	template <Solver solver>
-	void Method_MMF<solver>::Calculate_Force_Spectra_Matrix(const std::vector<std::shared_ptr<vectorfield>> & configurations, std::vector<vectorfield> & forces)
-	{
-		const int nos = configurations[0]->size();
-		// std::cerr << "mmf iteration" << std::endl;
-		
 		// Loop over chains and calculate the forces
 		for (int ichain = 0; ichain < this->collection->noc; ++ichain)
 		{
 			auto& image = *configurations[ichain];
-			auto& hess = hessian[ichain];
+			auto& hamiltonian = *this->systems[ichain]->hamiltonian;
 
-			// Copy std::vector<Eigen::Vector3> into one single Eigen::VectorX
-			Eigen::Ref<VectorX> x = Eigen::Map<VectorX>(image[0].data(), 3 * nos);
-			
 			// The gradient (unprojected)
-			this->systems[ichain]->hamiltonian->Gradient(image, gradient[ichain]);
-
-			// The Hessian (unprojected)
-			this->systems[ichain]->hamiltonian->Hessian(image, hess);
-
-			// The projection matrix
-			auto P = projector(image);
-
-			// std::cerr << "------------------------" << std::endl;
-			// std::cerr << "x:             " << x.transpose() << std::endl;
-			// std::cerr << "gradient:      " << gradient.transpose() << std::endl;
-			// std::cerr << "hessian:       " << std::endl << hess << std::endl;
-			// std::cerr << "projector:     " << std::endl << P << std::endl;
-			// std::cerr << "gradient proj: " << std::endl << (P*grad).transpose() << std::endl;
-			// std::cerr << "hessian proj:  " << std::endl << P*hess*P << std::endl;
-
-			// Eigen::EigenSolver<Eigen::MatrixXd> estest1(hess);
-			// td::cerr << "hessian:    " << std::endl << hess << std::endl;
-			// std::cerr << "eigen vals: " << std::endl << estest1.eigenvalues() << std::endl;
-			// std::cerr << "eigen vecs: " << std::endl << estest1.eigenvectors().real() << std::endl;
-
+			hamiltonian.Gradient(image, gradient[ichain]);
+			#ifdef SPIRIT_ENABLE_PINNING
+				Vectormath::set_c_a(1, gradient[ichain], gradient[ichain], this->parameters->pinning->mask_unpinned);
+			#endif // SPIRIT_ENABLE_PINNING
 
-			/*
-			/  Remove Hessian's components in the basis of the image (project it into tangent space)
-			/      and add the gradient contributions (inner and outer product)
-			*/
+			// The lowest eigenmode of the Hessian in the tangent space, starting from the previous one.
+			//		The Hessian is never assembled, only Hessian-vector products are used.
+			this->minimum_eigenvalue[ichain] = Eigenmodes::Lowest_Tangent_Eigenmode(hamiltonian, image, gradient[ichain], minimum_mode[ichain]);
 
-			// Correction components
-			// TODO: write Kernel for this
-			//     the following is equivalent to hess = P*hess*P but that could not be parallelized on the GPU
-			// for (int i = 0; i < nos; ++i)
-			// {
-			// 	for (int j = 0; j < nos; ++j)
-			// 	{
-			// 		hess.block<3, 3>(3*i, 3*j) = P.block<3, 3>(3*i, 3*i) * hess.block<3, 3>(3*i, 3*j) * P.block<3, 3>(3*j, 3*j);
-			// 	}
-			// }
+			Vectormath::set_c_a(-1, gradient[ichain], forces[ichain]);
+			if (this->minimum_eigenvalue[ichain] < 0)
+			{
+				// In the negative region, invert the force along the minimum mode
+				Manifoldmath::invert_parallel(forces[ichain], minimum_mode[ichain]);
+			}
+			else
+			{
+				// Otherwise only apply the inverted force component along the minimum mode
+				Manifoldmath::project_parallel(forces[ichain], minimum_mode[ichain]);
+				Vectormath::scale(forces[ichain], -1);
+			}
 
-			// // Hessian projection components (diagonal contribution blocks)
-			// // TODO: write Kernel for this
-			// for (int i = 0; i < nos; ++i)
-			// {
-			// 	hess.block<3, 3>(3*i, 3*i) -= P.block<3, 3>(3*i, 3*i)*(image[i].dot(gradient[ichain][i])) + (P.block<3, 3>(3*i, 3*i)*gradient[ichain][i])*image[i].transpose();
-			// }
-			
-			// // std::cerr << "hessian final: " << std::endl << hess << std::endl;
-
-
-    		// // Eigen::EigenSolver<Eigen::MatrixXd> estest1(hess);
-			// // Eigen::VectorXd estestvals = estest1.eigenvalues().real();
-			// // std::sort(estestvals.data(),estestvals.data()+estestvals.size());
-			// // std::cerr << "eigen vals (" << estestvals.size() << "): " << std::endl << estestvals.transpose() << std::endl;
-			// // int n_zero=0;
-			// // for (int _i=0; _i<estestvals.size(); ++_i)
-			// // {
-			// // 	if (std::abs(estestvals[_i]) < 1e-7) ++n_zero;
-			// // }
-			// // std::cerr << std::endl << "number of zero eigenvalues: " << n_zero << std::endl;
-
-			// // Get the lowest Eigenvector
-			// //		Create a Spectra solver
-			// Spectra::DenseGenMatProd<scalar> op(hess);
-			// Spectra::GenEigsSolver< scalar, Spectra::SMALLEST_REAL, Spectra::DenseGenMatProd<scalar> > hessian_spectrum(&op, 1, 3*nos);
-			// hessian_spectrum.init();
-			// //		Compute the specified spectrum
-			// int nconv = hessian_spectrum.compute();
-			// if (hessian_spectrum.info() == Spectra::SUCCESSFUL)
-			// {
-			// 	// Calculate the Force
-			// 	// 		Retrieve the Eigenvalues
-			// 	VectorX evalues = hessian_spectrum.eigenvalues().real();
-				
-			// 	//std::cerr << "spectra val: " << std::endl << hessian_spectrum.eigenvalues() << std::endl;
-			// 	//std::cerr << "spectra vec: " << std::endl << -reorder_vector(hessian_spectrum.eigenvectors().col(0).real()) << std::endl;
-				
-			// 	// 		Check if the lowest eigenvalue is negative
-			// 	if (evalues[0] < -1e-5)// || switched2)
-			// 	{
-			// 		// std::cerr << "negative region " << evalues.transpose() << std::endl;
-			// 		if (switched1)
-			// 			switched2 = true;
-			// 		// Retrieve the Eigenvectors
-			// 		MatrixX evectors = hessian_spectrum.eigenvectors().real();
-			// 		Eigen::Ref<VectorX> evec = evectors.col(0);
-
-			// 		// The following line does not seem to work with Eigen3.3
-			// 		// this->minimum_mode[ichain] = vectorfield(evec.data(), evec.data() + evec.rows()*evec.cols());
-			// 		// TODO: use Eigen's Map or Ref instead
-			// 		for (int n=0; n<nos; ++n)
-			// 		{
-			// 			this->minimum_mode[ichain][n] = {evec[3*n], evec[3*n+1], evec[3*n+2]};
-			// 		}
-
-			// 		scalar check = Vectormath::dot(minimum_mode[ichain], image);
-			// 		scalar checknorm = Manifoldmath::norm(minimum_mode[ichain]);
-			// 		if (std::abs(check) > 1e-8 || std::abs(checknorm) < 1e-8)
-			// 		{
-			// 			std::cerr << "-------------------------" << std::endl;
-			// 			std::cerr << "BAD MODE! evalue = " << evalues[0] << std::endl;
-			// 			std::cerr << "-------------------------" << std::endl;
-			// 		}
-
-
-			// 		//for (int _i = 0; _i < forces[ichain].size(); ++_i) minimum_mode[ichain][_i] = -minimum_mode[ichain][_i];
-			// 		// 		Normalize the mode vector in 3N dimensions
-			// 		Engine::Manifoldmath::normalize(this->minimum_mode[ichain]);
-					
-					
-			// 		// Invert the gradient force along the minimum mode
-			// 		Engine::Manifoldmath::invert_parallel(gradient[ichain], minimum_mode[ichain]);
-			// 		// Copy out the forces
-			// 		for (unsigned int _i = 0; _i < forces[ichain].size(); ++_i) forces[ichain][_i] = -gradient[ichain][_i];
-			// 		//forces[ichain] = gradient[ichain];
-					
-			// 		// std::cerr << "grad      " << gradient[ichain][0] << " " << gradient[ichain][1] << " " << gradient[ichain][2] << std::endl;
-			// 		// std::cerr << "min mode: " << std::endl << evec << std::endl;
-			// 		// std::cerr << "mode      " << minimum_mode[ichain][0] << " " << minimum_mode[ichain][1] << " " << minimum_mode[ichain][2] << std::endl;
-			// 		// std::cerr << "force     " << forces[ichain][0] << " " << forces[ichain][1] << " " << forces[ichain][2] << std::endl;
-			// 	}
-			// 	//		Otherwise we seek for the lowest nonzero eigenvalue
-			// 	else
-			// 	{
-			// 		switched1 = true;
-			// 		// std::cerr << "positive region " << evalues.transpose() << std::endl;
-			// 		///////////////////////////////////
-			// 		//// The Eigen way... calculate them all... Inefficient! Do it the spectra way instead!
-			// 		//Eigen::EigenSolver<Eigen::MatrixXd> estest1(hess);
-			// 		//std::cerr << "hessian:    " << std::endl << hess << std::endl;
-			// 		//std::cerr << "eigen vals: " << std::endl << estest1.eigenvalues() << std::endl;
-			// 		//std::cerr << "eigen vecs: " << std::endl << reorder_matrix(estest1.eigenvectors().real()) << std::endl;
-			// 		///////////////////////////////////
-
-			// 		// // Create the Minimum Mode
-			// 		// Spectra::DenseGenRealShiftSolve<scalar> op_pos(hess);
-			// 		// Spectra::GenEigsRealShiftSolver< scalar, Spectra::SMALLEST_REAL, Spectra::DenseGenRealShiftSolve<scalar> > hessian_spectrum_pos(&op_pos, 1, 3 * nos, 1.0e-5);
-			// 		// hessian_spectrum_pos.init();
-			// 		// //		Compute the specified spectrum
-			// 		// int nconv = hessian_spectrum_pos.compute();
-			// 		// // 		Retrieve the Eigenvectors
-			// 		// //std::cerr << "-----" << std::endl;
-			// 		// //std::cerr << "spectra:" << std::endl;
-			// 		// //std::cerr << hessian_spectrum_pos.eigenvalues() << std::endl;
-			// 		// //std::cerr << hessian_spectrum_pos.eigenvectors().real() << std::endl;
-			// 		// //std::cerr << "-----" << std::endl;
-			// 		// Eigen::MatrixXd evectors = hessian_spectrum_pos.eigenvectors().real();
-			// 		// //auto evec = evectors.col(0);
-			// 		// Eigen::Ref<Eigen::VectorXd> evec = evectors.col(0);
-
-			// 		// for (int n=0; n<nos; ++n)
-			// 		// {
-			// 		// 	this->minimum_mode[ichain][n] = {evec[3*n], evec[3*n+1], evec[3*n+2]};
-			// 		// }
-
-			// 		// Engine::Manifoldmath::normalize(this->minimum_mode[ichain]);
-
-
-			// 		// //this->minimum_mode[ichain] = std::vector<scalar>(evec.data(), evec.data() + evec.rows()*evec.cols());
-			// 		// ////for (int _i = 0; _i < forces[ichain].size(); ++_i) minimum_mode[ichain][_i] = -minimum_mode[ichain][_i];
-			// 		// //// 		Normalize the mode vector in 3N dimensions
-			// 		// //Utility::Vectormath::Normalize(this->minimum_mode[ichain]);
-
-			// 		// ////// 		Copy via assignment
-			// 		// ////this->minimum_mode[ichain] = std::vector<scalar>(evec_min.data(), evec_min.data() + evec_min.rows()*evec_min.cols());
-			// 		// ////// 		Normalize the mode vector in 3N dimensions
-			// 		// ////Utility::Vectormath::Normalize(this->minimum_mode[ichain]);
-			// 		// ////// We are too close to the local minimum so we have to use a strong force
-			// 		// //////		We apply the force against the minimum mode of the positive eigenvalue
-			// 		// scalar v1v2 = 0.0;
-			// 		// for (int i = 0; i < nos; ++i)
-			// 		// {
-			// 		// 	v1v2 += gradient[ichain][i].dot(minimum_mode[ichain][i]);
-			// 		// }
-			// 		// // Take out component in direction of v2
-			// 		// for (int i = 0; i < nos; ++i)
-			// 		// {
-			// 		// 	gradient[ichain][i] =  -v1v2 * minimum_mode[ichain][i]; // -gradient[ichain][i]
-			// 		// }
-
-			// 		// for (int i = 0; i < nos; ++i)
-			// 		// {
-			// 		// 	forces[ichain][i] =  -gradient[ichain][i];
-			// 		// }
-
-			// 		// Copy out the forces
-			// 		forces[ichain] = gradient[ichain];
-			// 	}
-			// 	//std::cerr << "------------------------" << std::endl;
-			// }
-			// else
-			// {
-			// 	Log(Log_Level::Error, Log_Sender::MMF, "Failed to calculate eigenvectors of the Hessian!");
-			// 	Log(Log_Level::Info, Log_Sender::MMF, "Zeroing the MMF force...");
-			// 	for (Vector3 x : forces[ichain]) x.setZero();
-			// }
+			#ifdef SPIRIT_ENABLE_PINNING
+				Vectormath::set_c_a(1, forces[ichain], forces[ichain], this->parameters->pinning->mask_unpinned);
+			#endif // SPIRIT_ENABLE_PINNING
 		}
-		// std::cerr << "mmf iteration done" << std::endl;
-	}
-
-	
+    }
 
-	void printmatrix(MatrixX & m)
-	{
-		std::cerr << m << std::endl;
-	}
+	template <Solver solver>
+    bool Method_MMF<solver>::Force_Inverted(int img)
+    {
+		// The force is inverted along the minimum mode
+		return true;
+    }
 
 		
     // Check if the Forces are converged
@@ -345,7 +135,6 @@ namespace Engine
 		}
 
         // --- Update the chains' last images
-		for (auto system : this->systems) system->UpdateEnergy();
 		for (auto chain : collection->chains)
 		{
 			int i = chain->noi - 1;
@@ -388,11 +177,23 @@ namespace Engine
                     std::string spinsFile = preSpinsFile + suffix + ".ovf";
                     std::string comment = std::to_string( iteration );
                     
-                    // Spin Configuration
-                    IO::File_OVF file_ovf( spinsFile, IO::VF_FileFormat::OVF_TEXT );
-                    file_ovf.write_segment( *( this->systems[0] )->spins, 
-                                            *( this->systems[0] )->geometry,
-                                            comment, append );
+                    // Spin Configuration. The archive is appended to through one File_OVF, which
+                    //      keeps track of the segments, so that the file is not read again for each segment
+                    if (append)
+                    {
+                        if (!this->archive_file)
+                            this->archive_file = std::unique_ptr<IO::File_OVF>(new IO::File_OVF(spinsFile, IO::VF_FileFormat::OVF_TEXT));
+                        this->archive_file->write_segment( *( this->systems[0] )->spins, 
+                                                           *( this->systems[0] )->geometry,
+                                                           comment, true );
+                    }
+                    else
+                    {
+                        IO::File_OVF file_ovf( spinsFile, IO::VF_FileFormat::OVF_TEXT );
+                        file_ovf.write_segment( *( this->systems[0] )->spins, 
+                                                *( this->systems[0] )->geometry,
+                                                comment, false );
+                    }
                 }
                 catch( ... )
                 {
@@ -412,8 +213,7 @@ namespace Engine
 
 				// Energy
 				// Check if Energy File exists and write Header if it doesn't
-				std::ifstream f(energyFile);
-				if (!f.good()) IO::Write_Energy_Header(*this->systems[0], energyFile);
+				if (!IO::Output_File_Exists(energyFile)) IO::Write_Energy_Header(*this->systems[0], energyFile);
 				// Append Energy to File
 				//IO::Append_Image_Energy(*this->systems[0], iteration, energyFile, normalize);
 
@@ -422,10 +222,11 @@ namespace Engine
 				spins_last[0] = *this->systems[0]->spins;
 				Rx_last = Rx;
 				//
+				this->systems[0]->UpdateEnergyIfOutdated();
 				scalar nd = 1.0;
 				if (this->collection->parameters->output_energy_divide_by_nspins) nd /= this->systems[0]->nos; // nos divide
-				std::string output_to_file = s_iter + fmt::format("    {18.10f}    {18.10f}\n", Rx, this->systems[0]->E * nd);
-				IO::Append_String_to_File(output_to_file, energyFile);
+				std::string output_to_file = s_iter + fmt::format("    {:18.10f}    {:18.10f}\n", Rx, this->systems[0]->E * nd);
+				IO::Dump_Append_to_File(output_to_file, energyFile);
 			};
 
 
@@ -458,6 +259,8 @@ namespace Engine
 			if (this->systems[0]->llg_parameters->output_configuration_archive)
 			{
 				writeOutputConfiguration("_archive", true);
+				if (final)
+					this->archive_file.reset();
 			}
 			if (this->systems[0]->llg_parameters->output_energy_archive)
 			{
@@ -583,4 +386,5 @@ namespace Engine
 	template class Method_MMF<Solver::Depondt>;
 	template class Method_MMF<Solver::NCG>;
 	template class Method_MMF<Solver::VP>;
+	template class Method_MMF<Solver::BFGS>;
 }
@@ -2,6 +2,7 @@
 
 #include <engine/Vectormath.hpp>
 #include <engine/Manifoldmath.hpp>
+#include <engine/Philox.hpp>
 #include <utility/Constants.hpp>
 #include <utility/Logging.hpp>
 #include <utility/Exception.hpp>
@@ -18,7 +19,97 @@ namespace Engine
 {
     namespace Vectormath
     {
-        
+        #ifdef SPIRIT_USE_SIMD
+        /*
+            SIMD kernels for vectorfields. A vectorfield is an array of 3N scalars (x0,y0,z0,x1,...),
+            so component-wise operations are done on the flat array. Operations which mix the components
+            of a vector (cross products, norms) are done in tiles, which are transposed into small
+            structure-of-arrays buffers, so that the arithmetic is vectorized across the spins.
+        */
+        namespace SIMD
+        {
+            static_assert(sizeof(Vector3) == 3*sizeof(scalar), "Vector3 is expected to be three contiguous scalars");
+
+            // Number of spins per tile: one AVX-512 register of doubles, two of floats
+            const int tile = 8;
+
+            inline scalar * data(vectorfield & vf) { return reinterpret_cast<scalar *>(vf.data()); }
+            inline const scalar * data(const vectorfield & vf) { return reinterpret_cast<const scalar *>(vf.data()); }
+
+            // Transpose n <= tile vectors from AoS into SoA and back
+            inline void load(const scalar * aos, int n, scalar * x, scalar * y, scalar * z)
+            {
+                #pragma omp simd
+                for (int j = 0; j < n; ++j)
+                {
+                    x[j] = aos[3*j];
+                    y[j] = aos[3*j+1];
+                    z[j] = aos[3*j+2];
+                }
+            }
+            inline void store(const scalar * x, const scalar * y, const scalar * z, int n, scalar * aos)
+            {
+                #pragma omp simd
+                for (int j = 0; j < n; ++j)
+                {
+                    aos[3*j]   = x[j];
+                    aos[3*j+1] = y[j];
+                    aos[3*j+2] = z[j];
+                }
+            }
+
+            // out = c*a x b, if add is set out += c*a x b
+            void c_cross(scalar c, const scalar * a, const scalar * b, scalar * out, int nos, bool add)
+            {
+                #pragma omp parallel for
+                for (int start = 0; start < nos; start += tile)
+                {
+                    int n = std::min(tile, nos - start);
+                    alignas(64) scalar ax[tile], ay[tile], az[tile], bx[tile], by[tile], bz[tile], ox[tile], oy[tile], oz[tile];
+                    load(a + 3*start, n, ax, ay, az);
+                    load(b + 3*start, n, bx, by, bz);
+                    #pragma omp simd
+                    for (int j = 0; j < n; ++j)
+                    {
+                        ox[j] = c * (ay[j]*bz[j] - az[j]*by[j]);
+                        oy[j] = c * (az[j]*bx[j] - ax[j]*bz[j]);
+                        oz[j] = c * (ax[j]*by[j] - ay[j]*bx[j]);
+                    }
+                    if (add)
+                    {
+                        scalar * o = out + 3*start;
+                        #pragma omp simd
+                        for (int j = 0; j < n; ++j)
+                        {
+                            o[3*j]   += ox[j];
+                            o[3*j+1] += oy[j];
+                            o[3*j+2] += oz[j];
+                        }
+                    }
+                    else
+                        store(ox, oy, oz, n, out + 3*start);
+                }
+            }
+
+            // out = c*a, if add is set out += c*a
+            void c_a(scalar c, const scalar * a, scalar * out, int n_scalars, bool add)
+            {
+                if (add)
+                {
+                    #pragma omp parallel for simd
+                    for (int i = 0; i < n_scalars; ++i)
+                        out[i] += c*a[i];
+                }
+                else
+                {
+                    #pragma omp parallel for simd
+                    for (int i = 0; i < n_scalars; ++i)
+                        out[i] = c*a[i];
+                }
+            }
+        }
+        #endif
+
         void rotate(const Vector3 & v, const Vector3 & axis, const scalar & angle, Vector3 & v_out)
         {
             v_out = v * std::cos(angle) + axis.cross(v) * std::sin(angle) + 
@@ -173,6 +264,34 @@ namespace Engine
         // Utility function for the SIB Solver
         void transform(const vectorfield & spins, const vectorfield & force, vectorfield & out)
         {
+            #ifdef SPIRIT_USE_SIMD
+            const scalar * s = SIMD::data(spins);
+            const scalar * f = SIMD::data(force);
+            scalar * o = SIMD::data(out);
+            int nos = spins.size();
+            #pragma omp parallel for
+            for (int start = 0; start < nos; start += SIMD::tile)
+            {
+                int n = std::min(SIMD::tile, nos - start);
+                alignas(64) scalar sx[SIMD::tile], sy[SIMD::tile], sz[SIMD::tile];
+                alignas(64) scalar ax[SIMD::tile], ay[SIMD::tile], az[SIMD::tile];
+                SIMD::load(s + 3*start, n, sx, sy, sz);
+                SIMD::load(f + 3*start, n, ax, ay, az);
+                #pragma omp simd
+                for (int j = 0; j < n; ++j)
+                {
+                    scalar A0 = 0.5*ax[j], A1 = 0.5*ay[j], A2 = 0.5*az[j];
+                    scalar detAi = 1 / (1 + A0*A0 + A1*A1 + A2*A2);
+                    scalar b0 = sx[j] - (sy[j]*A2 - sz[j]*A1);
+                    scalar b1 = sy[j] - (sz[j]*A0 - sx[j]*A2);
+                    scalar b2 = sz[j] - (sx[j]*A1 - sy[j]*A0);
+                    sx[j] = (b0 * (A0 * A0 + 1) + b1 * (A0 * A1 - A2) + b2 * (A0 * A2 + A1)) * detAi;
+                    sy[j] = (b0 * (A1 * A0 + A2) + b1 * (A1 * A1 + 1) + b2 * (A1 * A2 - A0)) * detAi;
+                    sz[j] = (b0 * (A2 * A0 - A1) + b1 * (A2 * A1 + A0) + b2 * (A2 * A2 + 1)) * detAi;
+                }
+                SIMD::store(sx, sy, sz, n, o + 3*start);
+            }
+            #else
             #pragma omp parallel for
             for (unsigned int i = 0; i < spins.size(); ++i)
             {
@@ -188,6 +307,7 @@ namespace Engine
                 out[i][1] = (a2[0] * (A[1] * A[0] + A[2]) + a2[1] * (A[1] * A[1] + 1   ) + a2[2] * (A[1] * A[2] - A[0])) * detAi;
                 out[i][2] = (a2[0] * (A[2] * A[0] - A[1]) + a2[1] * (A[2] * A[1] + A[0]) + a2[2] * (A[2] * A[2] + 1   )) * detAi;
             }
+            #endif
         }
 
         void get_random_vector(std::uniform_real_distribution<scalar> & distribution, std::mt19937 & prng, Vector3 & vec)
@@ -201,8 +321,7 @@ namespace Engine
         {
             // PRNG gives RN [-1,1] -> multiply with epsilon
             auto distribution = std::uniform_real_distribution<scalar>(-1, 1);
-            // TODO: parallelization of this is actually not quite so trivial
-            #pragma omp parallel for
+            // The PRNG is sequential, for parallel generation use a counter-based generator
             for (unsigned int i = 0; i < xi.size(); ++i)
             {
                 get_random_vector(distribution, prng, xi[i]);
@@ -224,14 +343,33 @@ namespace Engine
         {
             // PRNG gives RN [-1,1] -> multiply with epsilon
             auto distribution = std::uniform_real_distribution<scalar>(-1, 1);
-            // TODO: parallelization of this is actually not quite so trivial
-            #pragma omp parallel for
+            // The PRNG is sequential, for parallel generation use a counter-based generator
             for (unsigned int i = 0; i < xi.size(); ++i)
             {
                 get_random_vector_unitsphere(distribution, prng, xi[i]);
             }
         }
 
+        Vector3 get_random_vector_unitsphere(std::uint64_t seed, std::uint64_t counter, std::uint32_t index)
+        {
+            const std::uint32_t key[2] = { std::uint32_t(seed), std::uint32_t(seed >> 32) };
+            std::uint32_t ctr[4] = { index, std::uint32_t(counter), std::uint32_t(counter >> 32), 0 };
+            Philox::philox4x32_10(ctr, key);
+
+            scalar v_z = 2*Philox::uniform_open(ctr[0], ctr[1]) - 1;
+            scalar phi = Philox::uniform_open(ctr[2], ctr[3]);
+            scalar r_xy = std::sqrt(1 - v_z*v_z);
+
+            return Vector3{ r_xy * std::cos(2*Pi*phi), r_xy * std::sin(2*Pi*phi), v_z };
+        }
+
+        void get_random_vectorfield_unitsphere(std::uint64_t seed, std::uint64_t counter, vectorfield & xi)
+        {
+            #pragma omp parallel for
+            for (unsigned int i = 0; i < xi.size(); ++i)
+                xi[i] = get_random_vector_unitsphere(seed, counter, i);
+        }
+
         void get_gradient_distribution(const Data::Geometry & geometry, Vector3 gradient_direction, scalar gradient_start, scalar gradient_inclination, scalarfield & distribution, scalar range_min, scalar range_max)
         {
             // Ensure a normalized direction vector
@@ -434,9 +572,32 @@ namespace Engine
 
         void normalize_vectors(vectorfield & vf)
         {
+            #ifdef SPIRIT_USE_SIMD
+            scalar * v = SIMD::data(vf);
+            int nos = vf.size();
+            #pragma omp parallel for
+            for (int start = 0; start < nos; start += SIMD::tile)
+            {
+                int n = std::min(SIMD::tile, nos - start);
+                alignas(64) scalar x[SIMD::tile], y[SIMD::tile], z[SIMD::tile];
+                SIMD::load(v + 3*start, n, x, y, z);
+                #pragma omp simd
+                for (int j = 0; j < n; ++j)
+                {
+                    // Like Eigen's normalize, zero vectors are left unchanged
+                    scalar norm2 = x[j]*x[j] + y[j]*y[j] + z[j]*z[j];
+                    scalar inv_norm = norm2 > 0 ? 1/std::sqrt(norm2) : 1;
+                    x[j] *= inv_norm;
+                    y[j] *= inv_norm;
+                    z[j] *= inv_norm;
+                }
+                SIMD::store(x, y, z, n, v + 3*start);
+            }
+            #else
             #pragma omp parallel for
             for (unsigned int i=0; i<vf.size(); ++i)
                 vf[i].normalize();
+            #endif
         }
         
         void norm( const vectorfield & vf, scalarfield & norm )
@@ -466,20 +627,32 @@ namespace Engine
         {
             // We want the Maximum of Absolute Values of all force components on all images
             scalar absmax = 0;
+            #ifdef SPIRIT_USE_SIMD
+            const scalar * v = SIMD::data(vf);
+            int n_scalars = 3*vf.size();
+            #pragma omp parallel for simd reduction(max : absmax)
+            for (int i = 0; i < n_scalars; ++i)
+                absmax = std::max(absmax, std::abs(v[i]));
+            #else
             // Find minimum and maximum values
             std::pair<scalar,scalar> minmax = minmax_component(vf);
             // Mamimum of absolute values
             absmax = std::max(absmax, std::abs(minmax.first));
             absmax = std::max(absmax, std::abs(minmax.second));
+            #endif
             // Return
             return absmax;
         }
 
         void scale(vectorfield & vf, const scalar & sc)
         {
+            #ifdef SPIRIT_USE_SIMD
+            SIMD::c_a(sc, SIMD::data(vf), SIMD::data(vf), 3*vf.size(), false);
+            #else
             #pragma omp parallel for
             for (unsigned int i=0; i<vf.size(); ++i)
                 vf[i] *= sc;
+            #endif
         }
 
         Vector3 sum(const vectorfield & vf)
@@ -508,9 +681,18 @@ namespace Engine
         scalar dot(const vectorfield & v1, const vectorfield & v2)
         {
             scalar ret = 0;
+            #ifdef SPIRIT_USE_SIMD
+            const scalar * a = SIMD::data(v1);
+            const scalar * b = SIMD::data(v2);
+            int n_scalars = 3*v1.size();
+            #pragma omp parallel for simd reduction(+:ret)
+            for (int i = 0; i < n_scalars; ++i)
+                ret += a[i]*b[i];
+            #else
             #pragma omp parallel for reduction(+:ret)
             for (unsigned int i = 0; i<v1.size(); ++i)
                 ret += v1[i].dot(v2[i]);
+            #endif
             return ret;
         }
 
@@ -518,9 +700,18 @@ namespace Engine
         // vf1 and vf2 are vectorfields
         void dot(const vectorfield & vf1, const vectorfield & vf2, scalarfield & out)
         {
+            #ifdef SPIRIT_USE_SIMD
+            const scalar * a = SIMD::data(vf1);
+            const scalar * b = SIMD::data(vf2);
+            int nos = vf1.size();
+            #pragma omp parallel for simd
+            for (int i = 0; i < nos; ++i)
+                out[i] = a[3*i]*b[3*i] + a[3*i+1]*b[3*i+1] + a[3*i+2]*b[3*i+2];
+            #else
             #pragma omp parallel for
             for (unsigned int i=0; i<vf1.size(); ++i)
                 out[i] = vf1[i].dot(vf2[i]);
+            #endif
         }
 
         // computes the product of scalars in s1 and s2
@@ -536,9 +727,13 @@ namespace Engine
         // v1 and v2 are vector fields
         void cross(const vectorfield & v1, const vectorfield & v2, vectorfield & out)
         {
+            #ifdef SPIRIT_USE_SIMD
+            SIMD::c_cross(1, SIMD::data(v1), SIMD::data(v2), SIMD::data(out), v1.size(), false);
+            #else
             #pragma omp parallel for
             for (unsigned int i=0; i<v1.size(); ++i)
                 out[i] = v1[i].cross(v2[i]);
+            #endif
         }
 
 
@@ -552,9 +747,13 @@ namespace Engine
         // out[i] += c*a[i]
         void add_c_a(const scalar & c, const vectorfield & vf, vectorfield & out)
         {
+            #ifdef SPIRIT_USE_SIMD
+            SIMD::c_a(c, SIMD::data(vf), SIMD::data(out), 3*out.size(), true);
+            #else
             #pragma omp parallel for
             for(unsigned int idx = 0; idx < out.size(); ++idx)
                 out[idx] += c*vf[idx];
+            #endif
         }
         void add_c_a(const scalar & c, const vectorfield & vf, vectorfield & out, const intfield & mask)
         {
@@ -588,9 +787,13 @@ namespace Engine
         // out[i] = c*a[i]
         void set_c_a(const scalar & c, const vectorfield & vf, vectorfield & out)
         {
+            #ifdef SPIRIT_USE_SIMD
+            SIMD::c_a(c, SIMD::data(vf), SIMD::data(out), 3*out.size(), false);
+            #else
             #pragma omp parallel for
             for(unsigned int idx = 0; idx < out.size(); ++idx)
                 out[idx] = c*vf[idx];
+            #endif
         }
         // out[i] = c*a[i]
         void set_c_a(const scalar & c, const vectorfield & vf, vectorfield & out, const intfield & mask)
@@ -648,9 +851,13 @@ namespace Engine
         // out[i] += c * a[i] x b[i]
         void add_c_cross(const scalar & c, const vectorfield & a, const vectorfield & b, vectorfield & out)
         {
+            #ifdef SPIRIT_USE_SIMD
+            SIMD::c_cross(c, SIMD::data(a), SIMD::data(b), SIMD::data(out), out.size(), true);
+            #else
             #pragma omp parallel for
             for(unsigned int idx = 0; idx < out.size(); ++idx)
                 out[idx] += c*a[idx].cross(b[idx]);
+            #endif
         }
         // out[i] += c[i] * a[i] x b[i]
         void add_c_cross(const scalarfield & c, const vectorfield & a, const vectorfield & b, vectorfield & out)
@@ -670,9 +877,13 @@ namespace Engine
         // out[i] = c * a[i] x b[i]
         void set_c_cross(const scalar & c, const vectorfield & a, const vectorfield & b, vectorfield & out)
         {
+            #ifdef SPIRIT_USE_SIMD
+            SIMD::c_cross(c, SIMD::data(a), SIMD::data(b), SIMD::data(out), out.size(), false);
+            #else
             #pragma omp parallel for
             for(unsigned int idx = 0; idx < out.size(); ++idx)
                 out[idx] = c*a[idx].cross(b[idx]);
+            #endif
         }
     }
 }
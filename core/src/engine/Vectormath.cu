@@ -1,6 +1,7 @@
 #ifdef SPIRIT_USE_CUDA
 
 #include <engine/Vectormath.hpp>
+#include <engine/Philox.hpp>
 #include <utility/Constants.hpp>
 #include <utility/Logging.hpp>
 #include <utility/Exception.hpp>
@@ -475,14 +476,51 @@ namespace Engine
         {
             // PRNG gives RN [-1,1] -> multiply with epsilon
             auto distribution = std::uniform_real_distribution<scalar>(-1, 1);
-            // TODO: parallelization of this is actually not quite so trivial
-            #pragma omp parallel for
+            // The PRNG is sequential, for parallel generation use a counter-based generator
             for (unsigned int i = 0; i < xi.size(); ++i)
             {
                 get_random_vector_unitsphere(distribution, prng, xi[i]);
             }
         }
 
+        __global__ void cu_get_random_vectorfield_philox(std::uint32_t key0, std::uint32_t key1, std::uint64_t counter, Vector3 * xi, size_t N)
+        {
+            const std::uint32_t key[2] = { key0, key1 };
+            for(int idx = blockIdx.x * blockDim.x + threadIdx.x;
+                idx < N;
+                idx +=  blockDim.x * gridDim.x)
+            {
+                std::uint32_t ctr[4] = { std::uint32_t(idx), std::uint32_t(counter), std::uint32_t(counter >> 32), 0 };
+                Philox::philox4x32_10(ctr, key);
+
+                scalar v_z = 2*Philox::uniform_open(ctr[0], ctr[1]) - 1;
+                scalar phi = Philox::uniform_open(ctr[2], ctr[3]);
+                scalar r_xy = sqrt(1 - v_z*v_z);
+
+                xi[idx][0] = r_xy * cos(2*Pi*phi);
+                xi[idx][1] = r_xy * sin(2*Pi*phi);
+                xi[idx][2] = v_z;
+            }
+        }
+        void get_random_vectorfield_unitsphere(std::uint64_t seed, std::uint64_t counter, vectorfield & xi)
+        {
+            int n = xi.size();
+            cu_get_random_vectorfield_philox<<<(n+1023)/1024, 1024>>>(std::uint32_t(seed), std::uint32_t(seed >> 32), counter, xi.data(), n);
+            CU_CHECK_AND_SYNC();
+        }
+        Vector3 get_random_vector_unitsphere(std::uint64_t seed, std::uint64_t counter, std::uint32_t index)
+        {
+            const std::uint32_t key[2] = { std::uint32_t(seed), std::uint32_t(seed >> 32) };
+            std::uint32_t ctr[4] = { index, std::uint32_t(counter), std::uint32_t(counter >> 32), 0 };
+            Philox::philox4x32_10(ctr, key);
+
+            scalar v_z = 2*Philox::uniform_open(ctr[0], ctr[1]) - 1;
+            scalar phi = Philox::uniform_open(ctr[2], ctr[3]);
+            scalar r_xy = std::sqrt(1 - v_z*v_z);
+
+            return Vector3{ r_xy * std::cos(2*Pi*phi), r_xy * std::sin(2*Pi*phi), v_z };
+        }
+
         void get_gradient_distribution(const Data::Geometry & geometry, Vector3 gradient_direction, scalar gradient_start, scalar gradient_inclination, scalarfield & distribution, scalar range_min, scalar range_max)
         {
             // Starting value
@@ -32,7 +32,8 @@ namespace IO
              save_positions_initial  = false,
              save_positions_final    = false,
              save_neighbours_initial = false,
-             save_neighbours_final   = false;
+             save_neighbours_final   = false,
+             messages_timings        = false;
 
         // "Quiet" settings
         if (force_quiet)
@@ -94,6 +95,9 @@ namespace IO
                  // Save Input (parameters from config file and defaults) on State Delete
                  myfile.Read_Single(save_neighbours_final, "save_neighbours_final");
 
+                // Append the timings of the Hamiltonian, solvers and output to the method's log messages
+                myfile.Read_Single(messages_timings, "log_timings");
+
             }// end try
             catch( ... )
             {
@@ -114,6 +118,7 @@ namespace IO
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("Log positions save final    = {0}", save_positions_final));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("Log neighbours save initial = {0}", save_neighbours_initial));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("Log neighbours save final   = {0}", save_neighbours_final));
+        Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("Log timings            = {0}", messages_timings));
         
         // Update the Log
         if (!force_quiet)
@@ -129,6 +134,7 @@ namespace IO
             Log.save_positions_final    = save_positions_final;
             Log.save_neighbours_initial = save_neighbours_initial;
             Log.save_neighbours_final   = save_neighbours_final;
+            Log.messages_timings        = messages_timings;
         }
 
         Log.file_tag      = file_tag;
@@ -565,6 +571,9 @@ namespace IO
         bool output_configuration_step = false, 
              output_configuration_archive = false;
         int output_configuration_filetype = int(IO::VF_FileFormat::OVF_TEXT);
+        int output_energy_spin_resolved_filetype = int(IO::VF_FileFormat::OVF_BIN8);
+        bool output_trajectory = false;
+        int output_trajectory_bits = 16;
         // Maximum walltime in seconds
         long int max_walltime = 0;
         std::string str_max_walltime;
@@ -575,6 +584,10 @@ namespace IO
         long int n_iterations = (int)2E+6;
         // Number of iterations after which the system is logged to file
         long int n_iterations_log = 100;
+        // Maximum number of iterations between the checks of the stop file and walltime
+        long int n_iterations_amortize = 64;
+        // Number of iterations after which energy and magnetization are recorded (0 = only when logging)
+        long int n_iterations_observables = 0;
         // Temperature in K
         scalar temperature = 0.0;
         // Temperature gradient
@@ -618,10 +631,15 @@ namespace IO
                 myfile.Read_Single(output_configuration_step,           "llg_output_configuration_step");
                 myfile.Read_Single(output_configuration_archive,        "llg_output_configuration_archive");
                 myfile.Read_Single(output_configuration_filetype,       "llg_output_configuration_filetype");
+                myfile.Read_Single(output_energy_spin_resolved_filetype, "llg_output_energy_spin_resolved_filetype");
+                myfile.Read_Single(output_trajectory,                   "llg_output_trajectory");
+                myfile.Read_Single(output_trajectory_bits,              "llg_output_trajectory_bits");
                 myfile.Read_Single(str_max_walltime, "llg_max_walltime");
                 myfile.Read_Single(seed, "llg_seed");
                 myfile.Read_Single(n_iterations, "llg_n_iterations");
                 myfile.Read_Single(n_iterations_log, "llg_n_iterations_log");
+                myfile.Read_Single(n_iterations_amortize, "llg_n_iterations_amortize");
+                myfile.Read_Single(n_iterations_observables, "llg_n_iterations_observables");
                 myfile.Read_Single(dt, "llg_dt");
                 myfile.Read_Single(temperature, "llg_temperature");
                 myfile.Read_Vector3(temperature_gradient_direction, "llg_temperature_gradient_direction");
@@ -661,6 +679,8 @@ namespace IO
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<17} = {1}", "maximum walltime", str_max_walltime));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<17} = {1}", "n_iterations", n_iterations));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<17} = {1}", "n_iterations_log", n_iterations_log));
+        Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<17} = {1}", "n_iterations_amortize", n_iterations_amortize));
+        Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<17} = {1}", "n_iterations_observables", n_iterations_observables));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<17} = {1}", "output_folder", output_folder));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<17} = {1}", "output_any", output_any));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<17} = {1}", "output_initial", output_initial));
@@ -673,6 +693,9 @@ namespace IO
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<30} = {1}", "output_configuration_step", output_configuration_step));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<30} = {1}", "output_configuration_archive", output_configuration_archive));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<30} = {1}", "output_configuration_filetype", output_configuration_filetype));
+        Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<30} = {1}", "output_energy_spin_resolved_filetype", output_energy_spin_resolved_filetype));
+        Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<30} = {1}", "output_trajectory", output_trajectory));
+        Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<30} = {1}", "output_trajectory_bits", output_trajectory_bits));
 
         max_walltime = (long int)Utility::Timing::DurationFromString(str_max_walltime).count();
         auto llg_params = std::unique_ptr<Data::Parameters_Method_LLG>(new Data::Parameters_Method_LLG(
@@ -681,6 +704,11 @@ namespace IO
             output_configuration_filetype, force_convergence, n_iterations, n_iterations_log, max_walltime, pinning, seed,
             temperature, temperature_gradient_direction, temperature_gradient_inclination,
             damping, beta, dt, renorm_sd, stt_use_gradient, stt_magnitude, stt_polarisation_normal));
+        llg_params->n_iterations_observables = n_iterations_observables;
+        llg_params->output_energy_spin_resolved_filetype = output_energy_spin_resolved_filetype;
+        llg_params->output_trajectory = output_trajectory;
+        llg_params->output_trajectory_bits = output_trajectory_bits;
+        llg_params->n_iterations_amortize = n_iterations_amortize;
         Log(Log_Level::Info, Log_Sender::IO, "Parameters LLG: built");
         return llg_params;
     }// end Parameters_Method_LLG_from_Config
@@ -703,6 +731,8 @@ namespace IO
         bool output_configuration_step = false,
              output_configuration_archive = false;
         int output_configuration_filetype = int(IO::VF_FileFormat::OVF_TEXT);
+        bool output_trajectory = false;
+        int output_trajectory_bits = 16;
         // Maximum walltime in seconds
         long int max_walltime = 0;
         std::string str_max_walltime;
@@ -713,10 +743,17 @@ namespace IO
         int n_iterations = (int)2E+6;
         // Number of iterations after which the system is logged to file
         int n_iterations_log = 100;
+        // Maximum number of iterations between the checks of the stop file and walltime
+        long int n_iterations_amortize = 64;
         // Temperature in K
         scalar temperature = 0.0;
         // Acceptance ratio
         scalar acceptance_ratio = 0.5;
+        // Whether to pick spins randomly or sweep over them
+        bool metropolis_random_sample = true;
+        // Metropolis or heat bath algorithm
+        std::string algorithm_str = "metropolis";
+        auto algorithm = Data::MC_Algorithm::Metropolis;
 
         //------------------------------- Parser --------------------------------
         Log(Log_Level::Info, Log_Sender::IO, "Parameters MC: building");
@@ -740,12 +777,24 @@ namespace IO
                 myfile.Read_Single(output_configuration_step,      "mc_output_configuration_step");
                 myfile.Read_Single(output_configuration_archive,   "mc_output_configuration_archive");
                 myfile.Read_Single(output_configuration_filetype,  "mc_output_configuration_filetype");
+                myfile.Read_Single(output_trajectory,              "mc_output_trajectory");
+                myfile.Read_Single(output_trajectory_bits,         "mc_output_trajectory_bits");
                 myfile.Read_Single(str_max_walltime, "mc_max_walltime");
                 myfile.Read_Single(seed, "mc_seed");
                 myfile.Read_Single(n_iterations, "mc_n_iterations");
                 myfile.Read_Single(n_iterations_log, "mc_n_iterations_log");
+                myfile.Read_Single(n_iterations_amortize, "mc_n_iterations_amortize");
                 myfile.Read_Single(temperature, "mc_temperature");
                 myfile.Read_Single(acceptance_ratio, "mc_acceptance_ratio");
+                myfile.Read_Single(metropolis_random_sample, "mc_metropolis_random_sample");
+                myfile.Read_Single(algorithm_str, "mc_algorithm");
+                if (algorithm_str == "heat_bath")
+                    algorithm = Data::MC_Algorithm::Heat_Bath;
+                else if (algorithm_str != "metropolis")
+                {
+                    Log(Log_Level::Warning, Log_Sender::IO, fmt::format("Parameters MC: Keyword 'mc_algorithm' got passed invalid algorithm \"{}\". Setting to default \"metropolis\"", algorithm_str));
+                    algorithm_str = "metropolis";
+                }
             }// end try
             catch (...)
             {
@@ -759,9 +808,12 @@ namespace IO
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<17} = {1}", "seed", seed));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<17} = {1}", "temperature", temperature));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<17} = {1}", "acceptance_ratio", acceptance_ratio));
+        Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<17} = {1}", "algorithm", algorithm_str));
+        Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<17} = {1}", "random_sample", metropolis_random_sample));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<17} = {1}", "maximum walltime", str_max_walltime));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<17} = {1}", "n_iterations", n_iterations));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<17} = {1}", "n_iterations_log", n_iterations_log));
+        Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<17} = {1}", "n_iterations_amortize", n_iterations_amortize));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<17} = {1}", "output_folder", output_folder));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<17} = {1}", "output_any", output_any));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<17} = {1}", "output_initial", output_initial));
@@ -774,9 +826,16 @@ namespace IO
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<30} = {1}", "output_configuration_step", output_configuration_step));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<30} = {1}", "output_configuration_archive", output_configuration_archive));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<30} = {1}", "output_configuration_filetype", output_configuration_filetype));
+        Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<30} = {1}", "output_trajectory", output_trajectory));
+        Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<30} = {1}", "output_trajectory_bits", output_trajectory_bits));
         max_walltime = (long int)Utility::Timing::DurationFromString(str_max_walltime).count();
         auto mc_params = std::unique_ptr<Data::Parameters_Method_MC>(new Data::Parameters_Method_MC(output_folder, output_file_tag, { output_any, output_initial, output_final, output_energy_step, output_energy_archive, output_energy_spin_resolved,
             output_energy_divide_by_nspins, output_configuration_step, output_configuration_archive, output_energy_add_readability_lines }, output_configuration_filetype, n_iterations, n_iterations_log, max_walltime, pinning, seed, temperature, acceptance_ratio));
+        mc_params->metropolis_random_sample = metropolis_random_sample;
+        mc_params->algorithm = algorithm;
+        mc_params->output_trajectory = output_trajectory;
+        mc_params->output_trajectory_bits = output_trajectory_bits;
+        mc_params->n_iterations_amortize = n_iterations_amortize;
         Log(Log_Level::Info, Log_Sender::IO, "Parameters MC: built");
         return mc_params;
     }
@@ -808,8 +867,12 @@ namespace IO
         int n_iterations = (int)2E+6;
         // Number of iterations after which the system is logged to file
         int n_iterations_log = 100;
+        // Maximum number of iterations between the checks of the stop file and walltime
+        long int n_iterations_amortize = 64;
         // Number of Energy Interpolation points
         int n_E_interpolations = 10;
+        // Number of threads per image when evaluating images concurrently (0 = one image after the other)
+        int n_threads_per_image = 0;
         //------------------------------- Parser --------------------------------
         Log(Log_Level::Info, Log_Sender::IO, "Parameters GNEB: building");
         if (configFile != "")
@@ -834,7 +897,9 @@ namespace IO
                 myfile.Read_Single(force_convergence, "gneb_force_convergence");
                 myfile.Read_Single(n_iterations, "gneb_n_iterations");
                 myfile.Read_Single(n_iterations_log, "gneb_n_iterations_log");
+                myfile.Read_Single(n_iterations_amortize, "gneb_n_iterations_amortize");
                 myfile.Read_Single(n_E_interpolations, "gneb_n_energy_interpolations");
+                myfile.Read_Single(n_threads_per_image, "gneb_threads_per_image");
             }// end try
             catch (...)
             {
@@ -847,10 +912,12 @@ namespace IO
         Log(Log_Level::Parameter, Log_Sender::IO, "Parameters GNEB:");
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<18} = {1}", "spring_constant", spring_constant));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<18} = {1}", "n_E_interpolations", n_E_interpolations));
+        Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<18} = {1}", "threads_per_image", n_threads_per_image));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<18} = {1:e}", "force convergence", force_convergence));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<18} = {1}", "maximum walltime", str_max_walltime));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<18} = {1}", "n_iterations", n_iterations));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<18} = {1}", "n_iterations_log", n_iterations_log));
+        Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<18} = {1}", "n_iterations_amortize", n_iterations_amortize));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<18} = {1}", "output_folder", output_folder));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<18} = {1}", "output_any", output_any));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<18} = {1}", "output_initial", output_initial));
@@ -863,6 +930,8 @@ namespace IO
         max_walltime = (long int)Utility::Timing::DurationFromString(str_max_walltime).count();
         auto gneb_params = std::unique_ptr<Data::Parameters_Method_GNEB>(new Data::Parameters_Method_GNEB(output_folder, output_file_tag, { output_any, output_initial, output_final, output_energies_step, output_energies_interpolated, output_energies_divide_by_nspins, output_chain_step, output_energies_add_readability_lines},
             output_chain_filetype, force_convergence, n_iterations, n_iterations_log, max_walltime, pinning, spring_constant, n_E_interpolations));
+        gneb_params->n_threads_per_image = n_threads_per_image;
+        gneb_params->n_iterations_amortize = n_iterations_amortize;
         Log(Log_Level::Info, Log_Sender::IO, "Parameters GNEB: built");
         return gneb_params;
     }// end Parameters_Method_LLG_from_Config
@@ -891,6 +960,8 @@ namespace IO
         int n_iterations = (int)2E+6;
         // Number of iterations after which the system is logged to file
         int n_iterations_log = 100;
+        // Maximum number of iterations between the checks of the stop file and walltime
+        long int n_iterations_amortize = 64;
         
         //------------------------------- Parser --------------------------------
         Log(Log_Level::Info, Log_Sender::IO, "Parameters MMF: building");
@@ -914,6 +985,7 @@ namespace IO
                 myfile.Read_Single(force_convergence, "mmf_force_convergence");
                 myfile.Read_Single(n_iterations, "mmf_n_iterations");
                 myfile.Read_Single(n_iterations_log, "mmf_n_iterations_log");
+                myfile.Read_Single(n_iterations_amortize, "mmf_n_iterations_amortize");
             }// end try
             catch (...)
             {
@@ -928,6 +1000,7 @@ namespace IO
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<17} = {1}", "maximum walltime", str_max_walltime));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<17} = {1}", "n_iterations", n_iterations));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<17} = {1}", "n_iterations_log", n_iterations_log));
+        Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<17} = {1}", "n_iterations_amortize", n_iterations_amortize));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<17} = {1}", "output_folder", output_folder));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<17} = {1}", "output_any", output_any));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<17} = {1}", "output_initial", output_initial));
@@ -940,6 +1013,7 @@ namespace IO
         max_walltime = (long int)Utility::Timing::DurationFromString(str_max_walltime).count();
         auto mmf_params = std::unique_ptr<Data::Parameters_Method_MMF>(new Data::Parameters_Method_MMF(output_folder, output_file_tag, {output_any, output_initial, output_final, output_energy_step, output_energy_archive, output_energy_divide_by_nspins, output_configuration_step,output_configuration_archive },
             force_convergence, n_iterations, n_iterations_log, max_walltime, pinning));
+        mmf_params->n_iterations_amortize = n_iterations_amortize;
         Log(Log_Level::Info, Log_Sender::IO, "Parameters MMF: built");
         return mmf_params;
     }
@@ -1035,6 +1109,8 @@ namespace IO
         int n_shells_dmi = dmi_magnitudes.size();
         int dm_chirality = 1;
         
+        std::string ddi_method_str = "cutoff";
+        auto ddi_method = Engine::DDI_Method::Cutoff;
         scalar ddi_radius = 0.0;
 
         // ------------ Quadruplet Interactions ------------
@@ -1249,6 +1325,19 @@ namespace IO
                 IO::Filter_File_Handle myfile(configFile);
 
                 //		Dipole-Dipole Pairs
+                // Dipole Dipole method (fft, cutoff or none)
+                myfile.Read_Single(ddi_method_str, "ddi_method", false);
+                if (ddi_method_str == "fft")
+                    ddi_method = Engine::DDI_Method::FFT;
+                else if (ddi_method_str == "cutoff")
+                    ddi_method = Engine::DDI_Method::Cutoff;
+                else if (ddi_method_str == "none")
+                    ddi_method = Engine::DDI_Method::None;
+                else
+                {
+                    Log(Log_Level::Warning, Log_Sender::IO, fmt::format("Hamiltonian_Heisenberg: Keyword 'ddi_method' got passed invalid method \"{}\". Setting to default \"cutoff\"", ddi_method_str));
+                    ddi_method_str = "cutoff";
+                }
                 // Dipole Dipole radius
                 myfile.Read_Single(ddi_radius, "dd_radius");
             }// end try
@@ -1303,6 +1392,7 @@ namespace IO
             Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<19} = {1}", "DM chirality", dm_chirality));
         }
 
+        Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<19} = {1}", "ddi_method", ddi_method_str));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {0:<19} = {1}", "dd_radius", ddi_radius));
 
         std::unique_ptr<Engine::Hamiltonian_Heisenberg> hamiltonian;
@@ -1315,7 +1405,7 @@ namespace IO
                 anisotropy_index, anisotropy_magnitude, anisotropy_normal,
                 exchange_magnitudes,
                 dmi_magnitudes, dm_chirality,
-                ddi_radius,
+                ddi_method, ddi_radius,
                 quadruplets, quadruplet_magnitudes,
                 geometry,
                 boundary_conditions
@@ -1329,7 +1419,7 @@ namespace IO
                 anisotropy_index, anisotropy_magnitude, anisotropy_normal,
                 exchange_pairs, exchange_magnitudes,
                 dmi_pairs, dmi_magnitudes, dmi_normals,
-                ddi_radius,
+                ddi_method, ddi_radius,
                 quadruplets, quadruplet_magnitudes,
                 geometry,
                 boundary_conditions
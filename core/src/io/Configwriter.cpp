@@ -47,6 +47,7 @@ namespace IO
         config += fmt::format("{:<22} {}\n", "log_console_level",      (int)Log.level_console);
         config += fmt::format("{:<22} {}\n", "log_input_save_initial", (int)Log.save_input_initial);
         config += fmt::format("{:<22} {}\n", "log_input_save_final",   (int)Log.save_input_final);
+        config += fmt::format("{:<22} {}\n", "log_timings",            (int)Log.messages_timings);
         config += "############# End Logging Parameters #############";
         Append_String_to_File(config, configFile);
     }// End Log_Levels_to_Config
@@ -103,11 +104,15 @@ namespace IO
         config += fmt::format("{:<35} {:d}\n", "llg_output_energy_archive",           parameters->output_energy_archive);
         config += fmt::format("{:<35} {:d}\n", "llg_output_energy_spin_resolved",     parameters->output_energy_spin_resolved);
         config += fmt::format("{:<35} {:d}\n", "llg_output_energy_divide_by_nspins",  parameters->output_energy_divide_by_nspins);
+        config += fmt::format("{:<35} {:d}\n", "llg_output_energy_spin_resolved_filetype", parameters->output_energy_spin_resolved_filetype);
         config += fmt::format("{:<35} {:d}\n", "llg_output_configuration_step",       parameters->output_configuration_step);
         config += fmt::format("{:<35} {:d}\n", "llg_output_configuration_archive",    parameters->output_configuration_archive);
+        config += fmt::format("{:<35} {:d}\n", "llg_output_trajectory",               parameters->output_trajectory);
+        config += fmt::format("{:<35} {:d}\n", "llg_output_trajectory_bits",          parameters->output_trajectory_bits);
         config += fmt::format("{:<35} {:e}\n", "llg_force_convergence",               parameters->force_convergence);
         config += fmt::format("{:<35} {}\n",   "llg_n_iterations",                    parameters->n_iterations);
         config += fmt::format("{:<35} {}\n",   "llg_n_iterations_log",                parameters->n_iterations_log);
+        config += fmt::format("{:<35} {}\n",   "llg_n_iterations_amortize",           parameters->n_iterations_amortize);
         config += fmt::format("{:<35} {}\n",   "llg_seed",                            parameters->rng_seed);
         config += fmt::format("{:<35} {}\n",   "llg_temperature",                     parameters->temperature);
         config += fmt::format("{:<35} {}\n",   "llg_damping",                         parameters->damping);
@@ -131,8 +136,11 @@ namespace IO
         config += fmt::format("{:<35} {:d}\n", "mc_output_energy_divide_by_nspins",  parameters->output_energy_divide_by_nspins);
         config += fmt::format("{:<35} {:d}\n", "mc_output_configuration_step",       parameters->output_configuration_step);
         config += fmt::format("{:<35} {:d}\n", "mc_output_configuration_archive",    parameters->output_configuration_archive);
+        config += fmt::format("{:<35} {:d}\n", "mc_output_trajectory",               parameters->output_trajectory);
+        config += fmt::format("{:<35} {:d}\n", "mc_output_trajectory_bits",          parameters->output_trajectory_bits);
         config += fmt::format("{:<35} {}\n",   "mc_n_iterations",                    parameters->n_iterations);
         config += fmt::format("{:<35} {}\n",   "mc_n_iterations_log",                parameters->n_iterations_log);
+        config += fmt::format("{:<35} {}\n",   "mc_n_iterations_amortize",           parameters->n_iterations_amortize);
         config += fmt::format("{:<35} {}\n",   "mc_seed",                            parameters->rng_seed);
         config += fmt::format("{:<35} {}\n",   "mc_temperature",                     parameters->temperature);
         config += fmt::format("{:<35} {}\n",   "mc_acceptance_ratio",                parameters->acceptance_ratio_target);
@@ -154,6 +162,7 @@ namespace IO
         config += fmt::format("{:<38} {:e}\n", "gneb_force_convergence",                parameters->force_convergence);
         config += fmt::format("{:<38} {}\n",   "gneb_n_iterations",                     parameters->n_iterations);
         config += fmt::format("{:<38} {}\n",   "gneb_n_iterations_log",                 parameters->n_iterations_log);
+        config += fmt::format("{:<38} {}\n",   "gneb_n_iterations_amortize",            parameters->n_iterations_amortize);
         config += fmt::format("{:<38} {}\n",   "gneb_spring_constant",                  parameters->spring_constant);
         config += fmt::format("{:<38} {}\n",   "gneb_n_energy_interpolations",          parameters->n_E_interpolations);
         config += "############### End GNEB Parameters ##############";
@@ -175,6 +184,7 @@ namespace IO
         config += fmt::format("{:<38} {:e}\n", "mmf_force_convergence",              parameters->force_convergence);
         config += fmt::format("{:<38} {}\n",   "mmf_n_iterations",                   parameters->n_iterations);
         config += fmt::format("{:<38} {}\n",   "mmf_n_iterations_log",               parameters->n_iterations_log);
+        config += fmt::format("{:<38} {}\n",   "mmf_n_iterations_amortize",          parameters->n_iterations_amortize);
         config += "############### End MMF Parameters ###############";
         Append_String_to_File(config, configFile);
     }// end Parameters_Method_MMF_to_Config
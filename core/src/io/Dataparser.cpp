@@ -97,6 +97,29 @@ namespace IO
         }
     }
 
+    /*
+    Reads the spin-resolved energies from an OVF file written by Write_Image_Energy_per_Spin
+    */
+    void Read_Image_Energy_per_Spin( const std::string file, const Data::Geometry& geometry,
+                                     std::vector<std::pair<std::string, scalarfield>>& energies,
+                                     const int idx_image_infile )
+    {
+        try
+        {
+            File_OVF file_ovf( file );
+
+            if ( !file_ovf.is_OVF() )
+                spirit_throw( Exception_Classifier::Bad_File_Content, Log_Level::Error,
+                              fmt::format( "File \"{}\" is not an OVF file", file ) );
+
+            file_ovf.read_segment( energies, geometry, idx_image_infile );
+        }
+        catch( ... )
+        {
+            spirit_rethrow( fmt::format( "Could not read spin-resolved energies from file \"{}\"", file ) );
+        }
+    }
+
     /*
     Read from Anisotropy file
     */
@@ -16,10 +16,6 @@
 
 #include <fmt/format.h>
 
-#ifdef CORE_USE_THREADS
-#include <thread>
-#endif
-
 namespace IO
 {
     void Write_Neighbours_Exchange( const Data::Spin_System& system, const std::string filename )
@@ -128,7 +124,7 @@ namespace IO
         if (readability_toggle) header = separator + line + separator;
         else header = line;
         if (!readability_toggle) std::replace( header.begin(), header.end(), '|', ' ');
-        String_to_File(header, filename);
+        Dump_to_File(header, filename);
     }
 
     void Append_Image_Energy( const Data::Spin_System & s, const int iteration, 
@@ -150,7 +146,7 @@ namespace IO
         line += "\n";
 
         if (!readability_toggle) std::replace( line.begin(), line.end(), '|', ' ');
-        Append_String_to_File(line, filename);
+        Dump_Append_to_File(line, filename);
     }
 
     void Write_Image_Energy( const Data::Spin_System & system, const std::string filename, 
@@ -170,11 +166,12 @@ namespace IO
         line += "\n";
 
         if (!readability_toggle) std::replace( line.begin(), line.end(), '|', ' ');
-        Append_String_to_File(line, filename);
+        Dump_Append_to_File(line, filename);
     }
 
     void Write_Image_Energy_per_Spin( const Data::Spin_System & s, const std::string filename, 
-                                      bool normalize_by_nos, bool readability_toggle )
+                                      bool normalize_by_nos, bool readability_toggle,
+                                      VF_FileFormat format )
     {
         scalar nd = 1.0; // nos divide
         if (normalize_by_nos) nd = 1.0 / s.nos;
@@ -182,12 +179,34 @@ namespace IO
 
         // s.UpdateEnergy();
 
-        Write_Energy_Header(s, filename, {"ispin", "E_tot"});
-        
         std::vector<std::pair<std::string, scalarfield>> contributions_spins(0);
         s.hamiltonian->Energy_Contributions_per_Spin(*s.spins, contributions_spins);
 
-        std::string data = "";
+        if ( format == VF_FileFormat::OVF_BIN8 || format == VF_FileFormat::OVF_BIN4 ||
+             format == VF_FileFormat::OVF_TEXT || format == VF_FileFormat::OVF_CSV )
+        {
+            // The total energy is the first value of each spin, followed by the contributions
+            std::vector<std::pair<std::string, scalarfield>> fields(1, {"E_tot", scalarfield(s.nos, 0)});
+            fields.reserve(contributions_spins.size() + 1);
+            for (auto& contribution : contributions_spins)
+            {
+                for (int ispin=0; ispin<s.nos; ++ispin)
+                {
+                    contribution.second[ispin] *= nd;
+                    fields[0].second[ispin] += contribution.second[ispin];
+                }
+                fields.push_back({contribution.first, std::move(contribution.second)});
+            }
+
+            File_OVF file_ovf( filename, format );
+            file_ovf.write_segment( fields, *s.geometry, "Energy per spin" );
+            return;
+        }
+
+        Write_Energy_Header(s, filename, {"ispin", "E_tot"});
+
+        // The lines are formatted into a buffer which is appended to the file chunk by chunk
+        fmt::MemoryWriter data;
         for (int ispin=0; ispin<s.nos; ++ispin)
         {
             scalar E_spin=0;
@@ -195,16 +214,21 @@ namespace IO
             // BUG: if the energy is not updated at least one this will raise a SIGSEGV
             
             for (auto& contribution : contributions_spins) E_spin += contribution.second[ispin];
-            data += fmt::format(" {:^20} || {:^20.10f} |", ispin, E_spin * nd);
-            for (auto pair : contributions_spins)
+            data.write(" {:^20} || {:^20.10f} |", ispin, E_spin * nd);
+            for (auto& contribution : contributions_spins)
             {
-                data += fmt::format("| {:^20.10f} ", pair.second[ispin] * nd);
+                data.write("| {:^20.10f} ", contribution.second[ispin] * nd);
             }
-            data += "\n";
-        }
+            data << '\n';
 
-        if (!readability_toggle) std::replace( data.begin(), data.end(), '|', ' ');
-        Append_String_to_File(data, filename);
+            if ((ispin+1) % 4096 == 0 || ispin+1 == s.nos)
+            {
+                std::string chunk = data.str();
+                data.clear();
+                if (!readability_toggle) std::replace( chunk.begin(), chunk.end(), '|', ' ');
+                Dump_Append_to_File(std::move(chunk), filename);
+            }
+        }
     }
 
     void Write_System_Force(const Data::Spin_System & s, const std::string filename)
@@ -234,7 +258,7 @@ namespace IO
             line += "\n";
 
             if (!readability_toggle) std::replace( line.begin(), line.end(), '|', ' ');
-            Append_String_to_File(line, filename);
+            Dump_Append_to_File(line, filename);
         }
     }
 
@@ -274,7 +298,7 @@ namespace IO
                 line += "\n";
 
                 if (!readability_toggle) std::replace( line.begin(), line.end(), '|', ' ');
-                Append_String_to_File(line, filename);
+                Dump_Append_to_File(line, filename);
 
                 // Exit the loop if we reached the end
                 if (isystem == c.noi-1) break;
@@ -1,4 +1,5 @@
 ﻿#include <io/Filter_File_Handle.hpp>
+#include <io/IO.hpp>
 #include <engine/Vectormath.hpp>
 #include <utility/Exception.hpp>
 
@@ -23,6 +24,8 @@ namespace IO
         this->dump = "";
         this->line = "";
         this->found = std::string::npos;
+        // Make sure that queued output to the file has been written
+        Flush_Output( filename );
         this->myfile = std::unique_ptr<std::ifstream>( new std::ifstream( filename,
                                                         std::ios::in | std::ios::binary ) );
         
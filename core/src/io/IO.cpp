@@ -12,40 +12,256 @@
 #include <iomanip>
 #include <cctype>
 
+#include <chrono>
+#include <map>
+
+#ifdef SPIRIT_USE_THREADS
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#endif
+
 #include <io/IO.hpp>
 #include <utility/Logging.hpp>
+#include <utility/Timing.hpp>
+#include <utility/Exception.hpp>
 
 using Utility::Log_Level;
 using Utility::Log_Sender;
 
 namespace IO
 {
-    // ------ Saving Helpers --------------------------------------------
+    // ------ Asynchronous output ---------------------------------------
 
-    /*
-        Dump_to_File detaches a thread which writes the given string to a file.
-        This is asynchronous (i.e. fire & forget)
-    */
-    void Dump_to_File(const std::string text, const std::string name)
+    namespace
     {
-        
-        #ifdef CORE_USE_THREADS
-        // thread:      method       args  args    args   detatch thread
-        std::thread(String_to_File, text, name).detach();
-        #else
-        String_to_File(text, name);
+        // Time the current thread has been blocked on output
+        thread_local double output_blocked_time = 0;
+
+        // Wall time and number of writes, and of waits for the output queue (see Simulation_Get_Timings)
+        Utility::Timing::Counter timing_write("IO/Write");
+        Utility::Timing::Counter timing_output_blocked("IO/Output_Blocked");
+
+        // Write or append a string to a file
+        void Write_String(const std::string & text, const std::string & name, bool append)
+        {
+            std::ofstream myfile;
+            if (append)
+                myfile.open(name, std::ofstream::out | std::ofstream::app);
+            else
+                myfile.open(name);
+            if (myfile.is_open())
+            {
+                Log(Log_Level::Debug, Log_Sender::All, "Started writing " + name);
+                myfile << text;
+                myfile.close();
+                Log(Log_Level::Debug, Log_Sender::All, "Finished writing " + name);
+            }
+            else if (append)
+            {
+                Log(Log_Level::Error, Log_Sender::All, "Could not open " + name + " to append to file");
+            }
+            else
+            {
+                Log(Log_Level::Error, Log_Sender::All, "Could not open " + name + " to write to file");
+            }
+        }
+
+        // Carry out a write, so that a failing write does not take down the caller or the writer thread
+        void Write_Output(const std::function<void()> & write)
+        {
+            Utility::Timing::Scope timing(timing_write);
+            try
+            {
+                write();
+            }
+            catch( ... )
+            {
+                spirit_handle_exception_core("Asynchronous output failed");
+            }
+        }
+
+        #ifdef SPIRIT_USE_THREADS
+        // Single background thread, which carries out the queued writes one after the other
+        class Output_Writer
+        {
+        public:
+            // Limits of the queue
+            static const std::size_t max_writes = 256;
+            static const std::size_t max_bytes  = std::size_t(512) << 20;
+
+            Output_Writer() : queued_bytes(0), stop(false)
+            {
+                this->thread = std::thread(&Output_Writer::Run, this);
+            }
+
+            // All queued writes are carried out before the thread is stopped
+            ~Output_Writer()
+            {
+                {
+                    std::lock_guard<std::mutex> guard(this->mutex);
+                    this->stop = true;
+                }
+                this->cv_queued.notify_one();
+                this->thread.join();
+            }
+
+            void Push(const std::string & name, std::size_t size, std::function<void()> write)
+            {
+                std::unique_lock<std::mutex> lock(this->mutex);
+                // A single write which is larger than the limit is accepted if the queue is empty
+                auto full = [this, size]() { return !this->queue.empty() &&
+                    ( this->queue.size() >= max_writes || this->queued_bytes + size > max_bytes ); };
+                if ( full() )
+                {
+                    auto t_start = std::chrono::steady_clock::now();
+                    this->cv_written.wait(lock, [&full]() { return !full(); });
+                    auto dt = std::chrono::steady_clock::now() - t_start;
+                    output_blocked_time += std::chrono::duration<double>(dt).count();
+                    timing_output_blocked.Add(dt);
+                }
+                this->queue.push_back( Queued_Write{ name, size, std::move(write) } );
+                this->queued_bytes += size;
+                ++this->n_pending[name];
+                lock.unlock();
+                this->cv_queued.notify_one();
+            }
+
+            void Flush(const std::string & name)
+            {
+                std::unique_lock<std::mutex> lock(this->mutex);
+                auto done = [this, &name]()
+                {
+                    if ( name.empty() ) return this->n_pending.empty();
+                    return this->n_pending.find(name) == this->n_pending.end();
+                };
+                if ( !done() )
+                {
+                    auto t_start = std::chrono::steady_clock::now();
+                    this->cv_written.wait(lock, done);
+                    auto dt = std::chrono::steady_clock::now() - t_start;
+                    output_blocked_time += std::chrono::duration<double>(dt).count();
+                    timing_output_blocked.Add(dt);
+                }
+            }
+
+            bool Pending(const std::string & name)
+            {
+                std::lock_guard<std::mutex> guard(this->mutex);
+                return this->n_pending.find(name) != this->n_pending.end();
+            }
+
+        private:
+            struct Queued_Write
+            {
+                std::string name;
+                std::size_t size;
+                std::function<void()> write;
+            };
+
+            void Run()
+            {
+                std::unique_lock<std::mutex> lock(this->mutex);
+                while ( true )
+                {
+                    this->cv_queued.wait(lock, [this]() { return this->stop || !this->queue.empty(); });
+                    if ( this->queue.empty() )
+                        return;
+
+                    Queued_Write next = std::move(this->queue.front());
+                    this->queue.pop_front();
+
+                    lock.unlock();
+                    Write_Output(next.write);
+                    next.write = nullptr;
+                    lock.lock();
+
+                    // The file only counts as written once the write has been carried out
+                    this->queued_bytes -= next.size;
+                    if ( --this->n_pending[next.name] == 0 )
+                        this->n_pending.erase(next.name);
+                    this->cv_written.notify_all();
+                }
+            }
+
+            std::deque<Queued_Write> queue;
+            std::size_t queued_bytes;
+            // Number of queued or running writes per file
+            std::map<std::string, int> n_pending;
+            bool stop;
+            std::mutex mutex;
+            std::condition_variable cv_queued, cv_written;
+            std::thread thread;
+        };
+
+        Output_Writer & Get_Output_Writer()
+        {
+            static Output_Writer writer;
+            return writer;
+        }
         #endif
     }
 
-    void Dump_to_File(const std::vector<std::string> text, const std::string name, const int no)
+    void Queue_Output(const std::string & name, std::size_t size, std::function<void()> write)
     {
-        #ifdef CORE_USE_THREADS
-        std::thread(Strings_to_File, text, name, no).detach();
+        #ifdef SPIRIT_USE_THREADS
+        Get_Output_Writer().Push(name, size, std::move(write));
         #else
-        Strings_to_File(text, name, no);
+        Write_Output(write);
+        #endif
+    }
+
+    void Flush_Output(const std::string & name)
+    {
+        #ifdef SPIRIT_USE_THREADS
+        Get_Output_Writer().Flush(name);
         #endif
     }
 
+    bool Output_File_Exists(const std::string & name)
+    {
+        #ifdef SPIRIT_USE_THREADS
+        if ( Get_Output_Writer().Pending(name) )
+            return true;
+        #endif
+        std::ifstream f(name);
+        return f.good();
+    }
+
+    double Get_Output_Blocked_Time()
+    {
+        return output_blocked_time;
+    }
+
+    // ------ Saving Helpers --------------------------------------------
+
+    /*
+        The Dump functions take over the text, so that it does not need to be copied for
+        the writer thread.
+    */
+    void Dump_to_File(std::string text, const std::string name)
+    {
+        std::size_t size = text.size();
+        auto buffer = std::make_shared<std::string>(std::move(text));
+        Queue_Output(name, size, [buffer, name]() { Write_String(*buffer, name, false); });
+    }
+
+    void Dump_to_File(std::vector<std::string> text, const std::string name, const int no)
+    {
+        std::size_t size = 0;
+        for (int i = 0; i < no; ++i) size += text[i].size();
+        auto buffer = std::make_shared<std::vector<std::string>>(std::move(text));
+        Queue_Output(name, size, [buffer, name, no]() { Strings_to_File(*buffer, name, no); });
+    }
+
+    void Dump_Append_to_File(std::string text, const std::string name)
+    {
+        std::size_t size = text.size();
+        auto buffer = std::make_shared<std::string>(std::move(text));
+        Queue_Output(name, size, [buffer, name]() { Write_String(*buffer, name, true); });
+    }
+
     /*
         String_to_File is a simple string streamer
         Writing a vector of strings to file
@@ -72,26 +288,12 @@ namespace IO
 
     void Append_String_to_File(const std::string text, const std::string name)
     {
-        std::ofstream myfile;
-        myfile.open(name, std::ofstream::out | std::ofstream::app);
-        if (myfile.is_open())
-        {
-            Log(Log_Level::Debug, Log_Sender::All, "Started writing " + name);
-            myfile << text;
-            myfile.close();
-            Log(Log_Level::Debug, Log_Sender::All, "Finished writing " + name);
-        }
-        else
-        {
-            Log(Log_Level::Error, Log_Sender::All, "Could not open " + name + " to append to file");
-        }
+        Write_String(text, name, true);
     }
 
     void String_to_File(const std::string text, const std::string name)
     {
-        std::vector<std::string> v(1);
-        v[0] = text;
-        Strings_to_File(v, name, 1);
+        Write_String(text, name, false);
     }
 
     // ------------------------------------------------------------------
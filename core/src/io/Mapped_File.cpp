@@ -0,0 +1,113 @@
+#include <io/Mapped_File.hpp>
+#include <utility/Exception.hpp>
+
+#ifdef _WIN32
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+#include <fmt/format.h>
+
+using namespace Utility;
+
+namespace IO
+{
+    #ifdef _WIN32
+
+    Mapped_File::Mapped_File( const std::string& filename ) :
+        filename(filename), begin(nullptr), length(0), file_handle(nullptr), mapping_handle(nullptr)
+    {
+        HANDLE file = CreateFileA( filename.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                                   NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+        if ( file == INVALID_HANDLE_VALUE )
+            spirit_throw( Exception_Classifier::File_not_Found, Log_Level::Error,
+                          fmt::format( "Could not open file \"{}\"", filename ) );
+        this->file_handle = file;
+
+        LARGE_INTEGER file_size;
+        GetFileSizeEx( file, &file_size );
+        this->length = static_cast<std::size_t>( file_size.QuadPart );
+        if ( this->length == 0 )
+            return;
+
+        HANDLE mapping = CreateFileMappingA( file, NULL, PAGE_READONLY, 0, 0, NULL );
+        if ( mapping != NULL )
+        {
+            this->mapping_handle = mapping;
+            this->begin = static_cast<const char *>( MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 ) );
+        }
+        if ( this->begin == nullptr )
+        {
+            if ( this->mapping_handle ) CloseHandle( this->mapping_handle );
+            CloseHandle( this->file_handle );
+            spirit_throw( Exception_Classifier::File_not_Found, Log_Level::Error,
+                          fmt::format( "Could not map file \"{}\" into memory", filename ) );
+        }
+    }
+
+    Mapped_File::~Mapped_File()
+    {
+        if ( this->begin )          UnmapViewOfFile( this->begin );
+        if ( this->mapping_handle ) CloseHandle( this->mapping_handle );
+        if ( this->file_handle )    CloseHandle( this->file_handle );
+    }
+
+    #else
+
+    Mapped_File::Mapped_File( const std::string& filename ) :
+        filename(filename), begin(nullptr), length(0)
+    {
+        int fd = open( filename.c_str(), O_RDONLY );
+        if ( fd < 0 )
+            spirit_throw( Exception_Classifier::File_not_Found, Log_Level::Error,
+                          fmt::format( "Could not open file \"{}\"", filename ) );
+
+        struct stat file_stat;
+        if ( fstat( fd, &file_stat ) != 0 )
+        {
+            close( fd );
+            spirit_throw( Exception_Classifier::File_not_Found, Log_Level::Error,
+                          fmt::format( "Could not determine the size of file \"{}\"", filename ) );
+        }
+        this->length = static_cast<std::size_t>( file_stat.st_size );
+
+        // An empty file cannot be mapped
+        if ( this->length > 0 )
+        {
+            void * mapping = mmap( nullptr, this->length, PROT_READ, MAP_PRIVATE, fd, 0 );
+            if ( mapping == MAP_FAILED )
+            {
+                close( fd );
+                spirit_throw( Exception_Classifier::File_not_Found, Log_Level::Error,
+                              fmt::format( "Could not map file \"{}\" into memory", filename ) );
+            }
+            this->begin = static_cast<const char *>( mapping );
+        }
+
+        // The mapping stays valid after the file descriptor is closed
+        close( fd );
+    }
+
+    Mapped_File::~Mapped_File()
+    {
+        if ( this->begin )
+            munmap( const_cast<char *>( this->begin ), this->length );
+    }
+
+    #endif
+
+    const char * Mapped_File::data() const
+    {
+        return this->begin;
+    }
+
+    std::size_t Mapped_File::size() const
+    {
+        return this->length;
+    }
+}
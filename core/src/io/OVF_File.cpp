@@ -1,20 +1,58 @@
 #include <io/OVF_File.hpp>
 
 #include <utility/Logging.hpp>
+#include <utility/Timing.hpp>
 #include <utility/Exception.hpp>
 
 #include <engine/Vectormath.hpp>
 
+#include <algorithm>
+#include <memory>
+#include <type_traits>
+#include <cstring>
+#include <cctype>
+#include <sstream>
+
 using namespace Utility;
 
 namespace IO
 {
+    namespace
+    {
+        // Wall time and number of segments read and written (see Simulation_Get_Timings).
+        //      With SPIRIT_USE_THREADS, the writes only include the copy of the data,
+        //      while the actual writing is included in IO/Write
+        Timing::Counter timing_read_segment("IO/OVF/Read_Segment");
+        Timing::Counter timing_write_segment("IO/OVF/Write_Segment");
+
+        // Check if a line starts with keyword (which has to be lower case), ignoring capitalization
+        // and leading whitespace. If so, the rest of the line is put into rest
+        bool Line_Starts_With( const char * line, std::size_t length, const std::string& keyword,
+                               std::string& rest )
+        {
+            std::size_t i = 0;
+            while ( i < length && ( line[i] == ' ' || line[i] == '\t' ) ) ++i;
+            if ( length - i < keyword.size() )
+                return false;
+            for ( std::size_t j = 0; j < keyword.size(); ++j )
+            {
+                if ( std::tolower( static_cast<unsigned char>( line[i+j] ) ) != keyword[j] )
+                    return false;
+            }
+            rest.assign( line + i + keyword.size(), line + length );
+            return true;
+        }
+    }
+
+    const uint32_t File_OVF::test_hex_4b;
+    const uint64_t File_OVF::test_hex_8b;
+    const std::size_t File_OVF::n_spins_chunk;
+
     File_OVF::File_OVF( std::string filename, VF_FileFormat format ) : 
         filename(filename), format(format)
     {
         this->isOVF = false;
         this->output_to_file = "";
-        this->output_to_file.reserve( int( 0x08000000 ) );  // reserve 128[MByte]
         this->sender = Log_Sender::IO;
         this->n_segments = -1;
 
@@ -37,6 +75,7 @@ namespace IO
         this->meshunit = "";
         this->meshtype = "";
         this->valueunits = "";
+        this->valuelabels = "";
         this->datatype_in = "";
         this->max = Vector3(0,0,0);
         this->min = Vector3(0,0,0);
@@ -45,8 +84,22 @@ namespace IO
         this->stepsize = Vector3(0,0,0);
         this->sender = Log_Sender::IO;
 
+        // The file is only inspected once it is read or appended to
+        this->file_exists = false;
+        this->file_inspected = false;
+    }
+
+    void File_OVF::inspect_file()
+    {
+        if ( this->file_inspected )
+            return;
+        this->file_inspected = true;
+
+        // Writes to the file which are still queued have to be carried out before it is read
+        Flush_Output( this->filename );
+
         // check if the file exists
-        std::fstream file( filename );
+        std::fstream file( this->filename );
         this->file_exists = file.is_open();
         file.close();
                 
@@ -103,7 +156,7 @@ namespace IO
             ifile->Read_Single( this->meshunit, "# meshunit:" );
             ifile->Require_Single( this->valuedim, "# valuedim:" );
             ifile->Read_String( this->valueunits, "# valueunits:" );
-            ifile->Read_String( this->valueunits, "# valuelabels:" );
+            ifile->Read_String( this->valuelabels, "# valuelabels:" );
             
             ifile->Read_Single( this->min.x(), "# xmin:" );
             ifile->Read_Single( this->min.y(), "# ymin:" );
@@ -203,7 +256,7 @@ namespace IO
         }
     }
         
-    void File_OVF::read_data( vectorfield& vf, Data::Geometry& geometry )
+    void File_OVF::read_data_representation()
     {
         try
         {
@@ -237,10 +290,22 @@ namespace IO
                 spirit_throw( Exception_Classifier::Bad_File_Content, Log_Level::Error,
                               "Binary representation can be either \"binary 8\" or \"binary 4\"");
             }
-            
+        }
+        catch (...) 
+        {
+            spirit_rethrow( fmt::format("Failed to read OVF file \"{}\".", filename) );
+        }
+    }
+
+    void File_OVF::read_data( vectorfield& vf, Data::Geometry& geometry, const int idx_seg )
+    {
+        try
+        {
+            read_data_representation();
+
             // Read the data
             if( this->datatype_in == "binary" )
-                read_data_bin( vf, geometry );
+                read_data_bin( vf, geometry, idx_seg );
             else if( this->datatype_in == "text" )
                 read_data_txt( vf, geometry );
             else if( this->datatype_in == "csv" )
@@ -253,7 +318,7 @@ namespace IO
     }
    
 
-    bool File_OVF::check_binary_values()
+    bool File_OVF::check_binary_values( const char * data )
     {
         try
         {
@@ -267,7 +332,7 @@ namespace IO
             // check the validity of the initial check value read with the reference one
             if ( this->binary_length == 4 )
             {    
-                ifile->myfile->read( reinterpret_cast<char *>( &read_4byte ), sizeof(float) );
+                std::memcpy( &read_4byte, data, sizeof(float) );
                 if ( read_4byte != ref_4b ) 
                 {
                     spirit_throw( Exception_Classifier::Bad_File_Content, Log_Level::Error,
@@ -276,7 +341,7 @@ namespace IO
             }
             else if ( this->binary_length == 8 )
             {
-                ifile->myfile->read( reinterpret_cast<char *>( &read_8byte ), sizeof(double) );
+                std::memcpy( &read_8byte, data, sizeof(double) );
                 if ( read_8byte != ref_8b )
                 {
                     spirit_throw( Exception_Classifier::Bad_File_Content, Log_Level::Error,
@@ -295,87 +360,98 @@ namespace IO
     
     }
 
-    void File_OVF::read_data_bin( vectorfield& vf, Data::Geometry& geometry )
+    template <typename T> void File_OVF::read_data_bin_as( const char * data, vectorfield& vf,
+                                                           const int nos )
+    {
+        static_assert( sizeof(Vector3) == 3*sizeof(scalar), "Vector3 has to be densely packed" );
+
+        // If the precision matches, the whole block is copied at once
+        if ( std::is_same<T, scalar>::value )
+        {
+            std::memcpy( vf.data(), data, 3*sizeof(scalar)*nos );
+            return;
+        }
+
+        // Otherwise it is converted chunk by chunk
+        std::vector<T> buffer( 3*std::min( std::size_t(nos), n_spins_chunk ) );
+        for ( std::size_t start = 0; start < std::size_t(nos); start += n_spins_chunk )
+        {
+            std::size_t end = std::min( std::size_t(nos), start + n_spins_chunk );
+            std::memcpy( buffer.data(), data + 3*sizeof(T)*start, 3*sizeof(T)*(end-start) );
+            for ( std::size_t i = start; i < end; ++i )
+            {
+                vf[i][0] = static_cast<scalar>( buffer[3*(i-start)] );
+                vf[i][1] = static_cast<scalar>( buffer[3*(i-start)+1] );
+                vf[i][2] = static_cast<scalar>( buffer[3*(i-start)+2] );
+            }
+        }
+    }
+
+    const char * File_OVF::locate_data_bin( const int idx_seg, const std::size_t n_values )
     {
         try
         {        
-            // Set the input stream indicator to the end of the line describing the data block
-            ifile->iss.seekg( std::ios::end );
-            
+            if ( !this->mapped )
+                this->mapped = std::unique_ptr<Mapped_File>( new Mapped_File( this->filename ) );
+
+            // The binary data block starts after the line describing it
+            std::size_t data_line = this->segment_data_fpos[idx_seg];
+            const char * newline = nullptr;
+            if ( data_line < this->mapped->size() )
+                newline = static_cast<const char *>( std::memchr( this->mapped->data() + data_line, 
+                                                        '\n', this->mapped->size() - data_line ) );
+            if ( newline == nullptr )
+                spirit_throw( Exception_Classifier::Bad_File_Content, Log_Level::Error,
+                              "The OVF binary data block could not be located" );
+            std::size_t offset = newline + 1 - this->mapped->data();
+
+            std::size_t block_size = this->binary_length * ( 1 + n_values );
+            if ( offset + block_size > this->mapped->size() )
+                spirit_throw( Exception_Classifier::Bad_File_Content, Log_Level::Error,
+                              "The OVF binary data block is truncated" );
+
+            const char * data = this->mapped->data() + offset;
+
             // Check if the initial check value of the binary data is valid
-            if( !check_binary_values() )
+            if( !check_binary_values( data ) )
                 spirit_throw( Exception_Classifier::Bad_File_Content, Log_Level::Error,
                               "The OVF initial binary value could not be read correctly");
+            return data + this->binary_length;
+        }
+        catch (...)
+        {
+            spirit_rethrow( "Failed to locate OVF binary data" );
+            return nullptr;
+        }
+    }
+
+    void File_OVF::read_data_bin( vectorfield& vf, Data::Geometry& geometry, const int idx_seg )
+    {
+        try
+        {        
+            int nos = this->nodes[0] * this->nodes[1] * this->nodes[2];
+            const char * data = locate_data_bin( idx_seg, 3*std::size_t(nos) );
             
             // Comparison of datum size compared to scalar type
             if ( this->binary_length == 4 )
+                read_data_bin_as<float>( data, vf, nos );
+            else if ( this->binary_length == 8 )
+                read_data_bin_as<double>( data, vf, nos );
+
+            for ( int index = 0; index < nos; ++index )
             {
-                int vectorsize = 3 * sizeof(float);
-                float buffer[3];
-                int index;
-                for( int k=0; k<this->nodes[2]; k++ )
-                {
-                    for( int j=0; j<this->nodes[1]; j++ )
-                    {
-                        for( int i=0; i<this->nodes[0]; i++ )
-                        {
-                            index = i + j*this->nodes[0] + k*this->nodes[0]*this->nodes[1];
-                            
-                            ifile->myfile->read(reinterpret_cast<char *>(&buffer[0]), vectorsize);
-                            
-                            vf[index][0] = static_cast<scalar>(buffer[0]);
-                            vf[index][1] = static_cast<scalar>(buffer[1]);
-                            vf[index][2] = static_cast<scalar>(buffer[2]);
-                            
-                            if (vf[index].norm() < 1e-5)
-                            {
-                                vf[index] = {0, 0, 1};
-                                // in case of spin vector close to zero we have a vacancy
-                            #ifdef SPIRIT_ENABLE_DEFECTS
-                                geometry.atom_types[index] = -1;
-                            #endif
-                            }
-                        }
-                    }
-                }
-                
-                // normalize read in spins 
-                Engine::Vectormath::normalize_vectors( vf );
-            }
-            else if (this->binary_length == 8)
-            {
-                int vectorsize = 3 * sizeof(double);
-                double buffer[3];
-                int index;
-                for (int k = 0; k<this->nodes[2]; k++)
+                if (vf[index].norm() < 1e-5)
                 {
-                    for (int j = 0; j<this->nodes[1]; j++)
-                    {
-                        for (int i = 0; i<this->nodes[0]; i++)
-                        {
-                            index = i + j*this->nodes[0] + k*this->nodes[0] * this->nodes[1];
-                            
-                            ifile->myfile->read(reinterpret_cast<char *>(&buffer[0]), vectorsize);
-                            
-                            vf[index][0] = static_cast<scalar>(buffer[0]);
-                            vf[index][1] = static_cast<scalar>(buffer[1]);
-                            vf[index][2] = static_cast<scalar>(buffer[2]);
-                            
-                            if (vf[index].norm() < 1e-5)
-                            {
-                                vf[index] = {0, 0, 1};
-                                // in case of spin vector close to zero we have a vacancy
-                            #ifdef SPIRIT_ENABLE_DEFECTS
-                                geometry.atom_types[index] = -1;
-                            #endif
-                            }
-                        }
-                    }
+                    vf[index] = {0, 0, 1};
+                    // in case of spin vector close to zero we have a vacancy
+                #ifdef SPIRIT_ENABLE_DEFECTS
+                    geometry.atom_types[index] = -1;
+                #endif
                 }
-                
-                // normalize read in spins 
-                Engine::Vectormath::normalize_vectors( vf );
             }
+            
+            // normalize read in spins 
+            Engine::Vectormath::normalize_vectors( vf );
         }
         catch (...)
         {
@@ -417,6 +493,91 @@ namespace IO
         }
     }
 
+    void File_OVF::read_data( std::vector<std::pair<std::string, scalarfield>>& fields, 
+                              const int idx_seg )
+    {
+        try
+        {
+            read_data_representation();
+
+            std::size_t n_nodes = std::size_t(this->nodes[0]) * this->nodes[1] * this->nodes[2];
+
+            // The value labels are taken from the segment header in the file, as the file handle
+            // does not preserve their capitalization
+            if ( !this->mapped )
+                this->mapped = std::unique_ptr<Mapped_File>( new Mapped_File( this->filename ) );
+            std::size_t pos = this->segment_fpos[idx_seg];
+            std::size_t header_end = std::min( std::size_t( this->segment_data_fpos[idx_seg] ),
+                                               this->mapped->size() );
+            while ( pos < header_end )
+            {
+                const char * line = this->mapped->data() + pos;
+                const char * newline = static_cast<const char *>( std::memchr( line, '\n', header_end - pos ) );
+                std::size_t length = newline ? newline - line : header_end - pos;
+                if ( Line_Starts_With( line, length, "# valuelabels:", this->valuelabels ) )
+                    break;
+                pos += length + 1;
+            }
+
+            // The fields are named by the value labels, if there is one for each of them
+            std::vector<std::string> labels;
+            std::istringstream label_stream( this->valuelabels );
+            std::string label;
+            while ( label_stream >> label )
+                labels.push_back( label );
+            if ( labels.size() != std::size_t(this->valuedim) )
+            {
+                labels.clear();
+                for ( int i = 0; i < this->valuedim; ++i )
+                    labels.push_back( fmt::format( "value_{}", i ) );
+            }
+
+            fields.resize( this->valuedim );
+            for ( int i = 0; i < this->valuedim; ++i )
+                fields[i] = { labels[i], scalarfield( n_nodes, 0 ) };
+
+            if ( this->datatype_in == "binary" )
+            {
+                const char * data = locate_data_bin( idx_seg, this->valuedim*n_nodes );
+                if ( this->binary_length == 4 )
+                    read_fields_bin_as<float>( data, fields, n_nodes );
+                else if ( this->binary_length == 8 )
+                    read_fields_bin_as<double>( data, fields, n_nodes );
+            }
+            else
+            {
+                std::string delimiter = this->datatype_in == "csv" ? "," : "";
+                for ( std::size_t i = 0; i < n_nodes; ++i )
+                {
+                    this->ifile->GetLine( delimiter );
+                    for ( auto& field : fields )
+                        this->ifile->iss >> field.second[i];
+                }
+            }
+        }
+        catch (...) 
+        {
+            spirit_rethrow( fmt::format("Failed to read OVF file \"{}\".", filename) );
+        }
+    }
+
+    template <typename T> void File_OVF::read_fields_bin_as( const char * data,
+                    std::vector<std::pair<std::string, scalarfield>>& fields, const std::size_t n_nodes )
+    {
+        std::size_t valuedim = fields.size();
+        std::vector<T> buffer( valuedim*std::min( n_nodes, n_spins_chunk ) );
+        for ( std::size_t start = 0; start < n_nodes; start += n_spins_chunk )
+        {
+            std::size_t end = std::min( n_nodes, start + n_spins_chunk );
+            std::memcpy( buffer.data(), data + valuedim*sizeof(T)*start, valuedim*sizeof(T)*(end-start) );
+            for ( std::size_t i = start; i < end; ++i )
+            {
+                for ( std::size_t j = 0; j < valuedim; ++j )
+                    fields[j].second[i] = static_cast<scalar>( buffer[valuedim*(i-start)+j] );
+            }
+        }
+    }
+
     void File_OVF::write_top_header()
     {
         this->output_to_file += fmt::format( "# OOMMF OVF 2.0\n" );
@@ -432,117 +593,135 @@ namespace IO
         std::string padding( padding_length, '0' );
         // write padding plus n_segments
         this->output_to_file += fmt::format( "# Segment count: {}\n", padding + n_segments_str );
-        
-        Dump_to_File( this->output_to_file, this->filename );  // Dump to file
-        this->output_to_file = "";  // reset output string buffer
+
+        // the position after the segment count line, which is needed to increment n_segments
+        this->n_segments_pos = this->output_to_file.size();
     }
 
-    void File_OVF::write_data_bin( const vectorfield& vf )
+    void File_OVF::write_data_bin( std::ostream& stream, const vectorfield& vf,
+                                   const VF_FileFormat format )
     {
-        // float test value
-        const float ref_4b = *reinterpret_cast<const float *>( &this->test_hex_4b );
-        
-        // double test value
-        const double ref_8b = *reinterpret_cast<const double *>( &this->test_hex_8b );
-        
         if( format == VF_FileFormat::OVF_BIN8 )
         {
-            this->output_to_file += std::string( reinterpret_cast<const char *>(&ref_8b),
-                sizeof(double) );
-            
-            // in case that scalar is 4bytes long
-            if (sizeof(scalar) == sizeof(float))
-            {
-                double buffer[3];
-                for (unsigned int i=0; i<vf.size(); i++)
-                {
-                    buffer[0] = static_cast<double>(vf[i][0]);
-                    buffer[1] = static_cast<double>(vf[i][1]);
-                    buffer[2] = static_cast<double>(vf[i][2]);
-                    this->output_to_file += std::string( reinterpret_cast<char *>(buffer), 
-                        sizeof(buffer) );
-                }
-            } 
-            else
-            {
-                for (unsigned int i=0; i<vf.size(); i++)
-                    this->output_to_file += 
-                        std::string( reinterpret_cast<const char *>(&vf[i]), 3*sizeof(double) );
-            }
+            // double test value
+            const double ref_8b = *reinterpret_cast<const double *>( &test_hex_8b );
+            stream.write( reinterpret_cast<const char *>(&ref_8b), sizeof(double) );
+            write_data_bin_as<double>( stream, vf );
         }
         else if( format == VF_FileFormat::OVF_BIN4 )
         {
-            this->output_to_file += std::string( reinterpret_cast<const char *>(&ref_4b),
-                sizeof(float) );
-            
-            // in case that scalar is 8bytes long
-            if (sizeof(scalar) == sizeof(double))
-            {
-                float buffer[3];
-                for (unsigned int i=0; i<vf.size(); i++)
-                {
-                    buffer[0] = static_cast<float>(vf[i][0]);
-                    buffer[1] = static_cast<float>(vf[i][1]);
-                    buffer[2] = static_cast<float>(vf[i][2]);
-                    this->output_to_file += std::string( reinterpret_cast<char *>(buffer), 
-                        sizeof(buffer) );
-                }
-            } 
-            else
-            {
-                for (unsigned int i=0; i<vf.size(); i++)
-                    this->output_to_file += 
-                        std::string( reinterpret_cast<const char *>(&vf[i]), 3*sizeof(float) );
-            }
+            // float test value
+            const float ref_4b = *reinterpret_cast<const float *>( &test_hex_4b );
+            stream.write( reinterpret_cast<const char *>(&ref_4b), sizeof(float) );
+            write_data_bin_as<float>( stream, vf );
         }
     }
 
-    void File_OVF::write_data_txt( const vectorfield& vf, const std::string& delimiter )
+    template <typename T> void File_OVF::write_data_bin_as( std::ostream& stream, const vectorfield& vf )
     {
-        for (int iatom = 0; iatom < vf.size(); ++iatom)
+        static_assert( sizeof(Vector3) == 3*sizeof(scalar), "Vector3 has to be densely packed" );
+
+        // If the precision matches, the data can be written directly from the vectorfield
+        if ( std::is_same<T, scalar>::value )
+        {
+            stream.write( reinterpret_cast<const char *>( vf.data() ), 3*sizeof(scalar)*vf.size() );
+            return;
+        }
+
+        // Otherwise it is converted chunk by chunk
+        std::vector<T> buffer( 3*std::min( vf.size(), n_spins_chunk ) );
+        for ( std::size_t start = 0; start < vf.size(); start += n_spins_chunk )
         {
-            this->output_to_file += fmt::format( "{:22.12f}{} {:22.12f}{} {:22.12f}{}\n", 
-                                                  vf[iatom][0], delimiter, 
-                                                  vf[iatom][1], delimiter,
-                                                  vf[iatom][2], delimiter );
+            std::size_t end = std::min( vf.size(), start + n_spins_chunk );
+            for ( std::size_t i = start; i < end; ++i )
+            {
+                buffer[3*(i-start)]   = static_cast<T>( vf[i][0] );
+                buffer[3*(i-start)+1] = static_cast<T>( vf[i][1] );
+                buffer[3*(i-start)+2] = static_cast<T>( vf[i][2] );
+            }
+            stream.write( reinterpret_cast<const char *>( buffer.data() ), 3*sizeof(T)*(end-start) );
         }
     }
 
-    void File_OVF::increment_n_segments()
+    void File_OVF::write_data_txt( std::ostream& stream, const vectorfield& vf,
+                                   const std::string& delimiter )
     {
-        try
+        // The lines are formatted into a buffer which is written out chunk by chunk
+        fmt::MemoryWriter buffer;
+        for ( std::size_t i = 0; i < vf.size(); ++i )
         {
-            std::fstream file( this->filename ); 
-       
-            // update n_segments
-            this->n_segments++;
-            
-            // convert updated n_segment into padded string
-            std::string new_n_str = std::to_string( this->n_segments );
-            std::string::size_type new_n_len = new_n_str.length();
+            buffer.write( "{:22.12f}{} {:22.12f}{} {:22.12f}{}\n", 
+                          vf[i][0], delimiter, 
+                          vf[i][1], delimiter,
+                          vf[i][2], delimiter );
+            if ( (i+1) % n_spins_chunk == 0 || i+1 == vf.size() )
+            {
+                stream.write( buffer.data(), buffer.size() );
+                buffer.clear();
+            }
+        }
+    }
 
-            std::string::size_type padding_len = this->n_segments_str_digits - new_n_len;
-            std::string padding( padding_len, '0' ); 
+    template <typename T> void File_OVF::write_fields_bin_as( std::ostream& stream,
+                    const std::vector<std::pair<std::string, scalarfield>>& fields )
+    {
+        if ( fields.empty() )
+            return;
 
-            // n_segments_pos is the end of the line that contains '#segment count' (after '\n')
-            std::ios::off_type offset = this->n_segments_str_digits + 1;
-            
-            // go to the beginning '#segment count' value position
-            file.seekg( this->n_segments_pos );
-            file.seekg( (-1)*offset, std::ios::cur );
+        // The fields are interleaved chunk by chunk
+        std::size_t valuedim = fields.size();
+        std::size_t n_nodes = fields[0].second.size();
+        std::vector<T> buffer( valuedim*std::min( n_nodes, n_spins_chunk ) );
+        for ( std::size_t start = 0; start < n_nodes; start += n_spins_chunk )
+        {
+            std::size_t end = std::min( n_nodes, start + n_spins_chunk );
+            for ( std::size_t j = 0; j < valuedim; ++j )
+            {
+                const scalarfield & field = fields[j].second;
+                for ( std::size_t i = start; i < end; ++i )
+                    buffer[valuedim*(i-start)+j] = static_cast<T>( field[i] );
+            }
+            stream.write( reinterpret_cast<const char *>( buffer.data() ), valuedim*sizeof(T)*(end-start) );
+        }
+    }
 
-            // replace n_segments value in the stream
-            file << ( padding + new_n_str );
+    void File_OVF::write_fields_txt( std::ostream& stream,
+                    const std::vector<std::pair<std::string, scalarfield>>& fields,
+                    const std::string& delimiter )
+    {
+        if ( fields.empty() )
+            return;
 
-            file.close();
-        }
-        catch( ... )
+        // The lines are formatted into a buffer which is written out chunk by chunk
+        fmt::MemoryWriter buffer;
+        std::size_t n_nodes = fields[0].second.size();
+        for ( std::size_t i = 0; i < n_nodes; ++i )
         {
-            spirit_rethrow( fmt::format("Failed to increment n_segments in OVF file \"{}\".", 
-                            this->filename) );
+            for ( std::size_t j = 0; j < fields.size(); ++j )
+            {
+                if ( j > 0 ) buffer << ' ';
+                buffer.write( "{:22.12f}{}", fields[j].second[i], delimiter );
+            }
+            buffer << '\n';
+            if ( (i+1) % n_spins_chunk == 0 || i+1 == n_nodes )
+            {
+                stream.write( buffer.data(), buffer.size() );
+                buffer.clear();
+            }
         }
     }
 
+    void File_OVF::increment_n_segments()
+    {
+        // update n_segments
+        this->n_segments++;
+        
+        // convert updated n_segment into padded string
+        std::string new_n_str = std::to_string( this->n_segments );
+        std::string::size_type padding_len = this->n_segments_str_digits - new_n_str.length();
+        this->n_segments_as_str = std::string( padding_len, '0' ) + new_n_str;
+    }
+
     void File_OVF::read_n_segments_from_top_header()
     {
         try
@@ -575,33 +754,76 @@ namespace IO
     {
         try
         {
-            this->ifile = std::unique_ptr<Filter_File_Handle>( 
-                                new Filter_File_Handle( this->filename, this->comment_tag ) ); 
+            this->segment_fpos.clear();
+            this->segment_data_fpos.clear();
 
-            // get the number of segments from the occurrences of "# Begin: Segment"
-            int n_begin_segment = 0;
-            
-            std::ios::pos_type end = this->ifile->GetPosition( std::ios::end ); 
-            
-            // NOTE: the keyword to find must be lower case since the Filter File Handle 
-            // converts the content of the input file to lower case automatically
-            while( ifile->Find( "# begin: segment" ) )
+            this->mapped = std::unique_ptr<Mapped_File>( new Mapped_File( this->filename ) );
+            const char * data = this->mapped->data();
+            std::size_t size = this->mapped->size();
+
+            // Number of values and value dimension of the current segment, needed to skip its
+            // binary data block
+            std::size_t nodes[3] = { 0, 0, 0 };
+            std::size_t pointcount = 0;
+            std::size_t valuedim = 3;
+
+            std::string rest;
+            std::size_t pos = 0;
+            while ( pos < size )
             {
-                std::ios::pos_type pos = this->ifile->GetPosition(); 
-                this->segment_fpos.push_back( pos );
-                ifile->SetLimits( pos, end );
+                const char * line = data + pos;
+                const char * newline = static_cast<const char *>( std::memchr( line, '\n', size - pos ) );
+                std::size_t length = newline ? newline - line : size - pos;
+                std::size_t next = std::min( pos + length + 1, size );
+
+                if ( Line_Starts_With( line, length, "# begin: segment", rest ) )
+                {
+                    // A segment without data block ends where the next one begins
+                    while ( this->segment_data_fpos.size() < this->segment_fpos.size() )
+                        this->segment_data_fpos.push_back( pos );
+                    // The segment starts after its "# Begin: Segment" line
+                    this->segment_fpos.push_back( next );
+                    nodes[0] = nodes[1] = nodes[2] = 0;
+                    pointcount = 0;
+                    valuedim = 3;
+                }
+                else if ( Line_Starts_With( line, length, "# xnodes:", rest ) )
+                    std::istringstream( rest ) >> nodes[0];
+                else if ( Line_Starts_With( line, length, "# ynodes:", rest ) )
+                    std::istringstream( rest ) >> nodes[1];
+                else if ( Line_Starts_With( line, length, "# znodes:", rest ) )
+                    std::istringstream( rest ) >> nodes[2];
+                else if ( Line_Starts_With( line, length, "# pointcount:", rest ) )
+                    std::istringstream( rest ) >> pointcount;
+                else if ( Line_Starts_With( line, length, "# valuedim:", rest ) )
+                    std::istringstream( rest ) >> valuedim;
+                else if ( Line_Starts_With( line, length, "# begin: data", rest ) &&
+                          this->segment_data_fpos.size() < this->segment_fpos.size() )
+                {
+                    this->segment_data_fpos.push_back( pos );
+
+                    // Jump over a binary data block instead of scanning it
+                    std::string representation;
+                    int length_binary = 0;
+                    std::istringstream repr( rest );
+                    repr >> representation >> length_binary;
+                    std::transform( representation.begin(), representation.end(),
+                                    representation.begin(), ::tolower );
+                    std::size_t n_values = pointcount > 0 ? pointcount : nodes[0]*nodes[1]*nodes[2];
+                    if ( representation == "binary" && ( length_binary == 4 || length_binary == 8 ) &&
+                         n_values > 0 )
+                        next = std::min( next + length_binary * ( 1 + valuedim*n_values ), size );
+                }
 
-                ++n_begin_segment;
+                pos = next;
             }
-           
-            // find the very last keyword of the file
-            this->segment_fpos.push_back( end );
 
-            // reset limits
-            ifile->ResetLimits();
-            
-            // close the file
-            this->ifile = NULL;
+            int n_begin_segment = this->segment_fpos.size();
+
+            while ( this->segment_data_fpos.size() < this->segment_fpos.size() )
+                this->segment_data_fpos.push_back( size );
+            // the end of the file is the end of the last segment
+            this->segment_fpos.push_back( size );
 
             return n_begin_segment;
         }
@@ -616,24 +838,29 @@ namespace IO
 
     bool File_OVF::exists()
     {
+        inspect_file();
         return this->file_exists;
     }
 
     bool File_OVF::is_OVF()
     {
+        inspect_file();
         return this->isOVF;
     }
 
     int File_OVF::get_n_segments()
     {
+        inspect_file();
         return this->n_segments;
     }
 
     void File_OVF::read_segment( vectorfield& vf, Data::Geometry& geometry, 
                                  const int idx_seg )
     {
+        Timing::Scope timing(timing_read_segment);
         try
         {
+            inspect_file();
             if ( !this->file_exists )
             {
                 spirit_throw( Exception_Classifier::File_not_Found, Log_Level::Warning, 
@@ -655,12 +882,68 @@ namespace IO
                     spirit_throw( Exception_Classifier::Input_parse_failed, Log_Level::Error,
                                   "OVF error while choosing segment - index out of bounds" );
 
+                // The header ends where the data block begins
                 this->ifile->SetLimits( this->segment_fpos[idx_seg], 
+                                        this->segment_data_fpos[idx_seg] );
+                read_header();
+                check_geometry( geometry );
+
+                if ( this->valuedim != 3 )
+                    spirit_throw( Exception_Classifier::Bad_File_Content, Log_Level::Error,
+                                  fmt::format( "OVF segment has value dimension {} instead of 3 "
+                                               "and is not a vector field", this->valuedim ) );
+
+                this->ifile->SetLimits( this->segment_data_fpos[idx_seg], 
                                         this->segment_fpos[idx_seg+1] );
-           
+                read_data( vf, geometry, idx_seg );
+
+                // close the file
+                this->ifile = NULL;
+            }
+        }
+        catch( ... )
+        {
+            spirit_rethrow( fmt::format("Failed to read OVF file \"{}\".", this->filename) );
+        }
+    }
+
+    void File_OVF::read_segment( std::vector<std::pair<std::string, scalarfield>>& fields,
+                                 const Data::Geometry& geometry, const int idx_seg )
+    {
+        Timing::Scope timing(timing_read_segment);
+        try
+        {
+            inspect_file();
+            if ( !this->file_exists )
+            {
+                spirit_throw( Exception_Classifier::File_not_Found, Log_Level::Warning, 
+                              fmt::format( "The file \"{}\" does not exist", filename ) );
+            } 
+            else if ( this->n_segments == 0 )
+            {
+                spirit_throw( Exception_Classifier::Bad_File_Content, Log_Level::Warning, 
+                              fmt::format( "File \"{}\" is empty", filename ) );
+            }
+            else
+            {
+                // open the file
+                this->ifile = std::unique_ptr<Filter_File_Handle>( 
+                                    new Filter_File_Handle( this->filename, this->comment_tag ) ); 
+                
+                // NOTE: seg_idx.max = segment_fpos.size - 2
+                if ( idx_seg >= ( this->segment_fpos.size() - 1 ) )
+                    spirit_throw( Exception_Classifier::Input_parse_failed, Log_Level::Error,
+                                  "OVF error while choosing segment - index out of bounds" );
+
+                // The header ends where the data block begins
+                this->ifile->SetLimits( this->segment_fpos[idx_seg], 
+                                        this->segment_data_fpos[idx_seg] );
                 read_header();
                 check_geometry( geometry );
-                read_data( vf, geometry );
+
+                this->ifile->SetLimits( this->segment_data_fpos[idx_seg], 
+                                        this->segment_fpos[idx_seg+1] );
+                read_data( fields, idx_seg );
 
                 // close the file
                 this->ifile = NULL;
@@ -675,17 +958,128 @@ namespace IO
     void File_OVF::write_segment( const vectorfield& vf, const Data::Geometry& geometry,
                                   const std::string comment, const bool append )
     {
+        Timing::Scope timing(timing_write_segment);
+        try
+        {
+            #ifdef SPIRIT_USE_THREADS
+            // The writer thread needs its own copy, as vf may change before the data is written
+            auto data = std::make_shared<const vectorfield>( vf );
+            #else
+            // The output is written immediately, so the data can be taken directly from vf
+            auto data = std::shared_ptr<const vectorfield>( &vf, [](const vectorfield *){} );
+            #endif
+
+            std::size_t bytes_per_spin = 3*sizeof(double);
+            if ( this->format == VF_FileFormat::OVF_TEXT || this->format == VF_FileFormat::OVF_CSV )
+                bytes_per_spin = 3*(22+2);
+
+            VF_FileFormat format = this->format;
+            // The value dimension is always 3 since we are writting Vector3-data
+            write_segment_queued( geometry, comment, append, 3, "None None None",
+                                  "spin_x_component spin_y_component spin_z_component ",
+                                  bytes_per_spin*vf.size(), [data, format]( std::ostream& stream )
+            {
+                if ( format == VF_FileFormat::OVF_BIN8 || format == VF_FileFormat::OVF_BIN4 )
+                    write_data_bin( stream, *data, format );
+                else if ( format == VF_FileFormat::OVF_TEXT )
+                    write_data_txt( stream, *data );
+                else if ( format == VF_FileFormat::OVF_CSV )
+                    write_data_txt( stream, *data, "," );
+            });
+        }
+        catch( ... )
+        {
+            spirit_rethrow( fmt::format("Failed to write OVF file \"{}\".", this->filename) );
+        }
+    }
+
+    void File_OVF::write_segment( const std::vector<std::pair<std::string, scalarfield>>& fields,
+                                  const Data::Geometry& geometry, const std::string comment,
+                                  const bool append )
+    {
+        Timing::Scope timing(timing_write_segment);
         try
         {
-            this->output_to_file.reserve( int( 0x08000000 ) );  // reserve 128[MByte]
+            typedef std::vector<std::pair<std::string, scalarfield>> fieldlist;
+            #ifdef SPIRIT_USE_THREADS
+            // The writer thread needs its own copy, as the fields may change before they are written
+            auto data = std::make_shared<const fieldlist>( fields );
+            #else
+            // The output is written immediately, so the data can be taken directly from the fields
+            auto data = std::shared_ptr<const fieldlist>( &fields, [](const fieldlist *){} );
+            #endif
+
+            std::string valueunits, valuelabels;
+            for ( auto& field : fields )
+            {
+                valueunits  += valueunits.empty()  ? "None" : " None";
+                valuelabels += valuelabels.empty() ? field.first : " " + field.first;
+            }
+
+            std::size_t n_nodes = fields.empty() ? 0 : fields[0].second.size();
+            std::size_t bytes_per_value = sizeof(double);
+            if ( this->format == VF_FileFormat::OVF_TEXT || this->format == VF_FileFormat::OVF_CSV )
+                bytes_per_value = 22+2;
+
+            VF_FileFormat format = this->format;
+            write_segment_queued( geometry, comment, append, fields.size(), valueunits, valuelabels,
+                                  bytes_per_value*fields.size()*n_nodes,
+                                  [data, format]( std::ostream& stream )
+            {
+                if ( format == VF_FileFormat::OVF_BIN8 )
+                {
+                    const double ref_8b = *reinterpret_cast<const double *>( &test_hex_8b );
+                    stream.write( reinterpret_cast<const char *>(&ref_8b), sizeof(double) );
+                    write_fields_bin_as<double>( stream, *data );
+                }
+                else if ( format == VF_FileFormat::OVF_BIN4 )
+                {
+                    const float ref_4b = *reinterpret_cast<const float *>( &test_hex_4b );
+                    stream.write( reinterpret_cast<const char *>(&ref_4b), sizeof(float) );
+                    write_fields_bin_as<float>( stream, *data );
+                }
+                else if ( format == VF_FileFormat::OVF_TEXT )
+                    write_fields_txt( stream, *data );
+                else if ( format == VF_FileFormat::OVF_CSV )
+                    write_fields_txt( stream, *data, "," );
+            });
+        }
+        catch( ... )
+        {
+            spirit_rethrow( fmt::format("Failed to write OVF file \"{}\".", this->filename) );
+        }
+    }
+
+    void File_OVF::write_segment_queued( const Data::Geometry& geometry, const std::string& comment,
+                                         const bool append, const int valuedim,
+                                         const std::string& valueunits, const std::string& valuelabels,
+                                         const std::size_t data_size,
+                                         std::function<void(std::ostream&)> write_data )
+    {
+        try
+        {
+            // Segments can only be appended to an existing file once its segments are known
+            if ( append )
+                inspect_file();
 
             // If we are not appending or the file does not exists we need to write the top header
             // and to turn the file_exists attribute to true so we can append more segments
-            if ( !append || !this->file_exists ) 
+            bool new_file = !append || !this->file_exists;
+            // The memory mapping does not cover what is written now
+            this->mapped = nullptr;
+            if ( new_file ) 
             {
                 write_top_header();
-                read_n_segments_from_top_header();  // finds the file position of n_segments
                 this->file_exists = true; 
+                this->file_inspected = true;
+                this->isOVF = true;
+                // A new file is written through a new file handle, which truncates it
+                this->ofile = std::make_shared<std::fstream>();
+            }
+            else if ( !this->ofile )
+            {
+                // Segments appended to an existing file are all written through one file handle
+                this->ofile = std::make_shared<std::fstream>();
             }
 
             this->output_to_file += fmt::format( this->empty_line );
@@ -700,12 +1094,9 @@ namespace IO
             this->output_to_file += fmt::format( "# Desc: {}\n", comment );
             this->output_to_file += fmt::format( this->empty_line );
 
-            // The value dimension is always 3 since we are writting Vector3-data
-            this->output_to_file += fmt::format( "# valuedim: {} ##Value dimension\n", 3 );
-            this->output_to_file += fmt::format( "# valueunits: None None None\n" );
-            this->output_to_file +=
-                fmt::format("# valuelabels: spin_x_component spin_y_component "
-                            "spin_z_component \n");
+            this->output_to_file += fmt::format( "# valuedim: {} ##Value dimension\n", valuedim );
+            this->output_to_file += fmt::format( "# valueunits: {}\n", valueunits );
+            this->output_to_file += fmt::format( "# valuelabels: {}\n", valuelabels );
             this->output_to_file += fmt::format( this->empty_line );
 
             this->output_to_file += fmt::format( "## Fundamental mesh measurement unit. "
@@ -756,25 +1147,59 @@ namespace IO
             // Data
             this->output_to_file += fmt::format( "# Begin: Data {}\n", this->datatype_out );
 
-            if ( this->format == VF_FileFormat::OVF_BIN8 || format == VF_FileFormat::OVF_BIN4 )
-                write_data_bin( vf );
-            else if ( this->format == VF_FileFormat::OVF_TEXT )
-                write_data_txt( vf );
-            else if ( this->format == VF_FileFormat::OVF_CSV )
-                write_data_txt( vf, "," );
+            // The segment count in the top header is updated once the segment has been written
+            increment_n_segments();
 
-            this->output_to_file += fmt::format( "# End: Data {}\n", this->datatype_out );
-            
-            this->output_to_file += fmt::format( "# End: Segment\n" );
+            // Only the header is buffered here, the data is streamed into the file
+            auto header = std::make_shared<const std::string>( std::move(this->output_to_file) );
+            this->output_to_file = "";
+
+            std::size_t size = header->size() + data_size;
+
+            auto file = this->ofile;
+            std::string filename = this->filename;
+            std::string datatype = this->datatype_out;
+            std::string n_segments_str = this->n_segments_as_str;
+            // n_segments_pos is the end of the line that contains '#segment count' (after '\n')
+            std::ios::pos_type n_segments_pos = this->n_segments_pos;
+            std::ios::off_type offset = this->n_segments_str_digits + 1;
+
+            Queue_Output( filename, size, [=]()
+            {
+                if ( !file->is_open() )
+                {
+                    if ( new_file )
+                        file->open( filename, std::ios::out | std::ios::binary | std::ios::trunc );
+                    else
+                        file->open( filename, std::ios::in | std::ios::out | std::ios::binary );
+                    file->seekp( 0, std::ios::end );
+                }
+                if ( !file->is_open() )
+                {
+                    Log( Log_Level::Error, Log_Sender::IO, "Could not open " + filename + " to write to file" );
+                    return;
+                }
+
+                file->write( header->data(), header->size() );
 
-            // Append the #End keywords
-            Append_String_to_File( this->output_to_file, this->filename );
+                write_data( *file );
 
-            // reset output string buffer
-            this->output_to_file = "";  
+                *file << fmt::format( "# End: Data {}\n", datatype );
+                *file << fmt::format( "# End: Segment\n" );
 
-            // Increment the n_segments after succesfully appending the segment body to the file
-            increment_n_segments(); 
+                // Replace the n_segments value in the top header and return to the end of the file
+                std::ios::pos_type end = file->tellp();
+                file->seekp( n_segments_pos );
+                file->seekp( (-1)*offset, std::ios::cur );
+                *file << n_segments_str;
+                file->seekp( end );
+
+                // Readers of the file may open it while this handle is still kept open
+                file->flush();
+                if ( !file->good() )
+                    spirit_throw( Exception_Classifier::Bad_File_Content, Log_Level::Error,
+                                  fmt::format( "Failed to write to file \"{}\"", filename ) );
+            });
         }
         catch( ... )
         {
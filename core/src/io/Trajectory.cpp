@@ -0,0 +1,510 @@
+#include <io/Trajectory.hpp>
+#include <io/IO.hpp>
+#include <utility/Logging.hpp>
+#include <utility/Exception.hpp>
+
+#include <fstream>
+#include <atomic>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+
+#include <fmt/format.h>
+
+using namespace Utility;
+
+namespace IO
+{
+    namespace
+    {
+        const char file_tag[8]         = { 'S', 'P', 'I', 'R', 'I', 'T', 'T', 'J' };
+        const char frame_tag[4]        = { 'F', 'R', 'A', 'M' };
+        const std::uint32_t version    = 1;
+        // tag, version, n_bits, keyframe_interval, nos
+        const std::size_t header_size  = 8 + 4 + 4 + 4 + 8;
+        // tag, keyframe, iteration, energy, n_bytes
+        const std::size_t record_size  = 4 + 1 + 8 + 8 + 8;
+
+        template <typename T> void Put_Value( std::string & out, T value )
+        {
+            out.append( reinterpret_cast<const char *>( &value ), sizeof(T) );
+        }
+
+        template <typename T> T Get_Value( const char * data )
+        {
+            T value;
+            std::memcpy( &value, data, sizeof(T) );
+            return value;
+        }
+
+        // Variable length (LEB128) encoding of unsigned integers: 7 bits per byte
+        void Put_Varint( std::string & out, std::uint64_t value )
+        {
+            while ( value >= 0x80 )
+            {
+                out.push_back( static_cast<char>( ( value & 0x7F ) | 0x80 ) );
+                value >>= 7;
+            }
+            out.push_back( static_cast<char>( value ) );
+        }
+
+        std::uint64_t Get_Varint( const char *& data, const char * end )
+        {
+            std::uint64_t value = 0;
+            for ( int shift = 0; data < end && shift < 64; shift += 7 )
+            {
+                std::uint8_t byte = static_cast<std::uint8_t>( *data++ );
+                value |= std::uint64_t( byte & 0x7F ) << shift;
+                if ( !( byte & 0x80 ) )
+                    return value;
+            }
+            spirit_throw( Exception_Classifier::Bad_File_Content, Log_Level::Error,
+                          "Trajectory frame data is corrupted" );
+            return 0;
+        }
+
+        // Map signed integers onto unsigned ones, so that small magnitudes give short varints
+        std::uint64_t Zigzag( std::int64_t value )
+        {
+            return ( std::uint64_t( value ) << 1 ) ^ std::uint64_t( value >> 63 );
+        }
+
+        std::int64_t Unzigzag( std::uint64_t value )
+        {
+            return std::int64_t( value >> 1 ) ^ -std::int64_t( value & 1 );
+        }
+
+        scalar Sign( scalar value )
+        {
+            return value < 0 ? -1 : 1;
+        }
+
+        // Map a unit vector onto the octahedron |u|+|w|+|z|=1, with the lower half folded outwards
+        void Octahedral_Encode( const Vector3 & vec, scalar & u, scalar & w )
+        {
+            scalar norm = std::abs( vec[0] ) + std::abs( vec[1] ) + std::abs( vec[2] );
+            if ( norm < 1e-12 )
+            {
+                u = 0;
+                w = 0;
+                return;
+            }
+            u = vec[0] / norm;
+            w = vec[1] / norm;
+            if ( vec[2] < 0 )
+            {
+                scalar u_folded = ( 1 - std::abs( w ) ) * Sign( u );
+                w = ( 1 - std::abs( u ) ) * Sign( w );
+                u = u_folded;
+            }
+        }
+
+        Vector3 Octahedral_Decode( scalar u, scalar w )
+        {
+            Vector3 vec{ u, w, 1 - std::abs( u ) - std::abs( w ) };
+            if ( vec[2] < 0 )
+            {
+                vec[0] = ( 1 - std::abs( w ) ) * Sign( u );
+                vec[1] = ( 1 - std::abs( u ) ) * Sign( w );
+            }
+            return vec.normalized();
+        }
+
+        std::int32_t Max_Quantized( int n_bits )
+        {
+            return ( std::int32_t( 1 ) << ( n_bits - 1 ) ) - 1;
+        }
+
+        /*
+            Linear prediction of the quantized value idx of a frame, which is n_since_keyframe
+            frames after the last keyframe. A keyframe is predicted from the two preceding spins
+            of the same frame (current), any other frame from the two preceding frames.
+        */
+        std::int64_t Predict( const std::vector<std::int32_t> & current,
+                              const std::vector<std::int32_t> & last,
+                              const std::vector<std::int32_t> & before_last,
+                              std::size_t idx, int n_since_keyframe )
+        {
+            if ( n_since_keyframe == 0 )
+            {
+                if ( idx >= 4 )
+                    return 2 * std::int64_t( current[idx-2] ) - current[idx-4];
+                else if ( idx >= 2 )
+                    return current[idx-2];
+                else
+                    return 0;
+            }
+            else if ( n_since_keyframe == 1 )
+                return last[idx];
+            else
+                return 2 * std::int64_t( last[idx] ) - before_last[idx];
+        }
+
+        std::uint64_t Double_Bits( double value )
+        {
+            std::uint64_t bits;
+            std::memcpy( &bits, &value, sizeof(double) );
+            return bits;
+        }
+
+        double Bits_Double( std::uint64_t bits )
+        {
+            double value;
+            std::memcpy( &value, &bits, sizeof(double) );
+            return value;
+        }
+    }
+
+    // ------ Writer ----------------------------------------------------
+
+    struct Trajectory_Writer::Encoder
+    {
+        std::string filename;
+        std::size_t nos;
+        int n_bits;
+        int keyframe_interval;
+        bool append;
+
+        std::fstream file;
+        bool failed;
+        // Number of frames since the last keyframe
+        int n_since_keyframe;
+        // Quantized values of the current and the two preceding frames, or raw values of the last frame
+        std::vector<std::int32_t> quantized, quantized_last, quantized_before_last;
+        std::vector<std::uint64_t> raw;
+        // Buffers for the record header and the frame data
+        std::string record;
+        std::string data;
+        std::atomic<int> n_frames_written;
+
+        // Open the file and write the header or, when appending, move to the end of the last frame
+        void Open()
+        {
+            std::size_t end = 0;
+            if ( this->append )
+            {
+                try
+                {
+                    Mapped_File mapped( this->filename );
+                    std::size_t nos_file;
+                    int n_bits_file;
+                    std::vector<Trajectory_Reader::Frame_Record> frames;
+                    if ( Trajectory_Reader::Index_Frames( mapped, nos_file, n_bits_file, frames ) )
+                    {
+                        if ( nos_file == this->nos && n_bits_file == this->n_bits )
+                            end = frames.empty() ? header_size : frames.back().offset + frames.back().n_bytes;
+                        else
+                            Log( Log_Level::Warning, Log_Sender::IO, fmt::format( "Trajectory file \"{}\" "
+                                 "has {} spins and {} bits, but {} and {} are needed. It will be overwritten",
+                                 this->filename, nos_file, n_bits_file, this->nos, this->n_bits ) );
+                    }
+                }
+                catch( ... )
+                {
+                    // The file does not exist yet
+                }
+            }
+
+            if ( end > 0 )
+            {
+                this->file.open( this->filename, std::ios::in | std::ios::out | std::ios::binary );
+                this->file.seekp( end );
+            }
+            else
+            {
+                this->file.open( this->filename, std::ios::out | std::ios::binary | std::ios::trunc );
+                std::string header( file_tag, sizeof(file_tag) );
+                Put_Value<std::uint32_t>( header, version );
+                Put_Value<std::uint32_t>( header, this->n_bits );
+                Put_Value<std::uint32_t>( header, this->keyframe_interval );
+                Put_Value<std::uint64_t>( header, this->nos );
+                this->file.write( header.data(), header.size() );
+            }
+
+            if ( !this->file.good() )
+            {
+                this->failed = true;
+                Log( Log_Level::Error, Log_Sender::IO, "Could not open " + this->filename + " to write to file" );
+            }
+        }
+
+        void Encode( const vectorfield & spins, long int iteration, scalar energy )
+        {
+            if ( this->failed )
+                return;
+
+            int n_since_keyframe = this->n_since_keyframe;
+            bool keyframe = ( n_since_keyframe == 0 );
+            this->n_since_keyframe = ( this->n_since_keyframe + 1 ) % this->keyframe_interval;
+
+            this->data.clear();
+            if ( this->n_bits > 0 )
+            {
+                std::int32_t q_max = Max_Quantized( this->n_bits );
+                for ( std::size_t i = 0; i < this->nos; ++i )
+                {
+                    scalar coords[2];
+                    Octahedral_Encode( spins[i], coords[0], coords[1] );
+                    for ( int c = 0; c < 2; ++c )
+                    {
+                        std::size_t idx = 2*i + c;
+                        this->quantized[idx] = static_cast<std::int32_t>( std::lround( coords[c] * q_max ) );
+                        std::int64_t prediction = Predict( this->quantized, this->quantized_last,
+                                                           this->quantized_before_last, idx, n_since_keyframe );
+                        Put_Varint( this->data, Zigzag( this->quantized[idx] - prediction ) );
+                    }
+                }
+                std::swap( this->quantized_before_last, this->quantized_last );
+                std::swap( this->quantized_last, this->quantized );
+            }
+            else
+            {
+                // Lossless frames hold the bitwise differences to the previous frame
+                for ( std::size_t i = 0; i < this->nos; ++i )
+                {
+                    for ( int c = 0; c < 3; ++c )
+                    {
+                        std::uint64_t bits = Double_Bits( spins[i][c] );
+                        std::uint64_t reference = keyframe ? 0 : this->raw[3*i+c];
+                        Put_Varint( this->data, bits ^ reference );
+                        this->raw[3*i+c] = bits;
+                    }
+                }
+            }
+
+            this->record.assign( frame_tag, sizeof(frame_tag) );
+            Put_Value<std::uint8_t>( this->record, keyframe ? 1 : 0 );
+            Put_Value<std::int64_t>( this->record, iteration );
+            Put_Value<double>( this->record, energy );
+            Put_Value<std::uint64_t>( this->record, this->data.size() );
+
+            this->file.write( this->record.data(), this->record.size() );
+            this->file.write( this->data.data(), this->data.size() );
+            // Readers only see complete frames
+            this->file.flush();
+
+            if ( !this->file.good() )
+            {
+                this->failed = true;
+                spirit_throw( Exception_Classifier::Bad_File_Content, Log_Level::Error,
+                              fmt::format( "Failed to write to trajectory file \"{}\"", this->filename ) );
+            }
+            ++this->n_frames_written;
+        }
+    };
+
+    Trajectory_Writer::Trajectory_Writer( const std::string & filename, std::size_t nos, int n_bits,
+                                          int keyframe_interval, bool append ) :
+        filename(filename), nos(nos), encoder(std::make_shared<Encoder>())
+    {
+        // Quantize with 2 to 24 bits, or store lossless
+        if ( n_bits > 0 )
+            n_bits = std::max( 2, std::min( 24, n_bits ) );
+        else
+            n_bits = 0;
+
+        this->encoder->filename          = filename;
+        this->encoder->nos               = nos;
+        this->encoder->n_bits            = n_bits;
+        this->encoder->keyframe_interval = std::max( 1, keyframe_interval );
+        this->encoder->append            = append;
+        this->encoder->failed            = false;
+        this->encoder->n_since_keyframe  = 0;
+        this->encoder->n_frames_written  = 0;
+        if ( n_bits > 0 )
+        {
+            this->encoder->quantized.resize( 2*nos );
+            this->encoder->quantized_last.resize( 2*nos );
+            this->encoder->quantized_before_last.resize( 2*nos );
+        }
+        else
+            this->encoder->raw.resize( 3*nos );
+
+        auto encoder = this->encoder;
+        Queue_Output( filename, 0, [encoder]() { encoder->Open(); } );
+    }
+
+    void Trajectory_Writer::Write_Frame( const vectorfield & spins, long int iteration, scalar energy )
+    {
+        if ( spins.size() < this->nos )
+            spirit_throw( Exception_Classifier::Unknown_Exception, Log_Level::Error,
+                          fmt::format( "Trajectory \"{}\" needs {} spins, but got {}",
+                                       this->filename, this->nos, spins.size() ) );
+
+        #ifdef SPIRIT_USE_THREADS
+        // The writer thread needs its own copy, as the spins may change before they are encoded
+        auto data = std::make_shared<const vectorfield>( spins );
+        #else
+        // The output is written immediately, so the spins can be used directly
+        auto data = std::shared_ptr<const vectorfield>( &spins, [](const vectorfield *){} );
+        #endif
+
+        auto encoder = this->encoder;
+        Queue_Output( this->filename, sizeof(Vector3)*this->nos, [encoder, data, iteration, energy]()
+        {
+            encoder->Encode( *data, iteration, energy );
+        });
+    }
+
+    int Trajectory_Writer::Get_N_Frames_Written() const
+    {
+        return this->encoder->n_frames_written;
+    }
+
+    // ------ Reader ----------------------------------------------------
+
+    bool Trajectory_Reader::Index_Frames( const Mapped_File & file, std::size_t & nos, int & n_bits,
+                                          std::vector<Frame_Record> & frames )
+    {
+        frames.clear();
+        const char * data = file.data();
+        std::size_t size  = file.size();
+
+        if ( size < header_size || std::memcmp( data, file_tag, sizeof(file_tag) ) != 0 ||
+             Get_Value<std::uint32_t>( data + 8 ) != version )
+            return false;
+        n_bits = Get_Value<std::uint32_t>( data + 12 );
+        nos    = Get_Value<std::uint64_t>( data + 20 );
+
+        // Jump from frame to frame, stopping at the first incomplete one
+        std::size_t pos = header_size;
+        while ( pos + record_size <= size && std::memcmp( data + pos, frame_tag, sizeof(frame_tag) ) == 0 )
+        {
+            Frame_Record frame;
+            frame.keyframe       = Get_Value<std::uint8_t>( data + pos + 4 ) != 0;
+            frame.info.iteration = static_cast<long int>( Get_Value<std::int64_t>( data + pos + 5 ) );
+            frame.info.energy    = static_cast<scalar>( Get_Value<double>( data + pos + 13 ) );
+            frame.n_bytes        = Get_Value<std::uint64_t>( data + pos + 21 );
+            frame.offset         = pos + record_size;
+            if ( frame.n_bytes > size - frame.offset )
+                break;
+            frames.push_back( frame );
+            pos = frame.offset + frame.n_bytes;
+        }
+        return true;
+    }
+
+    Trajectory_Reader::Trajectory_Reader( const std::string & filename ) :
+        filename(filename), nos(0), n_bits(0), idx_decoded(-1), n_since_keyframe_decoded(0)
+    {
+        // Frames which are still queued have to be written first
+        Flush_Output( filename );
+
+        this->mapped = std::unique_ptr<Mapped_File>( new Mapped_File( filename ) );
+        if ( !Index_Frames( *this->mapped, this->nos, this->n_bits, this->frames ) )
+            spirit_throw( Exception_Classifier::Bad_File_Content, Log_Level::Error,
+                          fmt::format( "File \"{}\" is not a trajectory file", filename ) );
+
+        if ( this->n_bits > 0 )
+        {
+            this->quantized.resize( 2*this->nos );
+            this->quantized_last.resize( 2*this->nos );
+            this->quantized_before_last.resize( 2*this->nos );
+        }
+        else
+            this->raw.resize( 3*this->nos );
+    }
+
+    int Trajectory_Reader::Get_N_Frames() const
+    {
+        return this->frames.size();
+    }
+
+    std::size_t Trajectory_Reader::Get_NOS() const
+    {
+        return this->nos;
+    }
+
+    int Trajectory_Reader::Get_N_Bits() const
+    {
+        return this->n_bits;
+    }
+
+    Trajectory_Frame Trajectory_Reader::Get_Frame_Info( int idx_frame ) const
+    {
+        if ( idx_frame < 0 || idx_frame >= int(this->frames.size()) )
+            spirit_throw( Exception_Classifier::Input_parse_failed, Log_Level::Error,
+                          fmt::format( "Trajectory \"{}\" has no frame {}", this->filename, idx_frame ) );
+        return this->frames[idx_frame].info;
+    }
+
+    void Trajectory_Reader::Decode_Frame( const Frame_Record & record, int n_since_keyframe )
+    {
+        const char * data = this->mapped->data() + record.offset;
+        const char * end  = data + record.n_bytes;
+
+        if ( this->n_bits > 0 )
+        {
+            for ( std::size_t idx = 0; idx < 2*this->nos; ++idx )
+            {
+                std::int64_t prediction = Predict( this->quantized, this->quantized_last,
+                                                   this->quantized_before_last, idx, n_since_keyframe );
+                this->quantized[idx] = static_cast<std::int32_t>( prediction + Unzigzag( Get_Varint( data, end ) ) );
+            }
+            std::swap( this->quantized_before_last, this->quantized_last );
+            std::swap( this->quantized_last, this->quantized );
+        }
+        else
+        {
+            for ( std::size_t i = 0; i < 3*this->nos; ++i )
+            {
+                std::uint64_t reference = n_since_keyframe == 0 ? 0 : this->raw[i];
+                this->raw[i] = reference ^ Get_Varint( data, end );
+            }
+        }
+    }
+
+    Trajectory_Frame Trajectory_Reader::Read_Frame( int idx_frame, vectorfield & spins )
+    {
+        Trajectory_Frame info = this->Get_Frame_Info( idx_frame );
+        if ( spins.size() < this->nos )
+            spirit_throw( Exception_Classifier::Unknown_Exception, Log_Level::Error,
+                          fmt::format( "Trajectory \"{}\" has {} spins, but only {} can be read",
+                                       this->filename, this->nos, spins.size() ) );
+
+        // Decode from the last keyframe, or continue from the currently decoded frame
+        int idx_start = idx_frame;
+        while ( idx_start > 0 && !this->frames[idx_start].keyframe )
+            --idx_start;
+        if ( !this->frames[idx_start].keyframe )
+            spirit_throw( Exception_Classifier::Bad_File_Content, Log_Level::Error,
+                          fmt::format( "Trajectory \"{}\" does not start with a keyframe", this->filename ) );
+        if ( this->idx_decoded >= idx_start && this->idx_decoded <= idx_frame )
+            idx_start = this->idx_decoded + 1;
+
+        try
+        {
+            for ( int idx = idx_start; idx <= idx_frame; ++idx )
+            {
+                if ( this->frames[idx].keyframe )
+                    this->n_since_keyframe_decoded = 0;
+                else
+                    ++this->n_since_keyframe_decoded;
+                this->Decode_Frame( this->frames[idx], this->n_since_keyframe_decoded );
+            }
+            this->idx_decoded = idx_frame;
+        }
+        catch( ... )
+        {
+            this->idx_decoded = -1;
+            spirit_rethrow( fmt::format( "Failed to read frame {} of trajectory \"{}\"", idx_frame, this->filename ) );
+        }
+
+        if ( this->n_bits > 0 )
+        {
+            scalar q_max = Max_Quantized( this->n_bits );
+            for ( std::size_t i = 0; i < this->nos; ++i )
+                spins[i] = Octahedral_Decode( this->quantized_last[2*i] / q_max, this->quantized_last[2*i+1] / q_max );
+        }
+        else
+        {
+            for ( std::size_t i = 0; i < this->nos; ++i )
+            {
+                for ( int c = 0; c < 3; ++c )
+                    spins[i][c] = static_cast<scalar>( Bits_Double( this->raw[3*i+c] ) );
+            }
+        }
+
+        return info;
+    }
+}
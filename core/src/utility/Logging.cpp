@@ -145,6 +145,7 @@ namespace Utility
         save_positions_final    = false;
         save_neighbours_initial = false;
         save_neighbours_final   = false;
+        messages_timings        = false;
         n_entries  = 0;
         n_errors   = 0;
         n_warnings = 0;
@@ -6,6 +6,9 @@
 
 #include <string>
 #include <sstream>
+#include <mutex>
+#include <algorithm>
+#include <cstring>
 
 namespace Utility
 {
@@ -103,5 +106,67 @@ namespace Utility
             // Return duration
             return duration<scalar>(chrono_seconds);
         }
+
+        // ------ Instrumentation -------------------------------------------
+
+        namespace
+        {
+            // The registry is created on first use, as counters may be constructed during
+            //      static initialisation
+            std::mutex & Registry_Mutex()
+            {
+                static std::mutex mutex;
+                return mutex;
+            }
+
+            std::vector<Counter *> & Registry()
+            {
+                static std::vector<Counter *> counters;
+                return counters;
+            }
+        }
+
+        Counter::Counter(const char * name) : name(name), nanoseconds(0), calls(0)
+        {
+            std::lock_guard<std::mutex> guard(Registry_Mutex());
+            Registry().push_back(this);
+        }
+
+        std::vector<Counter_Value> Get_Counters()
+        {
+            std::vector<Counter_Value> values;
+            {
+                std::lock_guard<std::mutex> guard(Registry_Mutex());
+                for (auto counter : Registry())
+                {
+                    std::int64_t calls = counter->calls.load(std::memory_order_relaxed);
+                    if (calls > 0)
+                        values.push_back({ counter->name, 1e-9 * counter->nanoseconds.load(std::memory_order_relaxed), calls });
+                }
+            }
+            std::sort(values.begin(), values.end(), [](const Counter_Value & a, const Counter_Value & b)
+                { return std::strcmp(a.name, b.name) < 0; });
+            return values;
+        }
+
+        void Reset_Counters()
+        {
+            std::lock_guard<std::mutex> guard(Registry_Mutex());
+            for (auto counter : Registry())
+            {
+                counter->nanoseconds.store(0, std::memory_order_relaxed);
+                counter->calls.store(0, std::memory_order_relaxed);
+            }
+        }
+
+        std::vector<std::string> Counters_Table()
+        {
+            std::vector<std::string> table;
+            table.push_back(fmt::format("    {:<44} {:>12} {:>12} {:>12}", "Timings", "total [s]", "calls", "per call [s]"));
+            for (auto & value : Get_Counters())
+                table.push_back(fmt::format("    {:<44} {:>12.6f} {:>12} {:>12.3e}",
+                    value.name, value.seconds, value.calls, value.seconds / value.calls));
+            return table;
+        }
     }
 }
\ No newline at end of file
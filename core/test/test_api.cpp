@@ -5,9 +5,16 @@
 #include <Spirit/System.h>
 #include <Spirit/Configurations.h>
 #include <Spirit/Quantities.h>
+#include <Spirit/Hamiltonian.h>
+#include <Spirit/Parameters.h>
 #include <Spirit/Simulation.h>
+#include <Spirit/Geometry.h>
 #include <utility/Exception.hpp>
 
+#include <thread>
+#include <atomic>
+#include <vector>
+
 auto inputfile = "core/test/input/api.cfg";
 
 TEST_CASE( "State", "[state]" )
@@ -172,4 +179,194 @@ TEST_CASE( "Quantities", "[quantities]" )
 			REQUIRE(charge == Approx(1));
 		}
 	}
-}
\ No newline at end of file
+}
+
+TEST_CASE( "Observables", "[observables]" )
+{
+	// The energy is calculated lazily by System_Get_Energy and explicitly by System_Update_Data
+	auto state = std::shared_ptr<State>(State_Setup(inputfile), State_Delete);
+	float anisotropy_normal[3]{ 1,0,0 };
+	Hamiltonian_Set_Anisotropy(state.get(), 1, anisotropy_normal);
+
+	Configuration_PlusZ(state.get());
+	float E_plusz = System_Get_Energy(state.get());
+
+	SECTION("Configuration changed")
+	{
+		Configuration_Skyrmion(state.get(), 6.0, 1.0, -90.0, false, false, false);
+		float E_lazy = System_Get_Energy(state.get());
+		System_Update_Data(state.get());
+		REQUIRE(System_Get_Energy(state.get()) == E_lazy);
+		REQUIRE(E_lazy != E_plusz);
+	}
+	SECTION("Hamiltonian changed")
+	{
+		float normal[3]{ 0,0,1 };
+		Hamiltonian_Set_Field(state.get(), 5, normal);
+		float E_lazy = System_Get_Energy(state.get());
+		System_Update_Data(state.get());
+		REQUIRE(System_Get_Energy(state.get()) == E_lazy);
+		REQUIRE(E_lazy != E_plusz);
+	}
+	SECTION("Iterations")
+	{
+		Configuration_Skyrmion(state.get(), 6.0, 1.0, -90.0, false, false, false);
+		float E_skyrmion = System_Get_Energy(state.get());
+		Parameters_Set_LLG_Output_General(state.get(), false, false, false);
+		Simulation_PlayPause(state.get(), "LLG", "VP", 10);
+		float E_lazy = System_Get_Energy(state.get());
+		float m[3];
+		Quantity_Get_Magnetization(state.get(), m);
+		System_Update_Data(state.get());
+		REQUIRE(System_Get_Energy(state.get()) == E_lazy);
+		REQUIRE(E_lazy < E_skyrmion);
+	}
+}
+
+TEST_CASE( "Spin directions", "[observables]" )
+{
+	// Writing through the pointer to the spins has to invalidate the cached observables
+	auto state = std::shared_ptr<State>(State_Setup(inputfile), State_Delete);
+	int nos = System_Get_NOS(state.get());
+	float normal[3]{ 0,0,1 };
+	Hamiltonian_Set_Field(state.get(), 5, normal);
+
+	Configuration_PlusZ(state.get());
+	float m[3];
+	Quantity_Get_Magnetization(state.get(), m);
+	float E_plusz = System_Get_Energy(state.get());
+	REQUIRE(m[2] == Approx(1));
+
+	scalar * spins = System_Get_Spin_Directions(state.get());
+	for (int i=0; i<nos; ++i)
+		spins[3*i+2] = -1;
+	Quantity_Get_Magnetization(state.get(), m);
+	float E_minusz = System_Get_Energy(state.get());
+	REQUIRE(m[2] == Approx(-1));
+	REQUIRE(E_minusz > E_plusz);
+
+	// Writing through a kept pointer needs an explicit invalidation
+	for (int i=0; i<nos; ++i)
+		spins[3*i+2] = 1;
+	System_Spins_Changed(state.get());
+	Quantity_Get_Magnetization(state.get(), m);
+	REQUIRE(m[2] == Approx(1));
+	REQUIRE(System_Get_Energy(state.get()) == E_plusz);
+}
+
+TEST_CASE( "Spin snapshot", "[snapshot]" )
+{
+	auto state = std::shared_ptr<State>(State_Setup(inputfile), State_Delete);
+	int nos = System_Get_NOS(state.get());
+	std::vector<scalar> spins(3*nos);
+
+	// Without a running simulation, the snapshot follows the configuration
+	Configuration_PlusZ(state.get());
+	REQUIRE(System_Get_Spin_Snapshot(state.get(), spins.data()) == 0);
+	REQUIRE(spins[3*nos-1] == 1);
+
+	// A homogeneous state precessing in a homogeneous field stays homogeneous,
+	// so any snapshot which is read during the simulation has to consist of identical spins
+	float direction[3]{ 1,0,1 };
+	Configuration_Domain(state.get(), direction);
+	float normal[3]{ 0,0,1 };
+	Hamiltonian_Set_Field(state.get(), 5, normal);
+	Parameters_Set_LLG_Output_General(state.get(), false, false, false);
+	Parameters_Set_LLG_Damping(state.get(), 0.1);
+	Parameters_Set_LLG_Convergence(state.get(), 0);
+	System_Set_Snapshot_Interval(state.get(), 5);
+
+	std::atomic<bool> finished(false);
+	std::thread simulation([&]()
+	{
+		Simulation_PlayPause(state.get(), "LLG", "Depondt", 500);
+		finished = true;
+	});
+
+	int iteration_last = 0;
+	while (!finished)
+	{
+		int iteration = System_Get_Spin_Snapshot(state.get(), spins.data());
+		REQUIRE(iteration >= iteration_last);
+		iteration_last = iteration;
+		for (int i=1; i<nos; ++i)
+		{
+			for (int dim=0; dim<3; ++dim)
+				REQUIRE(spins[3*i+dim] == spins[dim]);
+		}
+		// The magnetization is calculated from a snapshot, i.e. from identical spins
+		float m[3];
+		Quantity_Get_Magnetization(state.get(), m);
+		REQUIRE(m[0]*m[0] + m[1]*m[1] + m[2]*m[2] == Approx(1));
+	}
+	simulation.join();
+
+	// The final state is published at the end
+	REQUIRE(System_Get_Spin_Snapshot(state.get(), spins.data()) == 500);
+	scalar * spins_live = System_Get_Spin_Directions(state.get());
+	for (int i=0; i<3*nos; ++i)
+		REQUIRE(spins[i] == spins_live[i]);
+}
+
+TEST_CASE( "Shared geometry", "[state]" )
+{
+	auto state = std::shared_ptr<State>(State_Setup(inputfile), State_Delete);
+	Chain_Image_to_Clipboard(state.get());
+	Chain_Push_Back(state.get());
+	Chain_Push_Back(state.get());
+	auto& images = state->active_chain->images;
+	REQUIRE(images.size() == 3);
+
+	// The images share the geometry, but not the spins
+	for (int i=1; i<3; ++i)
+	{
+		REQUIRE(images[i]->geometry == images[0]->geometry);
+		REQUIRE(images[i]->spins != images[0]->spins);
+	}
+
+	// Changing the interactions of one image does not affect the others
+	for (int i=0; i<3; ++i)
+		Configuration_PlusZ(state.get(), defaultPos, defaultRect, -1, -1, false, i);
+	float E_initial = System_Get_Energy(state.get(), 0);
+	REQUIRE(System_Get_Energy(state.get(), 1) == E_initial);
+	float jij[1]{ 5 };
+	Hamiltonian_Set_Exchange(state.get(), 1, jij, 1);
+	REQUIRE(System_Get_Energy(state.get(), 0) == E_initial);
+	REQUIRE(System_Get_Energy(state.get(), 2) == E_initial);
+	REQUIRE(System_Get_Energy(state.get(), 1) != E_initial);
+
+	// A new geometry is shared again by all images
+	int n_cells[3]{ 10, 10, 1 };
+	Geometry_Set_N_Cells(state.get(), n_cells);
+	for (auto& image : images)
+	{
+		REQUIRE(image->geometry == images[0]->geometry);
+		REQUIRE(image->nos == 100);
+		REQUIRE(image->spins->size() == 100);
+	}
+	REQUIRE(System_Get_Energy(state.get(), 0) == System_Get_Energy(state.get(), 2));
+	REQUIRE(System_Get_Energy(state.get(), 1) != System_Get_Energy(state.get(), 0));
+
+	// The pinning is moved to the new geometry as well
+	for (int i=0; i<3; ++i)
+	{
+		REQUIRE(images[i]->llg_parameters->pinning->mask_unpinned.size() == 100);
+		Configuration_PlusZ(state.get(), defaultPos, defaultRect, -1, -1, false, i);
+	}
+
+	// The triangulations of the shared geometry can be retrieved concurrently and are
+	// calculated only once per n_cell_step
+	std::vector<const int *> indices(4, nullptr);
+	std::vector<int> n_triangles(4, 0);
+	std::vector<std::thread> threads;
+	for (int t=0; t<4; ++t)
+		threads.emplace_back([&, t]() {
+			n_triangles[t] = Geometry_Get_Triangulation(state.get(), &indices[t], 1 + t%2, t%3);
+		});
+	for (auto& thread : threads)
+		thread.join();
+	REQUIRE(n_triangles[0] > n_triangles[1]);
+	REQUIRE(n_triangles[1] > 0);
+	REQUIRE(indices[2] == indices[0]);
+	REQUIRE(indices[3] == indices[1]);
+}
@@ -1,14 +1,19 @@
 #include <catch.hpp>
 #include <io/IO.hpp>
+#include <io/Trajectory.hpp>
 #include <Spirit/State.h>
 #include <Spirit/Configurations.h>
 #include <Spirit/System.h>
 #include <Spirit/Chain.h>
+#include <data/State.hpp>
 #include <utility>
 #include <vector>
 #include <iostream>
 #include <algorithm>
 #include <string>
+#include <fstream>
+#include <cstdio>
+#include <cmath>
 
 const char inputfile[] = "core/test/input/fd_pairs.cfg";
 
@@ -167,6 +172,41 @@ TEST_CASE( "IO-CHAIN-READ", "[io-chain]" )
     }
 }
 
+TEST_CASE( "IO-OVF-RANDOM-ACCESS", "[io-chain]" )
+{
+    // Segments of an OVF file can be read in any order and have to match a sequential read
+    auto state = std::shared_ptr<State>( State_Setup( inputfile ), State_Delete );
+    auto state_single = std::shared_ptr<State>( State_Setup( inputfile ), State_Delete );
+
+    std::vector<std::string> filenames { 
+        "core/test/io_test_files/chain_ovf_bin_4.ovf",
+        "core/test/io_test_files/chain_ovf_bin_8.ovf",
+        "core/test/io_test_files/chain_ovf_csv.ovf",
+        "core/test/io_test_files/chain_ovf_txt.ovf"
+    };
+
+    int nos = System_Get_NOS( state.get() );
+
+    for ( auto file : filenames )
+    {
+        INFO( "IO random access " + file );
+        IO_Chain_Read( state.get(), file.c_str() );
+        int noi = Chain_Get_NOI( state.get() );
+        REQUIRE( noi == 3 );
+
+        for ( int idx_segment : { 2, 0, 1 } )
+        {
+            IO_Image_Read( state_single.get(), file.c_str(), idx_segment );
+            scalar * spins_single = System_Get_Spin_Directions( state_single.get() );
+            scalar * spins_chain  = System_Get_Spin_Directions( state.get(), idx_segment );
+            for ( int i = 0; i < 3*nos; ++i )
+                REQUIRE( spins_single[i] == spins_chain[i] );
+        }
+
+        for ( int i = 0; i < (noi-1); i++ ) Chain_Pop_Back( state.get() );
+    }
+}
+
 TEST_CASE( "IO-OVF-CAPITALIZATION", "[io-ovf]")
 {
     // That test is checking that the IO_Image_Read() would deal properly with capitalization for 
@@ -327,3 +367,162 @@ TEST_CASE( "IO-INTERACTION-PAIRS", "[io-interactions-pairs]" )
     IO_Image_Write_Neighbours_Exchange( state.get(), "core/test/io_test_files/neighbours_J.dat" );
     IO_Image_Write_Neighbours_DMI( state.get(), "core/test/io_test_files/neighbours_DMI.dat" );
 }
+
+TEST_CASE( "IO-OUTPUT-QUEUE", "[io-output-queue]" )
+{
+    // Writes to the same file may be queued, but have to arrive on disk in order
+    std::string file = "core/test/io_test_files/output_queue.txt";
+    int n_lines = 200;
+
+    IO::Dump_to_File( "line 0\n", file );
+    for ( int i = 1; i < n_lines; ++i )
+        IO::Dump_Append_to_File( "line " + std::to_string(i) + "\n", file );
+    IO::Flush_Output( file );
+
+    REQUIRE( IO::Output_File_Exists( file ) );
+
+    std::ifstream stream( file );
+    std::string line;
+    int i_line = 0;
+    while ( std::getline( stream, line ) )
+    {
+        REQUIRE( line == "line " + std::to_string(i_line) );
+        ++i_line;
+    }
+    REQUIRE( i_line == n_lines );
+
+    stream.close();
+    std::remove( file.c_str() );
+}
+
+TEST_CASE( "IO-TRAJECTORY", "[io-trajectory]" )
+{
+    std::string file = "core/test/io_test_files/trajectory.sptraj";
+    std::size_t nos = 1000;
+    int n_frames = 40;
+
+    // A slowly rotating spin spiral
+    auto frame = [nos]( int idx_frame )
+    {
+        vectorfield spins( nos );
+        for ( std::size_t i = 0; i < nos; ++i )
+        {
+            scalar theta = 0.05*i + 0.01*idx_frame;
+            scalar phi   = 0.02*i - 0.03*idx_frame;
+            spins[i] = { std::sin(theta)*std::cos(phi), std::sin(theta)*std::sin(phi), std::cos(theta) };
+        }
+        return spins;
+    };
+
+    SECTION( "Quantized" )
+    {
+        int n_bits = 16;
+        {
+            IO::Trajectory_Writer writer( file, nos, n_bits, 8 );
+            for ( int i = 0; i < n_frames; ++i )
+                writer.Write_Frame( frame(i), 10*i, -0.5*i );
+        }
+
+        IO::Trajectory_Reader reader( file );
+        REQUIRE( reader.Get_N_Frames() == n_frames );
+        REQUIRE( reader.Get_NOS() == nos );
+        REQUIRE( reader.Get_N_Bits() == n_bits );
+
+        // Much smaller than binary OVF with 8 bytes per component
+        std::ifstream stream( file, std::ios::binary | std::ios::ate );
+        REQUIRE( std::size_t( stream.tellg() ) * 8 < 3*sizeof(double)*nos*n_frames );
+        stream.close();
+
+        // Random access and sequential reading, with bounded angular error
+        vectorfield spins( nos );
+        for ( int idx_frame : { 37, 3, 4, 5, 39, 0 } )
+        {
+            auto info = reader.Read_Frame( idx_frame, spins );
+            REQUIRE( info.iteration == 10*idx_frame );
+            REQUIRE( info.energy == Approx( -0.5*idx_frame ) );
+
+            auto reference = frame( idx_frame );
+            for ( std::size_t i = 0; i < nos; ++i )
+            {
+                scalar angle = std::acos( std::min( scalar(1), spins[i].dot( reference[i] ) ) );
+                REQUIRE( angle < std::pow( 2.0, 3 - n_bits ) );
+            }
+        }
+    }
+
+    SECTION( "Lossless and appending" )
+    {
+        {
+            IO::Trajectory_Writer writer( file, nos, 0, 8 );
+            for ( int i = 0; i < n_frames; ++i )
+                writer.Write_Frame( frame(i), i, 0 );
+        }
+        {
+            IO::Trajectory_Writer writer( file, nos, 0, 8, true );
+            for ( int i = n_frames; i < n_frames + 5; ++i )
+                writer.Write_Frame( frame(i), i, 0 );
+        }
+
+        IO::Trajectory_Reader reader( file );
+        REQUIRE( reader.Get_N_Frames() == n_frames + 5 );
+
+        vectorfield spins( nos );
+        for ( int idx_frame : { n_frames + 2, 17, n_frames } )
+        {
+            auto info = reader.Read_Frame( idx_frame, spins );
+            REQUIRE( info.iteration == idx_frame );
+            auto reference = frame( idx_frame );
+            for ( std::size_t i = 0; i < nos; ++i )
+                REQUIRE( spins[i] == reference[i] );
+        }
+    }
+
+    std::remove( file.c_str() );
+}
+
+TEST_CASE( "IO-ENERGY-PER-SPIN", "[io-energy-per-spin]" )
+{
+    auto state = std::shared_ptr<State>( State_Setup( inputfile ), State_Delete );
+    Configuration_Random( state.get() );
+    auto& image = *state->active_image;
+    image.UpdateEnergy();
+
+    std::vector<std::pair<std::string, scalarfield>> contributions;
+    image.hamiltonian->Energy_Contributions_per_Spin( *image.spins, contributions );
+
+    std::vector<std::pair< std::string, IO::VF_FileFormat >> filetypes {
+        { "core/test/io_test_files/energy_per_spin_bin_8.ovf", IO::VF_FileFormat::OVF_BIN8 },
+        { "core/test/io_test_files/energy_per_spin_bin_4.ovf", IO::VF_FileFormat::OVF_BIN4 },
+        { "core/test/io_test_files/energy_per_spin_txt.ovf",   IO::VF_FileFormat::OVF_TEXT },
+        { "core/test/io_test_files/energy_per_spin_csv.ovf",   IO::VF_FileFormat::OVF_CSV  }
+    };
+
+    for ( auto file : filetypes )
+    {
+        INFO( "IO energy per spin " + file.first );
+
+        IO::Write_Image_Energy_per_Spin( image, file.first, false, true, file.second );
+        IO::Flush_Output( file.first );
+
+        std::vector<std::pair<std::string, scalarfield>> energies;
+        IO::Read_Image_Energy_per_Spin( file.first, *image.geometry, energies );
+
+        // The total energy comes first, followed by the contributions
+        REQUIRE( energies.size() == contributions.size() + 1 );
+        REQUIRE( energies[0].first == "E_tot" );
+        scalar epsilon = file.second == IO::VF_FileFormat::OVF_BIN4 ? 1e-5 : 1e-10;
+        for ( int ispin = 0; ispin < image.nos; ++ispin )
+        {
+            scalar E_spin = 0;
+            for ( std::size_t i = 0; i < contributions.size(); ++i )
+            {
+                REQUIRE( energies[i+1].first == contributions[i].first );
+                REQUIRE( energies[i+1].second[ispin] == Approx( contributions[i].second[ispin] ).epsilon( epsilon ) );
+                E_spin += contributions[i].second[ispin];
+            }
+            REQUIRE( energies[0].second[ispin] == Approx( E_spin ).epsilon( epsilon ) );
+        }
+
+        std::remove( file.first.c_str() );
+    }
+}
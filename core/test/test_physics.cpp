@@ -7,6 +7,8 @@
 #include <Spirit/Constants.h>
 #include <Spirit/Parameters.h>
 #include <data/State.hpp>
+#include <engine/Hamiltonian_Heisenberg.hpp>
+#include <engine/Eigenmodes.hpp>
 #include <Eigen/Dense>
 #include <Eigen/Core>
 #include <iostream>
@@ -113,5 +115,322 @@ TEST_CASE( "Finite Differences", "[physics]" )
         state->active_image->hamiltonian->Hessian( vf, hessian );
 
         REQUIRE( hessian_fd.isApprox( hessian ) );
+
+        // The sparse Hessian and the Hessian-vector product have to be consistent with the dense Hessian
+        auto sparse_hessian = SpMatrixX( 3*state->nos, 3*state->nos );
+        state->active_image->hamiltonian->Sparse_Hessian( vf, sparse_hessian );
+        REQUIRE( hessian_fd.isApprox( MatrixX( sparse_hessian ) ) );
+
+        auto vec = vectorfield( state->nos );
+        for( int i=0; i<state->nos; i++ )
+            vec[i] = Vector3::Random();
+        auto hvp = vectorfield( state->nos );
+        auto hvp_fd = vectorfield( state->nos );
+        state->active_image->hamiltonian->Hessian_Vector_Product( vf, vec, hvp );
+        state->active_image->hamiltonian->Hessian_Vector_Product_FD( vf, vec, hvp_fd );
+
+        VectorX vec_flat = VectorX::Map( vec[0].data(), 3*state->nos );
+        VectorX hvp_dense = hessian * vec_flat;
+        for( int i=0; i<state->nos; i++ )
+        {
+            REQUIRE( hvp_fd[i].isApprox( hvp[i] ) );
+            REQUIRE( hvp_dense.segment<3>( 3*i ).isApprox( hvp[i] ) );
+        }
+    }
+}
+
+TEST_CASE( "Hessian with Anisotropy and Quadruplets", "[physics]" )
+{
+    auto state = std::shared_ptr<State>( State_Setup( "core/test/input/fd_pairs.cfg" ), State_Delete );
+
+    float normal[3] = { 0.6, 0.0, 0.8 };
+    Hamiltonian_Set_Anisotropy( state.get(), 1.5, normal );
+
+    auto ham = std::dynamic_pointer_cast<Engine::Hamiltonian_Heisenberg>( state->active_image->hamiltonian );
+    REQUIRE( ham != nullptr );
+    ham->quadruplets.push_back( { 0, 0, 0, 0, {1,0,0}, {0,1,0}, {1,1,0} } );
+    ham->quadruplet_magnitudes.push_back( 2.0 );
+    ham->Update_Energy_Contributions();
+
+    Configuration_Random( state.get() );
+    auto& vf = *state->active_image->spins;
+
+    auto grad = vectorfield( state->nos );
+    auto grad_fd = vectorfield( state->nos );
+    ham->Gradient_FD( vf, grad_fd );
+    ham->Gradient( vf, grad );
+    for( int i=0; i<state->nos; i++ )
+        REQUIRE( grad_fd[i].isApprox( grad[i] ) );
+
+    auto hessian = MatrixX( 3*state->nos, 3*state->nos );
+    auto hessian_fd = MatrixX( 3*state->nos, 3*state->nos );
+    ham->Hessian_FD( vf, hessian_fd );
+    ham->Hessian( vf, hessian );
+    REQUIRE( hessian_fd.isApprox( hessian ) );
+
+    auto vec = vectorfield( state->nos );
+    for( int i=0; i<state->nos; i++ )
+        vec[i] = Vector3::Random();
+    // The quadruplet gradient is not linear, so the finite difference has a truncation error
+    // of the order of delta^2 = 1e-6 relative to the product
+    auto hvp = vectorfield( state->nos );
+    auto hvp_fd = vectorfield( state->nos );
+    ham->Hessian_Vector_Product( vf, vec, hvp );
+    ham->Hessian_Vector_Product_FD( vf, vec, hvp_fd );
+    for( int i=0; i<state->nos; i++ )
+        REQUIRE( hvp_fd[i].isApprox( hvp[i], 1e-5 ) );
+}
+
+TEST_CASE( "Minimum Mode", "[physics]" )
+{
+    auto state = std::shared_ptr<State>( State_Setup( "core/test/input/fd_pairs.cfg" ), State_Delete );
+
+    Configuration_Random( state.get() );
+    auto& vf = *state->active_image->spins;
+    auto& ham = *state->active_image->hamiltonian;
+    int nos = state->nos;
+
+    auto grad = vectorfield( nos );
+    ham.Gradient( vf, grad );
+
+    // Reference: dense Hessian in an orthonormal basis of the 2N-dimensional tangent space
+    MatrixX hessian = MatrixX::Zero( 3*nos, 3*nos );
+    ham.Hessian( vf, hessian );
+    for( int i=0; i<nos; i++ )
+        hessian.block<3,3>( 3*i, 3*i ) -= vf[i].dot( grad[i] ) * Matrix3::Identity();
+
+    MatrixX basis = MatrixX::Zero( 3*nos, 2*nos );
+    for( int i=0; i<nos; i++ )
+    {
+        Vector3 e1 = vf[i].cross( Vector3{ 1, 0, 0 } ).normalized();
+        Vector3 e2 = vf[i].cross( e1 );
+        basis.block<3,1>( 3*i, 2*i )   = e1;
+        basis.block<3,1>( 3*i, 2*i+1 ) = e2;
+    }
+    Eigen::SelfAdjointEigenSolver<MatrixX> solver( basis.transpose() * hessian * basis );
+    scalar eigenvalue_expected = solver.eigenvalues()[0];
+    VectorX mode_expected = basis * solver.eigenvectors().col( 0 );
+
+    // Matrix-free Lanczos, starting from a random vector
+    auto mode = vectorfield( nos, Vector3{ 0, 0, 0 } );
+    scalar eigenvalue = Engine::Eigenmodes::Lowest_Tangent_Eigenmode( ham, vf, grad, mode );
+
+    REQUIRE( eigenvalue == Approx( eigenvalue_expected ) );
+    VectorX mode_flat = VectorX::Map( mode[0].data(), 3*nos );
+    REQUIRE( std::abs( mode_flat.dot( mode_expected ) ) == Approx( 1 ) );
+
+    // Warm start from the converged mode
+    eigenvalue = Engine::Eigenmodes::Lowest_Tangent_Eigenmode( ham, vf, grad, mode );
+    REQUIRE( eigenvalue == Approx( eigenvalue_expected ) );
+
+    // A minimum mode following iteration has to keep the spins normalized
+    Simulation_SingleShot( state.get(), "MMF", "VP" );
+    for( int i=0; i<nos; i++ )
+        REQUIRE( vf[i].norm() == Approx( 1 ) );
+}
+
+TEST_CASE( "Single Spin Energy Difference", "[physics]" )
+{
+    // The local energy difference has to match the difference of the total energies
+    auto check_energy_diff = [] ( std::shared_ptr<Engine::Hamiltonian> ham, vectorfield & vf )
+    {
+        auto vf_new = vf;
+        for( unsigned int ispin=0; ispin<vf.size(); ispin++ )
+        {
+            Vector3 spin_new = Vector3::Random().normalized();
+            vf_new[ispin] = spin_new;
+            scalar Ediff = ham->Energy( vf_new ) - ham->Energy( vf );
+            REQUIRE( ham->Energy_Single_Spin_Diff( ispin, vf, spin_new ) == Approx( Ediff ) );
+
+            // The effective field is the part of the energy which is linear in the spin
+            Vector3 field = ham->Effective_Field_Single_Spin( ispin, vf );
+            scalar Ediff_odd = ham->Energy_Single_Spin_Diff( ispin, vf, spin_new ) - ham->Energy_Single_Spin_Diff( ispin, vf, -spin_new );
+            REQUIRE( std::abs( -2 * field.dot( spin_new ) - Ediff_odd ) < 1e-10 );
+            vf_new[ispin] = vf[ispin];
+        }
+    };
+
+    SECTION( "Exchange, DMI, Anisotropy and Quadruplets" )
+    {
+        auto state = std::shared_ptr<State>( State_Setup( "core/test/input/fd_pairs.cfg" ), State_Delete );
+
+        float normal[3] = { 0.6, 0.0, 0.8 };
+        Hamiltonian_Set_Anisotropy( state.get(), 1.5, normal );
+
+        auto ham = std::dynamic_pointer_cast<Engine::Hamiltonian_Heisenberg>( state->active_image->hamiltonian );
+        REQUIRE( ham != nullptr );
+        ham->quadruplets.push_back( { 0, 0, 0, 0, {1,0,0}, {0,1,0}, {1,1,0} } );
+        ham->quadruplet_magnitudes.push_back( 2.0 );
+        ham->Update_Interactions();
+
+        Configuration_Random( state.get() );
+        check_energy_diff( ham, *state->active_image->spins );
+    }
+
+    SECTION( "Dipole-Dipole Interaction" )
+    {
+        auto state = std::shared_ptr<State>( State_Setup( "core/test/input/physics_ddi.cfg" ), State_Delete );
+
+        auto ham = std::dynamic_pointer_cast<Engine::Hamiltonian_Heisenberg>( state->active_image->hamiltonian );
+        REQUIRE( ham != nullptr );
+
+        Configuration_Random( state.get() );
+        std::vector<intfield> boundary_conditions{ {0,0,0}, {1,1,0} };
+        std::vector<Engine::DDI_Method> methods{ Engine::DDI_Method::Cutoff, Engine::DDI_Method::FFT };
+        for( auto& bc : boundary_conditions )
+        {
+            for( auto method : methods )
+            {
+                INFO( "Boundary conditions " << bc[0] << " " << bc[1] << " " << bc[2] << ", method " << int(method) );
+                ham->boundary_conditions = bc;
+                ham->ddi_method = method;
+                ham->Update_Interactions();
+                check_energy_diff( ham, *state->active_image->spins );
+            }
+        }
+    }
+}
+
+TEST_CASE( "Energy and Gradient", "[physics]" )
+{
+    // The combined evaluation has to match the separate energy and gradient
+    auto check_energy_and_gradient = [] ( std::shared_ptr<Engine::Hamiltonian> ham, vectorfield & vf )
+    {
+        vectorfield grad( vf.size() ), grad_combined( vf.size() );
+        ham->Gradient( vf, grad );
+        scalar energy = ham->Energy_and_Gradient( vf, grad_combined );
+        REQUIRE( energy == Approx( ham->Energy( vf ) ) );
+        for( unsigned int i=0; i<vf.size(); i++ )
+            REQUIRE( (grad[i] - grad_combined[i]).norm() < 1e-10 );
+    };
+
+    SECTION( "Zeeman, Exchange, DMI, Anisotropy and Quadruplets" )
+    {
+        auto state = std::shared_ptr<State>( State_Setup( "core/test/input/fd_pairs.cfg" ), State_Delete );
+
+        float normal[3] = { 0.6, 0.0, 0.8 };
+        Hamiltonian_Set_Anisotropy( state.get(), 1.5, normal );
+        Hamiltonian_Set_Field( state.get(), 2.0, normal );
+
+        auto ham = std::dynamic_pointer_cast<Engine::Hamiltonian_Heisenberg>( state->active_image->hamiltonian );
+        REQUIRE( ham != nullptr );
+        ham->quadruplets.push_back( { 0, 0, 0, 0, {1,0,0}, {0,1,0}, {1,1,0} } );
+        ham->quadruplet_magnitudes.push_back( 2.0 );
+        ham->Update_Interactions();
+
+        Configuration_Random( state.get() );
+        check_energy_and_gradient( ham, *state->active_image->spins );
+    }
+
+    SECTION( "Dipole-Dipole Interaction" )
+    {
+        auto state = std::shared_ptr<State>( State_Setup( "core/test/input/physics_ddi.cfg" ), State_Delete );
+
+        auto ham = std::dynamic_pointer_cast<Engine::Hamiltonian_Heisenberg>( state->active_image->hamiltonian );
+        REQUIRE( ham != nullptr );
+
+        Configuration_Random( state.get() );
+        std::vector<intfield> boundary_conditions{ {0,0,0}, {1,1,0} };
+        std::vector<Engine::DDI_Method> methods{ Engine::DDI_Method::Cutoff, Engine::DDI_Method::FFT };
+        for( auto& bc : boundary_conditions )
+        {
+            for( auto method : methods )
+            {
+                INFO( "Boundary conditions " << bc[0] << " " << bc[1] << " " << bc[2] << ", method " << int(method) );
+                ham->boundary_conditions = bc;
+                ham->ddi_method = method;
+                ham->Update_Interactions();
+                check_energy_and_gradient( ham, *state->active_image->spins );
+            }
+        }
     }
 }
+
+TEST_CASE( "Dipole-Dipole Interaction", "[physics]" )
+{
+    // Input file (cutoff method)
+    auto inputfile = "core/test/input/physics_ddi.cfg";
+
+    // Create State
+    auto state = std::shared_ptr<State>( State_Setup( inputfile ), State_Delete );
+
+    Configuration_Random( state.get() );
+    auto& vf = *state->active_image->spins;
+
+    auto ham = std::dynamic_pointer_cast<Engine::Hamiltonian_Heisenberg>( state->active_image->hamiltonian );
+    REQUIRE( ham != nullptr );
+    REQUIRE( ham->ddi_method == Engine::DDI_Method::Cutoff );
+
+    // The FFT convolution with the same cutoff radius has to reproduce the direct summation,
+    // for open as well as periodic boundary conditions
+    std::vector<intfield> boundary_conditions{ {0,0,0}, {1,1,0} };
+    for( auto& bc : boundary_conditions )
+    {
+        INFO( "Boundary conditions " << bc[0] << " " << bc[1] << " " << bc[2] );
+
+        ham->boundary_conditions = bc;
+
+        auto grad_cutoff = vectorfield( state->nos );
+        auto grad_fft    = vectorfield( state->nos );
+        std::vector<std::pair<std::string, scalarfield>> contributions_cutoff, contributions_fft;
+
+        ham->ddi_method = Engine::DDI_Method::Cutoff;
+        ham->Update_DDI();
+        ham->Update_Energy_Contributions();
+        ham->Gradient( vf, grad_cutoff );
+        ham->Energy_Contributions_per_Spin( vf, contributions_cutoff );
+        scalar E_single_cutoff = ham->Energy_Single_Spin( 7, vf );
+
+        ham->ddi_method = Engine::DDI_Method::FFT;
+        ham->Update_DDI();
+        ham->Update_Energy_Contributions();
+        ham->Gradient( vf, grad_fft );
+        ham->Energy_Contributions_per_Spin( vf, contributions_fft );
+        scalar E_single_fft = ham->Energy_Single_Spin( 7, vf );
+
+        REQUIRE( contributions_cutoff.size() == contributions_fft.size() );
+        for( int i=0; i<state->nos; i++ )
+        {
+            REQUIRE( grad_fft[i].isApprox( grad_cutoff[i] ) );
+            for( unsigned int j=0; j<contributions_fft.size(); j++ )
+                REQUIRE( contributions_fft[j].second[i] == Approx( contributions_cutoff[j].second[i] ) );
+        }
+        REQUIRE( E_single_fft == Approx( E_single_cutoff ) );
+
+        // The FFT method has to give the same Hessian as the pairs of the cutoff method
+        SpMatrixX hessian_cutoff, hessian_fft;
+        ham->ddi_method = Engine::DDI_Method::Cutoff;
+        ham->Update_DDI();
+        ham->Sparse_Hessian( vf, hessian_cutoff );
+        ham->ddi_method = Engine::DDI_Method::FFT;
+        ham->Update_DDI();
+        ham->Sparse_Hessian( vf, hessian_fft );
+        REQUIRE( MatrixX( hessian_fft ).isApprox( MatrixX( hessian_cutoff ) ) );
+    }
+
+    // Without a cutoff, the FFT gradient has to be consistent with the energy
+    // (the finite difference energies are sums over all spins, so the precision is reduced)
+    ham->boundary_conditions = { 0, 0, 0 };
+    ham->ddi_method = Engine::DDI_Method::FFT;
+    ham->ddi_cutoff_radius = 0;
+    ham->Update_DDI();
+    ham->Update_Energy_Contributions();
+
+    auto grad = vectorfield( state->nos );
+    auto grad_fd = vectorfield( state->nos );
+    ham->Gradient_FD( vf, grad_fd );
+    ham->Gradient( vf, grad );
+    for( int i=0; i<state->nos; i++ )
+        REQUIRE( grad_fd[i].isApprox( grad[i], 1e-8 ) );
+
+    // The sparse Hessian has to include the same DDI as the Hessian-vector product
+    SpMatrixX hessian;
+    ham->Sparse_Hessian( vf, hessian );
+    auto vec = vectorfield( state->nos );
+    for( int i=0; i<state->nos; i++ )
+        vec[i] = Vector3::Random();
+    auto hvp = vectorfield( state->nos );
+    ham->Hessian_Vector_Product( vf, vec, hvp );
+    VectorX hvp_sparse = hessian * VectorX::Map( vec[0].data(), 3*state->nos );
+    REQUIRE( VectorX::Map( hvp[0].data(), 3*state->nos ).isApprox( hvp_sparse ) );
+}
@@ -8,7 +8,14 @@
 #include <Spirit/System.h>
 #include <Spirit/Chain.h>
 #include <Spirit/Quantities.h>
+#include <Spirit/Hamiltonian.h>
+#include <data/State.hpp>
+#include <engine/Method_LLG.hpp>
+#include <utility/Constants.hpp>
+#include <cmath>
 #include <iostream>
+#include <string>
+#include <map>
 
 TEST_CASE( "Solvers testing", "[solvers]" )
 {
@@ -22,7 +29,7 @@ TEST_CASE( "Solvers testing", "[solvers]" )
     auto method = "LLG";
     
     // Solvers to be tested
-    std::vector<const char *>  solvers { "VP", "Heun", "SIB", "Depondt" };
+    std::vector<const char *>  solvers { "VP", "BFGS", "Heun", "SIB", "Depondt" };
     
     // Expected values
     float energy_expected = -5849.69140625f;
@@ -89,8 +96,9 @@ TEST_CASE( "Solvers testing", "[solvers]" )
     // GNEB calculation test
     method = "GNEB";
 
-    // Solvers to be tested
-    solvers = { "VP", "Heun", "Depondt" };
+    // Solvers to be tested, where the last one evaluates the images concurrently
+    solvers = { "VP", "BFGS", "Heun", "Depondt", "VP" };
+    std::vector<int> threads_per_image{ 0, 0, 0, 0, 1 };
 
     // Expected values
     float energy_sp_expected = -5811.5244140625f;
@@ -101,8 +109,11 @@ TEST_CASE( "Solvers testing", "[solvers]" )
     std::vector<float> magnetization_sp{ 0, 0, 0 };
 
     // Calculate energy and magnetization at saddle point for every solver
-    for ( auto solver : solvers )
+    for ( unsigned int i_solver = 0; i_solver < solvers.size(); ++i_solver )
     {
+        auto solver = solvers[i_solver];
+        Parameters_Set_GNEB_Threads_Per_Image( state.get(), threads_per_image[i_solver] );
+
         // Create a skyrmion collapse transition
         Chain_Replace_Image(state.get(), 0);
         Chain_Jump_To_Image(state.get(), noi-1);
@@ -127,7 +138,7 @@ TEST_CASE( "Solvers testing", "[solvers]" )
         Quantity_Get_Magnetization( state.get(), magnetization_sp.data(), i_max );
             
         // Log the name of the solver
-        INFO( solver << std::string( " solver using " ) << method );
+        INFO( solver << std::string( " solver using " ) << method << ", threads per image: " << threads_per_image[i_solver] );
         
         // Check the values of energy and magnetization
         REQUIRE( energy_sp == Approx( energy_sp_expected ) );
@@ -135,4 +146,302 @@ TEST_CASE( "Solvers testing", "[solvers]" )
             REQUIRE( magnetization_sp[dim] == Approx( magnetization_sp_expected[dim] ) );
     }
 
-}
\ No newline at end of file
+}
+
+TEST_CASE( "Monte Carlo", "[solvers]" )
+{
+    auto state = std::shared_ptr<State>( State_Setup( "core/test/input/solvers.cfg" ), State_Delete );
+
+    Parameters_Set_MC_Output_General( state.get(), false, false, false );
+    Parameters_Set_MC_N_Iterations( state.get(), 20, 20 );
+    Parameters_Set_MC_Temperature( state.get(), 0 );
+
+    // Random sampling and the (parallel) sweep over colour classes
+    for( int algorithm : { MC_Algorithm_Metropolis, MC_Algorithm_Heat_Bath } )
+    for( bool random_sample : { true, false } )
+    {
+        INFO( "MC algorithm: " << algorithm << ", random sample: " << random_sample );
+        Parameters_Set_MC_Algorithm( state.get(), algorithm );
+        Parameters_Set_MC_Random_Sample( state.get(), random_sample );
+
+        // At zero temperature the algorithms can only lower the energy
+        Configuration_Random( state.get() );
+        System_Update_Data( state.get() );
+        float energy_initial = System_Get_Energy( state.get() );
+
+        Simulation_PlayPause( state.get(), "MC", "" );
+
+        System_Update_Data( state.get() );
+        float energy_final = System_Get_Energy( state.get() );
+        REQUIRE( energy_final < energy_initial );
+
+        // The spins have to stay normalized
+        int nos = System_Get_NOS( state.get() );
+        auto spins = System_Get_Spin_Directions( state.get() );
+        for( int i=0; i<nos; i++ )
+        {
+            float norm = std::sqrt( spins[3*i]*spins[3*i] + spins[3*i+1]*spins[3*i+1] + spins[3*i+2]*spins[3*i+2] );
+            REQUIRE( norm == Approx( 1 ) );
+        }
+    }
+}
+
+TEST_CASE( "Monte Carlo Paramagnet", "[solvers]" )
+{
+    auto state = std::shared_ptr<State>( State_Setup( "core/test/input/solvers.cfg" ), State_Delete );
+
+    // Non-interacting spins in an external field
+    Hamiltonian_Set_Exchange( state.get(), 0, nullptr );
+    Hamiltonian_Set_DMI( state.get(), 0, nullptr );
+    float normal[3] = { 0, 0, 1 };
+    Hamiltonian_Set_Field( state.get(), 1, normal );
+    float mu_s;
+    Hamiltonian_Get_mu_s( state.get(), &mu_s );
+
+    scalar temperature = 1;
+    Parameters_Set_MC_Output_General( state.get(), false, false, false );
+    Parameters_Set_MC_Temperature( state.get(), temperature );
+
+    // The thermal average of the magnetization is given by the Langevin function
+    scalar x = mu_s * Utility::Constants::mu_B / ( Utility::Constants::k_B * temperature );
+    scalar langevin = 1/std::tanh(x) - 1/x;
+
+    for( int algorithm : { MC_Algorithm_Metropolis, MC_Algorithm_Heat_Bath } )
+    {
+        INFO( "MC algorithm: " << algorithm );
+        Parameters_Set_MC_Algorithm( state.get(), algorithm );
+        Configuration_PlusZ( state.get() );
+
+        // Thermalize
+        Parameters_Set_MC_N_Iterations( state.get(), 50, 50 );
+        Simulation_PlayPause( state.get(), "MC", "" );
+
+        // Average over sweeps
+        int n_samples = 100;
+        scalar m_z = 0;
+        Parameters_Set_MC_N_Iterations( state.get(), 2, 2 );
+        for( int i=0; i<n_samples; i++ )
+        {
+            Simulation_PlayPause( state.get(), "MC", "" );
+            float m[3];
+            Quantity_Get_Magnetization( state.get(), m );
+            m_z += m[2] / n_samples;
+        }
+        REQUIRE( std::abs( m_z - langevin ) < 0.02 );
+    }
+}
+
+TEST_CASE( "LLG fused kernel", "[solvers]" )
+{
+    auto state = std::shared_ptr<State>( State_Setup( "core/test/input/solvers.cfg" ), State_Delete );
+    Configuration_Random( state.get() );
+
+    auto& system     = *state->active_image;
+    auto& spins      = *system.spins;
+    auto& parameters = *system.llg_parameters;
+    auto& geometry   = *system.geometry;
+    auto& boundary_conditions = system.hamiltonian->boundary_conditions;
+    int nos = system.nos;
+
+    vectorfield force(nos), xi(nos), s_c_grad(nos);
+    scalarfield temperature_distribution(nos);
+    vectorfield force_virtual_passes(nos), force_virtual_fused(nos);
+    system.hamiltonian->Gradient( spins, force );
+    for( auto& f : force )
+        f = -f;
+
+    float normal[3]    = { 1, 0, 0 };
+    float direction[3] = { 1, 1, 0 };
+    Parameters_Set_LLG_Damping( state.get(), 0.3 );
+
+    // Each combination of the terms of the virtual force, given as
+    //      { direct minimization, STT magnitude, STT gradient, temperature, temperature gradient }
+    struct Terms { bool direct; float stt; bool stt_gradient; float temperature; float inclination; };
+    std::vector<Terms> combinations{
+        { true,  0,   false, 0,  0   },
+        { true,  0.5, true,  10, 0.5 },
+        { false, 0,   false, 0,  0   },
+        { false, 0.5, false, 0,  0   },
+        { false, 0.5, true,  0,  0   },
+        { false, 0,   false, 10, 0   },
+        { false, 0,   false, 5,  0.5 },
+        { false, 0,   false, 0,  -0.5 },
+        { false, 0.5, true,  10, 0.5 } };
+
+    for( auto& terms : combinations )
+    {
+        INFO( "direct: " << terms.direct << ", STT: " << terms.stt << " gradient: " << terms.stt_gradient
+            << ", T: " << terms.temperature << " inclination: " << terms.inclination );
+        Parameters_Set_LLG_STT( state.get(), terms.stt_gradient, terms.stt, normal );
+        Parameters_Set_LLG_Temperature( state.get(), terms.temperature );
+        Parameters_Set_LLG_Temperature_Gradient( state.get(), terms.inclination, direction );
+
+        Engine::LLG::Force_Virtual_Passes( parameters, geometry, boundary_conditions, spins, force,
+            terms.direct, 42, xi, s_c_grad, temperature_distribution, force_virtual_passes );
+        Engine::LLG::Force_Virtual_Fused( parameters, geometry, boundary_conditions, spins, force,
+            terms.direct, 42, s_c_grad, force_virtual_fused );
+
+        for( int i=0; i<nos; ++i )
+        {
+            INFO( "i = " << i << ", passes = " << force_virtual_passes[i].transpose()
+                << ", fused = " << force_virtual_fused[i].transpose() );
+            REQUIRE( (force_virtual_passes[i] - force_virtual_fused[i]).norm() <= 1e-12 * (1 + force_virtual_passes[i].norm()) );
+        }
+    }
+}
+
+TEST_CASE( "Resumed methods", "[solvers]" )
+{
+    // Repeated short runs of a method continue from its state (iteration count, solver
+    // temporaries and random numbers), so that they reproduce a single long run
+    auto state_long  = std::shared_ptr<State>( State_Setup( "core/test/input/solvers.cfg" ), State_Delete );
+    auto state_short = std::shared_ptr<State>( State_Setup( "core/test/input/solvers.cfg" ), State_Delete );
+    int nos = System_Get_NOS( state_long.get() );
+
+    std::vector<std::pair<const char *, const char *>> methods{ { "LLG", "VP" }, { "LLG", "Depondt" }, { "MC", "" } };
+    for( auto& method : methods )
+    {
+        INFO( "Method: " << method.first << ", solver: " << method.second );
+        for( auto state : { state_long.get(), state_short.get() } )
+        {
+            Parameters_Set_LLG_Output_General( state, false, false, false );
+            Parameters_Set_MC_Output_General( state, false, false, false );
+            Configuration_PlusZ( state );
+            Configuration_Skyrmion( state, 5, 1, -90, false, false, false );
+        }
+
+        Simulation_PlayPause( state_long.get(), method.first, method.second, 24 );
+        for( int i=0; i<5; ++i )
+            Simulation_PlayPause( state_short.get(), method.first, method.second, 4 );
+        for( int i=0; i<4; ++i )
+            Simulation_SingleShot( state_short.get(), method.first, method.second );
+
+        // The short runs continued the iteration count
+        std::vector<scalar> snapshot( 3*nos );
+        REQUIRE( System_Get_Spin_Snapshot( state_long.get(), snapshot.data() ) == 24 );
+        REQUIRE( System_Get_Spin_Snapshot( state_short.get(), snapshot.data() ) == 24 );
+
+        auto spins_long  = System_Get_Spin_Directions( state_long.get() );
+        auto spins_short = System_Get_Spin_Directions( state_short.get() );
+        for( int i=0; i<3*nos; ++i )
+            REQUIRE( spins_short[i] == Approx( spins_long[i] ).epsilon( 1e-10 ) );
+
+        // A modified configuration starts a new run
+        Configuration_Skyrmion( state_short.get(), 3, 1, -90, false, false, false );
+        Simulation_PlayPause( state_short.get(), method.first, method.second, 2 );
+        REQUIRE( System_Get_Spin_Snapshot( state_short.get(), snapshot.data() ) == 2 );
+    }
+}
+
+TEST_CASE( "Timings", "[solvers]" )
+{
+    // The wall time and number of calls of the Hamiltonian terms and solver phases are accumulated
+    auto state = std::shared_ptr<State>( State_Setup( "core/test/input/solvers.cfg" ), State_Delete );
+    Parameters_Set_LLG_Output_General( state.get(), false, false, false );
+    Configuration_PlusZ( state.get() );
+    Configuration_Skyrmion( state.get(), 5, 1, -90, false, false, false );
+
+    Simulation_Reset_Timings( state.get() );
+    Simulation_PlayPause( state.get(), "LLG", "Heun", 10 );
+
+    int n_timings = Simulation_Get_N_Timings( state.get() );
+    REQUIRE( n_timings > 0 );
+    std::vector<const char *> names( n_timings );
+    std::vector<float> seconds( n_timings );
+    std::vector<int> calls( n_timings );
+    REQUIRE( Simulation_Get_Timings( state.get(), names.data(), seconds.data(), calls.data(), n_timings ) == n_timings );
+
+    std::map<std::string, int> calls_by_name;
+    for( int i=0; i<n_timings; ++i )
+    {
+        REQUIRE( seconds[i] >= 0 );
+        calls_by_name[names[i]] = calls[i];
+    }
+    REQUIRE( calls_by_name["Method/Iteration"] == 10 );
+    // Two force calculations per Heun iteration and one on the creation of the method
+    REQUIRE( calls_by_name["LLG/Force"] == 21 );
+    REQUIRE( calls_by_name["Hamiltonian/Gradient/Exchange"] >= 21 );
+    REQUIRE( calls_by_name["Hamiltonian/Gradient/DMI"] >= 21 );
+    REQUIRE( calls_by_name["Solver/Heun/Predictor"] == 10 );
+    REQUIRE( calls_by_name["Solver/Heun/Corrector"] == 10 );
+
+    Simulation_Reset_Timings( state.get() );
+    REQUIRE( Simulation_Get_N_Timings( state.get() ) == 0 );
+}
+
+TEST_CASE( "Amortized control checks", "[solvers]" )
+{
+    // The length of the blocks of iterations between the checks of the stop file and walltime
+    // does not change the result, the iteration count or the log steps
+    auto state_single  = std::shared_ptr<State>( State_Setup( "core/test/input/solvers.cfg" ), State_Delete );
+    auto state_blocked = std::shared_ptr<State>( State_Setup( "core/test/input/solvers.cfg" ), State_Delete );
+    int nos = System_Get_NOS( state_single.get() );
+    Parameters_Set_LLG_N_Iterations_Amortize( state_single.get(), 1 );
+    Parameters_Set_LLG_N_Iterations_Amortize( state_blocked.get(), 64 );
+    REQUIRE( Parameters_Get_LLG_N_Iterations_Amortize( state_blocked.get() ) == 64 );
+
+    for( auto state : { state_single.get(), state_blocked.get() } )
+    {
+        Parameters_Set_LLG_Output_General( state, false, false, false );
+        Parameters_Set_LLG_N_Iterations( state, 50, 7 );
+        Configuration_PlusZ( state );
+        Configuration_Skyrmion( state, 5, 1, -90, false, false, false );
+
+        Simulation_Reset_Timings( state );
+        Simulation_PlayPause( state, "LLG", "Depondt" );
+        std::vector<scalar> snapshot( 3*nos );
+        REQUIRE( System_Get_Spin_Snapshot( state, snapshot.data() ) == 50 );
+
+        std::map<std::string, int> calls_by_name;
+        int n_timings = Simulation_Get_N_Timings( state );
+        std::vector<const char *> names( n_timings );
+        std::vector<float> seconds( n_timings );
+        std::vector<int> calls( n_timings );
+        Simulation_Get_Timings( state, names.data(), seconds.data(), calls.data(), n_timings );
+        for( int i=0; i<n_timings; ++i )
+            calls_by_name[names[i]] = calls[i];
+        REQUIRE( calls_by_name["Method/Iteration"] == 50 );
+        // Log steps at iterations 7, 14, ..., 49 and the final save
+        REQUIRE( calls_by_name["Method/Save"] == 8 );
+    }
+
+    auto spins_single  = System_Get_Spin_Directions( state_single.get() );
+    auto spins_blocked = System_Get_Spin_Directions( state_blocked.get() );
+    for( int i=0; i<3*nos; ++i )
+        REQUIRE( spins_blocked[i] == Approx( spins_single[i] ).epsilon( 1e-10 ) );
+}
+
+TEST_CASE( "L-BFGS convergence", "[solvers]" )
+{
+    // The L-BFGS solver relaxes a skyrmion to the same minimum with far fewer force calculations than VP
+    auto state = std::shared_ptr<State>( State_Setup( "core/test/input/solvers.cfg" ), State_Delete );
+    Parameters_Set_LLG_Output_General( state.get(), false, false, false );
+
+    std::map<std::string, int> iterations;
+    std::map<std::string, scalar> energies;
+    for( auto solver : { "VP", "BFGS" } )
+    {
+        Configuration_PlusZ( state.get() );
+        Configuration_Skyrmion( state.get(), 5, 1, -90, false, false, false );
+
+        Simulation_Reset_Timings( state.get() );
+        Simulation_PlayPause( state.get(), "LLG", solver );
+
+        int n_timings = Simulation_Get_N_Timings( state.get() );
+        std::vector<const char *> names( n_timings );
+        std::vector<float> seconds( n_timings );
+        std::vector<int> calls( n_timings );
+        Simulation_Get_Timings( state.get(), names.data(), seconds.data(), calls.data(), n_timings );
+        for( int i=0; i<n_timings; ++i )
+        {
+            if( std::string( names[i] ) == "Method/Iteration" )
+                iterations[solver] = calls[i];
+        }
+        energies[solver] = System_Get_Energy( state.get() );
+    }
+
+    INFO( "Iterations VP: " << iterations["VP"] << ", BFGS: " << iterations["BFGS"] );
+    REQUIRE( energies["BFGS"] == Approx( energies["VP"] ) );
+    REQUIRE( iterations["BFGS"] > 0 );
+    REQUIRE( 4 * iterations["BFGS"] < iterations["VP"] );
+}
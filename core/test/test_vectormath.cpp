@@ -1,6 +1,8 @@
 #include <catch.hpp>
 #include <engine/Vectormath_Defines.hpp>
 #include <engine/Vectormath.hpp>
+#include <engine/Philox.hpp>
+#include <Eigen/Dense>
 
 
 TEST_CASE( "Vectormath operations", "[vectormath]" )
@@ -262,4 +264,156 @@ TEST_CASE( "Vectormath operations", "[vectormath]" )
         for (int i = 0; i < N_check; ++i)
             REQUIRE(vftest[i] == vtest3);
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE( "Counter-based random numbers", "[vectormath]" )
+{
+    SECTION("Philox known answers")
+    {
+        // Test vectors of the reference implementation (Random123)
+        std::vector<std::array<std::uint32_t, 10>> kat{
+            { 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+              0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 },
+            { 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff,
+              0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd },
+            { 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344, 0xa4093822, 0x299f31d0,
+              0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1 } };
+        for( auto& v : kat )
+        {
+            std::uint32_t ctr[4] = { v[0], v[1], v[2], v[3] };
+            std::uint32_t key[2] = { v[4], v[5] };
+            Engine::Philox::philox4x32_10( ctr, key );
+            for( int j=0; j<4; j++ )
+                REQUIRE( ctr[j] == v[6+j] );
+        }
+    }
+
+    SECTION("Random vectorfield on the unit sphere")
+    {
+        int N = 10000;
+        vectorfield xi1(N), xi2(N), xi3(N);
+        Engine::Vectormath::get_random_vectorfield_unitsphere( 2006, 17, xi1 );
+        Engine::Vectormath::get_random_vectorfield_unitsphere( 2006, 17, xi2 );
+        Engine::Vectormath::get_random_vectorfield_unitsphere( 2006, 18, xi3 );
+
+        // Reproducible for the same seed and counter, and different for a different counter
+        int n_equal = 0;
+        for( int i=0; i<N; i++ )
+        {
+            REQUIRE( xi1[i] == xi2[i] );
+            REQUIRE( xi1[i].norm() == Approx( 1 ) );
+            if( xi1[i] == xi3[i] ) ++n_equal;
+        }
+        REQUIRE( n_equal == 0 );
+
+        // Uniform on the unit sphere
+        auto m = Engine::Vectormath::Magnetization( xi1 );
+        for( int dim=0; dim<3; dim++ )
+            REQUIRE( std::abs( m[dim] ) < 0.05 );
+    }
+}
+
+TEST_CASE( "Vectorfield kernels against single vector operations", "[vectormath]" )
+{
+    // A number of spins which is not a multiple of any SIMD width
+    int N = 37;
+    vectorfield a(N), b(N), out(N), ref(N);
+    Engine::Vectormath::get_random_vectorfield_unitsphere( 1, 0, a );
+    Engine::Vectormath::get_random_vectorfield_unitsphere( 1, 1, b );
+    Engine::Vectormath::scale( b, 3 );
+    a[5] = { 0, 0, 0 };
+    scalar c = 0.7;
+
+    auto require_equal = [&]( const vectorfield & v1, const vectorfield & v2 )
+    {
+        for( int i=0; i<N; i++ )
+        {
+            INFO( "i = " << i );
+            REQUIRE( (v1[i] - v2[i]).norm() < 1e-12 );
+        }
+    };
+
+    SECTION("Dot products")
+    {
+        scalar dot_ref = 0;
+        for( int i=0; i<N; i++ )
+            dot_ref += a[i].dot(b[i]);
+        REQUIRE( std::abs( Engine::Vectormath::dot( a, b ) - dot_ref ) < 1e-12 );
+
+        scalarfield dots(N);
+        Engine::Vectormath::dot( a, b, dots );
+        for( int i=0; i<N; i++ )
+            REQUIRE( std::abs( dots[i] - a[i].dot(b[i]) ) < 1e-12 );
+    }
+
+    SECTION("Linear combinations")
+    {
+        out = b;
+        Engine::Vectormath::add_c_a( c, a, out );
+        for( int i=0; i<N; i++ )
+            ref[i] = b[i] + c*a[i];
+        require_equal( out, ref );
+
+        Engine::Vectormath::set_c_a( c, a, out );
+        for( int i=0; i<N; i++ )
+            ref[i] = c*a[i];
+        require_equal( out, ref );
+
+        Engine::Vectormath::scale( out, c );
+        for( int i=0; i<N; i++ )
+            ref[i] *= c;
+        require_equal( out, ref );
+    }
+
+    SECTION("Cross products")
+    {
+        Engine::Vectormath::cross( a, b, out );
+        for( int i=0; i<N; i++ )
+            ref[i] = a[i].cross(b[i]);
+        require_equal( out, ref );
+
+        out = b;
+        Engine::Vectormath::add_c_cross( c, a, b, out );
+        for( int i=0; i<N; i++ )
+            ref[i] = b[i] + c*a[i].cross(b[i]);
+        require_equal( out, ref );
+
+        // The output may be one of the inputs
+        out = b;
+        Engine::Vectormath::set_c_cross( c, a, out, out );
+        for( int i=0; i<N; i++ )
+            ref[i] = c*a[i].cross(b[i]);
+        require_equal( out, ref );
+    }
+
+    SECTION("Normalization and maximum component")
+    {
+        out = b;
+        Engine::Vectormath::normalize_vectors( out );
+        for( int i=0; i<N; i++ )
+            ref[i] = b[i].normalized();
+        require_equal( out, ref );
+
+        out = a;
+        Engine::Vectormath::normalize_vectors( out );
+        REQUIRE( out[5].norm() == 0 );
+
+        b[17][1] = -5;
+        scalar max_ref = 0;
+        for( int i=0; i<N; i++ )
+            max_ref = std::max( max_ref, b[i].cwiseAbs().maxCoeff() );
+        REQUIRE( Engine::Vectormath::max_abs_component( b ) == max_ref );
+    }
+
+    SECTION("SIB transformation")
+    {
+        Engine::Vectormath::transform( a, b, out );
+        for( int i=0; i<N; i++ )
+        {
+            // The transformation solves (1 - A x) s' = (1 + A x) s with A = b/2
+            Vector3 A = 0.5 * b[i];
+            ref[i] = out[i] - A.cross(out[i]) - A.cross(a[i]);
+        }
+        require_equal( ref, a );
+    }
+}